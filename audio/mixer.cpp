@@ -197,7 +197,8 @@ private:
 #pragma mark -
 
 MixerImpl::MixerImpl(uint sampleRate, bool stereo, uint outBufSize)
-	: _mutex(), _sampleRate(sampleRate), _stereo(stereo), _outBufSize(outBufSize), _mixerReady(false), _handleSeed(0), _soundTypeSettings() {
+	: _mutex(), _sampleRate(sampleRate), _stereo(stereo), _outBufSize(outBufSize), _mixerReady(false), _handleSeed(0), _soundTypeSettings(),
+	  _commandsQueued(0), _stats(), _lastCallbackTime(0), _lastBufferTime(0) {
 
 	assert(sampleRate > 0);
 
@@ -228,6 +229,83 @@ uint MixerImpl::getOutputBufSize() const {
 	return _outBufSize;
 }
 
+Mixer::Stats MixerImpl::getStats() {
+	Common::StackLock lock(_mutex);
+
+	Stats stats = _stats;
+	stats.commandsQueued = _commandsQueued.load();
+	return stats;
+}
+
+void MixerImpl::resetStats() {
+	Common::StackLock lock(_mutex);
+
+	_stats = Stats();
+	_commandsQueued.store(0);
+}
+
+void MixerImpl::queueCommand(ChannelCommand::Type type, SoundHandle handle, int32 value) {
+	ChannelCommand cmd;
+	cmd.type = type;
+	cmd.handle = handle;
+	cmd.value = value;
+	cmd.time = g_system->getMillis(true);
+
+	{
+		Common::StackLock lock(_commandMutex);
+		if (_commands.push(cmd)) {
+			_commandsQueued.fetchAdd(1);
+			return;
+		}
+	}
+
+	// The mixer callback is lagging behind. Flush the queue and apply this
+	// update right away. Holding the producer mutex while doing so keeps
+	// other threads from queueing updates that would be applied ahead of
+	// this one. The mixer mutex is taken first, as it is by callers that
+	// hold Mixer::mutex() while updating a channel.
+	Common::StackLock lock(_mutex);
+	Common::StackLock commandLock(_commandMutex);
+	_stats.commandsOverflowed++;
+	applyCommands();
+	applyCommand(cmd);
+}
+
+void MixerImpl::applyCommands() {
+	ChannelCommand cmd;
+	while (_commands.pop(cmd)) {
+		const uint32 latency = g_system->getMillis(true) - cmd.time;
+		if (latency > _stats.maxCommandLatency)
+			_stats.maxCommandLatency = latency;
+
+		applyCommand(cmd);
+	}
+}
+
+void MixerImpl::applyCommand(const ChannelCommand &cmd) {
+	// Ignore updates for sounds which terminated in the meantime
+	const int index = cmd.handle._val % NUM_CHANNELS;
+	if (!_channels[index] || _channels[index]->getHandle()._val != cmd.handle._val)
+		return;
+
+	switch (cmd.type) {
+	case ChannelCommand::kSetVolume:
+		_channels[index]->setVolume((byte)cmd.value);
+		break;
+	case ChannelCommand::kSetBalance:
+		_channels[index]->setBalance((int8)cmd.value);
+		break;
+	case ChannelCommand::kSetRate:
+		_channels[index]->setRate((uint32)cmd.value);
+		break;
+	case ChannelCommand::kResetRate:
+		_channels[index]->resetRate();
+		break;
+	default:
+		break;
+	}
+}
+
 void MixerImpl::insertChannel(SoundHandle *handle, Channel *chan) {
 	int index = -1;
 	for (int i = 0; i != NUM_CHANNELS; i++) {
@@ -301,8 +379,12 @@ void MixerImpl::playStream(
 int MixerImpl::mixCallback(byte *samples, uint len) {
 	assert(samples);
 
+	const uint32 startTime = g_system->getMillis(true);
+
 	Common::StackLock lock(_mutex);
 
+	const uint32 lockTime = g_system->getMillis(true);
+
 	int16 *buf = (int16 *)samples;
 
 	// Since the mixer callback has been called, the mixer must be ready...
@@ -320,6 +402,9 @@ int MixerImpl::mixCallback(byte *samples, uint len) {
 		len >>= 1;
 	}
 
+	// apply channel updates queued since the last callback
+	applyCommands();
+
 	// mix all channels
 	int res = 0, tmp;
 	for (int i = 0; i != NUM_CHANNELS; i++)
@@ -335,6 +420,24 @@ int MixerImpl::mixCallback(byte *samples, uint len) {
 			}
 		}
 
+	// A buffer counts as an underrun if it was requested later than the
+	// previous buffer plus one buffer of backend slack could cover, or if
+	// mixing it took longer than it takes to play it back.
+	const uint32 endTime = g_system->getMillis(true);
+	const uint32 bufferTime = len * 1000 / _sampleRate;
+	const uint32 mixTime = endTime - lockTime;
+
+	_stats.callbacks++;
+	if ((_lastCallbackTime != 0 && startTime - _lastCallbackTime > 2 * _lastBufferTime) || mixTime > bufferTime)
+		_stats.underruns++;
+	if (mixTime > _stats.maxMixTime)
+		_stats.maxMixTime = mixTime;
+	if (lockTime - startTime > _stats.maxLockWait)
+		_stats.maxLockWait = lockTime - startTime;
+
+	_lastCallbackTime = startTime;
+	_lastBufferTime = bufferTime;
+
 	return res;
 }
 
@@ -386,16 +489,13 @@ bool MixerImpl::isSoundTypeMuted(SoundType type) const {
 }
 
 void MixerImpl::setChannelVolume(SoundHandle handle, byte volume) {
-	Common::StackLock lock(_mutex);
-
-	const int index = handle._val % NUM_CHANNELS;
-	if (!_channels[index] || _channels[index]->getHandle()._val != handle._val)
-		return;
-
-	_channels[index]->setVolume(volume);
+	queueCommand(ChannelCommand::kSetVolume, handle, volume);
 }
 
 byte MixerImpl::getChannelVolume(SoundHandle handle) {
+	Common::StackLock lock(_mutex);
+	applyCommands();
+
 	const int index = handle._val % NUM_CHANNELS;
 	if (!_channels[index] || _channels[index]->getHandle()._val != handle._val)
 		return 0;
@@ -404,16 +504,13 @@ byte MixerImpl::getChannelVolume(SoundHandle handle) {
 }
 
 void MixerImpl::setChannelBalance(SoundHandle handle, int8 balance) {
-	Common::StackLock lock(_mutex);
-
-	const int index = handle._val % NUM_CHANNELS;
-	if (!_channels[index] || _channels[index]->getHandle()._val != handle._val)
-		return;
-
-	_channels[index]->setBalance(balance);
+	queueCommand(ChannelCommand::kSetBalance, handle, balance);
 }
 
 int8 MixerImpl::getChannelBalance(SoundHandle handle) {
+	Common::StackLock lock(_mutex);
+	applyCommands();
+
 	const int index = handle._val % NUM_CHANNELS;
 	if (!_channels[index] || _channels[index]->getHandle()._val != handle._val)
 		return 0;
@@ -422,16 +519,13 @@ int8 MixerImpl::getChannelBalance(SoundHandle handle) {
 }
 
 void MixerImpl::setChannelRate(SoundHandle handle, uint32 rate) {
-	Common::StackLock lock(_mutex);
-
-	const int index = handle._val % NUM_CHANNELS;
-	if (!_channels[index] || _channels[index]->getHandle()._val != handle._val)
-		return;
-
-	_channels[index]->setRate(rate);
+	queueCommand(ChannelCommand::kSetRate, handle, (int32)rate);
 }
 
 uint32 MixerImpl::getChannelRate(SoundHandle handle) {
+	Common::StackLock lock(_mutex);
+	applyCommands();
+
 	const int index = handle._val % NUM_CHANNELS;
 	if (!_channels[index] || _channels[index]->getHandle()._val != handle._val)
 		return 0;
@@ -440,13 +534,7 @@ uint32 MixerImpl::getChannelRate(SoundHandle handle) {
 }
 
 void MixerImpl::resetChannelRate(SoundHandle handle) {
-	Common::StackLock lock(_mutex);
-
-	const int index = handle._val % NUM_CHANNELS;
-	if (!_channels[index] || _channels[index]->getHandle()._val != handle._val)
-		return;
-	
-	_channels[index]->resetRate();
+	queueCommand(ChannelCommand::kResetRate, handle, 0);
 }
 
 uint32 MixerImpl::getSoundElapsedTime(SoundHandle handle) {
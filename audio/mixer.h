@@ -72,6 +72,23 @@ public:
 		kMaxMixerVolume = 256    /*!< Max global volume. */
 	};
 
+	/**
+	 * Statistics about the real-time behavior of the mixer.
+	 *
+	 * All times are in milliseconds.
+	 *
+	 * @see getStats()
+	 */
+	struct Stats {
+		uint32 callbacks;          /*!< Number of buffers mixed. */
+		uint32 underruns;          /*!< Buffers which were requested late or took longer to mix than they last. */
+		uint32 maxMixTime;         /*!< Longest time spent mixing a single buffer. */
+		uint32 maxLockWait;        /*!< Longest time the mixing callback waited for the mixer mutex. */
+		uint32 commandsQueued;     /*!< Channel updates queued for the mixing callback. */
+		uint32 commandsOverflowed; /*!< Channel updates applied synchronously because the queue was full. */
+		uint32 maxCommandLatency;  /*!< Longest delay between queuing a channel update and applying it. */
+	};
+
 public:
 	Mixer() {}
 	virtual ~Mixer() {}
@@ -341,6 +358,16 @@ public:
 	 * @return The number of samples processed at each audio callback.
 	 */
 	virtual uint getOutputBufSize() const = 0;
+
+	/**
+	 * Return statistics about underruns and latency of the mixer.
+	 */
+	virtual Stats getStats() = 0;
+
+	/**
+	 * Reset the statistics returned by getStats().
+	 */
+	virtual void resetStats() = 0;
 };
 
 /** @} */
@@ -24,6 +24,7 @@
 
 #include "common/scummsys.h"
 #include "common/mutex.h"
+#include "common/spscqueue.h"
 #include "audio/mixer.h"
 
 namespace Audio {
@@ -49,6 +50,13 @@ namespace Audio {
  * 4) Change the mixer into ready mode via setReady(true).
  * 5) Start audio processing (e.g. by resuming the audio thread, if applicable).
  *
+ * Changes to the volume, balance and rate of a channel do not take the
+ * mixer mutex. They are put into a lock-free queue instead, which the mixer
+ * callback empties before mixing the next buffer. Operations which affect
+ * the lifetime of a channel or its stream (playing, stopping, pausing) stay
+ * synchronous, since callers are allowed to dispose of a stream as soon as
+ * these return.
+ *
  * In the future, we might make it possible for backends to provide
  * (partial) alternative implementations of the mixer, e.g. to make
  * better use of native sound mixing support on low-end devices.
@@ -58,11 +66,41 @@ namespace Audio {
 class MixerImpl : public Mixer {
 private:
 	enum {
-		NUM_CHANNELS = 32
+		NUM_CHANNELS = 32,
+		COMMAND_QUEUE_SIZE = 256
+	};
+
+	/**
+	 * A deferred channel update, applied by the mixer callback.
+	 */
+	struct ChannelCommand {
+		enum Type {
+			kSetVolume,
+			kSetBalance,
+			kSetRate,
+			kResetRate
+		};
+
+		Type type;
+		SoundHandle handle;
+		int32 value;
+		uint32 time; ///< When the command was queued, for latency statistics
 	};
 
 	Common::Mutex _mutex;
 
+	/**
+	 * Serializes producers of _commands; never taken by the mixer callback.
+	 * When both are needed, _mutex is locked first.
+	 */
+	Common::Mutex _commandMutex;
+	Common::SPSCQueue<ChannelCommand, COMMAND_QUEUE_SIZE> _commands;
+	Common::Atomic<uint32> _commandsQueued;
+
+	Stats _stats;
+	uint32 _lastCallbackTime;
+	uint32 _lastBufferTime;
+
 	const uint _sampleRate;
 	const bool _stereo;
 	const uint _outBufSize;
@@ -136,9 +174,24 @@ public:
 	virtual bool getOutputStereo() const;
 	virtual uint getOutputBufSize() const;
 
+	virtual Stats getStats();
+	virtual void resetStats();
+
 protected:
 	void insertChannel(SoundHandle *handle, Channel *chan);
 
+	/**
+	 * Queue a channel update for the mixer callback. If the queue is full,
+	 * the update is applied immediately while holding the mixer mutex.
+	 */
+	void queueCommand(ChannelCommand::Type type, SoundHandle handle, int32 value);
+
+	/**
+	 * Apply all queued channel updates. The mixer mutex must be held.
+	 */
+	void applyCommands();
+	void applyCommand(const ChannelCommand &cmd);
+
 public:
 	/**
 	 * The mixer callback function, to be called at regular intervals by
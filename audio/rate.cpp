@@ -29,7 +29,9 @@
 
 #include "audio/audiostream.h"
 #include "audio/rate.h"
+#include "audio/rate_intern.h"
 #include "audio/mixer.h"
+#include "common/system.h"
 #include "common/util.h"
 
 namespace Audio {
@@ -64,6 +66,15 @@ private:
 	/** Size of data currently loaded into the buffer */
 	int _bufferSize;
 
+	/**
+	 * Input samples brought to the output rate, waiting to be mixed into
+	 * the output buffer. Uses the channel layout of the input stream.
+	 */
+	st_sample_t _resampled[512];
+
+	/** Applies the volume and mixes the converted samples into the output */
+	RateConverterMix::MixFunc _mix;
+
 	/** How far output is ahead of input when doing simple conversion */
 	frac_t _outPos;
 
@@ -76,6 +87,22 @@ private:
 	/** Current sample(s) in the input stream (left/right channel) */
 	st_sample_t _inCurL, _inCurR;
 
+	/**
+	 * Refill the input buffer if it has been used up.
+	 *
+	 * @return False if the input stream has no more data.
+	 */
+	inline bool refillBuffer(AudioStream &input) {
+		if (_bufferSize == 0) {
+			_bufferPos = _buffer;
+			_bufferSize = input.readBuffer(_buffer, ARRAYSIZE(_buffer));
+
+			if (_bufferSize <= 0)
+				return false;
+		}
+		return true;
+	}
+
 	int copyConvert(AudioStream &input, st_sample_t *outBuffer, st_size_t numSamples, st_volume_t vol_l, st_volume_t vol_r);
 	int simpleConvert(AudioStream &input, st_sample_t *outBuffer, st_size_t numSamples, st_volume_t vol_l, st_volume_t vol_r);
 	int interpolateConvert(AudioStream &input, st_sample_t *outBuffer, st_size_t numSamples, st_volume_t vol_l, st_volume_t vol_r);
@@ -104,38 +131,16 @@ int RateConverter_Impl<inStereo, outStereo, reverseStereo>::copyConvert(AudioStr
 
 	while (outBuffer < outEnd) {
 		// Check if we have to refill the buffer
-		if (_bufferSize == 0) {
-			_bufferPos = _buffer;
-			_bufferSize = input.readBuffer(_buffer, ARRAYSIZE(_buffer));
+		if (!refillBuffer(input))
+			return (outBuffer - outStart) / (outStereo ? 2 : 1);
 
-			if (_bufferSize <= 0)
-				return (outBuffer - outStart) / (outStereo ? 2 : 1);
-		}
-
-		// Mix the data into the output buffer
-		st_sample_t inL, inR;
-		inL = *_bufferPos++;
-		inR = (inStereo ? *_bufferPos++ : inL);
-		_bufferSize -= (inStereo ? 2 : 1);
-
-		st_sample_t outL, outR;
-		outL = (inL * (int)volL) / Audio::Mixer::kMaxMixerVolume;
-		outR = (inR * (int)volR) / Audio::Mixer::kMaxMixerVolume;
-
-		if (outStereo) {
-			// Output left channel
-			clampedAdd(outBuffer[reverseStereo    ], outL);
-
-			// Output right channel
-			clampedAdd(outBuffer[reverseStereo ^ 1], outR);
+		// Mix as much of the buffered data as fits into the output buffer
+		const uint numFrames = MIN<uint>(_bufferSize / (inStereo ? 2 : 1), (outEnd - outBuffer) / (outStereo ? 2 : 1));
+		_mix(outBuffer, _bufferPos, numFrames, volL, volR);
 
-			outBuffer += 2;
-		} else {
-			// Output mono channel
-			clampedAdd(outBuffer[0], (outL + outR) / 2);
-
-			outBuffer += 1;
-		}
+		_bufferPos += numFrames * (inStereo ? 2 : 1);
+		_bufferSize -= numFrames * (inStereo ? 2 : 1);
+		outBuffer += numFrames * (outStereo ? 2 : 1);
 	}
 
 	return (outBuffer - outStart) / (outStereo ? 2 : 1);
@@ -152,50 +157,45 @@ int RateConverter_Impl<inStereo, outStereo, reverseStereo>::simpleConvert(AudioS
 	outEnd = outBuffer + numSamples * (outStereo ? 2 : 1);
 
 	while (outBuffer < outEnd) {
-		// Read enough input samples so that _outPos >= 0
-		do {
-			// Check if we have to refill the buffer
-			if (_bufferSize == 0) {
-				_bufferPos = _buffer;
-				_bufferSize = input.readBuffer(_buffer, ARRAYSIZE(_buffer));
-
-				if (_bufferSize <= 0)
-					return (outBuffer - outStart) / (outStereo ? 2 : 1);
-			}
-
-			_bufferSize -= (inStereo ? 2 : 1);
-			_outPos--;
+		const uint numFrames = MIN<uint>(ARRAYSIZE(_resampled) / (inStereo ? 2 : 1), (outEnd - outBuffer) / (outStereo ? 2 : 1));
+		st_sample_t *resampled = _resampled;
+		bool endOfInput = false;
+
+		for (uint i = 0; i < numFrames && !endOfInput; i++) {
+			// Read enough input samples so that _outPos >= 0
+			do {
+				// Check if we have to refill the buffer
+				if (!refillBuffer(input)) {
+					endOfInput = true;
+					break;
+				}
+
+				_bufferSize -= (inStereo ? 2 : 1);
+				_outPos--;
+
+				if (_outPos >= 0) {
+					_bufferPos += (inStereo ? 2 : 1);
+				}
+			} while (_outPos >= 0);
+
+			if (endOfInput)
+				break;
+
+			*resampled++ = *_bufferPos++;
+			if (inStereo)
+				*resampled++ = *_bufferPos++;
 
-			if (_outPos >= 0) {
-				_bufferPos += (inStereo ? 2 : 1);
-			}
-		} while (_outPos >= 0);
-
-		st_sample_t inL, inR;
-		inL = *_bufferPos++;
-		inR = (inStereo ? *_bufferPos++ : inL);
-
-		// Increment output position
-		_outPos += outPos_inc;
-
-		st_sample_t outL, outR;
-		outL = (inL * (int)volL) / Audio::Mixer::kMaxMixerVolume;
-		outR = (inR * (int)volR) / Audio::Mixer::kMaxMixerVolume;
-
-		if (outStereo) {
-			// output left channel
-			clampedAdd(outBuffer[reverseStereo    ], outL);
-
-			// output right channel
-			clampedAdd(outBuffer[reverseStereo ^ 1], outR);
+			// Increment output position
+			_outPos += outPos_inc;
+		}
 
-			outBuffer += 2;
-		} else {
-			// output mono channel
-			clampedAdd(outBuffer[0], (outL + outR) / 2);
+		// Mix the collected samples into the output buffer
+		const uint numResampled = (resampled - _resampled) / (inStereo ? 2 : 1);
+		_mix(outBuffer, _resampled, numResampled, volL, volR);
+		outBuffer += numResampled * (outStereo ? 2 : 1);
 
-			outBuffer += 1;
-		}
+		if (endOfInput)
+			break;
 	}
 	return (outBuffer - outStart) / (outStereo ? 2 : 1);
 }
@@ -213,13 +213,8 @@ int RateConverter_Impl<inStereo, outStereo, reverseStereo>::interpolateConvert(A
 		// Read enough input samples so that _outPosFrac < 0
 		while ((frac_t)FRAC_ONE_LOW <= _outPosFrac) {
 			// Check if we have to refill the buffer
-			if (_bufferSize == 0) {
-				_bufferPos = _buffer;
-				_bufferSize = input.readBuffer(_buffer, ARRAYSIZE(_buffer));
-
-				if (_bufferSize <= 0)
-					return (outBuffer - outStart) / (outStereo ? 2 : 1);
-			}
+			if (!refillBuffer(input))
+				return (outBuffer - outStart) / (outStereo ? 2 : 1);
 
 			_bufferSize -= (inStereo ? 2 : 1);
 			_inLastL = _inCurL;
@@ -233,38 +228,26 @@ int RateConverter_Impl<inStereo, outStereo, reverseStereo>::interpolateConvert(A
 			_outPosFrac -= FRAC_ONE_LOW;
 		}
 
+		const uint numFrames = MIN<uint>(ARRAYSIZE(_resampled) / (inStereo ? 2 : 1), (outEnd - outBuffer) / (outStereo ? 2 : 1));
+		st_sample_t *resampled = _resampled;
+		st_sample_t *resampledEnd = _resampled + numFrames * (inStereo ? 2 : 1);
+
 		// Loop as long as the _outPos trails behind, and as long as there is
 		// still space in the output buffer.
-		while (_outPosFrac < (frac_t)FRAC_ONE_LOW && outBuffer < outEnd) {
+		while (_outPosFrac < (frac_t)FRAC_ONE_LOW && resampled < resampledEnd) {
 			// Interpolate
-			st_sample_t inL, inR;
-			inL = (st_sample_t)(_inLastL + (((_inCurL - _inLastL) * _outPosFrac + FRAC_HALF_LOW) >> FRAC_BITS_LOW));
-			inR = (inStereo ?
-						(st_sample_t)(_inLastR + (((_inCurR - _inLastR) * _outPosFrac + FRAC_HALF_LOW) >> FRAC_BITS_LOW)) :
-						inL);
-
-			st_sample_t outL, outR;
-			outL = (inL * (int)volL) / Audio::Mixer::kMaxMixerVolume;
-			outR = (inR * (int)volR) / Audio::Mixer::kMaxMixerVolume;
-
-			if (outStereo) {
-				// Output left channel
-				clampedAdd(outBuffer[reverseStereo    ], outL);
-
-				// Output right channel
-				clampedAdd(outBuffer[reverseStereo ^ 1], outR);
-
-				outBuffer += 2;
-			} else {
-				// Output mono channel
-				clampedAdd(outBuffer[0], (outL + outR) / 2);
-
-				outBuffer += 1;
-			}
+			*resampled++ = (st_sample_t)(_inLastL + (((_inCurL - _inLastL) * _outPosFrac + FRAC_HALF_LOW) >> FRAC_BITS_LOW));
+			if (inStereo)
+				*resampled++ = (st_sample_t)(_inLastR + (((_inCurR - _inLastR) * _outPosFrac + FRAC_HALF_LOW) >> FRAC_BITS_LOW));
 
 			// Increment output position
 			_outPosFrac += outPos_inc;
 		}
+
+		// Mix the interpolated samples into the output buffer
+		const uint numResampled = (resampled - _resampled) / (inStereo ? 2 : 1);
+		_mix(outBuffer, _resampled, numResampled, volL, volR);
+		outBuffer += numResampled * (outStereo ? 2 : 1);
 	}
 	return (outBuffer - outStart) / (outStereo ? 2 : 1);
 }
@@ -280,7 +263,8 @@ RateConverter_Impl<inStereo, outStereo, reverseStereo>::RateConverter_Impl(st_ra
 	_inCurL(0),
 	_inCurR(0),
 	_bufferSize(0),
-	_bufferPos(nullptr) {}
+	_bufferPos(nullptr),
+	_mix(RateConverterMix::getMixFunc(inStereo, outStereo, reverseStereo)) {}
 
 template<bool inStereo, bool outStereo, bool reverseStereo>
 int RateConverter_Impl<inStereo, outStereo, reverseStereo>::convert(AudioStream &input, st_sample_t *outBuffer, st_size_t numSamples, st_volume_t volL, st_volume_t volR) {
@@ -297,6 +281,49 @@ int RateConverter_Impl<inStereo, outStereo, reverseStereo>::convert(AudioStream
 	}
 }
 
+template<bool inStereo, bool outStereo, bool reverseStereo>
+static void mixGeneric(st_sample_t *outBuffer, const st_sample_t *inBuffer, uint numFrames, st_volume_t volL, st_volume_t volR) {
+	RateConverterMix::mixScalar<inStereo, outStereo, reverseStereo>(outBuffer, inBuffer, numFrames, volL, volR);
+}
+
+RateConverterMix::MixFunc RateConverterMix::getMixFuncGeneric(bool inStereo, bool outStereo, bool reverseStereo) {
+	if (inStereo) {
+		if (outStereo)
+			return reverseStereo ? mixGeneric<true, true, true> : mixGeneric<true, true, false>;
+		else
+			return reverseStereo ? mixGeneric<true, false, true> : mixGeneric<true, false, false>;
+	} else {
+		if (outStereo)
+			return reverseStereo ? mixGeneric<false, true, true> : mixGeneric<false, true, false>;
+		else
+			return reverseStereo ? mixGeneric<false, false, true> : mixGeneric<false, false, false>;
+	}
+}
+
+RateConverterMix::MixFunc RateConverterMix::getMixFunc(bool inStereo, bool outStereo, bool reverseStereo) {
+	MixFunc func = nullptr;
+
+	// The SIMD variants saturate on signed samples only
+#ifndef OUTPUT_UNSIGNED_AUDIO
+#ifdef SCUMMVM_NEON
+	if (!func && g_system->hasFeature(OSystem::kFeatureCpuNEON))
+		func = getMixFuncNEON(inStereo, outStereo, reverseStereo);
+#endif
+#ifdef SCUMMVM_AVX2
+	if (!func && g_system->hasFeature(OSystem::kFeatureCpuAVX2))
+		func = getMixFuncAVX2(inStereo, outStereo, reverseStereo);
+#endif
+#ifdef SCUMMVM_SSE2
+	if (!func && g_system->hasFeature(OSystem::kFeatureCpuSSE2))
+		func = getMixFuncSSE2(inStereo, outStereo, reverseStereo);
+#endif
+#endif
+
+	if (!func)
+		func = getMixFuncGeneric(inStereo, outStereo, reverseStereo);
+	return func;
+}
+
 RateConverter *makeRateConverter(st_rate_t inRate, st_rate_t outRate, bool inStereo, bool outStereo, bool reverseStereo) {
 	if (inStereo) {
 		if (outStereo) {
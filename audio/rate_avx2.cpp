@@ -0,0 +1,103 @@
+/* ScummVM - Graphic Adventure Engine
+ *
+ * ScummVM is the legal property of its developers, whose names
+ * are too numerous to list here. Please refer to the COPYRIGHT
+ * file distributed with this source distribution.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include "common/scummsys.h"
+
+#include "audio/rate_intern.h"
+
+#include <immintrin.h>
+
+#ifdef __GNUC__
+#pragma GCC push_options
+#pragma GCC target("avx2")
+#endif
+
+namespace Audio {
+
+// Scale the 16-bit samples in src by the 16-bit volumes in vol, dividing by
+// kMaxMixerVolume with the same rounding towards zero as the scalar code.
+static FORCEINLINE __m256i avx2_scale(__m256i src, __m256i vol) {
+	__m256i lo = _mm256_mullo_epi16(src, vol);
+	__m256i hi = _mm256_mulhi_epi16(src, vol);
+	__m256i p0 = _mm256_unpacklo_epi16(lo, hi);
+	__m256i p1 = _mm256_unpackhi_epi16(lo, hi);
+	p0 = _mm256_srai_epi32(_mm256_add_epi32(p0, _mm256_and_si256(_mm256_srai_epi32(p0, 31), _mm256_set1_epi32(Audio::Mixer::kMaxMixerVolume - 1))), 8);
+	p1 = _mm256_srai_epi32(_mm256_add_epi32(p1, _mm256_and_si256(_mm256_srai_epi32(p1, 31), _mm256_set1_epi32(Audio::Mixer::kMaxMixerVolume - 1))), 8);
+	// Unpacking and packing both work within 128-bit lanes, so the order is preserved
+	return _mm256_packs_epi32(p0, p1);
+}
+
+template<bool reverseStereo>
+static FORCEINLINE void avx2_mixStereo(st_sample_t *outBuffer, __m256i src, __m256i vol) {
+	__m256i out = avx2_scale(src, vol);
+	if (reverseStereo)
+		out = _mm256_shufflehi_epi16(_mm256_shufflelo_epi16(out, _MM_SHUFFLE(2, 3, 0, 1)), _MM_SHUFFLE(2, 3, 0, 1));
+	__m256i dst = _mm256_loadu_si256((const __m256i *)outBuffer);
+	_mm256_storeu_si256((__m256i *)outBuffer, _mm256_adds_epi16(dst, out));
+}
+
+template<bool inStereo, bool reverseStereo>
+static void mixAVX2(st_sample_t *outBuffer, const st_sample_t *inBuffer, uint numFrames, st_volume_t volL, st_volume_t volR) {
+	uint i = 0;
+
+	if (RateConverterMix::isSIMDVolume(volL, volR)) {
+		const __m256i vol = _mm256_set_epi16(volR, volL, volR, volL, volR, volL, volR, volL,
+		                                     volR, volL, volR, volL, volR, volL, volR, volL);
+
+		if (inStereo) {
+			for (; i + 8 <= numFrames; i += 8) {
+				__m256i src = _mm256_loadu_si256((const __m256i *)inBuffer);
+				avx2_mixStereo<reverseStereo>(outBuffer, src, vol);
+				inBuffer += 16;
+				outBuffer += 16;
+			}
+		} else {
+			for (; i + 16 <= numFrames; i += 16) {
+				// Reorder the 64-bit quarters so that the in-lane unpacking
+				// below duplicates the samples in their original order
+				__m256i src = _mm256_permute4x64_epi64(_mm256_loadu_si256((const __m256i *)inBuffer), _MM_SHUFFLE(3, 1, 2, 0));
+				avx2_mixStereo<reverseStereo>(outBuffer, _mm256_unpacklo_epi16(src, src), vol);
+				avx2_mixStereo<reverseStereo>(outBuffer + 16, _mm256_unpackhi_epi16(src, src), vol);
+				inBuffer += 16;
+				outBuffer += 32;
+			}
+		}
+	}
+
+	RateConverterMix::mixScalar<inStereo, true, reverseStereo>(outBuffer, inBuffer, numFrames - i, volL, volR);
+}
+
+RateConverterMix::MixFunc RateConverterMix::getMixFuncAVX2(bool inStereo, bool outStereo, bool reverseStereo) {
+	// Mono output is rare enough to stay with the generic code
+	if (!outStereo)
+		return nullptr;
+
+	if (inStereo)
+		return reverseStereo ? mixAVX2<true, true> : mixAVX2<true, false>;
+	else
+		return reverseStereo ? mixAVX2<false, true> : mixAVX2<false, false>;
+}
+
+} // End of namespace Audio
+
+#ifdef __GNUC__
+#pragma GCC pop_options
+#endif
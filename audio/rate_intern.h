@@ -0,0 +1,105 @@
+/* ScummVM - Graphic Adventure Engine
+ *
+ * ScummVM is the legal property of its developers, whose names
+ * are too numerous to list here. Please refer to the COPYRIGHT
+ * file distributed with this source distribution.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#ifndef AUDIO_RATE_INTERN_H
+#define AUDIO_RATE_INTERN_H
+
+#include "audio/mixer.h"
+#include "audio/rate.h"
+
+namespace Audio {
+
+/**
+ * Volume scaling and mixing kernels of the rate converters.
+ *
+ * The rate converters first bring their input to the output rate, then use
+ * one of these functions to apply the channel volumes and add the result to
+ * the output buffer with saturation. The function is picked at runtime,
+ * depending on the SIMD extensions supported by the CPU.
+ */
+class RateConverterMix {
+public:
+	/**
+	 * Scale @p numFrames frames of @p inBuffer by the channel volumes and
+	 * add them to @p outBuffer.
+	 */
+	typedef void (*MixFunc)(st_sample_t *outBuffer, const st_sample_t *inBuffer, uint numFrames, st_volume_t volL, st_volume_t volR);
+
+	/**
+	 * Return the fastest mixing function for the given channel layout.
+	 */
+	static MixFunc getMixFunc(bool inStereo, bool outStereo, bool reverseStereo);
+
+	static MixFunc getMixFuncGeneric(bool inStereo, bool outStereo, bool reverseStereo);
+#ifdef SCUMMVM_NEON
+	static MixFunc getMixFuncNEON(bool inStereo, bool outStereo, bool reverseStereo);
+#endif
+#ifdef SCUMMVM_SSE2
+	static MixFunc getMixFuncSSE2(bool inStereo, bool outStereo, bool reverseStereo);
+#endif
+#ifdef SCUMMVM_AVX2
+	static MixFunc getMixFuncAVX2(bool inStereo, bool outStereo, bool reverseStereo);
+#endif
+
+	/**
+	 * The scalar reference implementation. The SIMD variants use it for
+	 * the frames left over after their vectorized loop.
+	 */
+	template<bool inStereo, bool outStereo, bool reverseStereo>
+	static inline void mixScalar(st_sample_t *outBuffer, const st_sample_t *inBuffer, uint numFrames, st_volume_t volL, st_volume_t volR) {
+		for (uint i = 0; i < numFrames; i++) {
+			st_sample_t inL, inR;
+			inL = *inBuffer++;
+			inR = (inStereo ? *inBuffer++ : inL);
+
+			st_sample_t outL, outR;
+			outL = (inL * (int)volL) / Audio::Mixer::kMaxMixerVolume;
+			outR = (inR * (int)volR) / Audio::Mixer::kMaxMixerVolume;
+
+			if (outStereo) {
+				// Output left channel
+				clampedAdd(outBuffer[reverseStereo    ], outL);
+
+				// Output right channel
+				clampedAdd(outBuffer[reverseStereo ^ 1], outR);
+
+				outBuffer += 2;
+			} else {
+				// Output mono channel
+				clampedAdd(outBuffer[0], (outL + outR) / 2);
+
+				outBuffer += 1;
+			}
+		}
+	}
+
+	/**
+	 * The SIMD variants work on 16-bit products, so they only handle
+	 * volumes up to the maximum mixer volume.
+	 */
+	static inline bool isSIMDVolume(st_volume_t volL, st_volume_t volR) {
+		return volL <= Audio::Mixer::kMaxMixerVolume && volR <= Audio::Mixer::kMaxMixerVolume;
+	}
+};
+
+} // End of namespace Audio
+
+#endif
@@ -0,0 +1,103 @@
+/* ScummVM - Graphic Adventure Engine
+ *
+ * ScummVM is the legal property of its developers, whose names
+ * are too numerous to list here. Please refer to the COPYRIGHT
+ * file distributed with this source distribution.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include "common/scummsys.h"
+
+#ifdef SCUMMVM_NEON
+
+#include "audio/rate_intern.h"
+
+#include <arm_neon.h>
+
+#ifdef __GNUC__
+#pragma GCC push_options
+
+#if !defined(__aarch64__)
+#pragma GCC target("fpu=neon")
+#endif // !defined(__aarch64__)
+
+#endif // __GNUC__
+
+namespace Audio {
+
+// Divide the 32-bit products by kMaxMixerVolume, rounding towards zero
+// like the scalar code does.
+static inline int16x4_t neon_divide(int32x4_t p) {
+	p = vaddq_s32(p, vandq_s32(vshrq_n_s32(p, 31), vdupq_n_s32(Audio::Mixer::kMaxMixerVolume - 1)));
+	return vmovn_s32(vshrq_n_s32(p, 8));
+}
+
+template<bool reverseStereo>
+static inline void neon_mixStereo(st_sample_t *outBuffer, int16x8_t src, int16x4_t vol) {
+	int16x8_t out = vcombine_s16(neon_divide(vmull_s16(vget_low_s16(src), vol)),
+	                             neon_divide(vmull_s16(vget_high_s16(src), vol)));
+	if (reverseStereo)
+		out = vrev32q_s16(out);
+	vst1q_s16(outBuffer, vqaddq_s16(vld1q_s16(outBuffer), out));
+}
+
+template<bool inStereo, bool reverseStereo>
+static void mixNEON(st_sample_t *outBuffer, const st_sample_t *inBuffer, uint numFrames, st_volume_t volL, st_volume_t volR) {
+	uint i = 0;
+
+	if (RateConverterMix::isSIMDVolume(volL, volR)) {
+		const int16 volumes[4] = { (int16)volL, (int16)volR, (int16)volL, (int16)volR };
+		const int16x4_t vol = vld1_s16(volumes);
+
+		if (inStereo) {
+			for (; i + 4 <= numFrames; i += 4) {
+				neon_mixStereo<reverseStereo>(outBuffer, vld1q_s16(inBuffer), vol);
+				inBuffer += 8;
+				outBuffer += 8;
+			}
+		} else {
+			for (; i + 8 <= numFrames; i += 8) {
+				int16x8_t src = vld1q_s16(inBuffer);
+				int16x8x2_t dup = vzipq_s16(src, src);
+				neon_mixStereo<reverseStereo>(outBuffer, dup.val[0], vol);
+				neon_mixStereo<reverseStereo>(outBuffer + 8, dup.val[1], vol);
+				inBuffer += 8;
+				outBuffer += 16;
+			}
+		}
+	}
+
+	RateConverterMix::mixScalar<inStereo, true, reverseStereo>(outBuffer, inBuffer, numFrames - i, volL, volR);
+}
+
+RateConverterMix::MixFunc RateConverterMix::getMixFuncNEON(bool inStereo, bool outStereo, bool reverseStereo) {
+	// Mono output is rare enough to stay with the generic code
+	if (!outStereo)
+		return nullptr;
+
+	if (inStereo)
+		return reverseStereo ? mixNEON<true, true> : mixNEON<true, false>;
+	else
+		return reverseStereo ? mixNEON<false, true> : mixNEON<false, false>;
+}
+
+} // End of namespace Audio
+
+#ifdef __GNUC__
+#pragma GCC pop_options
+#endif
+
+#endif // SCUMMVM_NEON
@@ -0,0 +1,103 @@
+/* ScummVM - Graphic Adventure Engine
+ *
+ * ScummVM is the legal property of its developers, whose names
+ * are too numerous to list here. Please refer to the COPYRIGHT
+ * file distributed with this source distribution.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include "common/scummsys.h"
+
+#include "audio/rate_intern.h"
+
+#include <emmintrin.h>
+
+#ifdef __GNUC__
+#pragma GCC push_options
+
+#ifndef __x86_64__
+#pragma GCC target("sse2")
+#endif
+
+#endif
+
+namespace Audio {
+
+// Scale the 16-bit samples in src by the 16-bit volumes in vol, dividing by
+// kMaxMixerVolume with the same rounding towards zero as the scalar code.
+static FORCEINLINE __m128i sse2_scale(__m128i src, __m128i vol) {
+	__m128i lo = _mm_mullo_epi16(src, vol);
+	__m128i hi = _mm_mulhi_epi16(src, vol);
+	__m128i p0 = _mm_unpacklo_epi16(lo, hi);
+	__m128i p1 = _mm_unpackhi_epi16(lo, hi);
+	p0 = _mm_srai_epi32(_mm_add_epi32(p0, _mm_and_si128(_mm_srai_epi32(p0, 31), _mm_set1_epi32(Audio::Mixer::kMaxMixerVolume - 1))), 8);
+	p1 = _mm_srai_epi32(_mm_add_epi32(p1, _mm_and_si128(_mm_srai_epi32(p1, 31), _mm_set1_epi32(Audio::Mixer::kMaxMixerVolume - 1))), 8);
+	return _mm_packs_epi32(p0, p1);
+}
+
+template<bool reverseStereo>
+static FORCEINLINE void sse2_mixStereo(st_sample_t *outBuffer, __m128i src, __m128i vol) {
+	__m128i out = sse2_scale(src, vol);
+	if (reverseStereo)
+		out = _mm_shufflehi_epi16(_mm_shufflelo_epi16(out, _MM_SHUFFLE(2, 3, 0, 1)), _MM_SHUFFLE(2, 3, 0, 1));
+	__m128i dst = _mm_loadu_si128((const __m128i *)outBuffer);
+	_mm_storeu_si128((__m128i *)outBuffer, _mm_adds_epi16(dst, out));
+}
+
+template<bool inStereo, bool reverseStereo>
+static void mixSSE2(st_sample_t *outBuffer, const st_sample_t *inBuffer, uint numFrames, st_volume_t volL, st_volume_t volR) {
+	uint i = 0;
+
+	if (RateConverterMix::isSIMDVolume(volL, volR)) {
+		const __m128i vol = _mm_set_epi16(volR, volL, volR, volL, volR, volL, volR, volL);
+
+		if (inStereo) {
+			for (; i + 4 <= numFrames; i += 4) {
+				__m128i src = _mm_loadu_si128((const __m128i *)inBuffer);
+				sse2_mixStereo<reverseStereo>(outBuffer, src, vol);
+				inBuffer += 8;
+				outBuffer += 8;
+			}
+		} else {
+			for (; i + 8 <= numFrames; i += 8) {
+				__m128i src = _mm_loadu_si128((const __m128i *)inBuffer);
+				sse2_mixStereo<reverseStereo>(outBuffer, _mm_unpacklo_epi16(src, src), vol);
+				sse2_mixStereo<reverseStereo>(outBuffer + 8, _mm_unpackhi_epi16(src, src), vol);
+				inBuffer += 8;
+				outBuffer += 16;
+			}
+		}
+	}
+
+	RateConverterMix::mixScalar<inStereo, true, reverseStereo>(outBuffer, inBuffer, numFrames - i, volL, volR);
+}
+
+RateConverterMix::MixFunc RateConverterMix::getMixFuncSSE2(bool inStereo, bool outStereo, bool reverseStereo) {
+	// Mono output is rare enough to stay with the generic code
+	if (!outStereo)
+		return nullptr;
+
+	if (inStereo)
+		return reverseStereo ? mixSSE2<true, true> : mixSSE2<true, false>;
+	else
+		return reverseStereo ? mixSSE2<false, true> : mixSSE2<false, false>;
+}
+
+} // End of namespace Audio
+
+#ifdef __GNUC__
+#pragma GCC pop_options
+#endif
@@ -172,6 +172,17 @@ public:
 	 */
 	virtual bool isWritable() const = 0;
 
+	/**
+	 * Retrieves the size and the time of the last modification of the file
+	 * referred by this node. The modification time is only meant to be
+	 * compared against earlier values for the same file.
+	 *
+	 * @param size				the size of the file in bytes
+	 * @param modificationTime	the modification time, in seconds
+	 * @return true if the information is available, false otherwise
+	 */
+	virtual bool getFileStats(int64 &size, int64 &modificationTime) const;
+
 
 	/**
 	 * Creates a SeekableReadStream instance corresponding to the file
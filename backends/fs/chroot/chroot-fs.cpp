@@ -73,6 +73,10 @@ bool ChRootFilesystemNode::isWritable() const {
 	return _realNode->isWritable();
 }
 
+bool ChRootFilesystemNode::getFileStats(int64 &size, int64 &modificationTime) const {
+	return _realNode->getFileStats(size, modificationTime);
+}
+
 AbstractFSNode *ChRootFilesystemNode::getChild(const Common::String &n) const {
 	return new ChRootFilesystemNode(_root, (POSIXFilesystemNode *)_realNode->getChild(n), _drive);
 }
@@ -44,6 +44,19 @@ bool WindowsFilesystemNode::isWritable() const {
 	return ((fileAttribs != INVALID_FILE_ATTRIBUTES) && (!(fileAttribs & FILE_ATTRIBUTE_READONLY)));
 }
 
+bool WindowsFilesystemNode::getFileStats(int64 &size, int64 &modificationTime) const {
+	WIN32_FILE_ATTRIBUTE_DATA fileData;
+
+	if (!GetFileAttributesEx(charToTchar(_path.c_str()), GetFileExInfoStandard, &fileData) ||
+	    (fileData.dwFileAttributes & FILE_ATTRIBUTE_DIRECTORY))
+		return false;
+
+	size = ((int64)fileData.nFileSizeHigh << 32) | fileData.nFileSizeLow;
+	// FILETIME counts 100ns intervals
+	modificationTime = (((int64)fileData.ftLastWriteTime.dwHighDateTime << 32) | fileData.ftLastWriteTime.dwLowDateTime) / 10000000;
+	return true;
+}
+
 void WindowsFilesystemNode::addFile(AbstractFSList &list, ListMode mode, const char *base, bool hidden, WIN32_FIND_DATA* find_data) {
 	// Skip local directory (.) and parent (..)
 	if (!_tcscmp(find_data->cFileName, TEXT(".")) ||
@@ -76,7 +76,8 @@ OpenGLGraphicsManager::OpenGLGraphicsManager()
 	  _cursor(nullptr), _cursorMask(nullptr),
 	  _cursorHotspotX(0), _cursorHotspotY(0),
 	  _cursorHotspotXScaled(0), _cursorHotspotYScaled(0), _cursorWidthScaled(0), _cursorHeightScaled(0),
-	  _cursorKeyColor(0), _cursorUseKey(true), _cursorDontScale(false), _cursorPaletteEnabled(false), _shakeOffsetScaled()
+	  _cursorKeyColor(0), _cursorUseKey(true), _cursorDontScale(false), _cursorPaletteEnabled(false), _shakeOffsetScaled(),
+	  _frameUploadStats(), _uploadStatsTotal(), _uploadStatsFrames(0), _uploadStatsStartTime(0)
 #if !USE_FORCED_GLES
 	  , _libretroPipeline(nullptr)
 #endif
@@ -678,6 +679,9 @@ void OpenGLGraphicsManager::updateScreen() {
 	}
 	_overlay->updateGLTexture();
 
+	// This includes the OSD textures updated above.
+	updateUploadStats();
+
 #if !USE_FORCED_GLES
 	if (_libretroPipeline) {
 		_libretroPipeline->beginScaling();
@@ -797,6 +801,28 @@ void OpenGLGraphicsManager::updateScreen() {
 	refreshScreen();
 }
 
+void OpenGLGraphicsManager::updateUploadStats() {
+	_frameUploadStats = GLTexture::getUploadStats();
+	GLTexture::resetUploadStats();
+
+	_uploadStatsTotal.uploads += _frameUploadStats.uploads;
+	_uploadStatsTotal.bytes += _frameUploadStats.bytes;
+	_uploadStatsTotal.bufferedBytes += _frameUploadStats.bufferedBytes;
+	_uploadStatsFrames++;
+
+	const uint32 now = g_system->getMillis(false);
+	if (now - _uploadStatsStartTime < 1000) {
+		return;
+	}
+
+	debug(3, "OpenGL: %u frames, %u texture uploads, %u KiB uploaded (%u KiB through pixel buffers)",
+	      _uploadStatsFrames, _uploadStatsTotal.uploads, _uploadStatsTotal.bytes / 1024, _uploadStatsTotal.bufferedBytes / 1024);
+
+	_uploadStatsTotal = TextureUploadStats();
+	_uploadStatsFrames = 0;
+	_uploadStatsStartTime = now;
+}
+
 Graphics::Surface *OpenGLGraphicsManager::lockScreen() {
 	return _gameScreen->getSurface();
 }
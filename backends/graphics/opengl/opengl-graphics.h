@@ -23,6 +23,7 @@
 #define BACKENDS_GRAPHICS_OPENGL_OPENGL_GRAPHICS_H
 
 #include "backends/graphics/opengl/framebuffer.h"
+#include "backends/graphics/opengl/texture.h"
 #include "backends/graphics/windowed.h"
 
 #include "common/frac.h"
@@ -130,8 +131,14 @@ public:
 	void setPalette(const byte *colors, uint start, uint num) override;
 	void grabPalette(byte *colors, uint start, uint num) const override;
 
+	/**
+	 * Query the texture uploads done for the last drawn frame.
+	 */
+	const TextureUploadStats &getFrameUploadStats() const { return _frameUploadStats; }
+
 protected:
 	void renderCursor();
+	void updateUploadStats();
 
 	/**
 	 * Whether a GLES or GLES2 context is active.
@@ -446,6 +453,22 @@ protected:
 	 */
 	byte _cursorPalette[3 * 256];
 
+	//
+	// Texture upload statistics
+	//
+
+	/**
+	 * The texture uploads done for the last drawn frame.
+	 */
+	TextureUploadStats _frameUploadStats;
+
+	/**
+	 * Totals since _uploadStatsStartTime, logged about once per second.
+	 */
+	TextureUploadStats _uploadStatsTotal;
+	uint32 _uploadStatsFrames;
+	uint32 _uploadStatsStartTime;
+
 #ifdef USE_SCALERS
 	/**
 	 * The list of scaler plugins
@@ -39,16 +39,23 @@
 
 namespace OpenGL {
 
+TextureUploadStats GLTexture::_uploadStats;
+
 GLTexture::GLTexture(GLenum glIntFormat, GLenum glFormat, GLenum glType)
 	: _glIntFormat(glIntFormat), _glFormat(glFormat), _glType(glType),
 	  _width(0), _height(0), _logicalWidth(0), _logicalHeight(0),
 	  _texCoords(), _glFilter(GL_NEAREST),
-	  _glTexture(0) {
+	  _glTexture(0), _glPixelBuffer(0) {
 	create();
 }
 
 GLTexture::~GLTexture() {
 	GL_CALL_SAFE(glDeleteTextures, (1, &_glTexture));
+#if !USE_FORCED_GLES && !USE_FORCED_GLES2
+	if (_glPixelBuffer) {
+		GL_CALL_SAFE(glDeleteBuffers, (1, &_glPixelBuffer));
+	}
+#endif
 }
 
 void GLTexture::enableLinearFiltering(bool enable) {
@@ -113,6 +120,13 @@ void GLTexture::setWrapMode(WrapMode wrapMode) {
 void GLTexture::destroy() {
 	GL_CALL(glDeleteTextures(1, &_glTexture));
 	_glTexture = 0;
+
+#if !USE_FORCED_GLES && !USE_FORCED_GLES2
+	if (_glPixelBuffer) {
+		GL_CALL(glDeleteBuffers(1, &_glPixelBuffer));
+		_glPixelBuffer = 0;
+	}
+#endif
 }
 
 void GLTexture::create() {
@@ -217,8 +231,130 @@ void GLTexture::updateArea(const Common::Rect &area, const Graphics::Surface &sr
 	//
 	// 3) Use glTexSubImage2D per line changed. This is what the old OpenGL
 	//    graphics manager did but it is much slower! Thus, we do not use it.
-	GL_CALL(glTexSubImage2D(GL_TEXTURE_2D, 0, 0, area.top, src.w, area.height(),
-	                       _glFormat, _glType, src.getBasePtr(0, area.top)));
+	uploadRows(area.top, area.bottom, src);
+}
+
+void GLTexture::uploadRows(int top, int bottom, const Graphics::Surface &src) {
+	GL_CALL(glTexSubImage2D(GL_TEXTURE_2D, 0, 0, top, src.w, bottom - top,
+	                       _glFormat, _glType, src.getBasePtr(0, top)));
+
+	_uploadStats.uploads++;
+	_uploadStats.bytes += (bottom - top) * src.w * src.format.bytesPerPixel;
+}
+
+void GLTexture::updateAreas(const Common::Array<Common::Rect> &areas, const Graphics::Surface &src) {
+	if (areas.empty()) {
+		return;
+	}
+
+	// Set the texture on the active texture unit.
+	bind();
+
+	const uint bytesPerPixel = src.format.bytesPerPixel;
+
+	if (!OpenGLContext.unpackSubImageSupported || src.pitch % bytesPerPixel != 0) {
+		// Without GL_UNPACK_ROW_LENGTH we are limited to full texture rows,
+		// see updateArea. Upload each run of rows touched by the areas once.
+		Common::Array<Common::Rect> rows(areas);
+		Common::sort(rows.begin(), rows.end(), [](const Common::Rect &a, const Common::Rect &b) {
+			return a.top < b.top;
+		});
+
+		int top = rows[0].top;
+		int bottom = rows[0].bottom;
+		for (uint i = 1; i < rows.size(); ++i) {
+			if (rows[i].top > bottom) {
+				uploadRows(top, bottom, src);
+				top = rows[i].top;
+			}
+			bottom = MAX<int>(bottom, rows[i].bottom);
+		}
+		uploadRows(top, bottom, src);
+		return;
+	}
+
+#if !USE_FORCED_GLES && !USE_FORCED_GLES2
+	if (OpenGLContext.pixelBufferObjectSupported && uploadAreasBuffered(areas, src)) {
+		return;
+	}
+#endif
+
+	GL_CALL(glPixelStorei(GL_UNPACK_ROW_LENGTH, src.pitch / bytesPerPixel));
+	for (Common::Array<Common::Rect>::const_iterator area = areas.begin(); area != areas.end(); ++area) {
+		GL_CALL(glTexSubImage2D(GL_TEXTURE_2D, 0, area->left, area->top, area->width(), area->height(),
+		                        _glFormat, _glType, src.getBasePtr(area->left, area->top)));
+
+		_uploadStats.uploads++;
+		_uploadStats.bytes += area->width() * area->height() * bytesPerPixel;
+	}
+	GL_CALL(glPixelStorei(GL_UNPACK_ROW_LENGTH, 0));
+}
+
+bool GLTexture::uploadAreasBuffered(const Common::Array<Common::Rect> &areas, const Graphics::Surface &src) {
+#if !USE_FORCED_GLES && !USE_FORCED_GLES2
+	const uint bytesPerPixel = src.format.bytesPerPixel;
+
+	uint size = 0;
+	for (Common::Array<Common::Rect>::const_iterator area = areas.begin(); area != areas.end(); ++area) {
+		size += area->width() * area->height() * bytesPerPixel;
+	}
+
+	if (!_glPixelBuffer) {
+		GL_CALL(glGenBuffers(1, &_glPixelBuffer));
+	}
+
+	GL_CALL(glBindBuffer(GL_PIXEL_UNPACK_BUFFER, _glPixelBuffer));
+
+	// Orphan the previous storage, so we do not have to wait until the
+	// driver is done with the uploads of the last frame.
+	GL_CALL(glBufferData(GL_PIXEL_UNPACK_BUFFER, size, nullptr, GL_STREAM_DRAW));
+
+	byte *dst;
+	GL_ASSIGN(dst, (byte *)glMapBuffer(GL_PIXEL_UNPACK_BUFFER, GL_WRITE_ONLY));
+	if (!dst) {
+		GL_CALL(glBindBuffer(GL_PIXEL_UNPACK_BUFFER, 0));
+		return false;
+	}
+
+	// Pack all areas tightly into the buffer
+	for (Common::Array<Common::Rect>::const_iterator area = areas.begin(); area != areas.end(); ++area) {
+		const uint rowSize = area->width() * bytesPerPixel;
+		const byte *row = (const byte *)src.getBasePtr(area->left, area->top);
+
+		for (int y = area->top; y < area->bottom; ++y) {
+			memcpy(dst, row, rowSize);
+			dst += rowSize;
+			row += src.pitch;
+		}
+	}
+
+	GLboolean unmapped;
+	GL_ASSIGN(unmapped, glUnmapBuffer(GL_PIXEL_UNPACK_BUFFER));
+	if (!unmapped) {
+		// The buffer contents got lost, e.g. on a mode switch
+		GL_CALL(glBindBuffer(GL_PIXEL_UNPACK_BUFFER, 0));
+		return false;
+	}
+
+	// With a buffer bound, the data pointer is an offset into it. The copy
+	// into the texture is then done by the driver, possibly asynchronously.
+	uintptr offset = 0;
+	for (Common::Array<Common::Rect>::const_iterator area = areas.begin(); area != areas.end(); ++area) {
+		GL_CALL(glTexSubImage2D(GL_TEXTURE_2D, 0, area->left, area->top, area->width(), area->height(),
+		                        _glFormat, _glType, (const void *)offset));
+
+		offset += area->width() * area->height() * bytesPerPixel;
+	}
+
+	GL_CALL(glBindBuffer(GL_PIXEL_UNPACK_BUFFER, 0));
+
+	_uploadStats.uploads += areas.size();
+	_uploadStats.bytes += size;
+	_uploadStats.bufferedBytes += size;
+	return true;
+#else
+	return false;
+#endif
 }
 
 //
@@ -226,7 +362,7 @@ void GLTexture::updateArea(const Common::Rect &area, const Graphics::Surface &sr
 //
 
 Surface::Surface()
-	: _allDirty(false), _dirtyArea() {
+	: _allDirty(false), _dirtyAreas() {
 }
 
 void Surface::copyRectToTexture(uint x, uint y, uint w, uint h, const void *srcPtr, uint srcPitch) {
@@ -267,22 +403,51 @@ void Surface::fill(const Common::Rect &r, uint32 color) {
 }
 
 void Surface::addDirtyArea(const Common::Rect &r) {
-	// *sigh* Common::Rect::extend behaves unexpected whenever one of the two
-	// parameters is an empty rect. Thus, we check whether the current dirty
-	// area is valid. In case it is not we simply use the parameters as new
-	// dirty area. Otherwise, we simply call extend.
-	if (_dirtyArea.isEmpty()) {
-		_dirtyArea = r;
-	} else {
-		_dirtyArea.extend(r);
+	if (r.isEmpty()) {
+		return;
+	}
+
+	// Merge the new area with any area close enough to it. Every merge may
+	// bring the result close to another area, so start over after each.
+	Common::Rect area = r;
+	for (uint i = 0; i < _dirtyAreas.size();) {
+		const Common::Rect &other = _dirtyAreas[i];
+
+		Common::Rect bounds = area;
+		bounds.extend(other);
+
+		Common::Rect overlap = area.findIntersectingRect(other);
+		const int covered = area.width() * area.height() + other.width() * other.height()
+		                  - (overlap.isEmpty() ? 0 : overlap.width() * overlap.height());
+
+		if (bounds.width() * bounds.height() - covered <= kDirtyAreaMergeSlack) {
+			area = bounds;
+			_dirtyAreas.remove_at(i);
+			i = 0;
+		} else {
+			++i;
+		}
+	}
+
+	_dirtyAreas.push_back(area);
+
+	if (_dirtyAreas.size() > kMaxDirtyAreas) {
+		Common::Rect bounds = _dirtyAreas[0];
+		for (uint i = 1; i < _dirtyAreas.size(); ++i) {
+			bounds.extend(_dirtyAreas[i]);
+		}
+
+		_dirtyAreas.resize(1);
+		_dirtyAreas[0] = bounds;
 	}
 }
 
-Common::Rect Surface::getDirtyArea() const {
+void Surface::getDirtyAreas(Common::Array<Common::Rect> &areas) const {
 	if (_allDirty) {
-		return Common::Rect(getWidth(), getHeight());
+		areas.resize(1);
+		areas[0] = Common::Rect(getWidth(), getHeight());
 	} else {
-		return _dirtyArea;
+		areas = _dirtyAreas;
 	}
 }
 
@@ -343,15 +508,18 @@ void Texture::updateGLTexture() {
 		return;
 	}
 
-	Common::Rect dirtyArea = getDirtyArea();
+	Common::Array<Common::Rect> dirtyAreas;
+	getDirtyAreas(dirtyAreas);
 
-	updateGLTexture(dirtyArea);
+	updateGLTexture(dirtyAreas);
 }
 
-void Texture::updateGLTexture(Common::Rect &dirtyArea) {
+void Texture::updateGLTexture(Common::Array<Common::Rect> &dirtyAreas) {
 	// In case we use linear filtering we might need to duplicate the last
 	// pixel row/column to avoid glitches with filtering.
-	if (_glTexture.isLinearFilteringEnabled()) {
+	for (uint i = 0; i < dirtyAreas.size() && _glTexture.isLinearFilteringEnabled(); ++i) {
+		Common::Rect &dirtyArea = dirtyAreas[i];
+
 		if (dirtyArea.right == _userPixelData.w && _userPixelData.w != _textureData.w) {
 			uint height = dirtyArea.height();
 
@@ -378,7 +546,7 @@ void Texture::updateGLTexture(Common::Rect &dirtyArea) {
 		}
 	}
 
-	_glTexture.updateArea(dirtyArea, _textureData);
+	_glTexture.updateAreas(dirtyAreas, _textureData);
 
 	// We should have handled everything, thus not dirty anymore.
 	clearDirty();
@@ -463,15 +631,18 @@ void FakeTexture::updateGLTexture() {
 	// Convert color space.
 	Graphics::Surface *outSurf = Texture::getSurface();
 
-	const Common::Rect dirtyArea = getDirtyArea();
+	Common::Array<Common::Rect> dirtyAreas;
+	getDirtyAreas(dirtyAreas);
 
-	byte *dst = (byte *)outSurf->getBasePtr(dirtyArea.left, dirtyArea.top);
-	const byte *src = (const byte *)_rgbData.getBasePtr(dirtyArea.left, dirtyArea.top);
+	for (Common::Array<Common::Rect>::const_iterator dirtyArea = dirtyAreas.begin(); dirtyArea != dirtyAreas.end(); ++dirtyArea) {
+		byte *dst = (byte *)outSurf->getBasePtr(dirtyArea->left, dirtyArea->top);
+		const byte *src = (const byte *)_rgbData.getBasePtr(dirtyArea->left, dirtyArea->top);
 
-	applyPaletteAndMask(dst, src, outSurf->pitch, _rgbData.pitch, _rgbData.w, dirtyArea, outSurf->format, _rgbData.format);
+		applyPaletteAndMask(dst, src, outSurf->pitch, _rgbData.pitch, _rgbData.w, *dirtyArea, outSurf->format, _rgbData.format);
+	}
 
 	// Do generic handling of updating the texture.
-	Texture::updateGLTexture();
+	Texture::updateGLTexture(dirtyAreas);
 }
 
 void FakeTexture::applyPaletteAndMask(byte *dst, const byte *src, uint dstPitch, uint srcPitch, uint srcWidth, const Common::Rect &dirtyArea, const Graphics::PixelFormat &dstFormat, const Graphics::PixelFormat &srcFormat) const {
@@ -520,29 +691,32 @@ void TextureRGB555::updateGLTexture() {
 	// Convert color space.
 	Graphics::Surface *outSurf = Texture::getSurface();
 
-	const Common::Rect dirtyArea = getDirtyArea();
+	Common::Array<Common::Rect> dirtyAreas;
+	getDirtyAreas(dirtyAreas);
 
-	uint16 *dst = (uint16 *)outSurf->getBasePtr(dirtyArea.left, dirtyArea.top);
-	const uint dstAdd = outSurf->pitch - 2 * dirtyArea.width();
+	for (Common::Array<Common::Rect>::const_iterator dirtyArea = dirtyAreas.begin(); dirtyArea != dirtyAreas.end(); ++dirtyArea) {
+		uint16 *dst = (uint16 *)outSurf->getBasePtr(dirtyArea->left, dirtyArea->top);
+		const uint dstAdd = outSurf->pitch - 2 * dirtyArea->width();
 
-	const uint16 *src = (const uint16 *)_rgbData.getBasePtr(dirtyArea.left, dirtyArea.top);
-	const uint srcAdd = _rgbData.pitch - 2 * dirtyArea.width();
+		const uint16 *src = (const uint16 *)_rgbData.getBasePtr(dirtyArea->left, dirtyArea->top);
+		const uint srcAdd = _rgbData.pitch - 2 * dirtyArea->width();
 
-	for (int height = dirtyArea.height(); height > 0; --height) {
-		for (int width = dirtyArea.width(); width > 0; --width) {
-			const uint16 color = *src++;
+		for (int height = dirtyArea->height(); height > 0; --height) {
+			for (int width = dirtyArea->width(); width > 0; --width) {
+				const uint16 color = *src++;
 
-			*dst++ =   ((color & 0x7C00) << 1)                             // R
-			         | (((color & 0x03E0) << 1) | ((color & 0x0200) >> 4)) // G
-			         | (color & 0x001F);                                   // B
-		}
+				*dst++ =   ((color & 0x7C00) << 1)                             // R
+				         | (((color & 0x03E0) << 1) | ((color & 0x0200) >> 4)) // G
+				         | (color & 0x001F);                                   // B
+			}
 
-		src = (const uint16 *)((const byte *)src + srcAdd);
-		dst = (uint16 *)((byte *)dst + dstAdd);
+			src = (const uint16 *)((const byte *)src + srcAdd);
+			dst = (uint16 *)((byte *)dst + dstAdd);
+		}
 	}
 
 	// Do generic handling of updating the texture.
-	Texture::updateGLTexture();
+	Texture::updateGLTexture(dirtyAreas);
 }
 
 TextureRGBA8888Swap::TextureRGBA8888Swap()
@@ -562,27 +736,30 @@ void TextureRGBA8888Swap::updateGLTexture() {
 	// Convert color space.
 	Graphics::Surface *outSurf = Texture::getSurface();
 
-	const Common::Rect dirtyArea = getDirtyArea();
+	Common::Array<Common::Rect> dirtyAreas;
+	getDirtyAreas(dirtyAreas);
 
-	uint32 *dst = (uint32 *)outSurf->getBasePtr(dirtyArea.left, dirtyArea.top);
-	const uint dstAdd = outSurf->pitch - 4 * dirtyArea.width();
+	for (Common::Array<Common::Rect>::const_iterator dirtyArea = dirtyAreas.begin(); dirtyArea != dirtyAreas.end(); ++dirtyArea) {
+		uint32 *dst = (uint32 *)outSurf->getBasePtr(dirtyArea->left, dirtyArea->top);
+		const uint dstAdd = outSurf->pitch - 4 * dirtyArea->width();
 
-	const uint32 *src = (const uint32 *)_rgbData.getBasePtr(dirtyArea.left, dirtyArea.top);
-	const uint srcAdd = _rgbData.pitch - 4 * dirtyArea.width();
+		const uint32 *src = (const uint32 *)_rgbData.getBasePtr(dirtyArea->left, dirtyArea->top);
+		const uint srcAdd = _rgbData.pitch - 4 * dirtyArea->width();
 
-	for (int height = dirtyArea.height(); height > 0; --height) {
-		for (int width = dirtyArea.width(); width > 0; --width) {
-			const uint32 color = *src++;
+		for (int height = dirtyArea->height(); height > 0; --height) {
+			for (int width = dirtyArea->width(); width > 0; --width) {
+				const uint32 color = *src++;
 
-			*dst++ = SWAP_BYTES_32(color);
-		}
+				*dst++ = SWAP_BYTES_32(color);
+			}
 
-		src = (const uint32 *)((const byte *)src + srcAdd);
-		dst = (uint32 *)((byte *)dst + dstAdd);
+			src = (const uint32 *)((const byte *)src + srcAdd);
+			dst = (uint32 *)((byte *)dst + dstAdd);
+		}
 	}
 
 	// Do generic handling of updating the texture.
-	Texture::updateGLTexture();
+	Texture::updateGLTexture(dirtyAreas);
 }
 
 #ifdef USE_SCALERS
@@ -629,46 +806,51 @@ void ScaledTexture::updateGLTexture() {
 	// Convert color space.
 	Graphics::Surface *outSurf = Texture::getSurface();
 
-	Common::Rect dirtyArea = getDirtyArea();
+	Common::Array<Common::Rect> dirtyAreas;
+	getDirtyAreas(dirtyAreas);
 
-	// Extend the dirty region for scalers
-	// that "smear" the screen, e.g. 2xSAI
-	dirtyArea.grow(_extraPixels);
-	dirtyArea.clip(Common::Rect(0, 0, _rgbData.w, _rgbData.h));
+	for (Common::Array<Common::Rect>::iterator it = dirtyAreas.begin(); it != dirtyAreas.end(); ++it) {
+		Common::Rect &dirtyArea = *it;
 
-	const byte *src = (const byte *)_rgbData.getBasePtr(dirtyArea.left, dirtyArea.top);
-	uint srcPitch = _rgbData.pitch;
-	byte *dst;
-	uint dstPitch;
+		// Extend the dirty region for scalers
+		// that "smear" the screen, e.g. 2xSAI
+		dirtyArea.grow(_extraPixels);
+		dirtyArea.clip(Common::Rect(0, 0, _rgbData.w, _rgbData.h));
 
-	if (_convData) {
-		dst = (byte *)_convData->getBasePtr(dirtyArea.left + _extraPixels, dirtyArea.top + _extraPixels);
-		dstPitch = _convData->pitch;
+		const byte *src = (const byte *)_rgbData.getBasePtr(dirtyArea.left, dirtyArea.top);
+		uint srcPitch = _rgbData.pitch;
+		byte *dst;
+		uint dstPitch;
 
-		applyPaletteAndMask(dst, src, dstPitch, srcPitch, _rgbData.w, dirtyArea, _convData->format, _rgbData.format);
+		if (_convData) {
+			dst = (byte *)_convData->getBasePtr(dirtyArea.left + _extraPixels, dirtyArea.top + _extraPixels);
+			dstPitch = _convData->pitch;
 
-		src = dst;
-		srcPitch = dstPitch;
-	}
+			applyPaletteAndMask(dst, src, dstPitch, srcPitch, _rgbData.w, dirtyArea, _convData->format, _rgbData.format);
 
-	dst = (byte *)outSurf->getBasePtr(dirtyArea.left * _scaleFactor, dirtyArea.top * _scaleFactor);
-	dstPitch = outSurf->pitch;
+			src = dst;
+			srcPitch = dstPitch;
+		}
 
-	if (_scaler && (uint)dirtyArea.height() >= _extraPixels) {
-		_scaler->scale(src, srcPitch, dst, dstPitch, dirtyArea.width(), dirtyArea.height(), dirtyArea.left, dirtyArea.top);
-	} else {
-		Graphics::scaleBlit(dst, src, dstPitch, srcPitch,
-		                    dirtyArea.width() * _scaleFactor, dirtyArea.height() * _scaleFactor,
-		                    dirtyArea.width(), dirtyArea.height(), outSurf->format);
-	}
+		dst = (byte *)outSurf->getBasePtr(dirtyArea.left * _scaleFactor, dirtyArea.top * _scaleFactor);
+		dstPitch = outSurf->pitch;
 
-	dirtyArea.left   *= _scaleFactor;
-	dirtyArea.right  *= _scaleFactor;
-	dirtyArea.top    *= _scaleFactor;
-	dirtyArea.bottom *= _scaleFactor;
+		if (_scaler && (uint)dirtyArea.height() >= _extraPixels) {
+			_scaler->scale(src, srcPitch, dst, dstPitch, dirtyArea.width(), dirtyArea.height(), dirtyArea.left, dirtyArea.top);
+		} else {
+			Graphics::scaleBlit(dst, src, dstPitch, srcPitch,
+			                    dirtyArea.width() * _scaleFactor, dirtyArea.height() * _scaleFactor,
+			                    dirtyArea.width(), dirtyArea.height(), outSurf->format);
+		}
+
+		dirtyArea.left   *= _scaleFactor;
+		dirtyArea.right  *= _scaleFactor;
+		dirtyArea.top    *= _scaleFactor;
+		dirtyArea.bottom *= _scaleFactor;
+	}
 
 	// Do generic handling of updating the texture.
-	Texture::updateGLTexture(dirtyArea);
+	Texture::updateGLTexture(dirtyAreas);
 }
 
 void ScaledTexture::setScaler(uint scalerIndex, int scaleFactor) {
@@ -828,7 +1010,10 @@ void TextureCLUT8GPU::updateGLTexture() {
 
 	// Update CLUT8 texture if necessary.
 	if (Surface::isDirty()) {
-		_clut8Texture.updateArea(getDirtyArea(), _clut8Data);
+		Common::Array<Common::Rect> dirtyAreas;
+		getDirtyAreas(dirtyAreas);
+
+		_clut8Texture.updateAreas(dirtyAreas, _clut8Data);
 		clearDirty();
 	}
 
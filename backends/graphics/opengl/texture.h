@@ -28,6 +28,7 @@
 #include "graphics/pixelformat.h"
 #include "graphics/surface.h"
 
+#include "common/array.h"
 #include "common/rect.h"
 
 class Scaler;
@@ -41,6 +42,20 @@ enum WrapMode {
 	kWrapModeMirroredRepeat
 };
 
+/**
+ * Texture upload statistics, accumulated over all textures.
+ */
+struct TextureUploadStats {
+	/** The number of glTexSubImage2D calls. */
+	uint32 uploads;
+	/** The number of pixel bytes uploaded. */
+	uint32 bytes;
+	/** The part of bytes which was staged in a pixel buffer object. */
+	uint32 bufferedBytes;
+
+	TextureUploadStats() : uploads(0), bytes(0), bufferedBytes(0) {}
+};
+
 /**
  * A simple GL texture object abstraction.
  *
@@ -114,6 +129,19 @@ public:
 	 */
 	void updateArea(const Common::Rect &area, const Graphics::Surface &src);
 
+	/**
+	 * Copy image data of several areas to the texture.
+	 *
+	 * When the context allows specifying a pitch, only the areas themselves
+	 * are uploaded, staged in a pixel buffer object if those are supported.
+	 * Otherwise, the full texture rows covered by the areas are uploaded.
+	 *
+	 * @param areas    The areas to update.
+	 * @param src      Surface for the whole texture containing the pixel data
+	 *                 to upload.
+	 */
+	void updateAreas(const Common::Array<Common::Rect> &areas, const Graphics::Surface &src);
+
 	/**
 	 * Query the GL texture's width.
 	 */
@@ -146,7 +174,20 @@ public:
 	 * destroy will invalidate the texture name.
 	 */
 	GLuint getGLTexture() const { return _glTexture; }
+
+	/**
+	 * Query the upload statistics since the last reset.
+	 */
+	static const TextureUploadStats &getUploadStats() { return _uploadStats; }
+
+	/**
+	 * Reset the upload statistics.
+	 */
+	static void resetUploadStats() { _uploadStats = TextureUploadStats(); }
 private:
+	void uploadRows(int top, int bottom, const Graphics::Surface &src);
+	bool uploadAreasBuffered(const Common::Array<Common::Rect> &areas, const Graphics::Surface &src);
+
 	const GLenum _glIntFormat;
 	const GLenum _glFormat;
 	const GLenum _glType;
@@ -158,6 +199,9 @@ private:
 	GLint _glFilter;
 
 	GLuint _glTexture;
+	GLuint _glPixelBuffer;
+
+	static TextureUploadStats _uploadStats;
 };
 
 /**
@@ -224,7 +268,7 @@ public:
 	void fill(const Common::Rect &r, uint32 color);
 
 	void flagDirty() { _allDirty = true; }
-	virtual bool isDirty() const { return _allDirty || !_dirtyArea.isEmpty(); }
+	virtual bool isDirty() const { return _allDirty || !_dirtyAreas.empty(); }
 
 	virtual uint getWidth() const = 0;
 	virtual uint getHeight() const = 0;
@@ -264,13 +308,25 @@ public:
 	 */
 	virtual const GLTexture &getGLTexture() const = 0;
 protected:
-	void clearDirty() { _allDirty = false; _dirtyArea = Common::Rect(); }
+	void clearDirty() { _allDirty = false; _dirtyAreas.clear(); }
 
 	void addDirtyArea(const Common::Rect &r);
-	Common::Rect getDirtyArea() const;
+	void getDirtyAreas(Common::Array<Common::Rect> &areas) const;
 private:
+	enum {
+		/**
+		 * Two dirty areas are merged when their bounding box covers at
+		 * most this many pixels outside of them. This is roughly what
+		 * an extra upload call costs.
+		 */
+		kDirtyAreaMergeSlack = 64 * 64,
+
+		/** Above this count all dirty areas are merged into one. */
+		kMaxDirtyAreas = 16
+	};
+
 	bool _allDirty;
-	Common::Rect _dirtyArea;
+	Common::Array<Common::Rect> _dirtyAreas;
 };
 
 /**
@@ -314,7 +370,7 @@ public:
 protected:
 	const Graphics::PixelFormat _format;
 
-	void updateGLTexture(Common::Rect &dirtyArea);
+	void updateGLTexture(Common::Array<Common::Rect> &dirtyAreas);
 
 private:
 	GLTexture _glTexture;
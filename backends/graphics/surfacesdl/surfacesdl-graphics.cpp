@@ -34,6 +34,7 @@
 #ifdef USE_RGB_COLOR
 #include "common/list.h"
 #endif
+#include "common/threadpool.h"
 #include "graphics/blit.h"
 #include "graphics/font.h"
 #include "graphics/fontman.h"
@@ -136,6 +137,7 @@ SurfaceSdlGraphicsManager::SurfaceSdlGraphicsManager(SdlEventSource *sdlEventSou
 #endif
 	_transactionMode(kTransactionNone),
 	_scalerPlugins(ScalerMan.getPlugins()), _scalerPlugin(nullptr), _scaler(nullptr),
+	_scalerPool(nullptr),
 	_needRestoreAfterOverlay(false), _isInOverlayPalette(false), _isDoubleBuf(false), _prevForceRedraw(false), _numPrevDirtyRects(0),
 	_prevCursorNeedsRedraw(false),
 	_mouseKeyColor(0) {
@@ -186,6 +188,8 @@ SurfaceSdlGraphicsManager::SurfaceSdlGraphicsManager(SdlEventSource *sdlEventSou
 
 SurfaceSdlGraphicsManager::~SurfaceSdlGraphicsManager() {
 	unloadGFXMode();
+	deleteBandScalers();
+	delete _scalerPool;
 	delete _scaler;
 	delete _mouseScaler;
 	if (_mouseOrigSurface) {
@@ -683,6 +687,7 @@ void SurfaceSdlGraphicsManager::setGraphicsModeIntern() {
 
 		_scalerPlugin = &_scalerPlugins[_videoMode.scalerIndex]->get<ScalerPluginObject>();
 		_scaler = _scalerPlugin->createInstance(format);
+		createBandScalers(format);
 
 		if (_mouseScaler != nullptr) {
 			delete _mouseScaler;
@@ -1404,7 +1409,7 @@ void SurfaceSdlGraphicsManager::internUpdateScreen() {
 				if (_videoMode.aspectRatioCorrection && !_overlayInGUI)
 					dst_y = real2Aspect(dst_y);
 
-				_scaler->scale((byte *)srcSurf->pixels + (src_x + _maxExtraPixels) * bpp + (src_y + _maxExtraPixels) * srcPitch, srcPitch,
+				scaleRect((byte *)srcSurf->pixels + (src_x + _maxExtraPixels) * bpp + (src_y + _maxExtraPixels) * srcPitch, srcPitch,
 						(byte *)_hwScreen->pixels + dst_x * bpp + dst_y * dstPitch, dstPitch, dst_w, dst_h, src_x, src_y);
 
 				r->x = dst_x;
@@ -1938,7 +1943,7 @@ void SurfaceSdlGraphicsManager::clearOverlay() {
 		}
 	}
 
-	_scaler->scale((byte *)(_tmpscreen->pixels) + _maxExtraPixels * _tmpscreen->pitch + _maxExtraPixels * _tmpscreen->format->BytesPerPixel, _tmpscreen->pitch,
+	scaleRect((byte *)(_tmpscreen->pixels) + _maxExtraPixels * _tmpscreen->pitch + _maxExtraPixels * _tmpscreen->format->BytesPerPixel, _tmpscreen->pitch,
 	(byte *)_overlayscreen->pixels, _overlayscreen->pitch, _videoMode.screenWidth, _videoMode.screenHeight, 0, 0);
 
 #ifdef USE_ASPECT
@@ -2638,6 +2643,36 @@ void SurfaceSdlGraphicsManager::handleResizeImpl(const int width, const int heig
 	recalculateDisplayAreas();
 }
 
+void SurfaceSdlGraphicsManager::createBandScalers(const Graphics::PixelFormat &format) {
+	deleteBandScalers();
+
+	if (!_scalerPool)
+		_scalerPool = new Common::ThreadPool();
+
+	// The thread waiting for the bands scales one of them as well
+	if (_scalerPool->getWorkerCount() == 0)
+		return;
+
+	const uint numBands = _scalerPool->getWorkerCount() + 1;
+	for (uint i = 0; i < numBands; ++i)
+		_bandScalers.push_back(_scalerPlugin->createInstance(format));
+}
+
+void SurfaceSdlGraphicsManager::deleteBandScalers() {
+	for (uint i = 0; i < _bandScalers.size(); ++i)
+		delete _bandScalers[i];
+	_bandScalers.clear();
+}
+
+void SurfaceSdlGraphicsManager::scaleRect(const byte *srcPtr, uint32 srcPitch, byte *dstPtr, uint32 dstPitch,
+                                          int width, int height, int x, int y) {
+	if (_bandScalers.empty())
+		_scaler->scale(srcPtr, srcPitch, dstPtr, dstPitch, width, height, x, y);
+	else
+		_scaler->scaleBands(*_scalerPool, _bandScalers.begin(), _bandScalers.size(),
+		                    srcPtr, srcPitch, dstPtr, dstPitch, width, height, x, y);
+}
+
 void SurfaceSdlGraphicsManager::handleScalerHotkeys(uint mode, int factor) {
 #if SDL_VERSION_ATLEAST(2, 0, 0)
 	bool sizeChanged = _videoMode.scaleFactor != factor;
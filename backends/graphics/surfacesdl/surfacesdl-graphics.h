@@ -27,6 +27,7 @@
 #include "graphics/pixelformat.h"
 #include "graphics/scaler.h"
 #include "graphics/scalerplugin.h"
+#include "common/array.h"
 #include "common/events.h"
 #include "common/mutex.h"
 
@@ -336,6 +337,13 @@ protected:
 	uint _maxExtraPixels;
 	uint _extraPixels;
 
+	/**
+	 * Large rects are split into bands scaled on these threads, each band
+	 * with its own scaler instance.
+	 */
+	Common::ThreadPool *_scalerPool;
+	Common::Array<Scaler *> _bandScalers;
+
 	bool _screenIsLocked;
 	Graphics::Surface _framebuffer;
 
@@ -442,6 +450,13 @@ private:
 	void setFullscreenMode(bool enable);
 	void handleScalerHotkeys(uint mode, int factor);
 
+	void createBandScalers(const Graphics::PixelFormat &format);
+	void deleteBandScalers();
+
+	/** Scale a rect with _scaler, in parallel if worker threads are available. */
+	void scaleRect(const byte *srcPtr, uint32 srcPitch, byte *dstPtr, uint32 dstPitch,
+	               int width, int height, int x, int y);
+
 	/**
 	 * Converts the given point from the overlay's coordinate space to the
 	 * game's coordinate space.
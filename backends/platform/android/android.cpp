@@ -69,6 +69,7 @@
 #include "backends/audiocd/default/default-audiocd.h"
 #include "backends/events/default/default-events.h"
 #include "backends/mutex/pthread/pthread-mutex.h"
+#include "backends/threads/pthread/pthread-threads.h"
 #include "backends/saves/default/default-saves.h"
 #include "backends/timer/default/default-timer.h"
 
@@ -830,6 +831,18 @@ Common::MutexInternal *OSystem_Android::createMutex() {
 	return createPthreadMutexInternal();
 }
 
+Common::ThreadInternal *OSystem_Android::createThread(Common::ThreadProc proc, void *data) {
+	return createPthreadThreadInternal(proc, data);
+}
+
+Common::SemaphoreInternal *OSystem_Android::createSemaphore() {
+	return createPthreadSemaphoreInternal();
+}
+
+uint OSystem_Android::getCPUCount() {
+	return getPthreadCPUCount();
+}
+
 void OSystem_Android::quit() {
 	ENTER();
 
@@ -245,6 +245,9 @@ public:
 	uint32 getMillis(bool skipRecord = false) override;
 	void delayMillis(uint msecs) override;
 	Common::MutexInternal *createMutex() override;
+	Common::ThreadInternal *createThread(Common::ThreadProc proc, void *data) override;
+	Common::SemaphoreInternal *createSemaphore() override;
+	uint getCPUCount() override;
 
 	void quit() override;
 
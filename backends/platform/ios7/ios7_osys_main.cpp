@@ -52,6 +52,7 @@
 #include "backends/saves/default/default-saves.h"
 #include "backends/timer/default/default-timer.h"
 #include "backends/mutex/pthread/pthread-mutex.h"
+#include "backends/threads/pthread/pthread-threads.h"
 #include "backends/fs/chroot/chroot-fs-factory.h"
 #include "backends/fs/posix/posix-fs.h"
 #include "audio/mixer.h"
@@ -393,6 +394,18 @@ Common::MutexInternal *OSystem_iOS7::createMutex() {
 	return createPthreadMutexInternal();
 }
 
+Common::ThreadInternal *OSystem_iOS7::createThread(Common::ThreadProc proc, void *data) {
+	return createPthreadThreadInternal(proc, data);
+}
+
+Common::SemaphoreInternal *OSystem_iOS7::createSemaphore() {
+	return createPthreadSemaphoreInternal();
+}
+
+uint OSystem_iOS7::getCPUCount() {
+	return getPthreadCPUCount();
+}
+
 void OSystem_iOS7::quit() {
 }
 
@@ -49,6 +49,10 @@ typedef void (*sighandler_t)(int);
 #if defined(USE_NULL_DRIVER)
 #include "backends/modular-backend.h"
 #include "backends/mutex/null/null-mutex.h"
+#if defined(POSIX) && defined(NULL_DRIVER_USE_FOR_TEST)
+#include "backends/mutex/pthread/pthread-mutex.h"
+#include "backends/threads/pthread/pthread-threads.h"
+#endif
 #include "base/main.h"
 
 #ifndef NULL_DRIVER_USE_FOR_TEST
@@ -77,7 +81,7 @@ typedef void (*sighandler_t)(int);
 
 class OSystem_NULL : public ModularMixerBackend, public ModularGraphicsBackend, Common::EventSource {
 public:
-	OSystem_NULL(bool silenceLogs);
+	OSystem_NULL(bool silenceLogs, bool threads = false);
 	virtual ~OSystem_NULL();
 
 	virtual void initBackend();
@@ -85,6 +89,11 @@ public:
 	virtual bool pollEvent(Common::Event &event);
 
 	virtual Common::MutexInternal *createMutex();
+#if defined(POSIX) && defined(NULL_DRIVER_USE_FOR_TEST)
+	virtual Common::ThreadInternal *createThread(Common::ThreadProc proc, void *data);
+	virtual Common::SemaphoreInternal *createSemaphore();
+	virtual uint getCPUCount();
+#endif
 	virtual uint32 getMillis(bool skipRecord = false);
 	virtual void delayMillis(uint msecs);
 	virtual void getTimeAndDate(TimeDate &td, bool skipRecord = false) const;
@@ -102,10 +111,11 @@ private:
 	DWORD _startTime;
 #endif
 	bool _silenceLogs;
+	bool _threads;
 };
 
-OSystem_NULL::OSystem_NULL(bool silenceLogs) :
-	_silenceLogs(silenceLogs) {
+OSystem_NULL::OSystem_NULL(bool silenceLogs, bool threads) :
+	_silenceLogs(silenceLogs), _threads(threads) {
 	#if defined(__amigaos4__)
 		_fsFactory = new AmigaOSFilesystemFactory();
 	#elif defined(__MORPHOS__)
@@ -187,9 +197,28 @@ bool OSystem_NULL::pollEvent(Common::Event &event) {
 }
 
 Common::MutexInternal *OSystem_NULL::createMutex() {
+#if defined(POSIX) && defined(NULL_DRIVER_USE_FOR_TEST)
+	if (_threads)
+		return createPthreadMutexInternal();
+#endif
 	return new NullMutexInternal();
 }
 
+#if defined(POSIX) && defined(NULL_DRIVER_USE_FOR_TEST)
+Common::ThreadInternal *OSystem_NULL::createThread(Common::ThreadProc proc, void *data) {
+	return _threads ? createPthreadThreadInternal(proc, data) : nullptr;
+}
+
+Common::SemaphoreInternal *OSystem_NULL::createSemaphore() {
+	return _threads ? createPthreadSemaphoreInternal() : nullptr;
+}
+
+uint OSystem_NULL::getCPUCount() {
+	// At least two, so thread pools always have a worker to test with
+	return _threads ? MAX<uint>(getPthreadCPUCount(), 2) : 1;
+}
+#endif
+
 uint32 OSystem_NULL::getMillis(bool skipRecord) {
 #ifdef POSIX
 	timeval curTime;
@@ -249,8 +278,8 @@ void OSystem_NULL::addSysArchivesToSearchSet(Common::SearchSet &s, int priority)
 	s.add("gui/themes", new Common::FSDirectory("gui/themes", 4), priority);
 }
 
-OSystem *OSystem_NULL_create(bool silenceLogs) {
-	return new OSystem_NULL(silenceLogs);
+OSystem *OSystem_NULL_create(bool silenceLogs, bool threads = false) {
+	return new OSystem_NULL(silenceLogs, threads);
 }
 
 #ifndef NULL_DRIVER_USE_FOR_TEST
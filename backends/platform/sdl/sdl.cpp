@@ -46,6 +46,7 @@
 #include "backends/events/sdl/legacy-sdl-events.h"
 #include "backends/keymapper/hardware-input.h"
 #include "backends/mutex/sdl/sdl-mutex.h"
+#include "backends/threads/sdl/sdl-threads.h"
 #include "backends/timer/sdl/sdl-timer.h"
 #include "backends/graphics/surfacesdl/surfacesdl-graphics.h"
 #ifdef USE_OPENGL
@@ -724,6 +725,18 @@ Common::MutexInternal *OSystem_SDL::createMutex() {
 	return createSdlMutexInternal();
 }
 
+Common::ThreadInternal *OSystem_SDL::createThread(Common::ThreadProc proc, void *data) {
+	return createSdlThreadInternal(proc, data);
+}
+
+Common::SemaphoreInternal *OSystem_SDL::createSemaphore() {
+	return createSdlSemaphoreInternal();
+}
+
+uint OSystem_SDL::getCPUCount() {
+	return getSdlCPUCount();
+}
+
 uint32 OSystem_SDL::getMillis(bool skipRecord) {
 	uint32 millis = SDL_GetTicks();
 
@@ -83,6 +83,9 @@ public:
 	void setWindowCaption(const Common::U32String &caption) override;
 	void addSysArchivesToSearchSet(Common::SearchSet &s, int priority = 0) override;
 	Common::MutexInternal *createMutex() override;
+	Common::ThreadInternal *createThread(Common::ThreadProc proc, void *data) override;
+	Common::SemaphoreInternal *createSemaphore() override;
+	uint getCPUCount() override;
 	uint32 getMillis(bool skipRecord = false) override;
 	void delayMillis(uint msecs) override;
 	void getTimeAndDate(TimeDate &td, bool skipRecord = false) const override;
@@ -0,0 +1,136 @@
+/* ScummVM - Graphic Adventure Engine
+ *
+ * ScummVM is the legal property of its developers, whose names
+ * are too numerous to list here. Please refer to the COPYRIGHT
+ * file distributed with this source distribution.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#define FORBIDDEN_SYMBOL_EXCEPTION_time_h
+#define FORBIDDEN_SYMBOL_EXCEPTION_unistd_h
+
+#include "common/scummsys.h"
+
+#if defined(__ANDROID__) || defined(IPHONE) || defined(NULL_DRIVER_USE_FOR_TEST)
+
+#include "backends/threads/pthread/pthread-threads.h"
+#include "common/textconsole.h"
+
+#ifdef __ANDROID__
+#include "backends/platform/android/jni-android.h"
+#endif
+
+#include <pthread.h>
+#include <unistd.h>
+
+/**
+ * pthreads thread implementation
+ */
+class PthreadThreadInternal final : public Common::ThreadInternal {
+public:
+	PthreadThreadInternal(Common::ThreadProc proc, void *data) : _proc(proc), _data(data), _started(false) {}
+	~PthreadThreadInternal() override {}
+
+	bool start() {
+		_started = (pthread_create(&_thread, nullptr, threadProc, this) == 0);
+		if (!_started)
+			warning("pthread_create() failed");
+		return _started;
+	}
+
+	bool join() override {
+		if (!_started)
+			return false;
+		_started = false;
+		return pthread_join(_thread, nullptr) == 0;
+	}
+
+private:
+	static void *threadProc(void *arg) {
+		PthreadThreadInternal *thread = (PthreadThreadInternal *)arg;
+#ifdef __ANDROID__
+		// Jobs may access files, which goes through JNI with SAF storage
+		JNI::attachThread();
+#endif
+		thread->_proc(thread->_data);
+#ifdef __ANDROID__
+		JNI::detachThread();
+#endif
+		return nullptr;
+	}
+
+	pthread_t _thread;
+	Common::ThreadProc _proc;
+	void *_data;
+	bool _started;
+};
+
+/**
+ * Counting semaphore based on a condition variable, as unnamed POSIX
+ * semaphores are not available everywhere.
+ */
+class PthreadSemaphoreInternal final : public Common::SemaphoreInternal {
+public:
+	PthreadSemaphoreInternal() : _count(0) {
+		pthread_mutex_init(&_mutex, nullptr);
+		pthread_cond_init(&_cond, nullptr);
+	}
+
+	~PthreadSemaphoreInternal() override {
+		pthread_cond_destroy(&_cond);
+		pthread_mutex_destroy(&_mutex);
+	}
+
+	void post() override {
+		pthread_mutex_lock(&_mutex);
+		_count++;
+		pthread_cond_signal(&_cond);
+		pthread_mutex_unlock(&_mutex);
+	}
+
+	void wait() override {
+		pthread_mutex_lock(&_mutex);
+		while (_count == 0)
+			pthread_cond_wait(&_cond, &_mutex);
+		_count--;
+		pthread_mutex_unlock(&_mutex);
+	}
+
+private:
+	pthread_mutex_t _mutex;
+	pthread_cond_t _cond;
+	uint _count;
+};
+
+Common::ThreadInternal *createPthreadThreadInternal(Common::ThreadProc proc, void *data) {
+	PthreadThreadInternal *thread = new PthreadThreadInternal(proc, data);
+	if (!thread->start()) {
+		delete thread;
+		return nullptr;
+	}
+	return thread;
+}
+
+Common::SemaphoreInternal *createPthreadSemaphoreInternal() {
+	return new PthreadSemaphoreInternal();
+}
+
+uint getPthreadCPUCount() {
+	long count = sysconf(_SC_NPROCESSORS_ONLN);
+	return count > 1 ? (uint)count : 1;
+}
+
+#endif
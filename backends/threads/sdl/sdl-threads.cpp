@@ -0,0 +1,106 @@
+/* ScummVM - Graphic Adventure Engine
+ *
+ * ScummVM is the legal property of its developers, whose names
+ * are too numerous to list here. Please refer to the COPYRIGHT
+ * file distributed with this source distribution.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include "common/scummsys.h"
+
+#if defined(SDL_BACKEND)
+
+#include "backends/threads/sdl/sdl-threads.h"
+#include "backends/platform/sdl/sdl-sys.h"
+#include "common/textconsole.h"
+
+/**
+ * SDL thread
+ */
+class SdlThreadInternal final : public Common::ThreadInternal {
+public:
+	SdlThreadInternal(Common::ThreadProc proc, void *data) : _thread(nullptr), _proc(proc), _data(data) {}
+	~SdlThreadInternal() override {}
+
+	bool start() {
+#if SDL_VERSION_ATLEAST(2, 0, 0)
+		_thread = SDL_CreateThread(threadProc, "ScummVM worker", this);
+#else
+		_thread = SDL_CreateThread(threadProc, this);
+#endif
+		if (!_thread)
+			warning("SDL_CreateThread() failed: %s", SDL_GetError());
+		return _thread != nullptr;
+	}
+
+	bool join() override {
+		if (!_thread)
+			return false;
+		SDL_WaitThread(_thread, nullptr);
+		_thread = nullptr;
+		return true;
+	}
+
+private:
+	static int SDLCALL threadProc(void *arg) {
+		SdlThreadInternal *thread = (SdlThreadInternal *)arg;
+		thread->_proc(thread->_data);
+		return 0;
+	}
+
+	SDL_Thread *_thread;
+	Common::ThreadProc _proc;
+	void *_data;
+};
+
+/**
+ * SDL semaphore
+ */
+class SdlSemaphoreInternal final : public Common::SemaphoreInternal {
+public:
+	SdlSemaphoreInternal() { _semaphore = SDL_CreateSemaphore(0); }
+	~SdlSemaphoreInternal() override { SDL_DestroySemaphore(_semaphore); }
+
+	void post() override { SDL_SemPost(_semaphore); }
+	void wait() override { SDL_SemWait(_semaphore); }
+
+private:
+	SDL_sem *_semaphore;
+};
+
+Common::ThreadInternal *createSdlThreadInternal(Common::ThreadProc proc, void *data) {
+	SdlThreadInternal *thread = new SdlThreadInternal(proc, data);
+	if (!thread->start()) {
+		delete thread;
+		return nullptr;
+	}
+	return thread;
+}
+
+Common::SemaphoreInternal *createSdlSemaphoreInternal() {
+	return new SdlSemaphoreInternal();
+}
+
+uint getSdlCPUCount() {
+#if SDL_VERSION_ATLEAST(2, 0, 0)
+	int count = SDL_GetCPUCount();
+	return count > 1 ? (uint)count : 1;
+#else
+	return 1;
+#endif
+}
+
+#endif
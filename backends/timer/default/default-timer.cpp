@@ -23,6 +23,15 @@
 #include "backends/timer/default/default-timer.h"
 #include "common/util.h"
 #include "common/system.h"
+#include "common/debug.h"
+
+enum {
+	kSlotIdle,
+	kSlotFiring,
+	kSlotRemoved
+};
+
+static const uint kNotQueued = 0xFFFFFFFF;
 
 struct TimerSlot {
 	Common::TimerManager::TimerProc callback;
@@ -30,88 +39,216 @@ struct TimerSlot {
 	Common::String id;
 	uint32 interval;	// in microseconds
 
-	uint32 nextFireTime;	// in milliseconds
-	uint32 nextFireTimeMicro;	// microseconds part of nextFire
+	// Set by removeTimerProc(), so the handler stops firing the timer
+	// before the removal request is processed
+	Common::Atomic<uint32> state;
+
+	uint64 nextFireTime;	// in microseconds
+	uint32 sequence;	// orders timers with the same fire time
+	uint heapIndex;
 
-	TimerSlot *next;
+	uint32 fireCount;
+	uint64 totalLateness;	// in microseconds
+	uint32 maxLateness;	// in microseconds
 
-	TimerSlot() : callback(nullptr), refCon(nullptr), interval(0), nextFireTime(0), nextFireTimeMicro(0), next(nullptr) {}
+	TimerSlot() : callback(nullptr), refCon(nullptr), interval(0), state(kSlotIdle), nextFireTime(0), sequence(0),
+		heapIndex(kNotQueued), fireCount(0), totalLateness(0), maxLateness(0) {}
 };
 
-void insertPrioQueue(TimerSlot *head, TimerSlot *newSlot) {
-	// The head points to a fake anchor TimerSlot; this common
-	// trick allows us to get rid of many special cases.
 
-	const uint32 nextFireTime = newSlot->nextFireTime;
-	TimerSlot *slot = head;
-	newSlot->next = nullptr;
+DefaultTimerManager::DefaultTimerManager() :
+	_consumerBusy(0),
+	_clock(0),
+	_clockMillis(0),
+	_sequence(0),
+	_timerCallbackNext(0) {
+}
 
-	// Insert the new slot into the sorted list of already scheduled
-	// timers in such a way that the list stays sorted...
-	while (true) {
-		assert(slot);
-		if (slot->next == nullptr || nextFireTime < slot->next->nextFireTime) {
-			newSlot->next = slot->next;
-			slot->next = newSlot;
-			return;
+DefaultTimerManager::~DefaultTimerManager() {
+	lockConsumer();
+	processRequests();
+
+	for (uint i = 0; i < _queue.size(); ++i)
+		delete _queue[i];
+	_queue.clear();
+	unlockConsumer();
+}
+
+uint32 DefaultTimerManager::getMillis() const {
+	return g_system->getMillis(true);
+}
+
+uint64 DefaultTimerManager::updateClock() {
+	// Extends the millisecond counter to 64 bits, so fire times survive
+	// its wrap around.
+	const uint32 millis = getMillis();
+	_clock += (uint64)(uint32)(millis - _clockMillis) * 1000;
+	_clockMillis = millis;
+	return _clock;
+}
+
+bool DefaultTimerManager::tryLockConsumer() {
+	uint32 expected = 0;
+	return _consumerBusy.compareExchange(expected, 1);
+}
+
+void DefaultTimerManager::lockConsumer() {
+	while (!tryLockConsumer())
+		g_system->delayMillis(1);
+}
+
+void DefaultTimerManager::unlockConsumer() {
+	_consumerBusy.store(0);
+}
+
+void DefaultTimerManager::pushRequest(bool install, TimerSlot *slot) {
+	TimerRequest request;
+	request.install = install;
+	request.slot = slot;
+
+	// Producers hold _mutex, so they push one at a time. If the queue is
+	// full, process it here when no handler runs, else wait for the
+	// handler to catch up. The handler processes the queue before each
+	// callback, so this only hangs if more requests than the queue holds
+	// are made while a single callback runs.
+	while (!_requests.push(request)) {
+		if (tryLockConsumer()) {
+			processRequests();
+			unlockConsumer();
+		} else {
+			g_system->delayMillis(1);
 		}
-		slot = slot->next;
 	}
 }
 
+void DefaultTimerManager::processRequests() {
+	TimerRequest request;
+	while (_requests.pop(request)) {
+		TimerSlot *slot = request.slot;
+		if (request.install) {
+			slot->nextFireTime = updateClock() + slot->interval;
+			pushSlot(slot);
+		} else {
+			if (slot->heapIndex != kNotQueued)
+				removeSlot(slot->heapIndex);
+			logStats(slot);
+			delete slot;
+		}
+	}
+}
 
-DefaultTimerManager::DefaultTimerManager() :
-	_timerCallbackNext(0),
-	_head(nullptr) {
-
-	_head = new TimerSlot();
+bool DefaultTimerManager::isBefore(const TimerSlot *a, const TimerSlot *b) const {
+	if (a->nextFireTime != b->nextFireTime)
+		return a->nextFireTime < b->nextFireTime;
+	return (int32)(a->sequence - b->sequence) < 0;
 }
 
-DefaultTimerManager::~DefaultTimerManager() {
-	Common::StackLock lock(_mutex);
+void DefaultTimerManager::siftUp(uint index) {
+	TimerSlot *slot = _queue[index];
+	while (index > 0) {
+		const uint parent = (index - 1) / 2;
+		if (!isBefore(slot, _queue[parent]))
+			break;
+		_queue[index] = _queue[parent];
+		_queue[index]->heapIndex = index;
+		index = parent;
+	}
+	_queue[index] = slot;
+	slot->heapIndex = index;
+}
 
-	TimerSlot *slot = _head;
-	while (slot) {
-		TimerSlot *next = slot->next;
-		delete slot;
-		slot = next;
+void DefaultTimerManager::siftDown(uint index) {
+	TimerSlot *slot = _queue[index];
+	const uint size = _queue.size();
+	while (true) {
+		uint child = index * 2 + 1;
+		if (child >= size)
+			break;
+		if (child + 1 < size && isBefore(_queue[child + 1], _queue[child]))
+			child++;
+		if (!isBefore(_queue[child], slot))
+			break;
+		_queue[index] = _queue[child];
+		_queue[index]->heapIndex = index;
+		index = child;
 	}
-	_head = nullptr;
+	_queue[index] = slot;
+	slot->heapIndex = index;
 }
 
-void DefaultTimerManager::handler() {
-	Common::StackLock lock(_mutex);
+void DefaultTimerManager::pushSlot(TimerSlot *slot) {
+	// Timers with the same fire time keep firing in the order they were
+	// scheduled in.
+	slot->sequence = _sequence++;
+	_queue.push_back(slot);
+	siftUp(_queue.size() - 1);
+}
+
+void DefaultTimerManager::removeSlot(uint index) {
+	_queue[index]->heapIndex = kNotQueued;
+
+	TimerSlot *last = _queue.back();
+	_queue.pop_back();
+	if (index == _queue.size())
+		return;
 
-	uint32 curTime = g_system->getMillis(true);
+	_queue[index] = last;
+	last->heapIndex = index;
+	siftDown(index);
+	siftUp(last->heapIndex);
+}
 
-	// On slow systems this could still be run after destructor
-	if (!_head)
+void DefaultTimerManager::handler() {
+	// A thread installing or removing timers may be processing the
+	// requests because the queue ran full. Timers then fire on the next
+	// call, rather than waiting for it.
+	if (!tryLockConsumer())
 		return;
 
+	Common::StackLock callbackLock(_callbackMutex);
+
 	// Repeat as long as there is a TimerSlot that is scheduled to fire.
-	TimerSlot *slot = _head->next;
-	while (slot && slot->nextFireTime < curTime) {
-		// Remove the slot from the priority queue
-		_head->next = slot->next;
+	while (true) {
+		processRequests();
 
-		// Update the fire time and reinsert the TimerSlot into the priority
-		// queue.
-		assert(slot->interval > 0);
-		slot->nextFireTime += (slot->interval / 1000);
-		slot->nextFireTimeMicro += (slot->interval % 1000);
-		if (slot->nextFireTimeMicro > 1000) {
-			slot->nextFireTime += slot->nextFireTimeMicro / 1000;
-			slot->nextFireTimeMicro %= 1000;
+		const uint64 curTime = updateClock();
+		if (_queue.empty() || _queue[0]->nextFireTime >= curTime)
+			break;
+
+		TimerSlot *slot = _queue[0];
+
+		// The removal request has not been queued yet, it is deleted once
+		// it is
+		uint32 state = kSlotIdle;
+		if (!slot->state.compareExchange(state, kSlotFiring)) {
+			removeSlot(0);
+			continue;
 		}
-		insertPrioQueue(_head, slot);
 
-		// Invoke the timer callback
+		const uint64 lateness = curTime - slot->nextFireTime;
+		slot->fireCount++;
+		slot->totalLateness += lateness;
+		slot->maxLateness = MAX<uint32>(slot->maxLateness, (uint32)MIN<uint64>(lateness, 0xFFFFFFFF));
+
+		// The next fire time is derived from the previous one rather than
+		// from the current time, so a late tick does not delay all
+		// following ones.
+		assert(slot->interval > 0);
+		slot->nextFireTime += slot->interval;
+		slot->sequence = _sequence++;
+		siftDown(0);
+
+		// Invoke the timer callback. The slot is only deleted by
+		// processRequests(), so it stays valid even if the timer is
+		// removed from here on, see removeTimerProc.
 		assert(slot->callback);
 		slot->callback(slot->refCon);
 
-		// Look at the next scheduled timer
-		slot = _head->next;
+		state = kSlotFiring;
+		slot->state.compareExchange(state, kSlotIdle);
 	}
+
+	unlockConsumer();
 }
 
 void DefaultTimerManager::checkTimers(uint32 interval) {
@@ -147,44 +284,78 @@ bool DefaultTimerManager::installTimerProc(TimerProc callback, int32 interval, v
 	slot->refCon = refCon;
 	slot->id = id;
 	slot->interval = interval;
-	slot->nextFireTime = g_system->getMillis() + interval / 1000;
-	slot->nextFireTimeMicro = interval % 1000;
-	slot->next = nullptr;
 
-	insertPrioQueue(_head, slot);
+	_slots.push_back(slot);
+	pushRequest(true, slot);
 
 	return true;
 }
 
 void DefaultTimerManager::removeTimerProc(TimerProc callback) {
-	Common::StackLock lock(_mutex);
-
-	TimerSlot *slot = _head;
+	bool isFiring = false;
+
+	{
+		Common::StackLock lock(_mutex);
+
+		for (uint i = 0; i < _slots.size();) {
+			TimerSlot *slot = _slots[i];
+			if (slot->callback == callback) {
+				isFiring |= (slot->state.exchange(kSlotRemoved) == kSlotFiring);
+				_slots.remove_at(i);
+				pushRequest(false, slot);
+			} else {
+				++i;
+			}
+		}
 
-	while (slot->next) {
-		if (slot->next->callback == callback) {
-			TimerSlot *next = slot->next->next;
-			delete slot->next;
-			slot->next = next;
-		} else {
-			slot = slot->next;
+		// We need to remove all names referencing the timer proc here.
+		//
+		// Else we run into troubles, when the client code removes and readds timer
+		// callbacks.
+		//
+		// Another issues occurs when one plays a game with ALSA as music driver,
+		// returns to launcher and starts a different engine game with ALSA as music driver.
+		// In this case the MPU401 code will add different timer procs with the
+		// same name, resulting in two different callbacks added with the same
+		// name and causing installTimerProc to error out.
+		// A good test case is running a SCUMM with ALSA output and then a KYRA
+		// game for example.
+		for (TimerSlotMap::iterator i = _callbacks.begin(), end = _callbacks.end(); i != end; ++i) {
+			if (i->_value == callback)
+				_callbacks.erase(i);
 		}
 	}
 
-	// We need to remove all names referencing the timer proc here.
-	//
-	// Else we run into troubles, when the client code removes and readds timer
-	// callbacks.
-	//
-	// Another issues occurs when one plays a game with ALSA as music driver,
-	// returns to launcher and starts a different engine game with ALSA as music driver.
-	// In this case the MPU401 code will add different timer procs with the
-	// same name, resulting in two different callbacks added with the same
-	// name and causing installTimerProc to error out.
-	// A good test case is running a SCUMM with ALSA output and then a KYRA
-	// game for example.
-	for (TimerSlotMap::iterator i = _callbacks.begin(), end = _callbacks.end(); i != end; ++i) {
-		if (i->_value == callback)
-			_callbacks.erase(i);
+	// Callers may free the data passed to the callback right after this, so
+	// wait for a running invocation to finish. The mutex is recursive, thus
+	// a callback removing itself does not block here.
+	if (isFiring) {
+		Common::StackLock callbackLock(_callbackMutex);
 	}
 }
+
+void DefaultTimerManager::logStats(const TimerSlot *slot) const {
+	if (!slot->fireCount)
+		return;
+
+	debug(3, "Timer '%s' (%u us): fired %u times, lateness mean %u us, max %u us", slot->id.c_str(), slot->interval,
+	      slot->fireCount, (uint32)(slot->totalLateness / slot->fireCount), slot->maxLateness);
+}
+
+void DefaultTimerManager::getStats(Common::Array<TimerStats> &stats) {
+	// Waits for a running handler, whose state this reads
+	lockConsumer();
+	processRequests();
+
+	stats.resize(_queue.size());
+	for (uint i = 0; i < _queue.size(); ++i) {
+		const TimerSlot *slot = _queue[i];
+		stats[i].id = slot->id;
+		stats[i].interval = slot->interval;
+		stats[i].fireCount = slot->fireCount;
+		stats[i].meanLateness = slot->fireCount ? (uint32)(slot->totalLateness / slot->fireCount) : 0;
+		stats[i].maxLateness = slot->maxLateness;
+	}
+
+	unlockConsumer();
+}
@@ -22,6 +22,9 @@
 #ifndef BACKENDS_TIMER_DEFAULT_H
 #define BACKENDS_TIMER_DEFAULT_H
 
+#include "common/array.h"
+#include "common/atomic.h"
+#include "common/spscqueue.h"
 #include "common/str.h"
 #include "common/hash-str.h"
 #include "common/timer.h"
@@ -30,15 +33,77 @@
 struct TimerSlot;
 
 class DefaultTimerManager : public Common::TimerManager {
+public:
+	/**
+	 * How punctually a timer fired, lateness being measured against the
+	 * ideal fire time of each period.
+	 */
+	struct TimerStats {
+		Common::String id;
+		uint32 interval;		// in microseconds
+		uint32 fireCount;
+		uint32 meanLateness;	// in microseconds
+		uint32 maxLateness;		// in microseconds
+	};
+
 private:
 	typedef Common::HashMap<Common::String, TimerProc, Common::IgnoreCase_Hash, Common::IgnoreCase_EqualTo> TimerSlotMap;
 
+	struct TimerRequest {
+		bool install;	// else remove
+		TimerSlot *slot;
+	};
+
+	// Installing and removing timers only queues a request, which the
+	// handler processes before firing timers. The handler never takes
+	// _mutex, so it does not wait for registrations, nor the other way
+	// around.
+	enum {
+		kRequestQueueSize = 256
+	};
+	Common::SPSCQueue<TimerRequest, kRequestQueueSize> _requests;
+
+	// Serializes the producers of requests, and guards the state they use
 	Common::Mutex _mutex;
-	TimerSlot *_head;
+	Common::Array<TimerSlot *> _slots;
 	TimerSlotMap _callbacks;
 
+	// Held by the handler while it invokes callbacks
+	Common::Mutex _callbackMutex;
+
+	// Set while a thread processes the requests and owns the state below,
+	// normally the handler
+	Common::Atomic<uint32> _consumerBusy;
+
+	// Binary min-heap of the scheduled timers, ordered by fire time
+	Common::Array<TimerSlot *> _queue;
+
+	uint64 _clock;			// in microseconds
+	uint32 _clockMillis;
+	uint32 _sequence;
+
 	uint32 _timerCallbackNext;
 
+	void pushRequest(bool install, TimerSlot *slot);
+	void processRequests();
+	bool tryLockConsumer();
+	void lockConsumer();
+	void unlockConsumer();
+
+	uint64 updateClock();
+	void pushSlot(TimerSlot *slot);
+	void removeSlot(uint index);
+	void siftUp(uint index);
+	void siftDown(uint index);
+	bool isBefore(const TimerSlot *a, const TimerSlot *b) const;
+	void logStats(const TimerSlot *slot) const;
+
+protected:
+	/**
+	 * The time timers are scheduled against, in milliseconds.
+	 */
+	virtual uint32 getMillis() const;
+
 public:
 	DefaultTimerManager();
 	virtual ~DefaultTimerManager();
@@ -55,6 +120,12 @@ public:
 	 * Should be called from pollEvents() on backends without threads.
 	 */
 	void checkTimers(uint32 interval = 10);
+
+	/**
+	 * Query the firing statistics of all installed timers.
+	 * Must not be called from a timer callback.
+	 */
+	void getStats(Common::Array<TimerStats> &stats);
 };
 
 #endif
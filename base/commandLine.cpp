@@ -189,6 +189,8 @@ static const char HELP_STRING4[] =
 	"  --aspect-ratio           Enable aspect ratio correction\n"
 	"  --[no-]dirtyrects        Enable dirty rectangles optimisation in software renderer\n"
 	"                           (default: enabled)\n"
+	"  --[no-]tinygl-threads    Enable worker threads in software renderer\n"
+	"                           (default: enabled)\n"
 	"  --render-mode=MODE       Enable additional render modes (hercGreen, hercAmber,\n"
 	"                           cga, ega, vga, amiga, fmtowns, pc9821, pc9801, 2gs,\n"
 	"                           atari, macintosh, macintoshbw)\n"
@@ -301,6 +303,7 @@ void registerDefaults() {
 	ConfMan.registerDefault("shader", Common::Path("default", Common::Path::kNoSeparator));
 	ConfMan.registerDefault("show_fps", false);
 	ConfMan.registerDefault("dirtyrects", true);
+	ConfMan.registerDefault("tinygl_threads", true);
 	ConfMan.registerDefault("vsync", true);
 
 	// Sound & Music
@@ -896,6 +899,9 @@ Common::String parseCommandLine(Common::StringMap &settings, int argc, const cha
 			DO_LONG_OPTION_BOOL("dirtyrects")
 			END_OPTION
 
+			DO_LONG_OPTION_BOOL("tinygl-threads")
+			END_OPTION
+
 			DO_LONG_OPTION("gamma")
 			END_OPTION
 
@@ -744,6 +744,9 @@ DetectionResults EngineManager::detectGames(const Common::FSList &fslist, uint32
 	// Close all archives that were opened during detection
 	ADCacheMan.clearArchives();
 
+	ADCacheMan.flushPersistentMD5Cache(false);
+	ADCacheMan.printPersistentMD5Stats();
+
 	return DetectionResults(candidates);
 }
 
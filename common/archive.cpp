@@ -284,6 +284,58 @@ void SearchSet::insert(const Node &node) {
 			break;
 	}
 	_list.insert(it, node);
+	invalidateIndex();
+}
+
+void SearchSet::buildIndex() const {
+	_index.clear();
+
+	// The archives are in search order, so the first one listing a member
+	// is the one serving it
+	ArchiveNodeList::const_iterator it = _list.begin();
+	for (; it != _list.end(); ++it) {
+		ArchiveMemberList members;
+		it->_arc->listMembers(members);
+
+		for (ArchiveMemberList::const_iterator member = members.begin(); member != members.end(); ++member) {
+			Path path = (*member)->getPathInArchive().normalize();
+			if (!_index.contains(path))
+				_index[path] = &*it;
+		}
+	}
+
+	_indexValid = true;
+}
+
+const SearchSet::Node *SearchSet::lookupIndex(const Path &path) const {
+	if (!_indexValid)
+		buildIndex();
+
+	MemberIndex::const_iterator it = _index.find(path.normalize());
+	return (it != _index.end()) ? it->_value : nullptr;
+}
+
+void SearchSet::setUseIndex(bool useIndex) {
+	_useIndex = useIndex;
+	invalidateIndex();
+}
+
+void SearchSet::getArchiveStats(Array<ArchiveStats> &stats) const {
+	ArchiveNodeList::const_iterator it = _list.begin();
+	for (; it != _list.end(); ++it) {
+		ArchiveStats archiveStats;
+		archiveStats.name = it->_name;
+		archiveStats.priority = it->_priority;
+		archiveStats.lookups = it->_lookups;
+		archiveStats.hits = it->_hits;
+		stats.push_back(archiveStats);
+	}
+}
+
+void SearchSet::resetArchiveStats() {
+	ArchiveNodeList::iterator it = _list.begin();
+	for (; it != _list.end(); ++it)
+		it->_lookups = it->_hits = 0;
 }
 
 void SearchSet::add(const String &name, Archive *archive, int priority, bool autoFree) {
@@ -374,6 +426,7 @@ void SearchSet::remove(const String &name) {
 		if (it->_autoFree)
 			delete it->_arc;
 		_list.erase(it);
+		invalidateIndex();
 	}
 }
 
@@ -397,6 +450,7 @@ void SearchSet::clear() {
 	}
 
 	_list.clear();
+	invalidateIndex();
 }
 
 void SearchSet::setPriority(const String &name, int priority) {
@@ -419,9 +473,18 @@ bool SearchSet::hasFile(const Path &path) const {
 	if (path.empty())
 		return false;
 
+	if (_useIndex) {
+		const Node *node = lookupIndex(path);
+		if (!node)
+			return false;
+		if (node->countLookup(node->_arc->hasFile(path)))
+			return true;
+		// The index is out of date, so search all archives
+	}
+
 	ArchiveNodeList::const_iterator it = _list.begin();
 	for (; it != _list.end(); ++it) {
-		if (it->_arc->hasFile(path))
+		if (it->countLookup(it->_arc->hasFile(path)))
 			return true;
 	}
 
@@ -434,7 +497,7 @@ bool SearchSet::isPathDirectory(const Path &path) const {
 
 	ArchiveNodeList::const_iterator it = _list.begin();
 	for (; it != _list.end(); ++it) {
-		if (it->_arc->isPathDirectory(path)) {
+		if (it->countLookup(it->_arc->isPathDirectory(path))) {
 			// See if an earlier archive contains the same path as a non-directory file.
 			// If this is the case, then we want to return false here because getMember will return
 			// that file.  This is a bit faster than hasFile for each archive first.
@@ -489,9 +552,21 @@ const ArchiveMemberPtr SearchSet::getMember(const Path &path, Archive **containe
 	if (path.empty())
 		return ArchiveMemberPtr();
 
+	if (_useIndex) {
+		const Node *node = lookupIndex(path);
+		if (!node)
+			return ArchiveMemberPtr();
+		if (node->countLookup(node->_arc->hasFile(path))) {
+			if (container) {
+				*container = node->_arc;
+			}
+			return node->_arc->getMember(path);
+		}
+	}
+
 	ArchiveNodeList::const_iterator it = _list.begin();
 	for (; it != _list.end(); ++it) {
-		if (it->_arc->hasFile(path)) {
+		if (it->countLookup(it->_arc->hasFile(path))) {
 			if (container) {
 				*container = it->_arc;
 			}
@@ -510,10 +585,19 @@ SeekableReadStream *SearchSet::createReadStreamForMember(const Path &path) const
 	if (path.empty())
 		return nullptr;
 
+	if (_useIndex) {
+		const Node *node = lookupIndex(path);
+		if (!node)
+			return nullptr;
+		SeekableReadStream *stream = node->_arc->createReadStreamForMember(path);
+		if (node->countLookup(stream != nullptr))
+			return stream;
+	}
+
 	ArchiveNodeList::const_iterator it = _list.begin();
 	for (; it != _list.end(); ++it) {
 		SeekableReadStream *stream = it->_arc->createReadStreamForMember(path);
-		if (stream)
+		if (it->countLookup(stream != nullptr))
 			return stream;
 	}
 
@@ -527,7 +611,7 @@ SeekableReadStream *SearchSet::createReadStreamForMemberAltStream(const Path &pa
 	ArchiveNodeList::const_iterator it = _list.begin();
 	for (; it != _list.end(); ++it) {
 		SeekableReadStream *stream = it->_arc->createReadStreamForMemberAltStream(path, altStreamType);
-		if (stream)
+		if (it->countLookup(stream != nullptr))
 			return stream;
 	}
 
@@ -546,7 +630,7 @@ SeekableReadStream *SearchSet::createReadStreamForMemberNext(const Path &path, c
 		}
 	for (; it != _list.end(); ++it) {
 		SeekableReadStream *stream = it->_arc->createReadStreamForMember(path);
-		if (stream)
+		if (it->countLookup(stream != nullptr))
 			return stream;
 	}
 
@@ -22,6 +22,7 @@
 #ifndef COMMON_ARCHIVE_H
 #define COMMON_ARCHIVE_H
 
+#include "common/array.h"
 #include "common/error.h"
 #include "common/hashmap.h"
 #include "common/hash-str.h"
@@ -308,6 +309,9 @@ private:
  * contained Archives, hence the simplistic policy of always looking for the first
  * match. SearchSet does guarantee that searches are performed in DESCENDING
  * priority order. In case of conflicting priorities, insertion order prevails.
+ *
+ * SearchSet is not thread-safe. Even const lookups change its state, as they
+ * update the lookup counters and may build the member index.
  */
 class SearchSet : public Archive {
 	struct Node {
@@ -315,8 +319,18 @@ class SearchSet : public Archive {
 		String	_name;
 		Archive	*_arc;
 		bool	_autoFree;
+		mutable uint32	_lookups;
+		mutable uint32	_hits;
 		Node(int priority, const String &name, Archive *arc, bool autoFree)
-			: _priority(priority), _name(name), _arc(arc), _autoFree(autoFree) {
+			: _priority(priority), _name(name), _arc(arc), _autoFree(autoFree), _lookups(0), _hits(0) {
+		}
+
+		/** Count a lookup passed to the archive, and return whether it found the member. */
+		bool countLookup(bool hit) const {
+			_lookups++;
+			if (hit)
+				_hits++;
+			return hit;
 		}
 	};
 	typedef List<Node> ArchiveNodeList;
@@ -329,10 +343,41 @@ class SearchSet : public Archive {
 
 	bool _ignoreClashes;
 
+	/** The archive with the highest priority listing each member */
+	typedef HashMap<Path, const Node *, Path::IgnoreCaseAndMac_Hash, Path::IgnoreCaseAndMac_EqualTo> MemberIndex;
+	mutable MemberIndex _index;
+	bool _useIndex;
+	mutable bool _indexValid;
+
+	void buildIndex() const;
+	const Node *lookupIndex(const Path &path) const;
+
 public:
-	SearchSet() : _ignoreClashes(false) { }
+	/** Lookup counters of an archive in the set. */
+	struct ArchiveStats {
+		String name;
+		int priority;
+		uint32 lookups; //!< The number of lookups passed to the archive.
+		uint32 hits;    //!< The number of those lookups which found the member.
+	};
+
+	SearchSet() : _ignoreClashes(false), _useIndex(false), _indexValid(false) { }
 	virtual ~SearchSet() { clear(); }
 
+	// The index points into the list of the set it was built for, so a copy
+	// has to build its own.
+	SearchSet(const SearchSet &other) : Archive(other), _list(other._list), _ignoreClashes(other._ignoreClashes),
+		_useIndex(other._useIndex), _indexValid(false) { }
+	SearchSet &operator=(const SearchSet &other) {
+		if (this != &other) {
+			_list = other._list;
+			_ignoreClashes = other._ignoreClashes;
+			_useIndex = other._useIndex;
+			invalidateIndex();
+		}
+		return *this;
+	}
+
 	/**
 	 * Add a new archive to the searchable set.
 	 */
@@ -423,6 +468,35 @@ public:
 	 */
 	void setPriority(const String& name, int priority);
 
+	/**
+	 * Resolve lookups through a merged index of the members of all archives,
+	 * which maps each path to the archive with the highest priority listing
+	 * it. Only that archive is asked for the member, and paths missing from
+	 * the index are not looked up at all.
+	 *
+	 * The index is built from listMembers() on the first lookup after the
+	 * archives change. Only enable it if every archive lists all the files
+	 * it can open, and call invalidateIndex() when files are added to an
+	 * archive. It is used by hasFile(), getMember() and
+	 * createReadStreamForMember().
+	 */
+	void setUseIndex(bool useIndex);
+
+	/**
+	 * Rebuild the index on the next lookup.
+	 */
+	void invalidateIndex() { _indexValid = false; _index.clear(); }
+
+	/**
+	 * Append the lookup counters of all archives to the list, in search order.
+	 */
+	void getArchiveStats(Array<ArchiveStats> &stats) const;
+
+	/**
+	 * Reset the lookup counters of all archives.
+	 */
+	void resetArchiveStats();
+
 	bool hasFile(const Path &path) const override;
 	bool isPathDirectory(const Path &path) const override;
 	int listMatchingMembers(ArchiveMemberList &list, const Path &pattern, bool matchPathComponents = false) const override;
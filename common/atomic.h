@@ -0,0 +1,148 @@
+/* ScummVM - Graphic Adventure Engine
+ *
+ * ScummVM is the legal property of its developers, whose names
+ * are too numerous to list here. Please refer to the COPYRIGHT
+ * file distributed with this source distribution.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#ifndef COMMON_ATOMIC_H
+#define COMMON_ATOMIC_H
+
+#include "common/scummsys.h"
+#include "common/noncopyable.h"
+
+#if !defined(__GNUC__) && defined(_MSC_VER)
+#include <intrin.h>
+#endif
+
+namespace Common {
+
+/**
+ * @defgroup common_atomic Atomic integers
+ * @ingroup common
+ *
+ * @brief Minimal atomic integer type for data shared between threads.
+ * @{
+ */
+
+/**
+ * A 32-bit integer which can be accessed concurrently from several threads
+ * without taking a mutex.
+ *
+ * Loads have acquire semantics, stores have release semantics and all
+ * read-modify-write operations are sequentially consistent. This is enough
+ * to publish data from one thread to another (e.g. the indices of a
+ * single-producer single-consumer queue) and to maintain reference counts.
+ *
+ * On compilers without atomic intrinsics, plain memory accesses are used.
+ * Such platforms are expected to run all threads on a single core without
+ * preemption in the middle of an integer access.
+ */
+template<class T>
+class Atomic : NonCopyable {
+	static_assert(sizeof(T) == 4, "Common::Atomic only supports 32-bit types");
+
+public:
+	Atomic(T value = T()) : _value(value) {}
+
+	/** Return the current value. */
+	T load() const {
+#if defined(__GNUC__)
+		return __atomic_load_n(&_value, __ATOMIC_ACQUIRE);
+#elif defined(_MSC_VER)
+		return (T)_InterlockedCompareExchange((volatile long *)&_value, 0, 0);
+#else
+		return _value;
+#endif
+	}
+
+	/** Replace the current value. */
+	void store(T value) {
+#if defined(__GNUC__)
+		__atomic_store_n(&_value, value, __ATOMIC_RELEASE);
+#elif defined(_MSC_VER)
+		_InterlockedExchange((volatile long *)&_value, (long)value);
+#else
+		_value = value;
+#endif
+	}
+
+	/** Replace the current value and return the previous one. */
+	T exchange(T value) {
+#if defined(__GNUC__)
+		return __atomic_exchange_n(&_value, value, __ATOMIC_SEQ_CST);
+#elif defined(_MSC_VER)
+		return (T)_InterlockedExchange((volatile long *)&_value, (long)value);
+#else
+		T old = _value;
+		_value = value;
+		return old;
+#endif
+	}
+
+	/** Add @p delta to the value and return the previous value. */
+	T fetchAdd(T delta) {
+#if defined(__GNUC__)
+		return __atomic_fetch_add(&_value, delta, __ATOMIC_SEQ_CST);
+#elif defined(_MSC_VER)
+		return (T)_InterlockedExchangeAdd((volatile long *)&_value, (long)delta);
+#else
+		T old = _value;
+		_value += delta;
+		return old;
+#endif
+	}
+
+	/** Subtract @p delta from the value and return the previous value. */
+	T fetchSub(T delta) {
+		return fetchAdd((T)(0 - delta));
+	}
+
+	/**
+	 * Replace the value with @p desired if it currently equals @p expected.
+	 *
+	 * @return True if the value was replaced. Otherwise, @p expected receives
+	 *         the current value.
+	 */
+	bool compareExchange(T &expected, T desired) {
+#if defined(__GNUC__)
+		return __atomic_compare_exchange_n(&_value, &expected, desired, false, __ATOMIC_SEQ_CST, __ATOMIC_SEQ_CST);
+#elif defined(_MSC_VER)
+		T old = (T)_InterlockedCompareExchange((volatile long *)&_value, (long)desired, (long)expected);
+		if (old == expected)
+			return true;
+		expected = old;
+		return false;
+#else
+		if (_value == expected) {
+			_value = desired;
+			return true;
+		}
+		expected = _value;
+		return false;
+#endif
+	}
+
+private:
+	volatile T _value;
+};
+
+/** @} */
+
+} // End of namespace Common
+
+#endif
@@ -91,11 +91,16 @@ typedef Byte Bytef;
 #include "common/crc.h"
 #endif
 
+#include "common/debug.h"
 #include "common/fs.h"
 #include "common/compression/deflate.h"
 #include "common/compression/unzip.h"
 #include "common/memstream.h"
+#include "common/ptr.h"
+#include "common/substream.h"
+#include "common/textconsole.h"
 
+#include "common/array.h"
 #include "common/hashmap.h"
 #include "common/hash-str.h"
 
@@ -237,6 +242,13 @@ Common::SharedArchiveContents unzOpenCurrentFile(unzFile file
   If there is no error, the return value is UNZ_OK.
 */
 
+Common::SeekableReadStream *unzOpenCurrentFileStream(unzFile file);
+/*
+  Open the current file in the zipfile as a stream which decompresses on
+  the fly, instead of decompressing it to memory at once.
+  Return nullptr on error.
+*/
+
 int unzCloseCurrentFile(unzFile file);
 /*
   Close the file in zip opened with unzOpenCurrentFile
@@ -1018,6 +1030,235 @@ Common::SharedArchiveContents unzOpenCurrentFile (unzFile file
 	return Common::SharedArchiveContents(uncompressedBuffer, s->cur_file_info.uncompressed_size);
 }
 
+#ifdef USE_ZLIB
+namespace Common {
+
+/**
+ * Seekable stream inflating a deflated ZIP member on the fly.
+ *
+ * While reading forward, the state of the decompressor is saved at regular
+ * intervals. Seeking backwards (or far ahead, once the data has been read
+ * before) resumes from the closest saved state instead of decompressing
+ * the member from its start again.
+ */
+class ZipInflateReadStream : public SeekableReadStream {
+	enum {
+		BUFSIZE = 16384,
+		MIN_CHECKPOINT_INTERVAL = 1024 * 1024,
+		MAX_CHECKPOINTS = 64
+	};
+
+	struct Checkpoint {
+		uint32 outPos;   ///< Position in the uncompressed data
+		uint32 inPos;    ///< Position of the next unconsumed byte in the compressed data
+		z_stream *state; ///< Copy of the decompressor state
+	};
+
+	byte _buf[BUFSIZE];
+	ScopedPtr<SeekableReadStream> _wrapped;
+	z_stream _stream;
+	int _zlibErr;
+
+	uint32 _pos;
+	const uint32 _size;
+	bool _eos;
+
+	const uint32 _checkpointInterval;
+	Array<Checkpoint> _checkpoints;
+
+	// The CRC can only be verified when the whole member has been decompressed.
+	// It is updated as long as the data is read in order.
+	uint32 _crcPos;
+	uLong _crc;
+	const uint32 _expectedCrc;
+
+	uint32 inflateChunk(byte *dst, uint32 len) {
+		_stream.next_out = dst;
+		_stream.avail_out = len;
+
+		while (_zlibErr == Z_OK && _stream.avail_out) {
+			if (_stream.avail_in == 0 && !_wrapped->eos()) {
+				_stream.next_in = _buf;
+				_stream.avail_in = _wrapped->read(_buf, BUFSIZE);
+			}
+			_zlibErr = inflate(&_stream, Z_NO_FLUSH);
+		}
+
+		const uint32 produced = len - _stream.avail_out;
+
+		if (_pos <= _crcPos && _crcPos < _pos + produced) {
+			const uint32 skip = _crcPos - _pos;
+			_crc = crc32(_crc, dst + skip, produced - skip);
+			_crcPos = _pos + produced;
+			if (_crcPos == _size && _crc != _expectedCrc)
+				warning("CRC32 mismatch: %08x, %08x", (uint32)_crc, _expectedCrc);
+		}
+
+		_pos += produced;
+		return produced;
+	}
+
+	void addCheckpoint() {
+		Checkpoint checkpoint;
+		checkpoint.outPos = _pos;
+		checkpoint.inPos = _wrapped->pos() - _stream.avail_in;
+		checkpoint.state = new z_stream();
+		const int err = inflateCopy(checkpoint.state, &_stream);
+		if (err != Z_OK) {
+			// Seeking back past this point restarts from an earlier checkpoint
+			debug(1, "Could not save the inflate state at offset %u: %d", _pos, err);
+			delete checkpoint.state;
+			return;
+		}
+		_checkpoints.push_back(checkpoint);
+	}
+
+	bool restart(const Checkpoint *checkpoint) {
+		inflateEnd(&_stream);
+		if (checkpoint) {
+			_zlibErr = inflateCopy(&_stream, checkpoint->state);
+			_pos = checkpoint->outPos;
+			_wrapped->seek(checkpoint->inPos, SEEK_SET);
+		} else {
+			_stream = z_stream();
+			_zlibErr = inflateInit2(&_stream, -MAX_WBITS);
+			_pos = 0;
+			_wrapped->seek(0, SEEK_SET);
+		}
+		_stream.next_in = _buf;
+		_stream.avail_in = 0;
+		return _zlibErr == Z_OK;
+	}
+
+public:
+	ZipInflateReadStream(SeekableReadStream *compressed, uint32 uncompressedSize, uint32 crc) :
+			_wrapped(compressed), _stream(), _pos(0), _size(uncompressedSize), _eos(false),
+			_checkpointInterval(MAX<uint32>(MIN_CHECKPOINT_INTERVAL, uncompressedSize / MAX_CHECKPOINTS)),
+			_crcPos(0), _crc(crc32(0, nullptr, 0)), _expectedCrc(crc) {
+		_zlibErr = inflateInit2(&_stream, -MAX_WBITS);
+		_stream.next_in = _buf;
+		_stream.avail_in = 0;
+	}
+
+	~ZipInflateReadStream() {
+		for (uint i = 0; i < _checkpoints.size(); i++) {
+			inflateEnd(_checkpoints[i].state);
+			delete _checkpoints[i].state;
+		}
+		inflateEnd(&_stream);
+	}
+
+	bool err() const override { return (_zlibErr != Z_OK) && (_zlibErr != Z_STREAM_END); }
+	void clearErr() override { _eos = false; }
+	bool eos() const override { return _eos; }
+	int64 pos() const override { return _pos; }
+	int64 size() const override { return _size; }
+
+	uint32 read(void *dataPtr, uint32 dataSize) override {
+		byte *dst = (byte *)dataPtr;
+		uint32 total = 0;
+
+		while (total < dataSize && _zlibErr == Z_OK) {
+			// Save the decompressor state when reaching new checkpoint positions
+			const uint32 nextCheckpoint = (_pos / _checkpointInterval + 1) * _checkpointInterval;
+			if (_pos % _checkpointInterval == 0 && _pos != 0 && _pos / _checkpointInterval == _checkpoints.size() + 1)
+				addCheckpoint();
+
+			const uint32 produced = inflateChunk(dst + total, MIN<uint32>(dataSize - total, nextCheckpoint - _pos));
+			if (produced == 0)
+				break;
+			total += produced;
+		}
+
+		if (total < dataSize)
+			_eos = true;
+
+		return total;
+	}
+
+	bool seek(int64 offset, int whence = SEEK_SET) override {
+		int64 newPos;
+		switch (whence) {
+		case SEEK_END:
+			newPos = _size + offset;
+			break;
+		case SEEK_CUR:
+			newPos = _pos + offset;
+			break;
+		case SEEK_SET:
+		default:
+			newPos = offset;
+			break;
+		}
+
+		if (newPos < 0 || newPos > _size)
+			return false;
+
+		_eos = false;
+
+		// Find the last checkpoint before the new position, and resume from
+		// there if that is closer than the current position
+		const Checkpoint *checkpoint = nullptr;
+		for (uint i = 0; i < _checkpoints.size() && _checkpoints[i].outPos <= newPos; i++)
+			checkpoint = &_checkpoints[i];
+
+		if (newPos < _pos || (checkpoint && checkpoint->outPos > _pos)) {
+			if (!restart(checkpoint))
+				return false;
+		}
+
+		// Decompress up to the new position
+		byte skipBuf[4096];
+		while (_pos < newPos) {
+			const uint32 len = MIN<int64>(sizeof(skipBuf), newPos - _pos);
+			if (read(skipBuf, len) != len)
+				return false;
+		}
+
+		return true;
+	}
+};
+
+} // End of namespace Common
+#endif
+
+Common::SeekableReadStream *unzOpenCurrentFileStream(unzFile file) {
+	uInt iSizeVar;
+	unz_s *s;
+	uLong offset_local_extrafield;  /* offset of the local extra field */
+	uInt  size_local_extrafield;    /* size of the local extra field */
+
+	if (file == nullptr)
+		return nullptr;
+	s = (unz_s *)file;
+	if (!s->current_file_ok)
+		return nullptr;
+
+	if (unzlocal_CheckCurrentFileCoherencyHeader(s, &iSizeVar,
+				&offset_local_extrafield, &size_local_extrafield) != UNZ_OK)
+		return nullptr;
+
+	// Every stream seeks the archive before reading, so several members can
+	// be read at the same time
+	const uint32 begin = s->cur_file_info_internal.offset_curfile + SIZEZIPLOCALHEADER + iSizeVar;
+	Common::SeekableReadStream *compressed = new Common::SafeSeekableSubReadStream(s->_stream, begin, begin + s->cur_file_info.compressed_size);
+
+	switch (s->cur_file_info.compression_method) {
+	case 0: // Store
+		return compressed;
+	case Z_DEFLATED:
+#ifdef USE_ZLIB
+		return new Common::ZipInflateReadStream(compressed, s->cur_file_info.uncompressed_size, s->cur_file_info.crc);
+#else
+		return Common::wrapDeflateReadStream(compressed, DisposeAfterUse::YES, s->cur_file_info.uncompressed_size);
+#endif
+	default:
+		warning("Unknown compression algoritthm %d", (int)s->cur_file_info.compression_method);
+		delete compressed;
+		return nullptr;
+	}
+}
+
 
 namespace Common {
 
@@ -1028,9 +1269,10 @@ class ZipArchive : public MemcachingCaseInsensitiveArchive {
 	Common::CRC32 _crc;
 #endif
 	bool _flattenTree;
+	uint32 _streamingThreshold;
 
 public:
-	ZipArchive(unzFile zipFile, bool flattenTree);
+	ZipArchive(unzFile zipFile, bool flattenTree, uint32 streamingThreshold);
 
 
 	~ZipArchive();
@@ -1063,7 +1305,8 @@ public:
 };
 */
 
-ZipArchive::ZipArchive(unzFile zipFile, bool flattenTree) : _zipFile(zipFile), _flattenTree(flattenTree) {
+ZipArchive::ZipArchive(unzFile zipFile, bool flattenTree, uint32 streamingThreshold) :
+		_zipFile(zipFile), _flattenTree(flattenTree), _streamingThreshold(streamingThreshold) {
 	assert(_zipFile);
 }
 
@@ -1109,6 +1352,15 @@ const ArchiveMemberPtr ZipArchive::getMember(const Path &path) const {
 Common::SharedArchiveContents ZipArchive::readContentsForPath(const Common::Path &path) const {
 	if (unzLocateFile(_zipFile, path, 2) != UNZ_OK)
 		return Common::SharedArchiveContents();
+
+	// Large members are decompressed on the fly instead of being cached
+	const unz_s *const archive = (const unz_s *)_zipFile;
+	if (_streamingThreshold != 0 && archive->cur_file_info.uncompressed_size >= _streamingThreshold) {
+		SeekableReadStream *stream = unzOpenCurrentFileStream(_zipFile);
+		if (stream)
+			return Common::SharedArchiveContents::bypass(stream);
+	}
+
 #ifndef USE_ZLIB
 	return unzOpenCurrentFile(_zipFile, _crc);
 #else
@@ -1116,15 +1368,15 @@ Common::SharedArchiveContents ZipArchive::readContentsForPath(const Common::Path
 #endif
 }
 
-Archive *makeZipArchive(const Path &name, bool flattenTree) {
-	return makeZipArchive(SearchMan.createReadStreamForMember(name), flattenTree);
+Archive *makeZipArchive(const Path &name, bool flattenTree, uint32 streamingThreshold) {
+	return makeZipArchive(SearchMan.createReadStreamForMember(name), flattenTree, streamingThreshold);
 }
 
-Archive *makeZipArchive(const FSNode &node, bool flattenTree) {
-	return makeZipArchive(node.createReadStream(), flattenTree);
+Archive *makeZipArchive(const FSNode &node, bool flattenTree, uint32 streamingThreshold) {
+	return makeZipArchive(node.createReadStream(), flattenTree, streamingThreshold);
 }
 
-Archive *makeZipArchive(SeekableReadStream *stream, bool flattenTree) {
+Archive *makeZipArchive(SeekableReadStream *stream, bool flattenTree, uint32 streamingThreshold) {
 	if (!stream)
 		return nullptr;
 	unzFile zipFile = unzOpen(stream, flattenTree);
@@ -1133,7 +1385,7 @@ Archive *makeZipArchive(SeekableReadStream *stream, bool flattenTree) {
 		// goes wrong.
 		return nullptr;
 	}
-	return new ZipArchive(zipFile, flattenTree);
+	return new ZipArchive(zipFile, flattenTree, streamingThreshold);
 }
 
 } // End of namespace Common
@@ -39,31 +39,49 @@ class Archive;
 class FSNode;
 class SeekableReadStream;
 
+/**
+ * Members of at least this many uncompressed bytes are a good candidate for
+ * being decompressed on the fly, see makeZipArchive().
+ */
+enum {
+	kZipDefaultStreamingThreshold = 4 * 1024 * 1024
+};
+
 /**
  * This factory method creates an Archive instance corresponding to the content
  * of the ZIP compressed file with the given name.
  *
+ * Members with an uncompressed size below @p streamingThreshold are
+ * decompressed into memory at once and cached. Larger members are returned
+ * as streams which decompress on the fly, which keeps memory usage low for
+ * big files at the cost of slower backward seeking. A threshold of 0
+ * disables streaming.
+ *
  * May return 0 in case of a failure.
  */
-Archive *makeZipArchive(const Path &name, bool flattenTree = false);
+Archive *makeZipArchive(const Path &name, bool flattenTree = false, uint32 streamingThreshold = 0);
 
 /**
  * This factory method creates an Archive instance corresponding to the content
  * of the ZIP compressed file with the given name.
  *
+ * @see makeZipArchive(const Path &, bool, uint32)
+ *
  * May return 0 in case of a failure.
  */
-Archive *makeZipArchive(const FSNode &node, bool flattenTree = false);
+Archive *makeZipArchive(const FSNode &node, bool flattenTree = false, uint32 streamingThreshold = 0);
 
 /**
  * This factory method creates an Archive instance corresponding to the content
  * of the given ZIP compressed datastream.
  * This takes ownership of the stream,  in particular, it is deleted when the
- * ZipArchive is deleted.
+ * ZipArchive is deleted. Streams opened for large members (see
+ * makeZipArchive(const Path &, bool, uint32)) read from it, so they must
+ * not outlive the archive.
  *
  * May return 0 in case of a failure. In this case stream will still be deleted.
  */
-Archive *makeZipArchive(SeekableReadStream *stream, bool flattenTree = false);
+Archive *makeZipArchive(SeekableReadStream *stream, bool flattenTree = false, uint32 streamingThreshold = 0);
 
 /** @} */
 
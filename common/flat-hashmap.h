@@ -0,0 +1,661 @@
+/* ScummVM - Graphic Adventure Engine
+ *
+ * ScummVM is the legal property of its developers, whose names
+ * are too numerous to list here. Please refer to the COPYRIGHT
+ * file distributed with this source distribution.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+// The control byte layout of the hash table in this file is modeled after
+// the SwissTable design used by Abseil's flat_hash_map.
+
+#ifndef COMMON_FLAT_HASHMAP_H
+#define COMMON_FLAT_HASHMAP_H
+
+#include "common/endian.h"
+#include "common/hashmap.h"
+
+namespace Common {
+
+/**
+ * @defgroup common_flat_hashmap Flat hash table (FlatHashMap)
+ * @ingroup common
+ *
+ * @brief API for operations on a hash table with inline storage.
+ *
+ * @{
+ */
+
+/**
+ * FlatHashMap<Key,Val> provides the same interface as HashMap<Key,Val>, but
+ * stores its nodes directly inside the hash table instead of allocating
+ * each of them separately.
+ *
+ * A separate array holds one control byte per slot, which is either empty,
+ * deleted or 7 bits of the hash of the key stored in that slot. Lookups
+ * scan the control bytes eight at a time and only compare the keys whose
+ * hash bits match, so they usually touch two cache lines at most, and
+ * iteration never dereferences empty or erased slots.
+ *
+ * Since nodes are moved when the table grows, references to values and
+ * iterators do not stay valid across insertions, unlike with HashMap.
+ * Erasing an element does not move any other element, so erasing the
+ * current element while iterating is supported in the same way.
+ */
+template<class Key, class Val, class HashFunc = Hash<Key>, class EqualFunc = EqualTo<Key> >
+class FlatHashMap {
+public:
+	typedef uint size_type;
+
+	struct Node {
+		Val _value;
+		const Key _key;
+		explicit Node(const Key &key) : _value(), _key(key) {}
+		Node(const Node &node) : _value(node._value), _key(node._key) {}
+	};
+
+private:
+
+	typedef FlatHashMap<Key, Val, HashFunc, EqualFunc> HM_t;
+
+	enum {
+		FLATHASHMAP_GROUP_SIZE = 8,
+		FLATHASHMAP_MIN_CAPACITY = 16,
+
+		// The quotient of the next two constants controls how much the
+		// internal storage of the hashmap may fill up (including deleted
+		// slots) before being rehashed.
+		FLATHASHMAP_LOADFACTOR_NUMERATOR = 7,
+		FLATHASHMAP_LOADFACTOR_DENOMINATOR = 8,
+
+		FLATHASHMAP_CTRL_EMPTY = 0x80,
+		FLATHASHMAP_CTRL_DELETED = 0xFE,
+
+		FLATHASHMAP_NOT_FOUND = -1
+	};
+
+	/** Default value, returned by the const getVal. */
+	Val _defaultVal;
+
+	byte *_ctrl;		///< Control bytes of the hashtable, of size arrsize, followed by a copy of the first GROUP_SIZE - 1 ones.
+	Node *_slots;		///< Hashtable of size arrsize; only the slots with a full control byte are constructed.
+	size_type _mask;	///< Capacity of the FlatHashMap minus one; must be a power of two of minus one
+	size_type _size;
+	size_type _deleted;	///< Number of deleted slots
+
+	HashFunc _hash;
+	EqualFunc _equal;
+
+	static const uint64 kGroupLsbs = 0x0101010101010101ULL;
+	static const uint64 kGroupMsbs = 0x8080808080808080ULL;
+
+	/** Hash bits stored in the control byte; scrambled, since many hash functions are weak in the upper bits. */
+	static byte hashTag(size_type hash) {
+		return (byte)((uint32)(hash * 0x9E3779B1U) >> 25);
+	}
+
+	static bool isFull(byte ctrl) {
+		return !(ctrl & FLATHASHMAP_CTRL_EMPTY);
+	}
+
+	/** Return the set of slots in @p group (with the MSB of each byte set) which may hold @p tag. */
+	static uint64 matchTag(uint64 group, byte tag) {
+		const uint64 x = group ^ (kGroupLsbs * tag);
+		return (x - kGroupLsbs) & ~x & kGroupMsbs;
+	}
+
+	static uint64 matchEmpty(uint64 group) {
+		return group & ~(group << 6) & kGroupMsbs;
+	}
+
+	static uint64 matchEmptyOrDeleted(uint64 group) {
+		return group & kGroupMsbs;
+	}
+
+	/** Return the index of the first slot in a non-empty set returned by one of the match functions. */
+	static size_type firstMatch(uint64 match) {
+#if defined(__GNUC__)
+		return __builtin_ctzll(match) >> 3;
+#else
+		size_type idx = 0;
+		while (!(match & 0x80)) {
+			match >>= 8;
+			idx++;
+		}
+		return idx;
+#endif
+	}
+
+	/** Return the index of the last slot in a non-empty set returned by one of the match functions. */
+	static size_type lastMatch(uint64 match) {
+#if defined(__GNUC__)
+		return (63 - __builtin_clzll(match)) >> 3;
+#else
+		size_type idx = 7;
+		while (!(match & 0x8000000000000000ULL)) {
+			match <<= 8;
+			idx--;
+		}
+		return idx;
+#endif
+	}
+
+	/** Load the control bytes of the GROUP_SIZE slots starting at @p pos, wrapping around the end of the table. */
+	uint64 loadGroup(size_type pos) const {
+		return READ_LE_UINT64(_ctrl + pos);
+	}
+
+	size_type ctrlSize() const {
+		return _mask + FLATHASHMAP_GROUP_SIZE;
+	}
+
+	void setCtrl(size_type idx, byte ctrl) {
+		_ctrl[idx] = ctrl;
+		if (idx < FLATHASHMAP_GROUP_SIZE - 1)
+			_ctrl[_mask + 1 + idx] = ctrl;
+	}
+
+	void allocStorage(size_type capacity);
+	void freeStorage();
+	void assign(const HM_t &map);
+	size_type lookup(const Key &key, size_type hash) const;
+	size_type lookup(const Key &key) const { return lookup(key, _hash(key)); }
+	size_type lookupAndCreateIfMissing(const Key &key);
+	size_type findFreeSlot(size_type hash) const;
+	void rehash(size_type newCapacity);
+	void eraseSlot(size_type idx);
+
+	/**
+	 * Simple FlatHashMap iterator implementation.
+	 */
+	template<class NodeType>
+	class IteratorImpl {
+		friend class FlatHashMap;
+		template<class T> friend class IteratorImpl;
+	protected:
+		typedef const FlatHashMap hashmap_t;
+
+		size_type _idx;
+		hashmap_t *_hashmap;
+
+	protected:
+		IteratorImpl(size_type idx, hashmap_t *hashmap) : _idx(idx), _hashmap(hashmap) {}
+
+		NodeType *deref() const {
+			assert(_hashmap != nullptr);
+			assert(_idx <= _hashmap->_mask);
+			assert(isFull(_hashmap->_ctrl[_idx]));
+			return &_hashmap->_slots[_idx];
+		}
+
+	public:
+		IteratorImpl() : _idx(0), _hashmap(nullptr) {}
+		template<class T>
+		IteratorImpl(const IteratorImpl<T> &c) : _idx(c._idx), _hashmap(c._hashmap) {}
+
+		NodeType &operator*() const { return *deref(); }
+		NodeType *operator->() const { return deref(); }
+
+		bool operator==(const IteratorImpl &iter) const { return _idx == iter._idx && _hashmap == iter._hashmap; }
+		bool operator!=(const IteratorImpl &iter) const { return !(*this == iter); }
+
+		IteratorImpl &operator++() {
+			assert(_hashmap);
+			do {
+				_idx++;
+			} while (_idx <= _hashmap->_mask && !isFull(_hashmap->_ctrl[_idx]));
+			if (_idx > _hashmap->_mask)
+				_idx = (size_type)FLATHASHMAP_NOT_FOUND;
+
+			return *this;
+		}
+
+		IteratorImpl operator++(int) {
+			IteratorImpl old = *this;
+			operator ++();
+			return old;
+		}
+	};
+
+public:
+	typedef IteratorImpl<Node> iterator;
+	typedef IteratorImpl<const Node> const_iterator;
+
+	FlatHashMap();
+	FlatHashMap(const HM_t &map);
+	~FlatHashMap();
+
+	HM_t &operator=(const HM_t &map) {
+		if (this == &map)
+			return *this;
+
+		// Remove the previous content and ...
+		clear();
+		freeStorage();
+		// ... copy the new stuff.
+		assign(map);
+		return *this;
+	}
+
+	bool contains(const Key &key) const;
+
+	Val &operator[](const Key &key);
+	const Val &operator[](const Key &key) const;
+
+	Val &getOrCreateVal(const Key &key);
+	Val &getVal(const Key &key);
+	const Val &getVal(const Key &key) const;
+	const Val &getValOrDefault(const Key &key) const;
+	const Val &getValOrDefault(const Key &key, const Val &defaultVal) const;
+	bool tryGetVal(const Key &key, Val &out) const;
+	void setVal(const Key &key, const Val &val);
+
+	void clear(bool shrinkArray = 0);
+
+	void erase(iterator entry);
+	void erase(const Key &key);
+
+	size_type size() const { return _size; }
+
+	iterator	begin() {
+		// Find and return the first non-empty entry
+		for (size_type ctr = 0; ctr <= _mask; ++ctr) {
+			if (isFull(_ctrl[ctr]))
+				return iterator(ctr, this);
+		}
+		return end();
+	}
+	iterator	end() {
+		return iterator((size_type)FLATHASHMAP_NOT_FOUND, this);
+	}
+
+	const_iterator	begin() const {
+		// Find and return the first non-empty entry
+		for (size_type ctr = 0; ctr <= _mask; ++ctr) {
+			if (isFull(_ctrl[ctr]))
+				return const_iterator(ctr, this);
+		}
+		return end();
+	}
+	const_iterator	end() const {
+		return const_iterator((size_type)FLATHASHMAP_NOT_FOUND, this);
+	}
+
+	iterator	find(const Key &key) {
+		return iterator(lookup(key), this);
+	}
+
+	const_iterator	find(const Key &key) const {
+		return const_iterator(lookup(key), this);
+	}
+
+	/** Return true if hashmap is empty. */
+	bool empty() const {
+		return (_size == 0);
+	}
+};
+
+//-------------------------------------------------------
+// FlatHashMap functions
+
+/**
+ * Base constructor, creates an empty hashmap.
+ */
+template<class Key, class Val, class HashFunc, class EqualFunc>
+FlatHashMap<Key, Val, HashFunc, EqualFunc>::FlatHashMap() : _defaultVal() {
+	allocStorage(FLATHASHMAP_MIN_CAPACITY);
+	_size = 0;
+	_deleted = 0;
+}
+
+/**
+ * Copy constructor, creates a full copy of the given hashmap.
+ */
+template<class Key, class Val, class HashFunc, class EqualFunc>
+FlatHashMap<Key, Val, HashFunc, EqualFunc>::FlatHashMap(const HM_t &map) :
+	_defaultVal() {
+	assign(map);
+}
+
+/**
+ * Destructor, frees all used memory.
+ */
+template<class Key, class Val, class HashFunc, class EqualFunc>
+FlatHashMap<Key, Val, HashFunc, EqualFunc>::~FlatHashMap() {
+	clear();
+	freeStorage();
+}
+
+/**
+ * Internal method for allocating empty storage of the given capacity.
+ *
+ * @note The previous storage is *not* deallocated here -- the caller is
+ *       responsible for doing that!
+ */
+template<class Key, class Val, class HashFunc, class EqualFunc>
+void FlatHashMap<Key, Val, HashFunc, EqualFunc>::allocStorage(size_type capacity) {
+	_mask = capacity - 1;
+	_ctrl = new byte[ctrlSize()];
+	memset(_ctrl, FLATHASHMAP_CTRL_EMPTY, ctrlSize());
+	_slots = (Node *)malloc(capacity * sizeof(Node));
+	assert(_slots != nullptr);
+}
+
+/**
+ * Internal method for deallocating the storage. All nodes must have been
+ * destroyed before.
+ */
+template<class Key, class Val, class HashFunc, class EqualFunc>
+void FlatHashMap<Key, Val, HashFunc, EqualFunc>::freeStorage() {
+	delete[] _ctrl;
+	free(_slots);
+	_ctrl = nullptr;
+	_slots = nullptr;
+}
+
+/**
+ * Internal method for assigning the content of another FlatHashMap
+ * to this one.
+ *
+ * @note The previous storage here is *not* deallocated here -- the caller is
+ *       responsible for doing that!
+ */
+template<class Key, class Val, class HashFunc, class EqualFunc>
+void FlatHashMap<Key, Val, HashFunc, EqualFunc>::assign(const HM_t &map) {
+	allocStorage(map._mask + 1);
+
+	// The slots do not depend on anything but the hash, so the table
+	// layout can be copied as is.
+	memcpy(_ctrl, map._ctrl, ctrlSize());
+	for (size_type ctr = 0; ctr <= _mask; ++ctr) {
+		if (isFull(_ctrl[ctr]))
+			new ((void *)&_slots[ctr]) Node(map._slots[ctr]);
+	}
+	_size = map._size;
+	_deleted = map._deleted;
+}
+
+/**
+ * Clear all values in the hashmap.
+ */
+template<class Key, class Val, class HashFunc, class EqualFunc>
+void FlatHashMap<Key, Val, HashFunc, EqualFunc>::clear(bool shrinkArray) {
+	if (_size) {
+		for (size_type ctr = 0; ctr <= _mask; ++ctr) {
+			if (isFull(_ctrl[ctr]))
+				_slots[ctr].~Node();
+		}
+	}
+
+	if (shrinkArray && _mask >= FLATHASHMAP_MIN_CAPACITY) {
+		freeStorage();
+		allocStorage(FLATHASHMAP_MIN_CAPACITY);
+	} else {
+		memset(_ctrl, FLATHASHMAP_CTRL_EMPTY, ctrlSize());
+	}
+
+	_size = 0;
+	_deleted = 0;
+}
+
+/**
+ * Move all elements into a new table of the given capacity, dropping the
+ * deleted slots in the process.
+ */
+template<class Key, class Val, class HashFunc, class EqualFunc>
+void FlatHashMap<Key, Val, HashFunc, EqualFunc>::rehash(size_type newCapacity) {
+	assert(newCapacity > _size);
+
+	const size_type old_mask = _mask;
+	byte *old_ctrl = _ctrl;
+	Node *old_slots = _slots;
+
+	allocStorage(newCapacity);
+	_deleted = 0;
+
+	for (size_type ctr = 0; ctr <= old_mask; ++ctr) {
+		if (!isFull(old_ctrl[ctr]))
+			continue;
+
+		// Since we know that no key exists twice in the old table, we
+		// don't have to call _equal() to find a place for it.
+		const size_type hash = _hash(old_slots[ctr]._key);
+		const size_type idx = findFreeSlot(hash);
+		setCtrl(idx, hashTag(hash));
+		new ((void *)&_slots[idx]) Node(old_slots[ctr]);
+		old_slots[ctr].~Node();
+	}
+
+	delete[] old_ctrl;
+	free(old_slots);
+}
+
+template<class Key, class Val, class HashFunc, class EqualFunc>
+typename FlatHashMap<Key, Val, HashFunc, EqualFunc>::size_type FlatHashMap<Key, Val, HashFunc, EqualFunc>::lookup(const Key &key, size_type hash) const {
+	const byte tag = hashTag(hash);
+	size_type pos = hash & _mask;
+
+	// Probe the groups in triangular order, which visits every slot since
+	// the capacity is a power of two.
+	for (size_type step = FLATHASHMAP_GROUP_SIZE; ; step += FLATHASHMAP_GROUP_SIZE) {
+		const uint64 group = loadGroup(pos);
+
+		for (uint64 match = matchTag(group, tag); match; match &= match - 1) {
+			const size_type idx = (pos + firstMatch(match)) & _mask;
+			// matchTag may report false positives next to real matches
+			if (_ctrl[idx] == tag && _equal(_slots[idx]._key, key))
+				return idx;
+		}
+
+		// The table always keeps some empty slots, so this terminates
+		if (matchEmpty(group))
+			return (size_type)FLATHASHMAP_NOT_FOUND;
+
+		pos = (pos + step) & _mask;
+	}
+}
+
+template<class Key, class Val, class HashFunc, class EqualFunc>
+typename FlatHashMap<Key, Val, HashFunc, EqualFunc>::size_type FlatHashMap<Key, Val, HashFunc, EqualFunc>::findFreeSlot(size_type hash) const {
+	size_type pos = hash & _mask;
+	for (size_type step = FLATHASHMAP_GROUP_SIZE; ; step += FLATHASHMAP_GROUP_SIZE) {
+		const uint64 match = matchEmptyOrDeleted(loadGroup(pos));
+		if (match)
+			return (pos + firstMatch(match)) & _mask;
+
+		pos = (pos + step) & _mask;
+	}
+}
+
+template<class Key, class Val, class HashFunc, class EqualFunc>
+typename FlatHashMap<Key, Val, HashFunc, EqualFunc>::size_type FlatHashMap<Key, Val, HashFunc, EqualFunc>::lookupAndCreateIfMissing(const Key &key) {
+	const size_type hash = _hash(key);
+	size_type ctr = lookup(key, hash);
+	if (ctr != (size_type)FLATHASHMAP_NOT_FOUND)
+		return ctr;
+
+	// Keep the load factor below a certain threshold.
+	// Deleted slots are also counted, but if they are the main reason for
+	// going over it, dropping them is enough.
+	size_type capacity = _mask + 1;
+	if ((_size + _deleted + 1) * FLATHASHMAP_LOADFACTOR_DENOMINATOR >
+	        capacity * FLATHASHMAP_LOADFACTOR_NUMERATOR) {
+		if ((_size + 1) * FLATHASHMAP_LOADFACTOR_DENOMINATOR * 2 >
+		        capacity * FLATHASHMAP_LOADFACTOR_NUMERATOR)
+			capacity = capacity < 512 ? (capacity * 4) : (capacity * 2);
+		rehash(capacity);
+	}
+
+	ctr = findFreeSlot(hash);
+	if (_ctrl[ctr] == FLATHASHMAP_CTRL_DELETED)
+		_deleted--;
+	setCtrl(ctr, hashTag(hash));
+	new ((void *)&_slots[ctr]) Node(key);
+	_size++;
+
+	return ctr;
+}
+
+template<class Key, class Val, class HashFunc, class EqualFunc>
+void FlatHashMap<Key, Val, HashFunc, EqualFunc>::eraseSlot(size_type idx) {
+	assert(idx <= _mask);
+	assert(isFull(_ctrl[idx]));
+
+	_slots[idx].~Node();
+	_size--;
+
+	// Lookups stop at the first group containing an empty slot. If every
+	// group of GROUP_SIZE slots covering this one has an empty slot, no
+	// probe sequence ever went past it, so it does not need to be kept as
+	// deleted.
+	const uint64 emptyBefore = matchEmpty(loadGroup((idx - FLATHASHMAP_GROUP_SIZE) & _mask));
+	const uint64 emptyAfter = matchEmpty(loadGroup(idx));
+	if (emptyBefore && emptyAfter &&
+	        (FLATHASHMAP_GROUP_SIZE - 1 - lastMatch(emptyBefore)) + firstMatch(emptyAfter) < FLATHASHMAP_GROUP_SIZE) {
+		setCtrl(idx, FLATHASHMAP_CTRL_EMPTY);
+	} else {
+		setCtrl(idx, FLATHASHMAP_CTRL_DELETED);
+		_deleted++;
+	}
+}
+
+/**
+ * Check whether the hashmap contains the given key.
+ */
+template<class Key, class Val, class HashFunc, class EqualFunc>
+bool FlatHashMap<Key, Val, HashFunc, EqualFunc>::contains(const Key &key) const {
+	return lookup(key) != (size_type)FLATHASHMAP_NOT_FOUND;
+}
+
+/**
+ * Get a value from the hashmap.
+ */
+template<class Key, class Val, class HashFunc, class EqualFunc>
+Val &FlatHashMap<Key, Val, HashFunc, EqualFunc>::operator[](const Key &key) {
+	return getOrCreateVal(key);
+}
+
+/**
+ * @overload
+ */
+template<class Key, class Val, class HashFunc, class EqualFunc>
+const Val &FlatHashMap<Key, Val, HashFunc, EqualFunc>::operator[](const Key &key) const {
+	return getVal(key);
+}
+
+/**
+ * Get a value from the hashmap.
+ */
+template<class Key, class Val, class HashFunc, class EqualFunc>
+Val &FlatHashMap<Key, Val, HashFunc, EqualFunc>::getOrCreateVal(const Key &key) {
+	// The table may be reallocated, so look it up before accessing _slots
+	size_type ctr = lookupAndCreateIfMissing(key);
+	return _slots[ctr]._value;
+}
+
+/**
+ * @overload
+ */
+template<class Key, class Val, class HashFunc, class EqualFunc>
+Val &FlatHashMap<Key, Val, HashFunc, EqualFunc>::getVal(const Key &key) {
+	size_type ctr = lookup(key);
+	if (ctr != (size_type)FLATHASHMAP_NOT_FOUND)
+		return _slots[ctr]._value;
+	else
+		// See comment in HashMap::getVal().
+#ifdef RELEASE_BUILD
+		return _defaultVal;
+#else
+		unknownKeyError(key);
+#endif
+}
+
+template<class Key, class Val, class HashFunc, class EqualFunc>
+const Val &FlatHashMap<Key, Val, HashFunc, EqualFunc>::getVal(const Key &key) const {
+	size_type ctr = lookup(key);
+	if (ctr != (size_type)FLATHASHMAP_NOT_FOUND)
+		return _slots[ctr]._value;
+	else
+		// See comment in HashMap::getVal().
+#ifdef RELEASE_BUILD
+		return _defaultVal;
+#else
+		unknownKeyError(key);
+#endif
+}
+
+template<class Key, class Val, class HashFunc, class EqualFunc>
+const Val &FlatHashMap<Key, Val, HashFunc, EqualFunc>::getValOrDefault(const Key &key) const {
+	return getValOrDefault(key, _defaultVal);
+}
+
+/**
+ * Get a value from the hashmap. If the key is not present, then return @p defaultVal.
+ */
+template<class Key, class Val, class HashFunc, class EqualFunc>
+const Val &FlatHashMap<Key, Val, HashFunc, EqualFunc>::getValOrDefault(const Key &key, const Val &defaultVal) const {
+	size_type ctr = lookup(key);
+	if (ctr != (size_type)FLATHASHMAP_NOT_FOUND)
+		return _slots[ctr]._value;
+	else
+		return defaultVal;
+}
+
+template<class Key, class Val, class HashFunc, class EqualFunc>
+bool FlatHashMap<Key, Val, HashFunc, EqualFunc>::tryGetVal(const Key &key, Val &out) const {
+	size_type ctr = lookup(key);
+	if (ctr != (size_type)FLATHASHMAP_NOT_FOUND) {
+		out = _slots[ctr]._value;
+		return true;
+	} else {
+		return false;
+	}
+}
+
+/**
+ * Assign an element specified by @p key to a value @p val.
+ */
+template<class Key, class Val, class HashFunc, class EqualFunc>
+void FlatHashMap<Key, Val, HashFunc, EqualFunc>::setVal(const Key &key, const Val &val) {
+	size_type ctr = lookupAndCreateIfMissing(key);
+	_slots[ctr]._value = val;
+}
+
+/**
+ * Erase an element referred to by an iterator.
+ */
+template<class Key, class Val, class HashFunc, class EqualFunc>
+void FlatHashMap<Key, Val, HashFunc, EqualFunc>::erase(iterator entry) {
+	// Check whether we have a valid iterator
+	assert(entry._hashmap == this);
+	eraseSlot(entry._idx);
+}
+
+/**
+ * Erase an element specified by a key.
+ */
+template<class Key, class Val, class HashFunc, class EqualFunc>
+void FlatHashMap<Key, Val, HashFunc, EqualFunc>::erase(const Key &key) {
+	size_type ctr = lookup(key);
+	if (ctr != (size_type)FLATHASHMAP_NOT_FOUND)
+		eraseSlot(ctr);
+}
+
+/** @} */
+
+} // End of namespace Common
+
+#endif
@@ -252,6 +252,18 @@ public:
 	 */
 	bool isWritable() const;
 
+	/**
+	 * Retrieve the size and the time of the last modification of the file
+	 * referred by this node, without opening it.
+	 *
+	 * The modification time is given in seconds, and is only meant to be
+	 * compared against earlier values for the same file. Not all backends
+	 * provide this information.
+	 *
+	 * @return True if the information is available, false otherwise.
+	 */
+	bool getFileStats(int64 &size, int64 &modificationTime) const;
+
 	/**
 	 * Create a SeekableReadStream instance corresponding to the file
 	 * referred by this node. This assumes that the node actually refers
@@ -0,0 +1,111 @@
+/* ScummVM - Graphic Adventure Engine
+ *
+ * ScummVM is the legal property of its developers, whose names
+ * are too numerous to list here. Please refer to the COPYRIGHT
+ * file distributed with this source distribution.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#ifndef COMMON_SPSCQUEUE_H
+#define COMMON_SPSCQUEUE_H
+
+#include "common/scummsys.h"
+#include "common/atomic.h"
+
+namespace Common {
+
+/**
+ * @defgroup common_spscqueue Lock-free queue
+ * @ingroup common
+ *
+ * @brief Fixed size queue for passing data between two threads.
+ * @{
+ */
+
+/**
+ * Fixed size ring buffer which one producer thread and one consumer thread
+ * can access concurrently without locking.
+ *
+ * If several threads need to push (or pop), they must serialize among
+ * themselves, e.g. with a Common::Mutex which is never taken on the other
+ * side of the queue.
+ *
+ * @tparam T    Element type. Must be copy-assignable.
+ * @tparam SIZE Capacity of the queue. Must be a power of two.
+ */
+template<class T, uint SIZE>
+class SPSCQueue : NonCopyable {
+	static_assert(SIZE != 0 && (SIZE & (SIZE - 1)) == 0, "SPSCQueue size must be a power of two");
+
+public:
+	SPSCQueue() : _head(0), _tail(0) {}
+
+	/**
+	 * Append an element. Must only be called from the producer thread.
+	 *
+	 * @return False if the queue is full.
+	 */
+	bool push(const T &x) {
+		const uint32 tail = _tail.load();
+		if (tail - _head.load() == SIZE)
+			return false;
+
+		_storage[tail & (SIZE - 1)] = x;
+		_tail.store(tail + 1);
+		return true;
+	}
+
+	/**
+	 * Remove the oldest element. Must only be called from the consumer thread.
+	 *
+	 * @return False if the queue is empty.
+	 */
+	bool pop(T &x) {
+		const uint32 head = _head.load();
+		if (head == _tail.load())
+			return false;
+
+		x = _storage[head & (SIZE - 1)];
+		_head.store(head + 1);
+		return true;
+	}
+
+	/** Check whether the queue is empty (a snapshot, only reliable on the consumer side). */
+	bool empty() const {
+		return _head.load() == _tail.load();
+	}
+
+	/** Number of queued elements (a snapshot). */
+	uint size() const {
+		return _tail.load() - _head.load();
+	}
+
+	/** Maximum number of elements the queue can hold. */
+	uint capacity() const {
+		return SIZE;
+	}
+
+private:
+	T _storage[SIZE];
+	Atomic<uint32> _head; ///< Index of the next element to pop, only written by the consumer
+	Atomic<uint32> _tail; ///< Index of the next free slot, only written by the producer
+};
+
+/** @} */
+
+} // End of namespace Common
+
+#endif
@@ -20,48 +20,28 @@
  */
 
 #include "common/str-base.h"
+#include "common/atomic.h"
 #include "common/hash-str.h"
 #include "common/list.h"
-#include "common/memorypool.h"
 #include "common/textconsole.h"
 #include "common/util.h"
-#include "common/mutex.h"
 
 namespace Common {
 
 #define TEMPLATE template<class T>
 #define BASESTRING BaseString<T>
 
-MemoryPool *g_refCountPool = nullptr; // FIXME: This is never freed right now
-#ifndef SCUMMVM_UTIL
-Mutex *g_refCountPoolMutex = nullptr;
-
-void lockMemoryPoolMutex() {
-	// The Mutex class can only be used once g_system is set and initialized,
-	// but we may use the String class earlier than that (it is for example
-	// used in the OSystem_POSIX constructor). However in those early stages
-	// we can hope we don't have multiple threads either.
-	if (!g_system || !g_system->backendInitialized())
-		return;
-	if (!g_refCountPoolMutex)
-		g_refCountPoolMutex = new Mutex();
-	g_refCountPoolMutex->lock();
-}
-
-void unlockMemoryPoolMutex() {
-	if (g_refCountPoolMutex)
-		g_refCountPoolMutex->unlock();
-}
+/**
+ * The reference count of a heap storage block. It is stored right before the
+ * characters, so that both are allocated at once, and is updated atomically,
+ * so that strings can share storage across threads without a lock.
+ */
+typedef Atomic<int> RefCount;
 
-TEMPLATE void BASESTRING::releaseMemoryPoolMutex() {
-	if (g_refCountPoolMutex){
-		delete g_refCountPoolMutex;
-		g_refCountPoolMutex = nullptr;
-	}
+static inline RefCount *getRefCount(void *str) {
+	return (RefCount *)((byte *)str - sizeof(RefCount));
 }
 
-#endif
-
 static uint32 computeCapacity(uint32 len) {
 	// By default, for the capacity we use the next multiple of 32
 	return ((len + 32 - 1) & ~0x1F);
@@ -77,7 +57,6 @@ BASESTRING::BaseString(const BASESTRING &str)
 	} else {
 		// String in external storage: use refcount mechanism
 		str.incRefCount();
-		_extern._refCount = str._extern._refCount;
 		_extern._capacity = str._extern._capacity;
 		_str = str._str;
 	}
@@ -120,20 +99,19 @@ TEMPLATE BASESTRING::BaseString(const value_type *beginP, const value_type *endP
 }
 
 TEMPLATE BASESTRING::~BaseString() {
-	decRefCount(_extern._refCount);
+	decRefCount();
 }
 
 TEMPLATE void BASESTRING::ensureCapacity(uint32 new_size, bool keep_old) {
 	bool isShared;
 	uint32 curCapacity, newCapacity;
 	value_type *newStorage;
-	int *oldRefCount = _extern._refCount;
 
 	if (isStorageIntern()) {
 		isShared = false;
 		curCapacity = _builtinCapacity;
 	} else {
-		isShared = (oldRefCount && *oldRefCount > 1);
+		isShared = (getRefCount(_str)->load() > 1);
 		curCapacity = _extern._capacity;
 	}
 
@@ -157,8 +135,7 @@ TEMPLATE void BASESTRING::ensureCapacity(uint32 new_size, bool keep_old) {
 			newCapacity = MAX(curCapacity * 2, computeCapacity(new_size + 1));
 
 		// Allocate new storage
-		newStorage = new value_type[newCapacity];
-		assert(newStorage);
+		newStorage = allocStorage(newCapacity);
 	}
 
 	// Copy old data if needed, elsewise reset the new storage.
@@ -171,69 +148,44 @@ TEMPLATE void BASESTRING::ensureCapacity(uint32 new_size, bool keep_old) {
 	}
 
 	// Release hold on the old storage ...
-	decRefCount(oldRefCount);
+	decRefCount();
 
 	// ... in favor of the new storage
 	_str = newStorage;
 
 	if (!isStorageIntern()) {
-		// Set the ref count & capacity if we use an external storage.
+		// Set the capacity if we use an external storage.
 		// It is important to do this *after* copying any old content,
 		// else we would override data that has not yet been copied!
-		_extern._refCount = nullptr;
 		_extern._capacity = newCapacity;
 	}
 }
 
+TEMPLATE
+typename BASESTRING::value_type *BASESTRING::allocStorage(uint32 capacity) {
+	byte *block = new byte[sizeof(RefCount) + capacity * sizeof(value_type)];
+	assert(block);
+
+	// The storage is only referenced by the string allocating it
+	new (block) RefCount(1);
+	return (value_type *)(block + sizeof(RefCount));
+}
+
 TEMPLATE
 void BASESTRING::incRefCount() const {
 	assert(!isStorageIntern());
-	if (_extern._refCount == nullptr) {
-#ifndef SCUMMVM_UTIL
-		lockMemoryPoolMutex();
-#endif
-		if (g_refCountPool == nullptr) {
-			g_refCountPool = new MemoryPool(sizeof(int));
-			assert(g_refCountPool);
-		}
-
-		_extern._refCount = (int *)g_refCountPool->allocChunk();
-#ifndef SCUMMVM_UTIL
-		unlockMemoryPoolMutex();
-#endif
-		*_extern._refCount = 2;
-	} else {
-		++(*_extern._refCount);
-	}
+	getRefCount(_str)->fetchAdd(1);
 }
 
 TEMPLATE
-void BASESTRING::decRefCount(int *oldRefCount) {
+void BASESTRING::decRefCount() {
 	if (isStorageIntern())
 		return;
 
-	if (oldRefCount) {
-		--(*oldRefCount);
-	}
-	if (!oldRefCount || *oldRefCount <= 0) {
+	if (getRefCount(_str)->fetchSub(1) == 1) {
 		// The ref count reached zero, so we free the string storage
-		// and the ref count storage.
-		if (oldRefCount) {
-#ifndef SCUMMVM_UTIL
-			lockMemoryPoolMutex();
-#endif
-			assert(g_refCountPool);
-			g_refCountPool->freeChunk(oldRefCount);
-#ifndef SCUMMVM_UTIL
-			unlockMemoryPoolMutex();
-#endif
-		}
-		// Coverity thinks that we always free memory, as it assumes
-		// (correctly) that there are cases when oldRefCount == 0
-		// Thus, DO NOT COMPILE, trick it and shut tons of false positives
-#ifndef __COVERITY__
-		delete[] _str;
-#endif
+		// together with the ref count.
+		delete[] (byte *)getRefCount(_str);
 
 		// Even though _str points to a freed memory block now,
 		// we do not change its value, because any code that calls
@@ -251,9 +203,7 @@ TEMPLATE void BASESTRING::initWithValueTypeStr(const value_type *str, uint32 len
 	if (len >= _builtinCapacity) {
 		// Not enough internal storage, so allocate more
 		_extern._capacity = computeCapacity(len + 1);
-		_extern._refCount = nullptr;
-		_str = new value_type[_extern._capacity];
-		assert(_str != nullptr);
+		_str = allocStorage(_extern._capacity);
 	}
 
 	// Copy the string into the storage area
@@ -487,7 +437,7 @@ TEMPLATE typename BASESTRING::iterator BASESTRING::erase(iterator it) {
 }
 
 TEMPLATE void BASESTRING::clear() {
-	decRefCount(_extern._refCount);
+	decRefCount();
 
 	_size = 0;
 	_str = _storage;
@@ -507,15 +457,14 @@ TEMPLATE void BASESTRING::assign(const BaseString &str) {
 		return;
 
 	if (str.isStorageIntern()) {
-		decRefCount(_extern._refCount);
+		decRefCount();
 		_size = str._size;
 		_str = _storage;
 		memcpy(_str, str._str, (_size + 1) * sizeof(value_type));
 	} else {
 		str.incRefCount();
-		decRefCount(_extern._refCount);
+		decRefCount();
 
-		_extern._refCount = str._extern._refCount;
 		_extern._capacity = str._extern._capacity;
 		_size = str._size;
 		_str = str._str;
@@ -526,7 +475,7 @@ TEMPLATE void BASESTRING::assign(BaseString &&str) {
 	if (&str == this)
 		return;
 
-	decRefCount(_extern._refCount);
+	decRefCount();
 
 	if (str.isStorageIntern()) {
 		_str = _storage;
@@ -544,7 +493,7 @@ TEMPLATE void BASESTRING::assign(BaseString &&str) {
 }
 
 TEMPLATE void BASESTRING::assign(value_type c) {
-	decRefCount(_extern._refCount);
+	decRefCount();
 	_str = _storage;
 
 	_str[0] = c;
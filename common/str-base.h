@@ -31,8 +31,6 @@ namespace Common {
 template<class T>
 class BaseString {
 public:
-	static void releaseMemoryPoolMutex();
-
 	static const uint32 npos = 0xFFFFFFFF;
 	typedef T          value_type;
 	typedef T *        iterator;
@@ -55,7 +53,8 @@ protected:
 
 	/**
 	 * Pointer to the actual string storage. Either points to _storage,
-	 * or to a block allocated on the heap via malloc.
+	 * or into a block allocated on the heap, right after the reference
+	 * count of the block.
 	 */
 	value_type  *_str;
 
@@ -66,12 +65,11 @@ protected:
 		 */
 		value_type _storage[_builtinCapacity];
 		/**
-		 * External string storage data -- the refcounter, and the
-		 * capacity of the string _str points to.
+		 * External string storage data -- the capacity of the string
+		 * _str points to.
 		 */
 		struct {
-			mutable int *_refCount;
-			uint32       _capacity;
+			uint32 _capacity;
 		} _extern;
 	};
 
@@ -337,8 +335,9 @@ protected:
 	}
 
 	void ensureCapacity(uint32 new_size, bool keep_old);
+	static value_type *allocStorage(uint32 capacity);
 	void incRefCount() const;
-	void decRefCount(int *oldRefCount);
+	void decRefCount();
 	void initWithValueTypeStr(const value_type *str, uint32 len);
 
 	void assignInsert(const value_type *str, uint32 p);
@@ -57,7 +57,10 @@ class MutexInternal;
 struct Rect;
 class SaveFileManager;
 class SearchSet;
+class SemaphoreInternal;
 class String;
+class ThreadInternal;
+typedef void (*ThreadProc)(void *data);
 #if defined(USE_TASKBAR)
 class TaskbarManager;
 #endif
@@ -1612,6 +1615,45 @@ public:
 	/** @} */
 
 
+	/**
+	 * @defgroup common_system_thread Worker threads
+	 * @ingroup common_system
+	 * @{
+	 *
+	 * Backends may optionally allow running work on additional threads, to
+	 * make use of multiple CPU cores. Nothing depends on this: when these
+	 * methods are not implemented, Common::ThreadPool runs all work on the
+	 * calling thread instead.
+	 *
+	 * Code running on a worker thread must not call into the OSystem API,
+	 * except for the mutex, thread and semaphore functions.
+	 */
+
+	/**
+	 * Start a new thread running the given procedure.
+	 *
+	 * @return The new thread, or nullptr if threads are not supported
+	 *         or an error occurred.
+	 */
+	virtual Common::ThreadInternal *createThread(Common::ThreadProc proc, void *data) { return nullptr; }
+
+	/**
+	 * Create a new semaphore, with a count of zero.
+	 *
+	 * Must be implemented by backends implementing createThread().
+	 *
+	 * @return The newly created semaphore, or nullptr if an error occurred.
+	 */
+	virtual Common::SemaphoreInternal *createSemaphore() { return nullptr; }
+
+	/**
+	 * Return the number of CPU cores available to run threads on.
+	 */
+	virtual uint getCPUCount() { return 1; }
+
+	/** @} */
+
+
 
 	/** @defgroup common_system_sound Sound
 	 *  @ingroup common_system
@@ -0,0 +1,72 @@
+/* ScummVM - Graphic Adventure Engine
+ *
+ * ScummVM is the legal property of its developers, whose names
+ * are too numerous to list here. Please refer to the COPYRIGHT
+ * file distributed with this source distribution.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#ifndef COMMON_THREAD_H
+#define COMMON_THREAD_H
+
+#include "common/scummsys.h"
+
+namespace Common {
+
+/**
+ * @defgroup common_thread Threads
+ * @ingroup common
+ *
+ * @brief Backend interfaces for worker threads.
+ *
+ * These are created through OSystem::createThread() and
+ * OSystem::createSemaphore(). Most code should not use them directly, but
+ * go through Common::ThreadPool, which also handles backends without
+ * thread support.
+ * @{
+ */
+
+/** Entry point of a thread. */
+typedef void (*ThreadProc)(void *data);
+
+class ThreadInternal {
+public:
+	/** A thread must have been joined before it is deleted. */
+	virtual ~ThreadInternal() {}
+
+	/** Wait until the thread procedure returns. */
+	virtual bool join() = 0;
+};
+
+/**
+ * Counting semaphore, initially zero.
+ */
+class SemaphoreInternal {
+public:
+	virtual ~SemaphoreInternal() {}
+
+	/** Increment the count, waking up a waiting thread if any. */
+	virtual void post() = 0;
+
+	/** Wait until the count is positive, then decrement it. */
+	virtual void wait() = 0;
+};
+
+/** @} */
+
+} // End of namespace Common
+
+#endif
@@ -0,0 +1,159 @@
+/* ScummVM - Graphic Adventure Engine
+ *
+ * ScummVM is the legal property of its developers, whose names
+ * are too numerous to list here. Please refer to the COPYRIGHT
+ * file distributed with this source distribution.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include "common/threadpool.h"
+#include "common/system.h"
+#include "common/textconsole.h"
+
+namespace Common {
+
+ThreadPoolJob::~ThreadPoolJob() {
+	delete _semaphore;
+}
+
+ThreadPool::ThreadPool(uint numThreads) : _jobsAvailable(nullptr), _quit(false) {
+	if (numThreads == 0)
+		numThreads = g_system->getCPUCount();
+
+	// The thread waiting for results helps running jobs, so it counts as
+	// one of the threads
+	if (numThreads <= 1)
+		return;
+
+	_jobsAvailable = g_system->createSemaphore();
+	if (!_jobsAvailable)
+		return;
+
+	for (uint i = 0; i < numThreads - 1; i++) {
+		ThreadInternal *thread = g_system->createThread(workerProc, this);
+		if (!thread)
+			break;
+		_threads.push_back(thread);
+	}
+
+	if (_threads.empty()) {
+		delete _jobsAvailable;
+		_jobsAvailable = nullptr;
+	}
+}
+
+ThreadPool::~ThreadPool() {
+	if (_threads.empty())
+		return;
+
+	{
+		StackLock lock(_mutex);
+		_quit = true;
+	}
+
+	// Workers only quit once the queue is empty
+	for (uint i = 0; i < _threads.size(); i++)
+		_jobsAvailable->post();
+
+	for (uint i = 0; i < _threads.size(); i++) {
+		_threads[i]->join();
+		delete _threads[i];
+	}
+
+	delete _jobsAvailable;
+}
+
+void ThreadPool::enqueue(ThreadPoolJob *job) {
+	if (_threads.empty()) {
+		job->run();
+		job->_done.store(1);
+		return;
+	}
+
+	job->_semaphore = g_system->createSemaphore();
+	if (!job->_semaphore) {
+		warning("ThreadPool: Failed to create semaphore, running job synchronously");
+		job->run();
+		job->_done.store(1);
+		return;
+	}
+
+	// One reference for the queue, the other one for the future
+	job->incRef();
+
+	{
+		StackLock lock(_mutex);
+		_jobs.push(job);
+	}
+	_jobsAvailable->post();
+}
+
+void ThreadPool::runJob(ThreadPoolJob *job) {
+	job->run();
+	job->_done.store(1);
+	job->_semaphore->post();
+	job->decRef();
+}
+
+bool ThreadPool::runQueuedJob() {
+	ThreadPoolJob *job;
+	{
+		StackLock lock(_mutex);
+		if (_jobs.empty())
+			return false;
+		job = _jobs.pop();
+	}
+
+	runJob(job);
+	return true;
+}
+
+void ThreadPool::wait(ThreadPoolJob &job) {
+	while (!job.isDone()) {
+		// Rather than blocking, help with queued jobs. Once none are left,
+		// the awaited job is running on a worker thread.
+		if (runQueuedJob())
+			continue;
+
+		job._semaphore->wait();
+		// Let other waiters through as well
+		job._semaphore->post();
+	}
+}
+
+void ThreadPool::workerProc(void *data) {
+	ThreadPool *pool = (ThreadPool *)data;
+
+	for (;;) {
+		pool->_jobsAvailable->wait();
+
+		ThreadPoolJob *job;
+		{
+			StackLock lock(pool->_mutex);
+			if (pool->_jobs.empty()) {
+				// Jobs may have been taken by threads waiting for results
+				if (pool->_quit)
+					return;
+				continue;
+			}
+			job = pool->_jobs.pop();
+		}
+
+		runJob(job);
+	}
+}
+
+} // End of namespace Common
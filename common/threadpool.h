@@ -0,0 +1,278 @@
+/* ScummVM - Graphic Adventure Engine
+ *
+ * ScummVM is the legal property of its developers, whose names
+ * are too numerous to list here. Please refer to the COPYRIGHT
+ * file distributed with this source distribution.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#ifndef COMMON_THREADPOOL_H
+#define COMMON_THREADPOOL_H
+
+#include "common/array.h"
+#include "common/atomic.h"
+#include "common/mutex.h"
+#include "common/noncopyable.h"
+#include "common/queue.h"
+#include "common/thread.h"
+
+namespace Common {
+
+/**
+ * @defgroup common_threadpool Thread pool
+ * @ingroup common
+ *
+ * @brief Run independent pieces of work on worker threads.
+ * @{
+ */
+
+class ThreadPool;
+
+/**
+ * A unit of work queued on a ThreadPool. Jobs are reference counted, as they
+ * are shared between the pool and the Future waiting for their result.
+ */
+class ThreadPoolJob : NonCopyable {
+public:
+	ThreadPoolJob() : _refCount(1), _done(0), _semaphore(nullptr) {}
+	virtual ~ThreadPoolJob();
+
+	virtual void run() = 0;
+
+	bool isDone() const { return _done.load() != 0; }
+
+	void incRef() { _refCount.fetchAdd(1); }
+	void decRef() {
+		if (_refCount.fetchSub(1) == 1)
+			delete this;
+	}
+
+private:
+	friend class ThreadPool;
+
+	Atomic<uint32> _refCount;
+	Atomic<uint32> _done;
+	SemaphoreInternal *_semaphore;
+};
+
+/** Job producing a result of type T. */
+template<class T>
+class ThreadPoolResultJob : public ThreadPoolJob {
+public:
+	T _result;
+};
+
+template<class T, class F>
+class ThreadPoolFunctionJob : public ThreadPoolResultJob<T> {
+public:
+	explicit ThreadPoolFunctionJob(const F &func) : _func(func) {}
+	void run() override { this->_result = _func(); }
+
+private:
+	F _func;
+};
+
+template<class F>
+class ThreadPoolFunctionJob<void, F> : public ThreadPoolJob {
+public:
+	explicit ThreadPoolFunctionJob(const F &func) : _func(func) {}
+	void run() override { _func(); }
+
+private:
+	F _func;
+};
+
+/**
+ * Handle for the result of a job submitted to a ThreadPool.
+ *
+ * A future must not outlive its pool, and must only be waited for by one
+ * thread at a time.
+ */
+template<class T, class Job = ThreadPoolResultJob<T> >
+class FutureBase {
+public:
+	FutureBase() : _pool(nullptr), _job(nullptr) {}
+	FutureBase(const FutureBase &other) : _pool(other._pool), _job(other._job) {
+		if (_job)
+			_job->incRef();
+	}
+	~FutureBase() {
+		if (_job)
+			_job->decRef();
+	}
+
+	FutureBase &operator=(const FutureBase &other) {
+		if (other._job)
+			other._job->incRef();
+		if (_job)
+			_job->decRef();
+		_pool = other._pool;
+		_job = other._job;
+		return *this;
+	}
+
+	/** Return true if this future refers to a job. */
+	bool isValid() const { return _job != nullptr; }
+
+	/** Return true if the job has finished. */
+	bool isReady() const { return _job && _job->isDone(); }
+
+	/**
+	 * Wait for the job to finish. While waiting, the calling thread helps
+	 * running queued jobs.
+	 */
+	void wait() const;
+
+protected:
+	friend class ThreadPool;
+
+	FutureBase(ThreadPool *pool, Job *job) : _pool(pool), _job(job) {}
+
+	ThreadPool *_pool;
+	Job *_job;
+};
+
+template<class T>
+class Future : public FutureBase<T> {
+public:
+	Future() {}
+
+	/** Wait for the job to finish and return its result. */
+	const T &get() const {
+		this->wait();
+		return this->_job->_result;
+	}
+
+private:
+	friend class ThreadPool;
+
+	Future(ThreadPool *pool, ThreadPoolResultJob<T> *job) : FutureBase<T>(pool, job) {}
+};
+
+template<>
+class Future<void> : public FutureBase<void, ThreadPoolJob> {
+public:
+	Future() {}
+
+	void get() const { wait(); }
+
+private:
+	friend class ThreadPool;
+
+	Future(ThreadPool *pool, ThreadPoolJob *job) : FutureBase<void, ThreadPoolJob>(pool, job) {}
+};
+
+/**
+ * A fixed set of worker threads running submitted jobs in order.
+ *
+ * If the backend does not support threads (see OSystem::createThread()),
+ * or the pool is created with a single thread, jobs run synchronously when
+ * they are submitted. Code using the pool therefore works the same on all
+ * platforms, and only gets faster where threads are available.
+ *
+ * Jobs must not use the OSystem API besides mutexes, and must synchronize
+ * their accesses to shared data.
+ */
+class ThreadPool : NonCopyable {
+public:
+	/**
+	 * Create a pool.
+	 *
+	 * @param numThreads	Number of threads which may run jobs at the same
+	 *						time, including the thread waiting for the results.
+	 *						0 uses the number of CPU cores.
+	 */
+	explicit ThreadPool(uint numThreads = 0);
+
+	/** Finish all queued jobs and stop the worker threads. */
+	~ThreadPool();
+
+	/** Return the number of worker threads, 0 if jobs run synchronously. */
+	uint getWorkerCount() const { return _threads.size(); }
+
+	/**
+	 * Queue a function object for running on a worker thread.
+	 *
+	 * @return A future providing the return value of the function.
+	 */
+	template<class F>
+	auto submit(const F &func) -> Future<decltype(func())> {
+		typedef decltype(func()) Result;
+		ThreadPoolFunctionJob<Result, F> *job = new ThreadPoolFunctionJob<Result, F>(func);
+		enqueue(job);
+		return Future<Result>(this, job);
+	}
+
+	/**
+	 * Call func(i) for each i in [begin, end), splitting the range between
+	 * the worker threads and the calling thread. Returns once all calls are
+	 * done. The calls must be independent of each other.
+	 */
+	template<class F>
+	void parallelFor(uint begin, uint end, const F &func) {
+		if (begin >= end)
+			return;
+
+		const uint count = end - begin;
+		const uint numChunks = MIN<uint>(count, _threads.size() * 4);
+		if (numChunks <= 1) {
+			for (uint i = begin; i < end; i++)
+				func(i);
+			return;
+		}
+
+		Array<Future<void> > chunks;
+		chunks.reserve(numChunks);
+		for (uint chunk = 0; chunk < numChunks; chunk++) {
+			const uint chunkBegin = begin + (uint)((uint64)count * chunk / numChunks);
+			const uint chunkEnd = begin + (uint)((uint64)count * (chunk + 1) / numChunks);
+			chunks.push_back(submit([&func, chunkBegin, chunkEnd]() {
+				for (uint i = chunkBegin; i < chunkEnd; i++)
+					func(i);
+			}));
+		}
+
+		for (uint chunk = 0; chunk < numChunks; chunk++)
+			chunks[chunk].wait();
+	}
+
+	/** Wait for a job of this pool to finish, see FutureBase::wait(). */
+	void wait(ThreadPoolJob &job);
+
+private:
+	void enqueue(ThreadPoolJob *job);
+	bool runQueuedJob();
+	static void runJob(ThreadPoolJob *job);
+	static void workerProc(void *data);
+
+	Array<ThreadInternal *> _threads;
+	Queue<ThreadPoolJob *> _jobs;
+	Mutex _mutex;
+	SemaphoreInternal *_jobsAvailable;
+	bool _quit;
+};
+
+template<class T, class Job>
+void FutureBase<T, Job>::wait() const {
+	if (_job && !_job->isDone())
+		_pool->wait(*_job);
+}
+
+/** @} */
+
+} // End of namespace Common
+
+#endif
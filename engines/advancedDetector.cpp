@@ -28,8 +28,10 @@
 #include "common/md5.h"
 #include "common/config-manager.h"
 #include "common/punycode.h"
+#include "common/savefile.h"
 #include "common/system.h"
 #include "common/textconsole.h"
+#include "common/threadpool.h"
 #include "common/tokenizer.h"
 #include "common/translation.h"
 #include "common/compression/installshield_cab.h"
@@ -413,6 +415,7 @@ Common::Error AdvancedMetaEngineDetection::createInstance(OSystem *syst, Engine
 
 	// Detection is done, no need to keep archives in memory anymore
 	ADCacheMan.clearArchives();
+	ADCacheMan.flushPersistentMD5Cache(true);
 
 	// If the GUI options were updated, we catch this here and update them in the users config
 	// file transparently.
@@ -517,6 +520,125 @@ namespace Common {
 	DECLARE_SINGLETON(AdvancedDetectorCacheManager);
 }
 
+#define PERSISTENT_MD5_CACHE_FILENAME "scummvm-md5cache.txt"
+#define PERSISTENT_MD5_CACHE_HEADER "ScummVM MD5 cache v1"
+
+// Minimum time between two non-forced writes of the persistent MD5 cache,
+// so that mass adding does not rewrite the file for every directory.
+#define PERSISTENT_MD5_CACHE_FLUSH_INTERVAL 5000
+
+bool AdvancedDetectorCacheManager::loadPersistentMD5Cache() {
+	if (persistentMD5Loaded)
+		return true;
+
+	// Command line detection runs before the backend is initialized
+	Common::SaveFileManager *saveFileMan = g_system->getSavefileManager();
+	if (!saveFileMan)
+		return false;
+
+	persistentMD5Loaded = true;
+
+	Common::InSaveFile *loadFile = saveFileMan->openRawFile(PERSISTENT_MD5_CACHE_FILENAME);
+	if (!loadFile)
+		return true;
+
+	if (loadFile->readLine() != PERSISTENT_MD5_CACHE_HEADER) {
+		delete loadFile;
+		return true;
+	}
+
+	// Each line holds: key, signature, md5, size and md5 properties,
+	// separated by tabs
+	while (!loadFile->eos() && !loadFile->err()) {
+		Common::String line = loadFile->readLine();
+		Common::StringTokenizer tok(line, "\t");
+		Common::String key = tok.nextToken();
+		PersistentMD5Entry entry;
+		entry.signature = tok.nextToken();
+		entry.md5 = tok.nextToken();
+		Common::String size = tok.nextToken();
+		Common::String md5prop = tok.nextToken();
+		if (md5prop.empty() || !tok.empty())
+			continue;
+
+		entry.size = 0;
+		for (const char *c = size.c_str(); Common::isDigit(*c); c++)
+			entry.size = entry.size * 10 + (*c - '0');
+		entry.md5prop = (MD5Properties)atoi(md5prop.c_str());
+		persistentMD5HashMap.setVal(key, entry);
+	}
+	delete loadFile;
+
+	debugC(3, kDebugGlobalDetection, "Loaded %u entries from the MD5 cache", persistentMD5HashMap.size());
+	return true;
+}
+
+bool AdvancedDetectorCacheManager::getPersistentMD5(const Common::String &key, const Common::String &signature, FileProperties &fileProps) {
+	if (!loadPersistentMD5Cache())
+		return false;
+
+	PersistentMD5HashMap::const_iterator entry = persistentMD5HashMap.find(key);
+	if (entry == persistentMD5HashMap.end() || entry->_value.signature != signature) {
+		persistentMD5Misses++;
+		return false;
+	}
+
+	fileProps.md5 = entry->_value.md5;
+	fileProps.size = entry->_value.size;
+	fileProps.md5prop = entry->_value.md5prop;
+	persistentMD5Hits++;
+	return true;
+}
+
+void AdvancedDetectorCacheManager::setPersistentMD5(const Common::String &key, const Common::String &signature, const FileProperties &fileProps) {
+	if (!loadPersistentMD5Cache())
+		return;
+
+	// Replaces any outdated entry for the same file
+	PersistentMD5Entry &entry = persistentMD5HashMap.getOrCreateVal(key);
+	entry.signature = signature;
+	entry.md5 = fileProps.md5;
+	entry.size = fileProps.size;
+	entry.md5prop = fileProps.md5prop;
+	persistentMD5Dirty = true;
+}
+
+void AdvancedDetectorCacheManager::flushPersistentMD5Cache(bool force) {
+	if (!persistentMD5Dirty)
+		return;
+
+	uint32 now = g_system->getMillis();
+	if (!force && persistentMD5LastFlush && now - persistentMD5LastFlush < PERSISTENT_MD5_CACHE_FLUSH_INTERVAL)
+		return;
+
+	Common::WriteStream *saveFile = g_system->getSavefileManager()->openForSaving(PERSISTENT_MD5_CACHE_FILENAME, false);
+	if (!saveFile) {
+		warning("Failed to open " PERSISTENT_MD5_CACHE_FILENAME " for writing");
+		return;
+	}
+
+	saveFile->writeString(PERSISTENT_MD5_CACHE_HEADER "\n");
+	for (PersistentMD5HashMap::const_iterator i = persistentMD5HashMap.begin(); i != persistentMD5HashMap.end(); ++i) {
+		saveFile->writeString(Common::String::format("%s\t%s\t%s\t%lld\t%d\n", i->_key.c_str(),
+			i->_value.signature.c_str(), i->_value.md5.c_str(), (long long)i->_value.size, (int)i->_value.md5prop));
+	}
+	saveFile->finalize();
+	delete saveFile;
+
+	persistentMD5Dirty = false;
+	persistentMD5LastFlush = now;
+}
+
+void AdvancedDetectorCacheManager::printPersistentMD5Stats() {
+	uint32 lookups = persistentMD5Hits + persistentMD5Misses;
+	if (lookups) {
+		debugC(1, kDebugGlobalDetection, "MD5 cache: %u hits, %u misses (%u%% hit rate), %u entries",
+			persistentMD5Hits, persistentMD5Misses, persistentMD5Hits * 100 / lookups, persistentMD5HashMap.size());
+	}
+
+	persistentMD5Hits = persistentMD5Misses = 0;
+}
+
 
 static MD5Properties gameFileToMD5Props(const ADGameFileDescription *fileEntry, uint32 gameFlags) {
 	MD5Properties ret = kMD5Head;
@@ -581,29 +703,179 @@ Common::String md5PropToGameFile(MD5Properties flags) {
 
 static bool getFilePropertiesIntern(uint md5Bytes, const AdvancedMetaEngine::FileMap &allFiles, MD5Properties md5prop, const Common::Path &fname, FileProperties &fileProps);
 
-bool AdvancedMetaEngineDetection::getFileProperties(const FileMap &allFiles, MD5Properties md5prop, const Common::Path &fname, FileProperties &fileProps) const {
+static bool appendFileSignature(const AdvancedMetaEngine::FileMap &allFiles, const Common::Path &fname, Common::String &path, Common::String &signature) {
+	if (!allFiles.contains(fname))
+		return true;
+
+	const Common::FSNode &node = allFiles[fname];
+	int64 size, modificationTime;
+	if (!node.getFileStats(size, modificationTime))
+		return false;
+
+	if (path.empty())
+		path = node.getPath().toString('/');
+	signature += Common::String::format("%lld/%lld;", (long long)size, (long long)modificationTime);
+	return true;
+}
+
+/**
+ * Compute the key of a file in the persistent MD5 cache, and the signature
+ * of the files its MD5 depends on. Returns false if the file cannot be
+ * cached persistently.
+ */
+static bool getPersistentMD5Key(const AdvancedMetaEngine::FileMap &allFiles, MD5Properties md5prop, const Common::Path &fname, uint md5Bytes, Common::String &key, Common::String &signature) {
+	Common::String path;
+
+	if (md5prop & kMD5Archive) {
+		Common::StringTokenizer tok(fname.toString(), ":");
+		tok.nextToken();
+		if (!appendFileSignature(allFiles, Common::Path(tok.nextToken()), path, signature))
+			return false;
+	} else if (md5prop & (kMD5MacResFork | kMD5MacDataFork)) {
+		// The forks may come from any of the files MacResManager looks for
+		if (!appendFileSignature(allFiles, fname, path, signature) ||
+		    !appendFileSignature(allFiles, fname.append(".rsrc"), path, signature) ||
+		    !appendFileSignature(allFiles, fname.append(".bin"), path, signature) ||
+		    !appendFileSignature(allFiles, fname.getParent().appendComponent("._" + fname.baseName()), path, signature))
+			return false;
+	} else {
+		if (!appendFileSignature(allFiles, fname, path, signature))
+			return false;
+	}
+
+	if (path.empty())
+		return false;
+
+	key = Common::String::format("%s:%s:%s:%u", md5PropToCachePrefix(md5prop).c_str(), path.c_str(), fname.toString('/').c_str(), md5Bytes);
+	return true;
+}
+
+Common::String AdvancedMetaEngineDetection::getFilePropertiesCacheKey(MD5Properties md5prop, const Common::Path &fname) const {
 	Common::String hashname = md5PropToCachePrefix(md5prop);
 		hashname += ':';
 		hashname += fname.toString('/');
 		hashname += ':';
 		hashname += Common::String::format("%d", _md5Bytes);
+	return hashname;
+}
+
+bool AdvancedMetaEngineDetection::getFileProperties(const FileMap &allFiles, MD5Properties md5prop, const Common::Path &fname, FileProperties &fileProps) const {
+	Common::String hashname = getFilePropertiesCacheKey(md5prop, fname);
 
 	if (ADCacheMan.containsMD5(hashname)) {
 		fileProps.md5 = ADCacheMan.getMD5(hashname);
 		fileProps.size = ADCacheMan.getSize(hashname);
+		fileProps.md5prop = ADCacheMan.getMD5Prop(hashname);
 		return true;
 	}
 
-	bool res = getFilePropertiesIntern(_md5Bytes, allFiles, md5prop, fname, fileProps);
+	Common::String persistentKey, signature;
+	bool persistent = getPersistentMD5Key(allFiles, md5prop, fname, _md5Bytes, persistentKey, signature);
+
+	bool res;
+	if (persistent && ADCacheMan.getPersistentMD5(persistentKey, signature, fileProps)) {
+		res = true;
+	} else {
+		res = getFilePropertiesIntern(_md5Bytes, allFiles, md5prop, fname, fileProps);
+
+		if (res && persistent)
+			ADCacheMan.setPersistentMD5(persistentKey, signature, fileProps);
+	}
 
 	if (res) {
 		ADCacheMan.setMD5(hashname, fileProps.md5);
 		ADCacheMan.setSize(hashname, fileProps.size);
+		ADCacheMan.setMD5Prop(hashname, fileProps.md5prop);
 	}
 
 	return res;
 }
 
+void AdvancedMetaEngineDetection::prefetchFileProperties(const FileMap &allFiles) const {
+	struct HashRequest {
+		Common::String hashname;
+		Common::Path fname;
+		MD5Properties md5prop;
+		Common::String persistentKey;
+		Common::String signature;
+		bool persistent;
+		FileProperties fileProps;
+	};
+
+	// Collect the candidate files which still need to be hashed, in the
+	// same order as detectGame() would hash them
+	Common::Array<HashRequest> requests;
+	Common::HashMap<Common::String, bool, Common::IgnoreCase_Hash, Common::IgnoreCase_EqualTo> queued;
+
+	for (const byte *descPtr = _gameDescriptors; ((const ADGameDescription *)descPtr)->gameId != nullptr; descPtr += _descItemSize) {
+		const ADGameDescription *g = (const ADGameDescription *)descPtr;
+
+		for (const ADGameFileDescription *fileDesc = g->filesDescriptions; fileDesc->fileName; fileDesc++) {
+			MD5Properties md5prop = gameFileToMD5Props(fileDesc, g->flags);
+
+			// Files in archives share the archive cache, and Mac forks go
+			// through MacResManager, so both stay in the sequential path
+			if (md5prop & (kMD5Archive | kMD5MacResFork | kMD5MacDataFork))
+				continue;
+
+			Common::Path fname(fileDesc->fileName);
+			if (!allFiles.contains(fname))
+				continue;
+
+			Common::String hashname = getFilePropertiesCacheKey(md5prop, fname);
+			if (queued.contains(hashname) || ADCacheMan.containsMD5(hashname))
+				continue;
+			queued[hashname] = true;
+
+			HashRequest request;
+			request.hashname = hashname;
+			request.fname = fname;
+			request.md5prop = md5prop;
+			request.persistent = getPersistentMD5Key(allFiles, md5prop, fname, _md5Bytes, request.persistentKey, request.signature);
+
+			if (request.persistent && ADCacheMan.getPersistentMD5(request.persistentKey, request.signature, request.fileProps)) {
+				ADCacheMan.setMD5(hashname, request.fileProps.md5);
+				ADCacheMan.setSize(hashname, request.fileProps.size);
+				ADCacheMan.setMD5Prop(hashname, request.fileProps.md5prop);
+				continue;
+			}
+
+			requests.push_back(request);
+		}
+	}
+
+	if (requests.size() < 2)
+		return;
+
+	// Only the hashing runs on the worker threads, the results are merged
+	// into the caches in order afterwards
+	Common::ThreadPool pool(MIN<uint>(requests.size(), kMaxParallelHashes));
+	if (!pool.getWorkerCount())
+		return;
+
+	Common::Array<Common::Future<bool> > results;
+	results.reserve(requests.size());
+	for (uint i = 0; i < requests.size(); i++) {
+		HashRequest *request = &requests[i];
+		const uint md5Bytes = _md5Bytes;
+		results.push_back(pool.submit([request, md5Bytes, &allFiles]() {
+			return getFilePropertiesIntern(md5Bytes, allFiles, request->md5prop, request->fname, request->fileProps);
+		}));
+	}
+
+	for (uint i = 0; i < requests.size(); i++) {
+		if (!results[i].get())
+			continue;
+
+		const HashRequest &request = requests[i];
+		ADCacheMan.setMD5(request.hashname, request.fileProps.md5);
+		ADCacheMan.setSize(request.hashname, request.fileProps.size);
+		ADCacheMan.setMD5Prop(request.hashname, request.fileProps.md5prop);
+		if (request.persistent)
+			ADCacheMan.setPersistentMD5(request.persistentKey, request.signature, request.fileProps);
+	}
+}
+
 bool AdvancedMetaEngine::getFilePropertiesExtern(uint md5Bytes, const FileMap &allFiles, MD5Properties md5prop, const Common::Path &fname, FileProperties &fileProps) const {
 	return getFilePropertiesIntern(md5Bytes, allFiles, md5prop, fname, fileProps);
 }
@@ -775,6 +1047,10 @@ ADDetectedGames AdvancedMetaEngineDetection::detectGame(const Common::FSNode &pa
 
 	preprocessDescriptions();
 
+	// Hash the candidate files concurrently first. This only fills the
+	// caches, so the results below are the same as without it.
+	prefetchFileProperties(allFiles);
+
 	// Check which files are included in some ADGameDescription *and* whether
 	// they are present. Compute MD5s and file sizes for the available files.
 	for (descPtr = _gameDescriptors; ((const ADGameDescription *)descPtr)->gameId != nullptr; descPtr += _descItemSize) {
@@ -472,6 +472,20 @@ protected:
 	/** Get the properties (size and MD5) of this file. */
 	bool getFileProperties(const FileMap &allFiles, MD5Properties md5prop, const Common::Path &fname, FileProperties &fileProps) const;
 
+	/**
+	 * Compute the properties of all candidate files of the detection table
+	 * concurrently, and store them in the cache for getFileProperties().
+	 */
+	void prefetchFileProperties(const FileMap &allFiles) const;
+
+private:
+	/** Maximum number of files hashed at the same time by prefetchFileProperties(). */
+	static const uint kMaxParallelHashes = 8;
+
+	Common::String getFilePropertiesCacheKey(MD5Properties md5prop, const Common::Path &fname) const;
+
+protected:
+
 	/** Convert an AD game description into the shared game description format. */
 	virtual DetectedGame toDetectedGame(const ADDetectedGame &adGame, ADDetectedGameExtraInfo *extraInfo = nullptr) const;
 
@@ -591,6 +605,14 @@ public:
 		return sizeHashMap.getVal(fname);
 	}
 
+	void setMD5Prop(const Common::String &fname, MD5Properties md5prop) {
+		md5PropHashMap.setVal(fname, md5prop);
+	}
+
+	MD5Properties getMD5Prop(const Common::String &fname) const {
+		return md5PropHashMap.getValOrDefault(fname, kMD5Head);
+	}
+
 	bool containsMD5(const Common::String &fname) const {
 		return (md5HashMap.contains(fname) && sizeHashMap.contains(fname));
 	}
@@ -612,7 +634,27 @@ public:
 		return archiveHashMap.getValOrDefault(node.getPath(), nullptr);
 	}
 
-	AdvancedDetectorCacheManager() {
+	/**
+	 * Look up an entry in the persistent MD5 cache, which is kept on disk
+	 * across runs. Unlike the other caches, it is keyed on absolute paths.
+	 *
+	 * An entry is only valid as long as its signature, made of the sizes and
+	 * modification times of the files it was computed from, is unchanged.
+	 */
+	bool getPersistentMD5(const Common::String &key, const Common::String &signature, FileProperties &fileProps);
+	void setPersistentMD5(const Common::String &key, const Common::String &signature, const FileProperties &fileProps);
+
+	/**
+	 * Write the persistent MD5 cache to disk if it was modified. Unless
+	 * forced, writes are spaced out to keep mass detection cheap.
+	 */
+	void flushPersistentMD5Cache(bool force);
+
+	/** Print the persistent MD5 cache hit rate since the last call. */
+	void printPersistentMD5Stats();
+
+	AdvancedDetectorCacheManager() : persistentMD5Loaded(false), persistentMD5Dirty(false),
+			persistentMD5LastFlush(0), persistentMD5Hits(0), persistentMD5Misses(0) {
 		clear();
 	}
 
@@ -626,18 +668,38 @@ public:
 	void clear() {
 		md5HashMap.clear(true);
 		sizeHashMap.clear(true);
+		md5PropHashMap.clear(true);
 		clearArchives();
 	}
 
 private:
 	friend class Common::Singleton<AdvancedDetectorCacheManager>;
 
+	struct PersistentMD5Entry {
+		Common::String signature;
+		Common::String md5;
+		int64 size;
+		MD5Properties md5prop;
+	};
+
+	bool loadPersistentMD5Cache();
+
 	typedef Common::HashMap<Common::String, Common::String, Common::IgnoreCase_Hash, Common::IgnoreCase_EqualTo> FileHashMap;
 	typedef Common::HashMap<Common::String, int64, Common::IgnoreCase_Hash, Common::IgnoreCase_EqualTo> SizeHashMap;
+	typedef Common::HashMap<Common::String, MD5Properties, Common::IgnoreCase_Hash, Common::IgnoreCase_EqualTo> MD5PropHashMap;
 	typedef Common::HashMap<Common::Path, Common::Archive *, Common::Path::IgnoreCase_Hash, Common::Path::IgnoreCase_EqualTo> ArchiveHashMap;
 	FileHashMap md5HashMap;
 	SizeHashMap sizeHashMap;
+	MD5PropHashMap md5PropHashMap;
 	ArchiveHashMap archiveHashMap;
+
+	typedef Common::HashMap<Common::String, PersistentMD5Entry> PersistentMD5HashMap;
+	PersistentMD5HashMap persistentMD5HashMap;
+	bool persistentMD5Loaded;
+	bool persistentMD5Dirty;
+	uint32 persistentMD5LastFlush;
+	uint32 persistentMD5Hits;
+	uint32 persistentMD5Misses;
 };
 
 /** Convenience shortcut for accessing the MD5CacheManager. */
@@ -69,6 +69,10 @@ static bool play_video(Video::VideoDecoder *decoder, const char *name, int flags
 		return false;
 	}
 
+	// Decode a few frames ahead on a worker thread where the decoder
+	// supports it, to smooth out frames that are slow to decode
+	decoder->setDecodeAhead(4);
+
 	update_polled_stuff();  // TODO: probably unneeded
 
 	Graphics::Screen scr;
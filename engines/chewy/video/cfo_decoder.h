@@ -39,6 +39,10 @@ public:
 
 	bool loadStream(Common::SeekableReadStream *stream) override;
 
+protected:
+	// Frames trigger sounds, which must be played in sync
+	bool canDecodeAhead() const override { return false; }
+
 private:
 	Sound *_sound;
 	bool _disposeMusic;
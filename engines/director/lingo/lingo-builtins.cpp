@@ -2009,6 +2009,7 @@ void LB::b_clearGlobals(int nargs) {
 			g_lingo->_globalvars.erase(it._key);
 		}
 	}
+	g_lingo->invalidateGlobalSlots();
 }
 
 void LB::b_cursor(int nargs) {
@@ -90,6 +90,8 @@ static struct FuncDescr {
 	{ LC::c_globalinit,		"c_globalinit",		"s" },
 	{ LC::c_globalpush,		"c_globalpush",		"s" },
 	{ LC::c_globalrefpush,	"c_globalrefpush",	"s" },
+	{ LC::c_globalslotassign,"c_globalslotassign","i" },
+	{ LC::c_globalslotpush,	"c_globalslotpush",	"i" },
 	{ LC::c_ge,				"c_ge",				"" },
 	{ LC::c_gt,				"c_gt",				"" },
 	{ LC::c_hilite,			"c_hilite",			"" },
@@ -104,6 +106,8 @@ static struct FuncDescr {
 	{ LC::c_lineToOfRef,	"c_lineToOfRef",	"" },	// D3
 	{ LC::c_localpush,		"c_localpush",		"s" },
 	{ LC::c_localrefpush,	"c_localrefpush",	"s" },
+	{ LC::c_localslotassign,"c_localslotassign","i" },
+	{ LC::c_localslotpush,	"c_localslotpush",	"i" },
 	{ LC::c_lt,				"c_lt",				"" },
 	{ LC::c_mod,			"c_mod",			"" },
 	{ LC::c_mul,			"c_mul",			"" },
@@ -298,6 +302,17 @@ void Lingo::pushContext(const Symbol funcSym, bool allowRetVal, Datum defaultRet
 	}
 	_state->localVars = localvars;
 
+	// Resolve the slots used by c_localslotpush/c_localslotassign. Hash nodes
+	// stay put until the frame's var hash is destroyed in popContext().
+	uint nargs = funcSym.argNames ? funcSym.argNames->size() : 0;
+	uint nvars = funcSym.varNames ? funcSym.varNames->size() : 0;
+	fp->localSlots.resize(nargs + nvars);
+	for (uint i = 0; i < nargs + nvars; i++) {
+		const Common::String &name = i < nargs ? (*funcSym.argNames)[i] : (*funcSym.varNames)[i - nargs];
+		DatumHash::iterator it = localvars->find(name);
+		fp->localSlots[i] = (it != localvars->end()) ? &it->_value : nullptr;
+	}
+
 	fp->stackSizeBefore = _stack.size();
 
 	callstack.push_back(fp);
@@ -534,6 +549,59 @@ void LC::c_proppush() {
 	g_lingo->push(g_lingo->varFetch(d));
 }
 
+static Datum *localSlot(int slot) {
+	Common::Array<CFrame *> &callstack = g_lingo->_state->callstack;
+	if (callstack.empty() || slot < 0 || slot >= (int)callstack.back()->localSlots.size())
+		return nullptr;
+	return callstack.back()->localSlots[slot];
+}
+
+void LC::c_localslotpush() {
+	int slot = g_lingo->readInt();
+	Datum *var = localSlot(slot);
+	if (var) {
+		g_debugger->varReadHook(g_lingo->getLocalSlotName(slot));
+		g_lingo->push(*var);
+		return;
+	}
+	// Not resolved for this frame, take the slow path for the diagnostics
+	Datum d(g_lingo->getLocalSlotName(slot));
+	d.type = LOCALREF;
+	g_lingo->push(g_lingo->varFetch(d));
+}
+
+void LC::c_localslotassign() {
+	int slot = g_lingo->readInt();
+	Datum value = g_lingo->pop();
+	Datum *var = localSlot(slot);
+	if (var) {
+		*var = value;
+		g_debugger->varWriteHook(g_lingo->getLocalSlotName(slot));
+		return;
+	}
+	Datum d(g_lingo->getLocalSlotName(slot));
+	d.type = LOCALREF;
+	g_lingo->varAssign(d, value);
+}
+
+void LC::c_globalslotpush() {
+	int slot = g_lingo->readInt();
+	const Common::String &name = g_lingo->getGlobalSlotName(slot);
+	g_debugger->varReadHook(name);
+	Datum *var = g_lingo->findGlobalSlot(slot, false);
+	if (var) {
+		g_lingo->push(*var);
+		return;
+	}
+	debugC(1, kDebugLingoExec, "c_globalslotpush: global variable %s not defined", name.c_str());
+	g_lingo->push(Datum());
+}
+
+void LC::c_globalslotassign() {
+	int slot = g_lingo->readInt();
+	*g_lingo->findGlobalSlot(slot, true) = g_lingo->pop();
+}
+
 void LC::c_stackpeek() {
 	int peekOffset = g_lingo->readInt();
 	g_lingo->push(g_lingo->peek(peekOffset));
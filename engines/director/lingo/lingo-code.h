@@ -83,6 +83,10 @@ void c_varpush();
 void c_globalinit();
 void c_globalpush();
 void c_localpush();
+void c_localslotpush();
+void c_localslotassign();
+void c_globalslotpush();
+void c_globalslotassign();
 void c_proppush();
 void c_argcpush();
 void c_argcnoretpush();
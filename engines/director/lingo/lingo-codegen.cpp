@@ -99,6 +99,7 @@ LingoCompiler::LingoCompiler() {
 
 	_indef = false;
 	_methodVars = nullptr;
+	_methodArgNames = nullptr;
 
 	_linenumber = _colnumber = _bytenumber = 0;
 	_lines[0] = _lines[1] = _lines[2] = nullptr;
@@ -324,10 +325,66 @@ int LingoCompiler::codeFunc(const Common::String &s, int numpar) {
 
 void LingoCompiler::codeVarSet(const Common::String &name) {
 	registerMethodVar(name);
+	if (codeVarSlotSet(name))
+		return;
 	codeVarRef(name);
 	code1(LC::c_assign);
 }
 
+bool LingoCompiler::codeVarSlotSet(const Common::String &name) {
+	if (!_methodVars->contains(name))
+		return false;
+
+	switch ((*_methodVars)[name]) {
+	case kVarGlobal:
+		code1(LC::c_globalslotassign);
+		codeInt(g_lingo->getGlobalSlot(name));
+		return true;
+	case kVarLocal:
+	case kVarArgument:
+		{
+			int slot = getLocalSlot(name);
+			if (slot < 0)
+				return false;
+			code1(LC::c_localslotassign);
+			codeInt(slot);
+		}
+		return true;
+	default:
+		return false;
+	}
+}
+
+int LingoCompiler::getLocalSlot(const Common::String &name) {
+	// Slots follow the order in which pushContext() creates the frame's
+	// vars: handler arguments first, then locals as they were registered.
+	if (!_indef || !_methodArgNames)
+		return -1;
+	for (uint i = 0; i < _methodArgNames->size(); i++) {
+		if ((*_methodArgNames)[i].equalsIgnoreCase(name))
+			return i;
+	}
+	for (uint i = 0; i < _methodLocalNames.size(); i++) {
+		if (_methodLocalNames[i].equalsIgnoreCase(name))
+			return _methodArgNames->size() + i;
+	}
+	return -1;
+}
+
+bool LingoCompiler::isVarConst(const Common::String &name, int *castNum) {
+	if (castNum)
+		*castNum = -1;
+	if (g_director->getVersion() < 400 || (g_director->getCurrentMovie() && g_director->getCurrentMovie()->_allowOutdatedLingo)) {
+		int val = castNumToNum(name.c_str());
+		if (val != -1) {
+			if (castNum)
+				*castNum = val;
+			return true;
+		}
+	}
+	return g_lingo->_builtinConsts.contains(name);
+}
+
 void LingoCompiler::codeVarRef(const Common::String &name) {
 	VarType type;
 	if (_methodVars->contains(name)) {
@@ -368,10 +425,19 @@ void LingoCompiler::codeVarGet(const Common::String &name) {
 		code1(LC::c_varpush);
 		break;
 	case kVarGlobal:
-		code1(LC::c_globalpush);
-		break;
+		code1(LC::c_globalslotpush);
+		codeInt(g_lingo->getGlobalSlot(name));
+		return;
 	case kVarLocal:
 	case kVarArgument:
+		{
+			int slot = getLocalSlot(name);
+			if (slot >= 0) {
+				code1(LC::c_localslotpush);
+				codeInt(slot);
+				return;
+			}
+		}
 		code1(LC::c_localpush);
 		break;
 	case kVarProperty:
@@ -388,6 +454,8 @@ void LingoCompiler::registerMethodVar(const Common::String &name, VarType type)
 			type = kVarLocal;
 		}
 		(*_methodVars)[name] = type;
+		if (_indef && type == kVarLocal)
+			_methodLocalNames.push_back(name);
 		if (type == kVarProperty || type == kVarInstance) {
 			if (!_assemblyContext->hasProp(name))
 				_assemblyContext->setProp(name, Datum(), true);
@@ -463,6 +531,16 @@ bool LingoCompiler::visitHandlerNode(HandlerNode *node) {
 	VarTypeHash *mainMethodVars = _methodVars;
 	_methodVars = new VarTypeHash;
 
+	Common::Array<Common::String> *argNames = new Common::Array<Common::String>;
+	if (_inFactory) {
+		argNames->push_back("me");
+	}
+	for (uint i = 0; i < node->args->size(); i++) {
+		argNames->push_back(Common::String((*node->args)[i]->c_str()));
+	}
+	_methodArgNames = argNames;
+	_methodLocalNames.clear();
+
 	if (_inFactory) {
 		registerMethodVar("me", kVarArgument);
 	}
@@ -483,18 +561,8 @@ bool LingoCompiler::visitHandlerNode(HandlerNode *node) {
 	if (debugChannelSet(1, kDebugCompile))
 		debug("define handler \"%s\" (len: %d)", node->name->c_str(), _currentAssembly->size() - 1);
 
-	Common::Array<Common::String> *argNames = new Common::Array<Common::String>;
-	if (_inFactory) {
-		argNames->push_back("me");
-	}
-	for (uint i = 0; i < node->args->size(); i++) {
-		argNames->push_back(Common::String((*node->args)[i]->c_str()));
-	}
-	Common::Array<Common::String> *varNames = new Common::Array<Common::String>;
-	for (auto &it : *_methodVars) {
-		if (it._value == kVarLocal)
-			varNames->push_back(Common::String(it._key));
-	}
+	// Keep the registration order, the local slots coded above depend on it.
+	Common::Array<Common::String> *varNames = new Common::Array<Common::String>(_methodLocalNames);
 
 	if (debugChannelSet(1, kDebugCompile)) {
 		debug("Function vars");
@@ -513,6 +581,8 @@ bool LingoCompiler::visitHandlerNode(HandlerNode *node) {
 	_assemblyContext->define(*node->name, _currentAssembly, argNames, varNames);
 
 	_indef = false;
+	_methodArgNames = nullptr;
+	_methodLocalNames.clear();
 	_currentAssembly = mainAssembly;
 	delete _methodVars;
 	_methodVars = mainMethodVars;
@@ -602,6 +672,11 @@ bool LingoCompiler::visitPutIntoNode(PutIntoNode *node) {
 		registerMethodVar(*static_cast<VarNode *>(node->var)->name);
 	}
 	COMPILE(node->val);
+	if (node->var->type == kVarNode) {
+		const Common::String &name = *static_cast<VarNode *>(node->var)->name;
+		if (!isVarConst(name) && codeVarSlotSet(name))
+			return true;
+	}
 	COMPILE_REF(node->var);
 	code1(LC::c_assign);
 	return true;
@@ -799,6 +874,11 @@ bool LingoCompiler::visitSetNode(SetNode *node) {
 		registerMethodVar(*static_cast<VarNode *>(node->var)->name);
 	}
 	COMPILE(node->val);
+	if (node->var->type == kVarNode) {
+		const Common::String &name = *static_cast<VarNode *>(node->var)->name;
+		if (!isVarConst(name) && codeVarSlotSet(name))
+			return true;
+	}
 	COMPILE_REF(node->var);
 	code1(LC::c_assign);
 	return true;
@@ -1208,17 +1288,15 @@ bool LingoCompiler::visitFuncNode(FuncNode *node) {
 /* VarNode */
 
 bool LingoCompiler::visitVarNode(VarNode *node) {
-	if (g_director->getVersion() < 400 || (g_director->getCurrentMovie() && g_director->getCurrentMovie()->_allowOutdatedLingo)) {
-		int val = castNumToNum(node->name->c_str());
-		if (val != -1) {
+	int castNum;
+	if (isVarConst(*node->name, &castNum)) {
+		if (castNum != -1) {
 			code1(LC::c_intpush);
-			codeInt(val);
-			return true;
+			codeInt(castNum);
+		} else {
+			code1(LC::c_constpush);
+			codeString(node->name->c_str());
 		}
-	}
-	if (g_lingo->_builtinConsts.contains(*node->name)) {
-		code1(LC::c_constpush);
-		codeString(node->name->c_str());
 		return true;
 	}
 	if (_refMode) {
@@ -48,6 +48,9 @@ public:
 	void codeVarSet(const Common::String &name);
 	void codeVarRef(const Common::String &name);
 	void codeVarGet(const Common::String &name);
+	bool codeVarSlotSet(const Common::String &name);
+	int getLocalSlot(const Common::String &name);
+	bool isVarConst(const Common::String &name, int *castNum = nullptr);
 	int getTheFieldID(int entity, const Common::String &field, bool silent = false);
 	void registerFactory(Common::String &s);
 	void registerMethodVar(const Common::String &name, VarType type = kVarGeneric);
@@ -68,6 +71,8 @@ public:
 	bool _refMode;
 
 	Common::HashMap<Common::String, VarType, Common::IgnoreCase_Hash, Common::IgnoreCase_EqualTo> *_methodVars;
+	Common::Array<Common::String> *_methodArgNames;
+	Common::Array<Common::String> _methodLocalNames;
 
 	bool _hadError;
 
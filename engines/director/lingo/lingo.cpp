@@ -1778,6 +1778,52 @@ Datum Lingo::varFetch(const Datum &var, bool silent) {
 	return result;
 }
 
+const Common::String &Lingo::getLocalSlotName(int slot) {
+	static const Common::String emptyName;
+	if (_state->callstack.empty())
+		return emptyName;
+
+	const Symbol &sym = _state->callstack.back()->sp;
+	int nargs = sym.argNames ? sym.argNames->size() : 0;
+	if (slot < nargs)
+		return (*sym.argNames)[slot];
+	if (sym.varNames && slot - nargs < (int)sym.varNames->size())
+		return (*sym.varNames)[slot - nargs];
+	return emptyName;
+}
+
+int Lingo::getGlobalSlot(const Common::String &name) {
+	if (_globalSlotIndex.contains(name))
+		return _globalSlotIndex[name];
+
+	int slot = _globalSlotNames.size();
+	_globalSlotNames.push_back(name);
+	_globalSlots.push_back(nullptr);
+	_globalSlotIndex[name] = slot;
+	return slot;
+}
+
+Datum *Lingo::findGlobalSlot(int slot, bool create) {
+	Datum *&cached = _globalSlots[slot];
+	if (cached)
+		return cached;
+
+	const Common::String &name = _globalSlotNames[slot];
+	if (create) {
+		cached = &_globalvars[name];
+	} else {
+		DatumHash::iterator it = _globalvars.find(name);
+		if (it != _globalvars.end())
+			cached = &it->_value;
+	}
+	return cached;
+}
+
+void Lingo::invalidateGlobalSlots() {
+	for (uint i = 0; i < _globalSlots.size(); i++)
+		_globalSlots[i] = nullptr;
+}
+
 Common::U32String Lingo::evalChunkRef(const Datum &var) {
 	Common::U32String result;
 
@@ -256,6 +256,7 @@ struct CFrame {	/* proc/func call stack frame */
 	bool			allowRetVal;		/* whether to allow a return value */
 	Datum			defaultRetVal;		/* default return value */
 	int				paramCount;			/* original number of arguments submitted */
+	Common::Array<Datum *> localSlots;	/* args then locals, resolved at call time */
 };
 
 struct LingoEvent {
@@ -406,6 +407,11 @@ public:
 	void cleanLocalVars();
 	void varAssign(const Datum &var, const Datum &value);
 	Datum varFetch(const Datum &var, bool silent = false);
+	const Common::String &getLocalSlotName(int slot);
+	int getGlobalSlot(const Common::String &name);
+	const Common::String &getGlobalSlotName(int slot) { return _globalSlotNames[slot]; }
+	Datum *findGlobalSlot(int slot, bool create);
+	void invalidateGlobalSlots();
 	Common::U32String evalChunkRef(const Datum &var);
 	Datum findVarV4(int varType, const Datum &id);
 	CastMemberID resolveCastMember(const Datum &memberID, const Datum &castLib, CastType type);
@@ -528,6 +534,12 @@ public:
 
 	DatumHash _globalvars;
 
+	// Globals referenced by compiled handlers are interned to slot numbers,
+	// which cache a pointer into _globalvars until a global is removed.
+	Common::Array<Common::String> _globalSlotNames;
+	Common::HashMap<Common::String, int, Common::IgnoreCase_Hash, Common::IgnoreCase_EqualTo> _globalSlotIndex;
+	Common::Array<Datum *> _globalSlots;
+
 	FuncHash _functions;
 
 	Common::HashMap<int, LingoV4Bytecode *> _lingoV4;
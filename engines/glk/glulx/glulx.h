@@ -27,6 +27,7 @@
 #include "common/scummsys.h"
 #include "common/random.h"
 #include "glk/glk_api.h"
+#include "glk/undo_store.h"
 #include "glk/glulx/glulx_types.h"
 
 namespace Glk {
@@ -157,9 +158,10 @@ private:
 	 */
 	int max_undo_level;
 
-	int undo_chain_size;
-	int undo_chain_num;
-	byte **undo_chain;
+	/**
+	 * The undo snapshots, each stored as the changes to the previous one
+	 */
+	UndoStore undo_store;
 
 	/**
 	 * This will contain a copy of RAM (ramstate to endmem) as it exists in the game file.
@@ -942,12 +944,12 @@ public:
 	void final_serial();
 
 	/**
-	 * Add a state pointer to the undo chain. This returns 0 on success, 1 on failure.
+	 * Add a snapshot to the undo store. This returns 0 on success, 1 on failure.
 	 */
 	uint perform_saveundo();
 
 	/**
-	 * Pull a state pointer from the undo chain. This returns 0 on success, 1 on failure.
+	 * Pull the newest snapshot from the undo store. This returns 0 on success, 1 on failure.
 	 * Note that if it succeeds, the frameptr, localsbase, and valstackbase registers are invalid;
 	 * they must be rebuilt from the stack.
 	 */
@@ -27,11 +27,8 @@ namespace Glulx {
 #define IFFID(c1, c2, c3, c4) MKTAG(c1, c2, c3, c4)
 
 bool Glulx::init_serial() {
-	undo_chain_num = 0;
-	undo_chain_size = max_undo_level;
-	undo_chain = (unsigned char **)glulx_malloc(sizeof(unsigned char *) * undo_chain_size);
-	if (!undo_chain)
-		return false;
+	undo_store.setLimits(max_undo_level, UndoStore::DEFAULT_BUDGET);
+	undo_store.clear();
 
 #ifdef SERIALIZE_CACHE_RAM
 	{
@@ -52,16 +49,7 @@ bool Glulx::init_serial() {
 }
 
 void Glulx::final_serial() {
-	if (undo_chain) {
-		int ix;
-		for (ix = 0; ix < undo_chain_num; ix++) {
-			glulx_free(undo_chain[ix]);
-		}
-		glulx_free(undo_chain);
-	}
-	undo_chain = nullptr;
-	undo_chain_size = 0;
-	undo_chain_num = 0;
+	undo_store.clear();
 
 #ifdef SERIALIZE_CACHE_RAM
 	if (ramcache) {
@@ -74,16 +62,17 @@ void Glulx::final_serial() {
 uint Glulx::perform_saveundo() {
 	dest_t dest;
 	uint res;
-	uint memstart = 0, memlen = 0, heapstart = 0, heaplen = 0;
+	uint heapstart = 0, heaplen = 0;
 	uint stackstart = 0, stacklen = 0;
 
-	/* The format for undo-saves is simpler than for saves on disk. We
-	   just have a memory chunk, a heap chunk, and a stack chunk, in
-	   that order. We skip the IFF chunk headers (although the size
-	   fields are still there.) We also don't bother with IFF's 16-bit
+	/* The format for undo-saves is simpler than for saves on disk. The
+	   undo store keeps the memory, as the changes to the previous
+	   snapshot. The rest is a heap chunk and a stack chunk, in that
+	   order. We skip the IFF chunk headers (although the size fields
+	   are still there.) We also don't bother with IFF's 16-bit
 	   alignment. */
 
-	if (undo_chain_size == 0)
+	if (max_undo_level == 0)
 		return 1;
 
 	dest._isMem = true;
@@ -92,14 +81,6 @@ uint Glulx::perform_saveundo() {
 	if (res == 0) {
 		res = write_long(&dest, 0); /* space for chunk length */
 	}
-	if (res == 0) {
-		memstart = dest._pos;
-		res = write_memstate(&dest);
-		memlen = dest._pos - memstart;
-	}
-	if (res == 0) {
-		res = write_long(&dest, 0); /* space for chunk length */
-	}
 	if (res == 0) {
 		heapstart = dest._pos;
 		res = write_heapstate(&dest, false);
@@ -114,18 +95,6 @@ uint Glulx::perform_saveundo() {
 		stacklen = dest._pos - stackstart;
 	}
 
-	if (res == 0) {
-		/* Trim it down to the perfect size. */
-		dest._ptr = (byte *)glulx_realloc(dest._ptr, dest._pos);
-		if (!dest._ptr)
-			res = 1;
-	}
-	if (res == 0) {
-		res = reposition_write(&dest, memstart - 4);
-	}
-	if (res == 0) {
-		res = write_long(&dest, memlen);
-	}
 	if (res == 0) {
 		res = reposition_write(&dest, heapstart - 4);
 	}
@@ -141,23 +110,12 @@ uint Glulx::perform_saveundo() {
 
 	if (res == 0) {
 		/* It worked. */
-		if (undo_chain_num >= undo_chain_size) {
-			glulx_free(undo_chain[undo_chain_num - 1]);
-			undo_chain[undo_chain_num - 1] = nullptr;
-		}
-		if (undo_chain_size > 1)
-			memmove(undo_chain + 1, undo_chain,
-			        (undo_chain_size - 1) * sizeof(unsigned char *));
-		undo_chain[0] = dest._ptr;
-		if (undo_chain_num < undo_chain_size)
-			undo_chain_num += 1;
+		undo_store.save(memmap + ramstart, endmem - ramstart, dest._ptr, stackstart + stacklen);
+	}
+
+	if (dest._ptr) {
+		glulx_free(dest._ptr);
 		dest._ptr = nullptr;
-	} else {
-		/* It didn't work. */
-		if (dest._ptr) {
-			glulx_free(dest._ptr);
-			dest._ptr = nullptr;
-		}
 	}
 
 	return res;
@@ -168,6 +126,8 @@ uint Glulx::perform_restoreundo() {
 	uint res, val = 0;
 	uint heapsumlen = 0;
 	uint *heapsumarr = nullptr;
+	uint protstart, protend;
+	byte *protbuf = nullptr;
 
 	/* If profiling is enabled and active then fail. */
 #ifdef VM_PROFILING
@@ -175,19 +135,37 @@ uint Glulx::perform_restoreundo() {
 		return 1;
 #endif /* VM_PROFILING */
 
-	if (undo_chain_size == 0 || undo_chain_num == 0)
+	if (max_undo_level == 0 || undo_store.empty())
 		return 1;
 
 	dest._isMem = true;
-	dest._ptr = undo_chain[0];
+	dest._size = undo_store.getExtraSize();
+	dest._ptr = (byte *)glulx_malloc(dest._size);
+	if (!dest._ptr)
+		return 1;
 
-	res = 0;
-	if (res == 0) {
-		res = read_long(&dest, &val);
+	/* The protected range keeps its contents, as in read_memstate(). */
+	protstart = MAX(protectstart, ramstart);
+	protend = MIN(protectend, endmem);
+	if (protstart < protend) {
+		protbuf = (byte *)glulx_malloc(protend - protstart);
+		if (!protbuf) {
+			glulx_free(dest._ptr);
+			return 1;
+		}
+		memcpy(protbuf, memmap + protstart, protend - protstart);
 	}
+
+	heap_clear();
+
+	res = change_memsize(ramstart + undo_store.getMemorySize(), false);
 	if (res == 0) {
-		res = read_memstate(&dest, val);
+		undo_store.restore(memmap + ramstart, dest._ptr);
+
+		if (protbuf && protstart < endmem)
+			memcpy(memmap + protstart, protbuf, MIN(protend, endmem) - protstart);
 	}
+
 	if (res == 0) {
 		res = read_long(&dest, &val);
 	}
@@ -210,17 +188,14 @@ uint Glulx::perform_restoreundo() {
 
 	if (res == 0) {
 		/* It worked. */
-		if (undo_chain_size > 1)
-			memmove(undo_chain, undo_chain + 1,
-			        (undo_chain_size - 1) * sizeof(unsigned char *));
-		undo_chain_num -= 1;
-		glulx_free(dest._ptr);
-		dest._ptr = nullptr;
-	} else {
-		/* It didn't work. */
-		dest._ptr = nullptr;
+		undo_store.pop();
 	}
 
+	if (protbuf)
+		glulx_free(protbuf);
+	glulx_free(dest._ptr);
+	dest._ptr = nullptr;
+
 	return res;
 }
 
@@ -0,0 +1,163 @@
+/* ScummVM - Graphic Adventure Engine
+ *
+ * ScummVM is the legal property of its developers, whose names
+ * are too numerous to list here. Please refer to the COPYRIGHT
+ * file distributed with this source distribution.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include "glk/undo_store.h"
+
+namespace Glk {
+
+UndoStore::UndoStore(uint maxLevels, size_t budget) : _maxLevels(maxLevels), _budget(budget), _used(0) {
+}
+
+UndoStore::~UndoStore() {
+	clear();
+}
+
+void UndoStore::setLimits(uint maxLevels, size_t budget) {
+	_maxLevels = maxLevels;
+	_budget = budget;
+
+	if (!_maxLevels) {
+		clear();
+		return;
+	}
+
+	while (_snapshots.size() > 1 && (_snapshots.size() > _maxLevels || _used > _budget))
+		removeOldest();
+}
+
+void UndoStore::clear() {
+	for (uint idx = 0; idx < _snapshots.size(); ++idx)
+		delete _snapshots[idx];
+	_snapshots.clear();
+	_memory.clear();
+	_scratch.clear();
+	_used = 0;
+}
+
+void UndoStore::save(const byte *mem, uint memSize, const byte *extra, uint extraSize) {
+	if (!_maxLevels)
+		return;
+
+	Snapshot *snapshot = new Snapshot();
+	snapshot->_memSize = memSize;
+	if (!_snapshots.empty())
+		encodeDelta(mem, memSize, snapshot->_delta);
+	if (extraSize)
+		snapshot->_extra = Common::Array<byte>(extra, extraSize);
+
+	_memory.resize(memSize);
+	if (memSize)
+		memcpy(&_memory[0], mem, memSize);
+
+	_snapshots.push_back(snapshot);
+	_used += snapshot->_delta.size() + snapshot->_extra.size();
+
+	while (_snapshots.size() > 1 && (_snapshots.size() > _maxLevels || _used > _budget))
+		removeOldest();
+}
+
+void UndoStore::restore(byte *mem, byte *extra) const {
+	assert(!_snapshots.empty());
+	const Snapshot *snapshot = _snapshots.back();
+
+	if (snapshot->_memSize)
+		memcpy(mem, &_memory[0], snapshot->_memSize);
+	if (!snapshot->_extra.empty())
+		memcpy(extra, &snapshot->_extra[0], snapshot->_extra.size());
+}
+
+void UndoStore::pop() {
+	assert(!_snapshots.empty());
+	Snapshot *snapshot = _snapshots.back();
+	_snapshots.pop_back();
+	_used -= snapshot->_delta.size() + snapshot->_extra.size();
+
+	if (_snapshots.empty()) {
+		_memory.clear();
+	} else {
+		// Step the held memory back to the previous snapshot. Memory beyond
+		// the end of a snapshot counts as zero for the differences
+		const uint prevSize = _snapshots.back()->_memSize;
+		if (prevSize > _memory.size())
+			_memory.resize(prevSize);
+		applyDelta(snapshot->_delta, _memory.begin(), _memory.size());
+		_memory.resize(prevSize);
+	}
+
+	delete snapshot;
+}
+
+void UndoStore::removeOldest() {
+	Snapshot *snapshot = _snapshots.remove_at(0);
+	_used -= snapshot->_delta.size() + snapshot->_extra.size();
+	delete snapshot;
+
+	// The new oldest snapshot can't step back any further
+	Snapshot *oldest = _snapshots.front();
+	_used -= oldest->_delta.size();
+	oldest->_delta.clear();
+}
+
+void UndoStore::encodeDelta(const byte *mem, uint memSize, Common::Array<byte> &delta) {
+	const uint prevSize = _memory.size();
+	const uint size = MAX(memSize, prevSize);
+
+	// Every literal byte takes one byte and every zero run at least two, so
+	// the worst case is alternating changed and unchanged bytes
+	_scratch.resize(size + size / 2 + 2);
+	byte *p = _scratch.begin();
+	uint runLength = 0;
+
+	for (uint pos = 0; pos < size; ++pos) {
+		const byte c = (pos < memSize ? mem[pos] : 0) ^ (pos < prevSize ? _memory[pos] : 0);
+		if (c == 0) {
+			++runLength;
+			continue;
+		}
+
+		while (runLength) {
+			const uint len = MIN<uint>(runLength, 0x100);
+			*p++ = 0;
+			*p++ = len - 1;
+			runLength -= len;
+		}
+		*p++ = c;
+	}
+	// A trailing run of unchanged bytes doesn't need to be stored
+
+	delta = Common::Array<byte>(_scratch.begin(), p - _scratch.begin());
+}
+
+void UndoStore::applyDelta(const Common::Array<byte> &delta, byte *dest, uint size) {
+	uint pos = 0;
+
+	for (uint idx = 0; idx < delta.size() && pos < size; ++idx) {
+		if (delta[idx] == 0) {
+			if (++idx == delta.size())
+				break;
+			pos += (uint)delta[idx] + 1;
+		} else {
+			dest[pos++] ^= delta[idx];
+		}
+	}
+}
+
+} // End of namespace Glk
@@ -0,0 +1,137 @@
+/* ScummVM - Graphic Adventure Engine
+ *
+ * ScummVM is the legal property of its developers, whose names
+ * are too numerous to list here. Please refer to the COPYRIGHT
+ * file distributed with this source distribution.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#ifndef GLK_UNDO_STORE_H
+#define GLK_UNDO_STORE_H
+
+#include "common/array.h"
+
+namespace Glk {
+
+/**
+ * Keeps a chain of undo snapshots of an interpreter's memory.
+ *
+ * Only the newest snapshot's memory is held in full. Every other snapshot is
+ * stored as the difference to the snapshot after it, XORed and run-length
+ * encoded like the CMem chunk of Quetzal saves, so memory which didn't change
+ * between two snapshots takes up almost no space. Small extra data, such as
+ * the stack, is stored as is.
+ */
+class UndoStore {
+	struct Snapshot {
+		uint _memSize;
+		Common::Array<byte> _delta;		///< Difference to the previous snapshot
+		Common::Array<byte> _extra;
+	};
+public:
+	enum { DEFAULT_BUDGET = 1024 * 1024 };
+private:
+	Common::Array<Snapshot *> _snapshots;	///< Oldest first
+	Common::Array<byte> _memory;			///< Memory of the newest snapshot
+	Common::Array<byte> _scratch;
+	uint _maxLevels;
+	size_t _budget;
+	size_t _used;
+private:
+	/**
+	 * Encode the difference between the given memory and the newest snapshot
+	 */
+	void encodeDelta(const byte *mem, uint memSize, Common::Array<byte> &delta);
+
+	/**
+	 * Apply an encoded difference to a memory block
+	 */
+	static void applyDelta(const Common::Array<byte> &delta, byte *dest, uint size);
+
+	/**
+	 * Drop the oldest snapshot
+	 */
+	void removeOldest();
+public:
+	/**
+	 * Constructor
+	 * @param maxLevels		Maximum number of snapshots
+	 * @param budget		Maximum number of bytes for the differences and extra data.
+	 *						The newest snapshot is always kept.
+	 */
+	UndoStore(uint maxLevels = 8, size_t budget = DEFAULT_BUDGET);
+
+	/**
+	 * Destructor
+	 */
+	~UndoStore();
+
+	/**
+	 * Change the limits, dropping old snapshots which no longer fit
+	 */
+	void setLimits(uint maxLevels, size_t budget);
+
+	/**
+	 * Returns true if there are no snapshots
+	 */
+	bool empty() const { return _snapshots.empty(); }
+
+	/**
+	 * Returns the number of snapshots
+	 */
+	uint size() const { return _snapshots.size(); }
+
+	/**
+	 * Returns the number of bytes used by the differences and extra data
+	 */
+	size_t getUsedMemory() const { return _used; }
+
+	/**
+	 * Drop all snapshots
+	 */
+	void clear();
+
+	/**
+	 * Add a snapshot as the newest one
+	 */
+	void save(const byte *mem, uint memSize, const byte *extra, uint extraSize);
+
+	/**
+	 * Returns the memory size of the newest snapshot
+	 */
+	uint getMemorySize() const { return _snapshots.back()->_memSize; }
+
+	/**
+	 * Returns the extra data size of the newest snapshot
+	 */
+	uint getExtraSize() const { return _snapshots.back()->_extra.size(); }
+
+	/**
+	 * Copy the newest snapshot into the given buffers. The buffers must be
+	 * large enough for getMemorySize() and getExtraSize() bytes. The snapshot
+	 * is kept, so call pop() once restoring it has succeeded.
+	 */
+	void restore(byte *mem, byte *extra) const;
+
+	/**
+	 * Drop the newest snapshot
+	 */
+	void pop();
+};
+
+} // End of namespace Glk
+
+#endif
@@ -27,9 +27,7 @@
 namespace Glk {
 namespace ZCode {
 
-Mem::Mem() : story_fp(nullptr), story_size(0), first_undo(nullptr), last_undo(nullptr),
-		curr_undo(nullptr), undo_mem(nullptr), zmp(nullptr), pcp(nullptr), prev_zmp(nullptr),
-		undo_diff(nullptr), undo_count(0), reserve_mem(0) {
+Mem::Mem() : story_fp(nullptr), story_size(0), zmp(nullptr), pcp(nullptr) {
 }
 
 void Mem::initialize() {
@@ -89,26 +87,10 @@ void Mem::loadMemory() {
 }
 
 void Mem::initializeUndo() {
-	byte *reserved = nullptr;
-
-	if (reserve_mem != 0) {
-		if ((reserved = new byte[reserve_mem]) == nullptr)
-			return;
-	}
-
-	// Allocate h_dynamic_size bytes for previous dynamic zmp state
-	// + 1.5 h_dynamic_size for Quetzal diff + 2.
-	undo_mem = new zbyte[(h_dynamic_size * 5) / 2 + 2];
-	if (undo_mem != nullptr) {
-		prev_zmp = undo_mem;
-		undo_diff = undo_mem + h_dynamic_size;
-		memcpy(prev_zmp, zmp, h_dynamic_size);
-	} else {
-		_undo_slots = 0;
-	}
-
-	if (reserve_mem)
-		delete[] reserved;
+	// Snapshots only store the changes to the previous one, so a fixed
+	// budget holds many undo levels of the dynamic memory
+	undo_store.setLimits(_undo_slots, UndoStore::DEFAULT_BUDGET);
+	undo_store.clear();
 }
 
 zword Mem::get_header_extension(int entry) {
@@ -209,101 +191,13 @@ void Mem::storew(zword addr, zword value) {
 	storeb((zword)(addr + 1), lo(value));
 }
 
-void Mem::free_undo(int count) {
-	undo_t *p;
-
-	if (count > undo_count)
-		count = undo_count;
-	while (count--) {
-		p = first_undo;
-		if (curr_undo == first_undo)
-			curr_undo = curr_undo->next;
-		first_undo = first_undo->next;
-		free(p);
-		undo_count--;
-	}
-	if (first_undo)
-		first_undo->prev = nullptr;
-	else
-		last_undo = nullptr;
-}
-
 void Mem::reset_memory() {
 	story_fp = nullptr;
 
-	if (undo_mem) {
-		free_undo(undo_count);
-		delete[] undo_mem;
-	}
-
-	undo_mem = nullptr;
-	undo_count = 0;
+	undo_store.clear();
 	free(zmp);
 	zmp = nullptr;
 }
 
-long Mem::mem_diff(zbyte *a, zbyte *b, zword mem_size, zbyte *diff) {
-	unsigned size = mem_size;
-	zbyte *p = diff;
-	unsigned j;
-	zbyte c = 0;
-
-	for (;;) {
-		for (j = 0; size > 0 && (c = *a++ ^ *b++) == 0; j++)
-			size--;
-		if (size == 0) break;
-		size--;
-		if (j > 0x8000) {
-			*p++ = 0;
-			*p++ = 0xff;
-			*p++ = 0xff;
-			j -= 0x8000;
-		}
-		if (j > 0) {
-			*p++ = 0;
-			j--;
-			if (j <= 0x7f) {
-				*p++ = j;
-			} else {
-				*p++ = (j & 0x7f) | 0x80;
-				*p++ = (j & 0x7f80) >> 7;
-			}
-		}
-
-		*p++ = c;
-		*(b - 1) ^= c;
-	}
-
-	return p - diff;
-}
-
-void Mem::mem_undiff(zbyte *diff, long diff_length, zbyte *dest) {
-	zbyte c;
-
-	while (diff_length) {
-		c = *diff++;
-		diff_length--;
-		if (c == 0) {
-			unsigned runlen;
-
-			if (!diff_length)
-				return;  // Incomplete run
-			runlen = *diff++;
-			diff_length--;
-			if (runlen & 0x80) {
-				if (!diff_length)
-					return; // Incomplete extended run
-				c = *diff++;
-				diff_length--;
-				runlen = (runlen & 0x7f) | (((unsigned)c) << 7);
-			}
-
-			dest += runlen + 1;
-		} else {
-			*dest++ ^= c;
-		}
-	}
-}
-
 } // End of namespace ZCode
 } // End of namespace Glk
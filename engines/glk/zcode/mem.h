@@ -24,6 +24,7 @@
 
 #include "glk/zcode/frotz_types.h"
 #include "glk/zcode/config.h"
+#include "glk/undo_store.h"
 
 namespace Glk {
 namespace ZCode {
@@ -38,17 +39,14 @@ namespace ZCode {
 typedef uint offset_t;
 
 /**
- * Stores undo information
+ * Stores the processor state of an undo snapshot
  */
 struct undo_struct {
-	undo_struct *next;
-	undo_struct *prev;
 	offset_t pc;
-	long diff_size;
 	zword frame_count;
 	zword stack_size;
 	zword frame_offset;
-	// undo diff and stack data follow
+	// stack data follows
 };
 typedef undo_struct undo_t;
 
@@ -62,10 +60,7 @@ protected:
 	byte *pcp;
 	byte *zmp;
 
-	undo_t *first_undo, *last_undo, *curr_undo;
-	zbyte *undo_mem, *prev_zmp, *undo_diff;
-	int undo_count;
-	int reserve_mem;
+	UndoStore undo_store;
 private:
 	/**
 	 * Handles setting the story file, parsing it if it's a Blorb file
@@ -112,11 +107,6 @@ protected:
 	 */
 	void storew(zword addr, zword value);
 
-	/**
-	 * Free count undo blocks from the beginning of the undo list
-	 */
-	void free_undo(int count);
-
 	/**
 	 * Generates a runtime error
 	 */
@@ -131,21 +121,6 @@ protected:
 	 * Close the story file and deallocate memory.
 	 */
 	void reset_memory();
-
-	/**
-	 * Set diff to a Quetzal-like difference between a and b,
-	 * copying a to b as we go.  It is assumed that diff points to a
-	 * buffer which is large enough to hold the diff.
-	 * mem_size is the number of bytes to compare.
-	 * Returns the number of bytes copied to diff.
-	 *
-	 */
-	long mem_diff(zbyte *a, zbyte *b, zword mem_size, zbyte *diff);
-
-	/**
-	 * Applies a quetzal-like diff to dest
-	 */
-	void mem_undiff(zbyte *diff, long diff_length, zbyte *dest);
 public:
 	/**
 	 * Constructor
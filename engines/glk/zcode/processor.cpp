@@ -26,11 +26,6 @@
 namespace Glk {
 namespace ZCode {
 
-// TODO: Stubs to replace with actual code
-zword save_undo() { return 0; }
-zword restore_undo() { return 0; }
-
-
 Opcode Processor::var_opcodes[64] = {
 	&Processor::__illegal__,
 	&Processor::z_je,
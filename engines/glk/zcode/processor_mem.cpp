@@ -35,82 +35,51 @@ void Processor::flagsChanged(zbyte value) {
 }
 
 int Processor::save_undo() {
-	long diff_size;
-	zword stack_size;
-	undo_t *p;
+	undo_t state;
+	Common::Array<byte> extra;
 
 	if (_undo_slots == 0)
 		// undo feature unavailable
 		return -1;
 
-	// save undo possible
-	while (last_undo != curr_undo) {
-		p = last_undo;
-		last_undo = last_undo->prev;
-		delete p;
-		undo_count--;
-	}
-	if (last_undo)
-		last_undo->next = nullptr;
-	else
-		first_undo = nullptr;
-
-	if (undo_count == _undo_slots)
-		free_undo(1);
-
-	diff_size = mem_diff(zmp, prev_zmp, h_dynamic_size, undo_diff);
-	stack_size = _stack + STACK_SIZE - _sp;
-	do {
-		p = (undo_t *) malloc(sizeof(undo_t) + diff_size + stack_size * sizeof(*_sp));
-		if (p == nullptr)
-			free_undo(1);
-	} while (!p && undo_count);
-	if (p == nullptr)
-		return -1;
+	GET_PC(state.pc);
+	state.frame_count = _frameCount;
+	state.stack_size = _stack + STACK_SIZE - _sp;
+	state.frame_offset = _fp - _stack;
 
-	GET_PC(p->pc);
-	p->frame_count = _frameCount;
-	p->diff_size = diff_size;
-	p->stack_size = stack_size;
-	p->frame_offset = _fp - _stack;
-	memcpy(p + 1, undo_diff, diff_size);
-	memcpy((zbyte *)(p + 1) + diff_size, _sp, stack_size * sizeof(*_sp));
-
-	if (!first_undo) {
-		p->prev = nullptr;
-		first_undo = p;
-	} else {
-		last_undo->next = p;
-		p->prev = last_undo;
-	}
+	// The processor state and the used part of the stack go with the memory
+	extra.resize(sizeof(undo_t) + state.stack_size * sizeof(*_sp));
+	memcpy(&extra[0], &state, sizeof(undo_t));
+	memcpy(&extra[sizeof(undo_t)], _sp, state.stack_size * sizeof(*_sp));
 
-	p->next = nullptr;
-	curr_undo = last_undo = p;
-	undo_count++;
+	undo_store.save(zmp, h_dynamic_size, &extra[0], extra.size());
 
 	return 1;
 }
 
 int Processor::restore_undo(void) {
+	undo_t state;
+	Common::Array<byte> extra;
+
 	if (_undo_slots == 0)
 		// undo feature unavailable
 		return -1;
 
-	if (curr_undo == nullptr)
+	if (undo_store.empty())
 		// no saved game state
 		return 0;
 
 	// undo possible
-	memcpy(zmp, prev_zmp, h_dynamic_size);
-	SET_PC(curr_undo->pc);
-	_sp = _stack + STACK_SIZE - curr_undo->stack_size;
-	_fp = _stack + curr_undo->frame_offset;
-	_frameCount = curr_undo->frame_count;
-	mem_undiff((zbyte *)(curr_undo + 1), curr_undo->diff_size, prev_zmp);
-	memcpy(_sp, (zbyte *)(curr_undo + 1) + curr_undo->diff_size,
-		curr_undo->stack_size * sizeof(*_sp));
-
-	curr_undo = curr_undo->prev;
+	extra.resize(undo_store.getExtraSize());
+	undo_store.restore(zmp, &extra[0]);
+	undo_store.pop();
+	memcpy(&state, &extra[0], sizeof(undo_t));
+
+	SET_PC(state.pc);
+	_sp = _stack + STACK_SIZE - state.stack_size;
+	_fp = _stack + state.frame_offset;
+	_frameCount = state.frame_count;
+	memcpy(_sp, &extra[sizeof(undo_t)], state.stack_size * sizeof(*_sp));
 
 	restart_header();
 
@@ -117,6 +117,7 @@ Console::Console(SciEngine *engine) : GUI::Debugger(),
 	registerCmd("resource_types",		WRAP_METHOD(Console, cmdResourceTypes));
 	registerCmd("list",				WRAP_METHOD(Console, cmdList));
 	registerCmd("alloc_list",				WRAP_METHOD(Console, cmdAllocList));
+	registerCmd("resource_cache",		WRAP_METHOD(Console, cmdResourceCache));
 	registerCmd("hexgrep",			WRAP_METHOD(Console, cmdHexgrep));
 	registerCmd("verify_scripts",		WRAP_METHOD(Console, cmdVerifyScripts));
 	registerCmd("integrity_dump",	WRAP_METHOD(Console, cmdResourceIntegrityDump));
@@ -233,6 +234,7 @@ Console::Console(SciEngine *engine) : GUI::Debugger(),
 	registerCmd("bpe",				WRAP_METHOD(Console, cmdBreakpointFunction));		// alias
 	// VM
 	registerCmd("script_steps",		WRAP_METHOD(Console, cmdScriptSteps));
+	registerCmd("opcode_profile",		WRAP_METHOD(Console, cmdOpcodeProfile));
 	registerCmd("script_objects",   WRAP_METHOD(Console, cmdScriptObjects));
 	registerCmd("scro",             WRAP_METHOD(Console, cmdScriptObjects));
 	registerCmd("script_strings",   WRAP_METHOD(Console, cmdScriptStrings));
@@ -267,6 +269,8 @@ Console::Console(SciEngine *engine) : GUI::Debugger(),
 	_debugState.breakpointWasHit = false;
 	_debugState._breakpoints.clear(); // No breakpoints defined
 	_debugState._activeBreakpointTypes = 0;
+	_debugState.profileOpcodes = false;
+	memset(_debugState.opcodeCounts, 0, sizeof(_debugState.opcodeCounts));
 }
 
 Console::~Console() {
@@ -357,6 +361,7 @@ bool Console::cmdHelp(int argc, const char **argv) {
 	debugPrintf(" resource_types - Shows the valid resource types\n");
 	debugPrintf(" list - Lists all the resources of a given type\n");
 	debugPrintf(" alloc_list - Lists all allocated resources\n");
+	debugPrintf(" resource_cache - Shows or sets the resource cache budget and its statistics\n");
 	debugPrintf(" hexgrep - Searches some resources for a particular sequence of bytes, represented as hexadecimal numbers\n");
 	debugPrintf(" verify_scripts - Performs sanity checks on SCI1.1-SCI2.1 game scripts (e.g. if they're up to 64KB in total)\n");
 	debugPrintf(" integrity_dump - Dumps integrity data about resources in the current game to disk\n");
@@ -447,6 +452,7 @@ bool Console::cmdHelp(int argc, const char **argv) {
 	debugPrintf("\n");
 	debugPrintf("VM:\n");
 	debugPrintf(" script_steps - Shows the number of executed SCI operations\n");
+	debugPrintf(" opcode_profile - Counts executed SCI opcodes and shows the most frequent ones\n");
 	debugPrintf(" script_objects / scro - Shows all objects inside a specified script\n");
 	debugPrintf(" script_strings / scrs - Shows all strings inside a specified script\n");
 	debugPrintf(" script_said - Shows all said - strings inside a specified script\n");
@@ -1134,6 +1140,35 @@ bool Console::cmdAllocList(int argc, const char **argv) {
 	return true;
 }
 
+bool Console::cmdResourceCache(int argc, const char **argv) {
+	ResourceManager *resMan = _engine->getResMan();
+
+	if (argc > 2) {
+		debugPrintf("Shows the resource cache statistics, or sets its budget\n");
+		debugPrintf("Usage: %s [<budget in KiB>]\n", argv[0]);
+		return true;
+	}
+
+	if (argc == 2) {
+		int budget = atoi(argv[1]);
+		if (budget <= 0) {
+			debugPrintf("Invalid budget %s\n", argv[1]);
+			return true;
+		}
+		resMan->setMaxMemoryLRU(budget * 1024);
+	}
+
+	const ResourceManager::CacheStats &stats = resMan->getCacheStats();
+	const uint32 lookups = stats.hits + stats.misses;
+	debugPrintf("LRU budget: %d KiB, used: %d KiB, locked: %d KiB\n",
+		resMan->getMaxMemoryLRU() / 1024, resMan->getMemoryLRU() / 1024, resMan->getMemoryLocked() / 1024);
+	debugPrintf("Hits: %u, misses: %u (%u%% hit rate)\n", stats.hits, stats.misses, lookups ? stats.hits * 100 / lookups : 0);
+	debugPrintf("Evictions: %u, prefetches: %u\n", stats.evictions, stats.prefetches);
+	debugPrintf("Time spent loading resources: %u ms\n", stats.loadTime);
+
+	return true;
+}
+
 bool Console::cmdDissectScript(int argc, const char **argv) {
 	if (argc != 2) {
 		debugPrintf("Examines a script\n");
@@ -3440,6 +3475,54 @@ bool Console::cmdScriptSteps(int argc, const char **argv) {
 	return true;
 }
 
+struct OpcodeCountGreater {
+	OpcodeCountGreater(const uint32 *counts) : _counts(counts) {}
+	bool operator()(byte a, byte b) const { return _counts[a] > _counts[b]; }
+	const uint32 *_counts;
+};
+
+bool Console::cmdOpcodeProfile(int argc, const char **argv) {
+	if (argc == 2) {
+		if (!scumm_stricmp(argv[1], "on")) {
+			_debugState.profileOpcodes = true;
+		} else if (!scumm_stricmp(argv[1], "off")) {
+			_debugState.profileOpcodes = false;
+		} else if (!scumm_stricmp(argv[1], "reset")) {
+			memset(_debugState.opcodeCounts, 0, sizeof(_debugState.opcodeCounts));
+		} else {
+			debugPrintf("Counts the SCI opcodes executed by the VM.\n");
+			debugPrintf("Usage: %s [on | off | reset]\n", argv[0]);
+			debugPrintf("Without parameters, the most frequent opcodes are shown\n");
+			return true;
+		}
+	}
+
+	debugPrintf("Opcode profiling is %s\n", _debugState.profileOpcodes ? "on" : "off");
+
+	Common::Array<byte> opcodes;
+	uint32 total = 0;
+	for (uint i = 0; i < ARRAYSIZE(_debugState.opcodeCounts); i++) {
+		if (_debugState.opcodeCounts[i]) {
+			opcodes.push_back(i);
+			total += _debugState.opcodeCounts[i];
+		}
+	}
+
+	if (!total)
+		return true;
+
+	Common::sort(opcodes.begin(), opcodes.end(), OpcodeCountGreater(_debugState.opcodeCounts));
+
+	for (uint i = 0; i < opcodes.size(); i++) {
+		const uint32 count = _debugState.opcodeCounts[opcodes[i]];
+		debugPrintf("%02x %-10s %10u  %5.2f%%\n", opcodes[i], opcodeNames[opcodes[i]],
+			count, count * 100.0 / total);
+	}
+	debugPrintf("Total: %u opcodes\n", total);
+
+	return true;
+}
+
 bool Console::cmdScriptObjects(int argc, const char **argv) {
 	if (argc < 2) {
 		debugPrintf("Shows all objects inside a specified script.\n");
@@ -76,6 +76,7 @@ private:
 	bool cmdList(int argc, const char **argv);
 	bool cmdResourceIntegrityDump(int argc, const char **argv);
 	bool cmdAllocList(int argc, const char **argv);
+	bool cmdResourceCache(int argc, const char **argv);
 	bool cmdHexgrep(int argc, const char **argv);
 	bool cmdVerifyScripts(int argc, const char **argv);
 	// Game
@@ -160,6 +161,7 @@ private:
 	bool cmdBreakpointAddress(int argc, const char **argv);
 	// VM
 	bool cmdScriptSteps(int argc, const char **argv);
+	bool cmdOpcodeProfile(int argc, const char **argv);
 	bool cmdScriptObjects(int argc, const char **argv);
 	bool cmdScriptStrings(int argc, const char **argv);
 	bool cmdScriptSaid(int argc, const char **argv);
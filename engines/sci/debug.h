@@ -83,6 +83,8 @@ struct DebugState {
 	StackPtr old_sp;
 	Common::List<Breakpoint> _breakpoints;   //< List of breakpoints
 	int _activeBreakpointTypes;  //< Bit mask specifying which types of breakpoints are active
+	bool profileOpcodes;         //< Set to count executed opcodes in opcodeCounts
+	uint32 opcodeCounts[128];    //< Number of times each opcode was executed while profiling
 
 	void updateActiveBreakpointTypes();
 };
@@ -27,6 +27,7 @@
 #include "sci/engine/state.h"
 #include "sci/engine/kernel.h"
 #include "sci/engine/script.h"
+#include "sci/engine/vm.h"
 
 #include "common/util.h"
 
@@ -52,6 +53,7 @@ void Script::freeScript(const bool keepLocalsSegment) {
 	_buf.clear();
 	_script.clear();
 	_heap.clear();
+	_instructionCache.clear();
 	_exports.clear();
 	_numExports = 0;
 	_synonyms.clear();
@@ -230,6 +232,45 @@ void Script::load(int script_nr, ResourceManager *resMan, ScriptPatcher *scriptP
 	applySaidWorkarounds();
 }
 
+int Script::readInstruction(uint32 offset, byte &extOpcode, int16 opparams[4]) {
+	// Only the script itself contains code, not the heap
+	if (offset >= _script.size())
+		return readPMachineInstruction(getBuf(offset), extOpcode, opparams);
+
+	InstructionCache::const_iterator cached = _instructionCache.find(offset);
+	if (cached != _instructionCache.end()) {
+		const DecodedInstruction &instruction = cached->_value;
+		extOpcode = instruction.extOpcode;
+		opparams[0] = instruction.opparams[0];
+		opparams[1] = instruction.opparams[1];
+		opparams[2] = instruction.opparams[2];
+		opparams[3] = 0;
+		return instruction.size;
+	}
+
+	const int size = readPMachineInstruction(getBuf(offset), extOpcode, opparams);
+	// op_file instructions embed a file name and may not fit
+	if (size <= 0xFF) {
+		DecodedInstruction &instruction = _instructionCache[offset];
+		instruction.extOpcode = extOpcode;
+		instruction.opparams[0] = opparams[0];
+		instruction.opparams[1] = opparams[1];
+		instruction.opparams[2] = opparams[2];
+		instruction.size = size;
+	}
+	return size;
+}
+
+void Script::invalidateInstructionCache(uint32 offset, uint32 size) {
+	if (offset >= _script.size())
+		return;
+
+	for (InstructionCache::iterator it = _instructionCache.begin(); it != _instructionCache.end(); ++it) {
+		if (it->_key < offset + size && it->_key + it->_value.size > offset)
+			_instructionCache.erase(it);
+	}
+}
+
 void Script::identifyOffsets() {
 	offsetLookupArrayEntry arrayEntry;
 	SciSpan<const byte> scriptDataPtr;
@@ -797,6 +838,8 @@ const SciSpan<const uint16> Script::getRelocationTableSci0Sci21() const {
 }
 
 void Script::relocateSci0Sci21(const SegmentId segmentId) {
+	invalidateInstructionCache();
+
 	const SciSpan<const uint16> relocEntries = getRelocationTableSci0Sci21();
 
 	const uint32 heapOffset = getHeapOffset();
@@ -821,6 +864,8 @@ void Script::relocateSci0Sci21(const SegmentId segmentId) {
 
 #ifdef ENABLE_SCI32
 void Script::relocateSci3(const SegmentId segmentId) {
+	invalidateInstructionCache();
+
 	SciSpan<const byte> relocEntry = _buf->subspan(_buf->getUint32SEAt(8));
 	const uint relocCount = _buf->getUint16SEAt(18);
 
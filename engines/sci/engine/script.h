@@ -22,6 +22,7 @@
 #ifndef SCI_ENGINE_SCRIPT_H
 #define SCI_ENGINE_SCRIPT_H
 
+#include "common/hashmap.h"
 #include "common/str.h"
 #include "sci/util.h"
 #include "sci/engine/segment.h"
@@ -68,6 +69,15 @@ struct offsetLookupArrayEntry {
 
 typedef Common::Array<offsetLookupArrayEntry> offsetLookupArrayType;
 
+/** An instruction decoded by readPMachineInstruction(), cached for the VM. */
+struct DecodedInstruction {
+	int16 opparams[3];
+	byte extOpcode;
+	byte size; ///< Size of the instruction in bytes
+};
+
+typedef Common::HashMap<uint32, DecodedInstruction> InstructionCache;
+
 class Script : public SegmentObj {
 private:
 	int _nr; /**< Script number */
@@ -93,6 +103,12 @@ private:
 
 	ObjMap _objects;	/**< Table for objects, contains property variables */
 
+	/**
+	 * Instructions decoded so far, indexed by their offset in the script.
+	 * Only holds the instructions that have actually been executed.
+	 */
+	InstructionCache _instructionCache;
+
 protected:
 	offsetLookupArrayType _offsetLookupArray; // Table of all elements of currently loaded script, that may get pointed to
 
@@ -126,6 +142,25 @@ public:
 	ObjMap &getObjectMap() { return _objects; }
 	const ObjMap &getObjectMap() const { return _objects; }
 
+	/**
+	 * Decodes the instruction at the given offset, like readPMachineInstruction(),
+	 * but only reads the script data the first time it gets executed.
+	 * @return the size of the instruction in bytes
+	 */
+	int readInstruction(uint32 offset, byte &extOpcode, int16 opparams[4]);
+
+	/**
+	 * Drops all decoded instructions. Needs to be called whenever the code
+	 * of the script gets modified.
+	 */
+	void invalidateInstructionCache() { _instructionCache.clear(); }
+
+	/**
+	 * Drops the decoded instructions overlapping the given range of the
+	 * script, after it has been written to through a raw pointer.
+	 */
+	void invalidateInstructionCache(uint32 offset, uint32 size);
+
 	// speed optimization: inline due to frequent calling
 	bool offsetIsObject(uint32 offset) const {
 		return _buf->getUint16SEAt(offset + SCRIPT_OBJECT_MAGIC_OFFSET) == SCRIPT_OBJECT_MAGIC_NUMBER;
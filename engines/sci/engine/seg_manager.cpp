@@ -701,6 +701,7 @@ void SegManager::strncpy(reg_t dest, const char* src, size_t n) {
 
 	if (dest_r.isRaw) {
 		forwardCopy<true>(dest_r.raw, (const byte *)src, n);
+		invalidateScriptCode(dest, MIN<size_t>(n, dest_r.maxSize));
 	} else {
 		// raw -> non-raw
 		for (uint i = 0; i < n; i++) {
@@ -751,6 +752,7 @@ void SegManager::strncpy(reg_t dest, reg_t src, size_t n) {
 			if (!c)
 				break;
 		}
+		invalidateScriptCode(dest, MIN<size_t>(n, dest_r.maxSize));
 	} else {
 		// non-raw -> non-raw
 		for (uint i = 0; i < n; i++) {
@@ -784,6 +786,7 @@ void SegManager::memcpy(reg_t dest, const byte* src, size_t n) {
 	if (dest_r.isRaw) {
 		// raw -> raw
 		forwardCopy<false>(dest_r.raw, src, n);
+		invalidateScriptCode(dest, n);
 	} else {
 		// raw -> non-raw
 		for (uint i = 0; i < n; i++)
@@ -817,6 +820,7 @@ void SegManager::memcpy(reg_t dest, reg_t src, size_t n) {
 	} else if (dest_r.isRaw) {
 		// * -> raw
 		memcpy(dest_r.raw, src, n);
+		invalidateScriptCode(dest, n);
 	} else {
 		// non-raw -> non-raw
 		for (uint i = 0; i < n; i++) {
@@ -826,6 +830,12 @@ void SegManager::memcpy(reg_t dest, reg_t src, size_t n) {
 	}
 }
 
+void SegManager::invalidateScriptCode(reg_t dest, size_t n) {
+	Script *scr = getScriptIfLoaded(dest.getSegment());
+	if (scr)
+		scr->invalidateInstructionCache(dest.getOffset(), n);
+}
+
 void SegManager::memcpy(byte *dest, reg_t src, size_t n) {
 	const SegmentRef src_r = dereference(src);
 	if (!src_r.isValid()) {
@@ -1107,6 +1117,14 @@ int SegManager::instantiateScript(int scriptNum, bool applyScriptPatches) {
 	g_sci->_guestAdditions->instantiateScriptHook(*scr);
 #endif
 
+	// When a room is entered, the game sets the new room number and then
+	// loads the room script. Load the resources the room is likely to use
+	// while the game is busy anyway. Other scripts rarely have resources
+	// with their own number, so nothing is prefetched for them.
+	EngineState *s = g_sci->getEngineState();
+	if (s && s->variables[VAR_GLOBAL] && s->currentRoomNumber() == scriptNum)
+		_resMan->prefetchResources(scriptNum);
+
 	return segmentId;
 }
 
@@ -360,6 +360,13 @@ public:
 	 */
 	void memcpy(byte *dest, reg_t src, size_t n);
 
+	/**
+	 * Notifies the owning script that n bytes at dest have been written to
+	 * through a raw pointer, so that it drops any cached decoded code there.
+	 * Needs to be called by everything that writes to raw segments.
+	 */
+	void invalidateScriptCode(reg_t dest, size_t n);
+
 	/**
 	 * Determine length of string at str.
 	 * str can point to a raw or non-raw segment.
@@ -71,6 +71,8 @@ EngineState::EngineState(SegManager *segMan) :
 	_msgState(nullptr),
 	_dirseeker() {
 
+	// The globals are only set up by initGlobals(), once script 0 is loaded
+	memset(variables, 0, sizeof(variables));
 	reset(false);
 }
 
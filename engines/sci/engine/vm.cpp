@@ -537,6 +537,140 @@ uint32 findOffset(const int16 relOffset, const Script *scr, const uint32 pcOffse
 	return offset;
 }
 
+// With GCC compatible compilers, run_vm() dispatches through a table of label
+// addresses. Every handler ends with DISPATCH(), which finishes the current
+// instruction, runs the per-instruction prologue and jumps straight to the
+// handler of the next opcode, so each handler has its own indirect jump. The
+// case labels are kept, so other compilers (or SCI_VM_NO_COMPUTED_GOTO) simply
+// use the switch, with DISPATCH() meaning break.
+#if defined(__GNUC__) && !defined(SCI_VM_NO_COMPUTED_GOTO)
+#define SCI_VM_COMPUTED_GOTO
+#define OPCODE_CASE(name) case name: handle_##name
+#define OPCODE_DEFAULT default: handle_invalid
+#else
+#define OPCODE_CASE(name) case name
+#define OPCODE_DEFAULT default
+#endif
+
+/**
+ * Reloads the cached execution context after the execution stack has changed.
+ */
+static void loadExecutionContext(EngineState *s, Script *&scr, Object *&obj, Script *&local_script) {
+	scr = s->_segMan->getScriptIfLoaded(s->xs->addr.pc.getSegment());
+	if (!scr)
+		error("No script in segment %d",  s->xs->addr.pc.getSegment());
+	s->xs = &(s->_executionStack.back());
+	s->_executionStackPosChanged = false;
+
+	obj = s->_segMan->getObject(s->xs->objp);
+	local_script = s->_segMan->getScriptIfLoaded(s->xs->local_segment);
+	if (!local_script) {
+		error("Could not find local script from segment %x", s->xs->local_segment);
+	} else {
+		s->variablesSegment[VAR_LOCAL] = local_script->getLocalsSegment();
+		s->variablesBase[VAR_LOCAL] = s->variables[VAR_LOCAL] = local_script->getLocalsBegin();
+		s->variablesMax[VAR_LOCAL] = local_script->getLocalsCount();
+		s->variablesMax[VAR_TEMP] = s->xs->tempCount;
+		s->variablesMax[VAR_PARAM] = s->xs->argc + 1;
+	}
+	s->variables[VAR_TEMP] = s->xs->fp;
+	s->variables[VAR_PARAM] = s->xs->variables_argp;
+}
+
+/**
+ * Runs the checks that precede every instruction (breakpoints, debugger,
+ * stack and program counter sanity) and decodes the next instruction.
+ * Returns false if script processing has to stop.
+ */
+static inline bool fetchInstruction(EngineState *s, Script *&scr, Object *&obj, Script *&local_script, int16 *opparams, byte &extOpcode, byte &opcode) {
+	g_sci->_debugState.old_pc_offset = s->xs->addr.pc.getOffset();
+	g_sci->_debugState.old_sp = s->xs->sp;
+
+	if (s->abortScriptProcessing != kAbortNone)
+		return false;
+
+	if (s->_executionStackPosChanged)
+		loadExecutionContext(s, scr, obj, local_script);
+
+	g_sci->checkAddressBreakpoint(s->xs->addr.pc);
+
+	// Debug if this has been requested:
+	// TODO: re-implement sci_debug_flags
+	if (g_sci->_debugState.debugging /* sci_debug_flags*/) {
+		g_sci->scriptDebug();
+		g_sci->_debugState.breakpointWasHit = false;
+	}
+	Console *con = g_sci->getSciDebugger();
+	con->onFrame();
+
+	if (s->xs->sp < s->xs->fp)
+		error("run_vm(): stack underflow, sp: %04x:%04x, fp: %04x:%04x",
+		PRINT_REG(*s->xs->sp), PRINT_REG(*s->xs->fp));
+
+	if (s->xs->addr.pc.getOffset() >= scr->getBufSize())
+		error("run_vm(): program counter gone astray, addr: %d, code buffer size: %d",
+		s->xs->addr.pc.getOffset(), scr->getBufSize());
+
+	// Get opcode
+	s->xs->addr.pc.incOffset(scr->readInstruction(s->xs->addr.pc.getOffset(), extOpcode, opparams));
+	opcode = extOpcode >> 1;
+	if (g_sci->_debugState.profileOpcodes)
+		g_sci->_debugState.opcodeCounts[opcode]++;
+	//debug("%s: %d, %d, %d, %d, acc = %04x:%04x, script %d, local script %d", opcodeNames[opcode], opparams[0], opparams[1], opparams[2], opparams[3], PRINT_REG(s->r_acc), scr->getScriptNumber(), local_script->getScriptNumber());
+	return true;
+}
+
+/**
+ * Commits a pending execution stack change once an instruction is done.
+ */
+static inline void finishInstruction(EngineState *s, ExecStack *xs_new, byte opcode) {
+	if (s->_executionStackPosChanged) // Force initialization
+		s->xs = xs_new;
+
+	if (s->xs != &(s->_executionStack.back())) {
+		error("xs is stale (%p vs %p); last command was %02x",
+				(void *)s->xs, (void *)&(s->_executionStack.back()),
+				opcode);
+	}
+	++s->scriptStepCounter;
+}
+
+#ifdef ABORT_ON_INFINITE_LOOP
+static void checkInfiniteLoop(byte &prevOpcode, byte opcode, const Script *scr) {
+	if (prevOpcode != 0xFF) {
+		if (prevOpcode == op_eq_  || prevOpcode == op_ne_  ||
+			prevOpcode == op_gt_  || prevOpcode == op_ge_  ||
+			prevOpcode == op_lt_  || prevOpcode == op_le_  ||
+			prevOpcode == op_ugt_ || prevOpcode == op_uge_ ||
+			prevOpcode == op_ult_ || prevOpcode == op_ule_) {
+			if (opcode == op_jmp)
+				error("Infinite loop detected in script %d", scr->getScriptNumber());
+		}
+	}
+
+	prevOpcode = opcode;
+}
+#define CHECK_INFINITE_LOOP() checkInfiniteLoop(prevOpcode, opcode, scr)
+#else
+#define CHECK_INFINITE_LOOP()
+#endif
+
+#ifdef SCI_VM_COMPUTED_GOTO
+#define DISPATCH() \
+	do { \
+		finishInstruction(s, xs_new, opcode); \
+		if (!fetchInstruction(s, scr, obj, local_script, opparams, extOpcode, opcode)) \
+			return; /* Stop processing */ \
+		CHECK_INFINITE_LOOP(); \
+		goto *dispatchTable[opcode]; \
+	} while (0)
+
+#pragma GCC diagnostic push
+#pragma GCC diagnostic ignored "-Wpedantic"
+#else
+#define DISPATCH() break
+#endif
+
 void run_vm(EngineState *s) {
 	assert(s);
 
@@ -568,194 +702,171 @@ void run_vm(EngineState *s) {
 #ifdef ABORT_ON_INFINITE_LOOP
 	byte prevOpcode = 0xFF;
 #endif
+	int var_type; // See description below
+	int var_number;
+	byte extOpcode;
+	byte opcode;
+
+#ifdef SCI_VM_COMPUTED_GOTO
+	static const void *const dispatchTable[128] = {
+		&&handle_op_bnot, &&handle_op_add, &&handle_op_sub, &&handle_op_mul,
+		&&handle_op_div, &&handle_op_mod, &&handle_op_shr, &&handle_op_shl,
+		&&handle_op_xor, &&handle_op_and, &&handle_op_or, &&handle_op_neg,
+		&&handle_op_not, &&handle_op_eq_, &&handle_op_ne_, &&handle_op_gt_,
+		&&handle_op_ge_, &&handle_op_lt_, &&handle_op_le_, &&handle_op_ugt_,
+		&&handle_op_uge_, &&handle_op_ult_, &&handle_op_ule_, &&handle_op_bt,
+		&&handle_op_bnt, &&handle_op_jmp, &&handle_op_ldi, &&handle_op_push,
+		&&handle_op_pushi, &&handle_op_toss, &&handle_op_dup, &&handle_op_link,
+		&&handle_op_call, &&handle_op_callk, &&handle_op_callb, &&handle_op_calle,
+		&&handle_op_ret, &&handle_op_send, &&handle_op_info, &&handle_op_superP,
+		&&handle_op_class, &&handle_invalid, &&handle_op_self, &&handle_op_super,
+		&&handle_op_rest, &&handle_op_lea, &&handle_op_selfID, &&handle_invalid,
+		&&handle_op_pprev, &&handle_op_pToa, &&handle_op_aTop, &&handle_op_pTos,
+		&&handle_op_sTop, &&handle_op_ipToa, &&handle_op_dpToa, &&handle_op_ipTos,
+		&&handle_op_dpTos, &&handle_op_lofsa, &&handle_op_lofss, &&handle_op_push0,
+		&&handle_op_push1, &&handle_op_push2, &&handle_op_pushSelf, &&handle_op_line,
+		&&handle_op_lag, &&handle_op_lal, &&handle_op_lat, &&handle_op_lap,
+		&&handle_op_lsg, &&handle_op_lsl, &&handle_op_lst, &&handle_op_lsp,
+		&&handle_op_lagi, &&handle_op_lali, &&handle_op_lati, &&handle_op_lapi,
+		&&handle_op_lsgi, &&handle_op_lsli, &&handle_op_lsti, &&handle_op_lspi,
+		&&handle_op_sag, &&handle_op_sal, &&handle_op_sat, &&handle_op_sap,
+		&&handle_op_ssg, &&handle_op_ssl, &&handle_op_sst, &&handle_op_ssp,
+		&&handle_op_sagi, &&handle_op_sali, &&handle_op_sati, &&handle_op_sapi,
+		&&handle_op_ssgi, &&handle_op_ssli, &&handle_op_ssti, &&handle_op_sspi,
+		&&handle_op_plusag, &&handle_op_plusal, &&handle_op_plusat, &&handle_op_plusap,
+		&&handle_op_plussg, &&handle_op_plussl, &&handle_op_plusst, &&handle_op_plussp,
+		&&handle_op_plusagi, &&handle_op_plusali, &&handle_op_plusati, &&handle_op_plusapi,
+		&&handle_op_plussgi, &&handle_op_plussli, &&handle_op_plussti, &&handle_op_plusspi,
+		&&handle_op_minusag, &&handle_op_minusal, &&handle_op_minusat, &&handle_op_minusap,
+		&&handle_op_minussg, &&handle_op_minussl, &&handle_op_minusst, &&handle_op_minussp,
+		&&handle_op_minusagi, &&handle_op_minusali, &&handle_op_minusati, &&handle_op_minusapi,
+		&&handle_op_minussgi, &&handle_op_minussli, &&handle_op_minussti, &&handle_op_minusspi,
+	};
+#endif
 
 	while (1) {
-		int var_type; // See description below
-		int var_number;
-
-		g_sci->_debugState.old_pc_offset = s->xs->addr.pc.getOffset();
-		g_sci->_debugState.old_sp = s->xs->sp;
-
-		if (s->abortScriptProcessing != kAbortNone)
+		if (!fetchInstruction(s, scr, obj, local_script, opparams, extOpcode, opcode))
 			return; // Stop processing
+		CHECK_INFINITE_LOOP();
 
-		if (s->_executionStackPosChanged) {
-			scr = s->_segMan->getScriptIfLoaded(s->xs->addr.pc.getSegment());
-			if (!scr)
-				error("No script in segment %d",  s->xs->addr.pc.getSegment());
-			s->xs = &(s->_executionStack.back());
-			s->_executionStackPosChanged = false;
-
-			obj = s->_segMan->getObject(s->xs->objp);
-			local_script = s->_segMan->getScriptIfLoaded(s->xs->local_segment);
-			if (!local_script) {
-				error("Could not find local script from segment %x", s->xs->local_segment);
-			} else {
-				s->variablesSegment[VAR_LOCAL] = local_script->getLocalsSegment();
-				s->variablesBase[VAR_LOCAL] = s->variables[VAR_LOCAL] = local_script->getLocalsBegin();
-				s->variablesMax[VAR_LOCAL] = local_script->getLocalsCount();
-				s->variablesMax[VAR_TEMP] = s->xs->tempCount;
-				s->variablesMax[VAR_PARAM] = s->xs->argc + 1;
-			}
-			s->variables[VAR_TEMP] = s->xs->fp;
-			s->variables[VAR_PARAM] = s->xs->variables_argp;
-		}
-
-		g_sci->checkAddressBreakpoint(s->xs->addr.pc);
-
-		// Debug if this has been requested:
-		// TODO: re-implement sci_debug_flags
-		if (g_sci->_debugState.debugging /* sci_debug_flags*/) {
-			g_sci->scriptDebug();
-			g_sci->_debugState.breakpointWasHit = false;
-		}
-		Console *con = g_sci->getSciDebugger();
-		con->onFrame();
-
-		if (s->xs->sp < s->xs->fp)
-			error("run_vm(): stack underflow, sp: %04x:%04x, fp: %04x:%04x",
-			PRINT_REG(*s->xs->sp), PRINT_REG(*s->xs->fp));
-
-		if (s->xs->addr.pc.getOffset() >= scr->getBufSize())
-			error("run_vm(): program counter gone astray, addr: %d, code buffer size: %d",
-			s->xs->addr.pc.getOffset(), scr->getBufSize());
-
-		// Get opcode
-		byte extOpcode;
-		s->xs->addr.pc.incOffset(readPMachineInstruction(scr->getBuf(s->xs->addr.pc.getOffset()), extOpcode, opparams));
-		const byte opcode = extOpcode >> 1;
-		//debug("%s: %d, %d, %d, %d, acc = %04x:%04x, script %d, local script %d", opcodeNames[opcode], opparams[0], opparams[1], opparams[2], opparams[3], PRINT_REG(s->r_acc), scr->getScriptNumber(), local_script->getScriptNumber());
-
-#ifdef ABORT_ON_INFINITE_LOOP
-		if (prevOpcode != 0xFF) {
-			if (prevOpcode == op_eq_  || prevOpcode == op_ne_  ||
-				prevOpcode == op_gt_  || prevOpcode == op_ge_  ||
-				prevOpcode == op_lt_  || prevOpcode == op_le_  ||
-				prevOpcode == op_ugt_ || prevOpcode == op_uge_ ||
-				prevOpcode == op_ult_ || prevOpcode == op_ule_) {
-				if (opcode == op_jmp)
-					error("Infinite loop detected in script %d", scr->getScriptNumber());
-			}
-		}
-
-		prevOpcode = opcode;
+#ifdef SCI_VM_COMPUTED_GOTO
+		goto *dispatchTable[opcode];
 #endif
-
 		switch (opcode) {
 
-		case op_bnot: // 0x00 (00)
+		OPCODE_CASE(op_bnot): // 0x00 (00)
 			// Binary not
 			s->r_acc = make_reg(0, 0xffff ^ s->r_acc.requireUint16());
-			break;
+			DISPATCH();
 
-		case op_add: // 0x01 (01)
+		OPCODE_CASE(op_add): // 0x01 (01)
 			s->r_acc = POP32() + s->r_acc;
-			break;
+			DISPATCH();
 
-		case op_sub: // 0x02 (02)
+		OPCODE_CASE(op_sub): // 0x02 (02)
 			s->r_acc = POP32() - s->r_acc;
-			break;
+			DISPATCH();
 
-		case op_mul: // 0x03 (03)
+		OPCODE_CASE(op_mul): // 0x03 (03)
 			s->r_acc = POP32() * s->r_acc;
-			break;
+			DISPATCH();
 
-		case op_div: // 0x04 (04)
+		OPCODE_CASE(op_div): // 0x04 (04)
 			// we check for division by 0 inside the custom reg_t division operator
 			s->r_acc = POP32() / s->r_acc;
-			break;
+			DISPATCH();
 
-		case op_mod: // 0x05 (05)
+		OPCODE_CASE(op_mod): // 0x05 (05)
 			// we check for division by 0 inside the custom reg_t modulo operator
 			s->r_acc = POP32() % s->r_acc;
-			break;
+			DISPATCH();
 
-		case op_shr: // 0x06 (06)
+		OPCODE_CASE(op_shr): // 0x06 (06)
 			// Shift right logical
 			s->r_acc = POP32() >> s->r_acc;
-			break;
+			DISPATCH();
 
-		case op_shl: // 0x07 (07)
+		OPCODE_CASE(op_shl): // 0x07 (07)
 			// Shift left logical
 			s->r_acc = POP32() << s->r_acc;
-			break;
+			DISPATCH();
 
-		case op_xor: // 0x08 (08)
+		OPCODE_CASE(op_xor): // 0x08 (08)
 			s->r_acc = POP32() ^ s->r_acc;
-			break;
+			DISPATCH();
 
-		case op_and: // 0x09 (09)
+		OPCODE_CASE(op_and): // 0x09 (09)
 			s->r_acc = POP32() & s->r_acc;
-			break;
+			DISPATCH();
 
-		case op_or: // 0x0a (10)
+		OPCODE_CASE(op_or): // 0x0a (10)
 			s->r_acc = POP32() | s->r_acc;
-			break;
+			DISPATCH();
 
-		case op_neg:	// 0x0b (11)
+		OPCODE_CASE(op_neg):	// 0x0b (11)
 			s->r_acc = make_reg(0, -s->r_acc.requireSint16());
-			break;
+			DISPATCH();
 
-		case op_not: // 0x0c (12)
+		OPCODE_CASE(op_not): // 0x0c (12)
 			s->r_acc = make_reg(0, !(s->r_acc.getOffset() || s->r_acc.getSegment()));
 			// Must allow pointers to be negated, as this is used for checking whether objects exist
-			break;
+			DISPATCH();
 
-		case op_eq_: // 0x0d (13)
+		OPCODE_CASE(op_eq_): // 0x0d (13)
 			s->r_prev = s->r_acc;
 			s->r_acc  = make_reg(0, POP32() == s->r_acc);
-			break;
+			DISPATCH();
 
-		case op_ne_: // 0x0e (14)
+		OPCODE_CASE(op_ne_): // 0x0e (14)
 			s->r_prev = s->r_acc;
 			s->r_acc  = make_reg(0, POP32() != s->r_acc);
-			break;
+			DISPATCH();
 
-		case op_gt_: // 0x0f (15)
+		OPCODE_CASE(op_gt_): // 0x0f (15)
 			s->r_prev = s->r_acc;
 			s->r_acc  = make_reg(0, POP32() > s->r_acc);
-			break;
+			DISPATCH();
 
-		case op_ge_: // 0x10 (16)
+		OPCODE_CASE(op_ge_): // 0x10 (16)
 			s->r_prev = s->r_acc;
 			s->r_acc  = make_reg(0, POP32() >= s->r_acc);
-			break;
+			DISPATCH();
 
-		case op_lt_: // 0x11 (17)
+		OPCODE_CASE(op_lt_): // 0x11 (17)
 			s->r_prev = s->r_acc;
 			s->r_acc  = make_reg(0, POP32() < s->r_acc);
-			break;
+			DISPATCH();
 
-		case op_le_: // 0x12 (18)
+		OPCODE_CASE(op_le_): // 0x12 (18)
 			s->r_prev = s->r_acc;
 			s->r_acc  = make_reg(0, POP32() <= s->r_acc);
-			break;
+			DISPATCH();
 
-		case op_ugt_: // 0x13 (19)
+		OPCODE_CASE(op_ugt_): // 0x13 (19)
 			// > (unsigned)
 			s->r_prev = s->r_acc;
 			s->r_acc  = make_reg(0, POP32().gtU(s->r_acc));
-			break;
+			DISPATCH();
 
-		case op_uge_: // 0x14 (20)
+		OPCODE_CASE(op_uge_): // 0x14 (20)
 			// >= (unsigned)
 			s->r_prev = s->r_acc;
 			s->r_acc  = make_reg(0, POP32().geU(s->r_acc));
-			break;
+			DISPATCH();
 
-		case op_ult_: // 0x15 (21)
+		OPCODE_CASE(op_ult_): // 0x15 (21)
 			// < (unsigned)
 			s->r_prev = s->r_acc;
 			s->r_acc  = make_reg(0, POP32().ltU(s->r_acc));
-			break;
+			DISPATCH();
 
-		case op_ule_: // 0x16 (22)
+		OPCODE_CASE(op_ule_): // 0x16 (22)
 			// <= (unsigned)
 			s->r_prev = s->r_acc;
 			s->r_acc  = make_reg(0, POP32().leU(s->r_acc));
-			break;
+			DISPATCH();
 
-		case op_bt: // 0x17 (23)
+		OPCODE_CASE(op_bt): // 0x17 (23)
 			// Branch relative if true
 			if (s->r_acc.getOffset() || s->r_acc.getSegment())
 				s->xs->addr.pc.incOffset(opparams[0]);
@@ -763,9 +874,9 @@ void run_vm(EngineState *s) {
 			if (s->xs->addr.pc.getOffset() >= local_script->getScriptSize())
 				error("[VM] op_bt: request to jump past the end of script %d (offset %d, script is %d bytes)",
 					local_script->getScriptNumber(), s->xs->addr.pc.getOffset(), local_script->getScriptSize());
-			break;
+			DISPATCH();
 
-		case op_bnt: // 0x18 (24)
+		OPCODE_CASE(op_bnt): // 0x18 (24)
 			// Branch relative if not true
 			if (!(s->r_acc.getOffset() || s->r_acc.getSegment()))
 				s->xs->addr.pc.incOffset(opparams[0]);
@@ -773,43 +884,43 @@ void run_vm(EngineState *s) {
 			if (s->xs->addr.pc.getOffset() >= local_script->getScriptSize())
 				error("[VM] op_bnt: request to jump past the end of script %d (offset %d, script is %d bytes)",
 					local_script->getScriptNumber(), s->xs->addr.pc.getOffset(), local_script->getScriptSize());
-			break;
+			DISPATCH();
 
-		case op_jmp: // 0x19 (25)
+		OPCODE_CASE(op_jmp): // 0x19 (25)
 			s->xs->addr.pc.incOffset(opparams[0]);
 
 			if (s->xs->addr.pc.getOffset() >= local_script->getScriptSize())
 				error("[VM] op_jmp: request to jump past the end of script %d (offset %d, script is %d bytes)",
 					local_script->getScriptNumber(), s->xs->addr.pc.getOffset(), local_script->getScriptSize());
-			break;
+			DISPATCH();
 
-		case op_ldi: // 0x1a (26)
+		OPCODE_CASE(op_ldi): // 0x1a (26)
 			// Load data immediate
 			s->r_acc = make_reg(0, opparams[0]);
-			break;
+			DISPATCH();
 
-		case op_push: // 0x1b (27)
+		OPCODE_CASE(op_push): // 0x1b (27)
 			// Push to stack
 			PUSH32(s->r_acc);
-			break;
+			DISPATCH();
 
-		case op_pushi: // 0x1c (28)
+		OPCODE_CASE(op_pushi): // 0x1c (28)
 			// Push immediate
 			PUSH(opparams[0]);
-			break;
+			DISPATCH();
 
-		case op_toss: // 0x1d (29)
+		OPCODE_CASE(op_toss): // 0x1d (29)
 			// TOS (Top Of Stack) subtract
 			s->xs->sp--;
-			break;
+			DISPATCH();
 
-		case op_dup: // 0x1e (30)
+		OPCODE_CASE(op_dup): // 0x1e (30)
 			// Duplicate TOD (Top Of Stack) element
 			r_temp = s->xs->sp[-1];
 			PUSH32(r_temp);
-			break;
+			DISPATCH();
 
-		case op_link: // 0x1f (31)
+		OPCODE_CASE(op_link): // 0x1f (31)
 			s->variablesMax[VAR_TEMP] = s->xs->tempCount = opparams[0];
 
 			// We shouldn't initialize temp variables at all
@@ -818,9 +929,9 @@ void run_vm(EngineState *s) {
 				s->xs->sp[i] = make_reg(kUninitializedSegment, 0);
 
 			s->xs->sp += opparams[0];
-			break;
+			DISPATCH();
 
-		case op_call: { // 0x20 (32)
+		OPCODE_CASE(op_call): { // 0x20 (32)
 			// Call a script subroutine
 			int argc = (opparams[1] >> 1) // Given as offset, but we need count
 			           + 1 + s->r_rest;
@@ -843,10 +954,10 @@ void run_vm(EngineState *s) {
 			s->xs->sp = call_base;
 
 			s->_executionStackPosChanged = true;
-			break;
+			DISPATCH();
 		}
 
-		case op_callk: { // 0x21 (33)
+		OPCODE_CASE(op_callk): { // 0x21 (33)
 			// Run the garbage collector, if needed
 			if (s->gcCountDown-- <= 0) {
 				s->gcCountDown = s->scriptGCInterval;
@@ -880,10 +991,10 @@ void run_vm(EngineState *s) {
 			if (s->abortScriptProcessing != kAbortNone)
 				return; // Stop processing
 
-			break;
+			DISPATCH();
 		}
 
-		case op_callb: // 0x22 (34)
+		OPCODE_CASE(op_callb): // 0x22 (34)
 			// Call base script
 			temp = ((opparams[1] >> 1) + s->r_rest + 1);
 			s_temp = s->xs->sp;
@@ -895,9 +1006,9 @@ void run_vm(EngineState *s) {
 			s->r_rest = 0; // Used up the &rest adjustment
 			if (xs_new)    // in case of error, keep old stack
 				s->_executionStackPosChanged = true;
-			break;
+			DISPATCH();
 
-		case op_calle: // 0x23 (35)
+		OPCODE_CASE(op_calle): // 0x23 (35)
 			// Call external script
 			temp = ((opparams[2] >> 1) + s->r_rest + 1);
 			s_temp = s->xs->sp;
@@ -909,9 +1020,9 @@ void run_vm(EngineState *s) {
 			s->r_rest = 0; // Used up the &rest adjustment
 			if (xs_new)  // in case of error, keep old stack
 				s->_executionStackPosChanged = true;
-			break;
+			DISPATCH();
 
-		case op_ret: // 0x24 (36)
+		OPCODE_CASE(op_ret): // 0x24 (36)
 			// Return from an execution loop started by call, calle, callb, send, self or super
 			do {
 				StackPtr old_sp = s->xs->sp;
@@ -955,9 +1066,9 @@ void run_vm(EngineState *s) {
 			s->_executionStackPosChanged = true;
 			xs_new = s->xs;
 
-			break;
+			DISPATCH();
 
-		case op_send: // 0x25 (37)
+		OPCODE_CASE(op_send): // 0x25 (37)
 			// Send for one or more selectors
 			s_temp = s->xs->sp;
 			s->xs->sp -= ((opparams[0] >> 1) + s->r_rest); // Adjust stack
@@ -971,9 +1082,9 @@ void run_vm(EngineState *s) {
 
 			s->r_rest = 0;
 
-			break;
+			DISPATCH();
 
-		case op_info: // (38)
+		OPCODE_CASE(op_info): // (38)
 			if (getSciVersion() < SCI_VERSION_3)
 				error("Dummy opcode 0x%x called", opcode);	// should never happen
 
@@ -981,9 +1092,9 @@ void run_vm(EngineState *s) {
 				s->r_acc = obj->getInfoSelector();
 			else
 				PUSH32(obj->getInfoSelector());
-			break;
+			DISPATCH();
 
-		case op_superP: // (39)
+		OPCODE_CASE(op_superP): // (39)
 			if (getSciVersion() < SCI_VERSION_3)
 				error("Dummy opcode 0x%x called", opcode);	// should never happen
 
@@ -991,19 +1102,19 @@ void run_vm(EngineState *s) {
 				s->r_acc = obj->getSuperClassSelector();
 			else
 				PUSH32(obj->getSuperClassSelector());
-			break;
+			DISPATCH();
 
-		case op_class: // 0x28 (40)
+		OPCODE_CASE(op_class): // 0x28 (40)
 			// Get class address
 			s->r_acc = s->_segMan->getClassAddress((unsigned)opparams[0], SCRIPT_GET_LOCK,
 											s->xs->addr.pc.getSegment());
-			break;
+			DISPATCH();
 
 		case 0x29: // (41)
 			error("Dummy opcode 0x%x called", opcode);	// should never happen
-			break;
+			DISPATCH();
 
-		case op_self: // 0x2a (42)
+		OPCODE_CASE(op_self): // 0x2a (42)
 			// Send to self
 			s_temp = s->xs->sp;
 			s->xs->sp -= ((opparams[0] >> 1) + s->r_rest); // Adjust stack
@@ -1017,9 +1128,9 @@ void run_vm(EngineState *s) {
 				s->_executionStackPosChanged = true;
 
 			s->r_rest = 0;
-			break;
+			DISPATCH();
 
-		case op_super: // 0x2b (43)
+		OPCODE_CASE(op_super): // 0x2b (43)
 			// Send to any class
 			r_temp = s->_segMan->getClassAddress(opparams[0], SCRIPT_GET_LOAD, s->xs->addr.pc.getSegment());
 
@@ -1048,9 +1159,9 @@ void run_vm(EngineState *s) {
 				s->r_rest = 0;
 			}
 
-			break;
+			DISPATCH();
 
-		case op_rest: // 0x2c (44)
+		OPCODE_CASE(op_rest): // 0x2c (44)
 			// Pushes all or part of the parameter variable list on the stack
 			// Index 0 is argc, so normally this will be called as &rest 1 to
 			// forward all the arguments.
@@ -1060,9 +1171,9 @@ void run_vm(EngineState *s) {
 			for (; temp <= s->xs->argc; temp++)
 				PUSH32(s->xs->variables_argp[temp]);
 
-			break;
+			DISPATCH();
 
-		case op_lea: // 0x2d (45)
+		OPCODE_CASE(op_lea): // 0x2d (45)
 			// Load Effective Address
 			temp = (uint16) opparams[0] >> 1;
 			var_number = temp & 0x03; // Get variable type
@@ -1078,25 +1189,25 @@ void run_vm(EngineState *s) {
 			r_temp.setOffset(r_temp.getOffset() * 2); // variables are 16 bit
 			// That's the immediate address now
 			s->r_acc = r_temp;
-			break;
+			DISPATCH();
 
 
-		case op_selfID: // 0x2e (46)
+		OPCODE_CASE(op_selfID): // 0x2e (46)
 			// Get 'self' identity
 			s->r_acc = s->xs->objp;
-			break;
+			DISPATCH();
 
 		case 0x2f: // (47)
 			error("Dummy opcode 0x%x called", opcode);	// should never happen
-			break;
+			DISPATCH();
 
-		case op_pprev: // 0x30 (48)
+		OPCODE_CASE(op_pprev): // 0x30 (48)
 			// Pushes the value of the prev register, set by the last comparison
 			// bytecode (eq?, lt?, etc.), on the stack
 			PUSH32(s->r_prev);
-			break;
+			DISPATCH();
 
-		case op_pToa: // 0x31 (49)
+		OPCODE_CASE(op_pToa): // 0x31 (49)
 			// Property To Accumulator
 			if (g_sci->_debugState._activeBreakpointTypes & BREAK_SELECTORREAD) {
 				debugPropertyAccess(obj, s->xs->objp, opparams[0], NULL_SELECTOR,
@@ -1104,9 +1215,9 @@ void run_vm(EngineState *s) {
 				                    s->_segMan, BREAK_SELECTORREAD);
 			}
 			s->r_acc = validate_property(s, obj, opparams[0]);
-			break;
+			DISPATCH();
 
-		case op_aTop: // 0x32 (50)
+		OPCODE_CASE(op_aTop): // 0x32 (50)
 			{
 			// Accumulator To Property
 			reg_t &opProperty = validate_property(s, obj, opparams[0]);
@@ -1120,10 +1231,10 @@ void run_vm(EngineState *s) {
 #ifdef ENABLE_SCI32
 			updateInfoFlagViewVisible(obj, opparams[0], true);
 #endif
-			break;
+			DISPATCH();
 		}
 
-		case op_pTos: // 0x33 (51)
+		OPCODE_CASE(op_pTos): // 0x33 (51)
 			{
 			// Property To Stack
 			reg_t value = validate_property(s, obj, opparams[0]);
@@ -1133,10 +1244,10 @@ void run_vm(EngineState *s) {
 				                    s->_segMan, BREAK_SELECTORREAD);
 			}
 			PUSH32(value);
-			break;
+			DISPATCH();
 		}
 
-		case op_sTop: // 0x34 (52)
+		OPCODE_CASE(op_sTop): // 0x34 (52)
 			{
 			// Stack To Property
 			reg_t newValue = POP32();
@@ -1150,13 +1261,13 @@ void run_vm(EngineState *s) {
 #ifdef ENABLE_SCI32
 			updateInfoFlagViewVisible(obj, opparams[0], true);
 #endif
-			break;
+			DISPATCH();
 		}
 
-		case op_ipToa: // 0x35 (53)
-		case op_dpToa: // 0x36 (54)
-		case op_ipTos: // 0x37 (55)
-		case op_dpTos: // 0x38 (56)
+		OPCODE_CASE(op_ipToa): // 0x35 (53)
+		OPCODE_CASE(op_dpToa): // 0x36 (54)
+		OPCODE_CASE(op_ipTos): // 0x37 (55)
+		OPCODE_CASE(op_dpTos): // 0x38 (56)
 			{
 			// Increment/decrement a property and copy to accumulator,
 			// or push to stack
@@ -1187,11 +1298,11 @@ void run_vm(EngineState *s) {
 				s->r_acc = opProperty;
 			else
 				PUSH32(opProperty);
-			break;
+			DISPATCH();
 		}
 
-		case op_lofsa: // 0x39 (57)
-		case op_lofss: { // 0x3a (58)
+		OPCODE_CASE(op_lofsa): // 0x39 (57)
+		OPCODE_CASE(op_lofss): { // 0x3a (58)
 			// Load offset to accumulator or push to stack
 
 			r_temp.setSegment(s->xs->addr.pc.getSegment());
@@ -1204,22 +1315,22 @@ void run_vm(EngineState *s) {
 				s->r_acc = r_temp;
 			else
 				PUSH32(r_temp);
-			break;
+			DISPATCH();
 		}
 
-		case op_push0: // 0x3b (59)
+		OPCODE_CASE(op_push0): // 0x3b (59)
 			PUSH(0);
-			break;
+			DISPATCH();
 
-		case op_push1: // 0x3c (60)
+		OPCODE_CASE(op_push1): // 0x3c (60)
 			PUSH(1);
-			break;
+			DISPATCH();
 
-		case op_push2: // 0x3d (61)
+		OPCODE_CASE(op_push2): // 0x3d (61)
 			PUSH(2);
-			break;
+			DISPATCH();
 
-		case op_pushSelf: // 0x3e (62)
+		OPCODE_CASE(op_pushSelf): // 0x3e (62)
 			// Compensate for a bug in non-Sierra compilers, which seem to generate
 			// pushSelf instructions with the low bit set. This makes the following
 			// heuristic fail and leads to endless loops and crashes. Our
@@ -1231,54 +1342,54 @@ void run_vm(EngineState *s) {
 			} else {
 				// Debug opcode op_file
 			}
-			break;
+			DISPATCH();
 
-		case op_line: // 0x3f (63)
+		OPCODE_CASE(op_line): // 0x3f (63)
 			// Debug opcode (line number)
 			//debug("Script %d, line %d", scr->getScriptNumber(), opparams[0]);
-			break;
+			DISPATCH();
 
-		case op_lag: // 0x40 (64)
-		case op_lal: // 0x41 (65)
-		case op_lat: // 0x42 (66)
-		case op_lap: // 0x43 (67)
+		OPCODE_CASE(op_lag): // 0x40 (64)
+		OPCODE_CASE(op_lal): // 0x41 (65)
+		OPCODE_CASE(op_lat): // 0x42 (66)
+		OPCODE_CASE(op_lap): // 0x43 (67)
 			// Load global, local, temp or param variable into the accumulator
-		case op_lagi: // 0x48 (72)
-		case op_lali: // 0x49 (73)
-		case op_lati: // 0x4a (74)
-		case op_lapi: // 0x4b (75)
+		OPCODE_CASE(op_lagi): // 0x48 (72)
+		OPCODE_CASE(op_lali): // 0x49 (73)
+		OPCODE_CASE(op_lati): // 0x4a (74)
+		OPCODE_CASE(op_lapi): // 0x4b (75)
 			// Same as the 4 ones above, except that the accumulator is used as
 			// an additional index
 			var_type = opcode & 0x3; // Gets the variable type: g, l, t or p
 			var_number = opparams[0] + (opcode >= op_lagi ? s->r_acc.requireSint16() : 0);
 			s->r_acc = read_var(s, var_type, var_number);
-			break;
+			DISPATCH();
 
-		case op_lsg: // 0x44 (68)
-		case op_lsl: // 0x45 (69)
-		case op_lst: // 0x46 (70)
-		case op_lsp: // 0x47 (71)
+		OPCODE_CASE(op_lsg): // 0x44 (68)
+		OPCODE_CASE(op_lsl): // 0x45 (69)
+		OPCODE_CASE(op_lst): // 0x46 (70)
+		OPCODE_CASE(op_lsp): // 0x47 (71)
 			// Load global, local, temp or param variable into the stack
-		case op_lsgi: // 0x4c (76)
-		case op_lsli: // 0x4d (77)
-		case op_lsti: // 0x4e (78)
-		case op_lspi: // 0x4f (79)
+		OPCODE_CASE(op_lsgi): // 0x4c (76)
+		OPCODE_CASE(op_lsli): // 0x4d (77)
+		OPCODE_CASE(op_lsti): // 0x4e (78)
+		OPCODE_CASE(op_lspi): // 0x4f (79)
 			// Same as the 4 ones above, except that the accumulator is used as
 			// an additional index
 			var_type = opcode & 0x3; // Gets the variable type: g, l, t or p
 			var_number = opparams[0] + (opcode >= op_lsgi ? s->r_acc.requireSint16() : 0);
 			PUSH32(read_var(s, var_type, var_number));
-			break;
+			DISPATCH();
 
-		case op_sag: // 0x50 (80)
-		case op_sal: // 0x51 (81)
-		case op_sat: // 0x52 (82)
-		case op_sap: // 0x53 (83)
+		OPCODE_CASE(op_sag): // 0x50 (80)
+		OPCODE_CASE(op_sal): // 0x51 (81)
+		OPCODE_CASE(op_sat): // 0x52 (82)
+		OPCODE_CASE(op_sap): // 0x53 (83)
 			// Save the accumulator into the global, local, temp or param variable
-		case op_sagi: // 0x58 (88)
-		case op_sali: // 0x59 (89)
-		case op_sati: // 0x5a (90)
-		case op_sapi: // 0x5b (91)
+		OPCODE_CASE(op_sagi): // 0x58 (88)
+		OPCODE_CASE(op_sali): // 0x59 (89)
+		OPCODE_CASE(op_sati): // 0x5a (90)
+		OPCODE_CASE(op_sapi): // 0x5b (91)
 			// Save the accumulator into the global, local, temp or param variable,
 			// using the accumulator as an additional index
 			var_type = opcode & 0x3; // Gets the variable type: g, l, t or p
@@ -1286,52 +1397,52 @@ void run_vm(EngineState *s) {
 			if (opcode >= op_sagi)	// load the actual value to store in the accumulator
 				s->r_acc = POP32();
 			write_var(s, var_type, var_number, s->r_acc);
-			break;
+			DISPATCH();
 
-		case op_ssg: // 0x54 (84)
-		case op_ssl: // 0x55 (85)
-		case op_sst: // 0x56 (86)
-		case op_ssp: // 0x57 (87)
+		OPCODE_CASE(op_ssg): // 0x54 (84)
+		OPCODE_CASE(op_ssl): // 0x55 (85)
+		OPCODE_CASE(op_sst): // 0x56 (86)
+		OPCODE_CASE(op_ssp): // 0x57 (87)
 			// Save the stack into the global, local, temp or param variable
-		case op_ssgi: // 0x5c (92)
-		case op_ssli: // 0x5d (93)
-		case op_ssti: // 0x5e (94)
-		case op_sspi: // 0x5f (95)
+		OPCODE_CASE(op_ssgi): // 0x5c (92)
+		OPCODE_CASE(op_ssli): // 0x5d (93)
+		OPCODE_CASE(op_ssti): // 0x5e (94)
+		OPCODE_CASE(op_sspi): // 0x5f (95)
 			// Same as the 4 ones above, except that the accumulator is used as
 			// an additional index
 			var_type = opcode & 0x3; // Gets the variable type: g, l, t or p
 			var_number = opparams[0] + (opcode >= op_ssgi ? s->r_acc.requireSint16() : 0);
 			write_var(s, var_type, var_number, POP32());
-			break;
+			DISPATCH();
 
-		case op_plusag: // 0x60 (96)
-		case op_plusal: // 0x61 (97)
-		case op_plusat: // 0x62 (98)
-		case op_plusap: // 0x63 (99)
+		OPCODE_CASE(op_plusag): // 0x60 (96)
+		OPCODE_CASE(op_plusal): // 0x61 (97)
+		OPCODE_CASE(op_plusat): // 0x62 (98)
+		OPCODE_CASE(op_plusap): // 0x63 (99)
 			// Increment the global, local, temp or param variable and save it
 			// to the accumulator
-		case op_plusagi: // 0x68 (104)
-		case op_plusali: // 0x69 (105)
-		case op_plusati: // 0x6a (106)
-		case op_plusapi: // 0x6b (107)
+		OPCODE_CASE(op_plusagi): // 0x68 (104)
+		OPCODE_CASE(op_plusali): // 0x69 (105)
+		OPCODE_CASE(op_plusati): // 0x6a (106)
+		OPCODE_CASE(op_plusapi): // 0x6b (107)
 			// Same as the 4 ones above, except that the accumulator is used as
 			// an additional index
 			var_type = opcode & 0x3; // Gets the variable type: g, l, t or p
 			var_number = opparams[0] + (opcode >= op_plusagi ? s->r_acc.requireSint16() : 0);
 			s->r_acc = read_var(s, var_type, var_number) + 1;
 			write_var(s, var_type, var_number, s->r_acc);
-			break;
+			DISPATCH();
 
-		case op_plussg: // 0x64 (100)
-		case op_plussl: // 0x65 (101)
-		case op_plusst: // 0x66 (102)
-		case op_plussp: // 0x67 (103)
+		OPCODE_CASE(op_plussg): // 0x64 (100)
+		OPCODE_CASE(op_plussl): // 0x65 (101)
+		OPCODE_CASE(op_plusst): // 0x66 (102)
+		OPCODE_CASE(op_plussp): // 0x67 (103)
 			// Increment the global, local, temp or param variable and save it
 			// to the stack
-		case op_plussgi: // 0x6c (108)
-		case op_plussli: // 0x6d (109)
-		case op_plussti: // 0x6e (110)
-		case op_plusspi: // 0x6f (111)
+		OPCODE_CASE(op_plussgi): // 0x6c (108)
+		OPCODE_CASE(op_plussli): // 0x6d (109)
+		OPCODE_CASE(op_plussti): // 0x6e (110)
+		OPCODE_CASE(op_plusspi): // 0x6f (111)
 			// Same as the 4 ones above, except that the accumulator is used as
 			// an additional index
 			var_type = opcode & 0x3; // Gets the variable type: g, l, t or p
@@ -1339,36 +1450,36 @@ void run_vm(EngineState *s) {
 			r_temp = read_var(s, var_type, var_number) + 1;
 			PUSH32(r_temp);
 			write_var(s, var_type, var_number, r_temp);
-			break;
+			DISPATCH();
 
-		case op_minusag: // 0x70 (112)
-		case op_minusal: // 0x71 (113)
-		case op_minusat: // 0x72 (114)
-		case op_minusap: // 0x73 (115)
+		OPCODE_CASE(op_minusag): // 0x70 (112)
+		OPCODE_CASE(op_minusal): // 0x71 (113)
+		OPCODE_CASE(op_minusat): // 0x72 (114)
+		OPCODE_CASE(op_minusap): // 0x73 (115)
 			// Decrement the global, local, temp or param variable and save it
 			// to the accumulator
-		case op_minusagi: // 0x78 (120)
-		case op_minusali: // 0x79 (121)
-		case op_minusati: // 0x7a (122)
-		case op_minusapi: // 0x7b (123)
+		OPCODE_CASE(op_minusagi): // 0x78 (120)
+		OPCODE_CASE(op_minusali): // 0x79 (121)
+		OPCODE_CASE(op_minusati): // 0x7a (122)
+		OPCODE_CASE(op_minusapi): // 0x7b (123)
 			// Same as the 4 ones above, except that the accumulator is used as
 			// an additional index
 			var_type = opcode & 0x3; // Gets the variable type: g, l, t or p
 			var_number = opparams[0] + (opcode >= op_minusagi ? s->r_acc.requireSint16() : 0);
 			s->r_acc = read_var(s, var_type, var_number) - 1;
 			write_var(s, var_type, var_number, s->r_acc);
-			break;
+			DISPATCH();
 
-		case op_minussg: // 0x74 (116)
-		case op_minussl: // 0x75 (117)
-		case op_minusst: // 0x76 (118)
-		case op_minussp: // 0x77 (119)
+		OPCODE_CASE(op_minussg): // 0x74 (116)
+		OPCODE_CASE(op_minussl): // 0x75 (117)
+		OPCODE_CASE(op_minusst): // 0x76 (118)
+		OPCODE_CASE(op_minussp): // 0x77 (119)
 			// Decrement the global, local, temp or param variable and save it
 			// to the stack
-		case op_minussgi: // 0x7c (124)
-		case op_minussli: // 0x7d (125)
-		case op_minussti: // 0x7e (126)
-		case op_minusspi: // 0x7f (127)
+		OPCODE_CASE(op_minussgi): // 0x7c (124)
+		OPCODE_CASE(op_minussli): // 0x7d (125)
+		OPCODE_CASE(op_minussti): // 0x7e (126)
+		OPCODE_CASE(op_minusspi): // 0x7f (127)
 			// Same as the 4 ones above, except that the accumulator is used as
 			// an additional index
 			var_type = opcode & 0x3; // Gets the variable type: g, l, t or p
@@ -1376,25 +1487,26 @@ void run_vm(EngineState *s) {
 			r_temp = read_var(s, var_type, var_number) - 1;
 			PUSH32(r_temp);
 			write_var(s, var_type, var_number, r_temp);
-			break;
+			DISPATCH();
 
-		default:
+		OPCODE_DEFAULT:
 			error("run_vm(): illegal opcode %x", opcode);
 
 		} // switch (opcode)
 
-		if (s->_executionStackPosChanged) // Force initialization
-			s->xs = xs_new;
-
-		if (s->xs != &(s->_executionStack.back())) {
-			error("xs is stale (%p vs %p); last command was %02x",
-					(void *)s->xs, (void *)&(s->_executionStack.back()),
-					opcode);
-		}
-		++s->scriptStepCounter;
+		finishInstruction(s, xs_new, opcode);
 	}
 }
 
+#ifdef SCI_VM_COMPUTED_GOTO
+#pragma GCC diagnostic pop
+#endif
+
+#undef DISPATCH
+#undef CHECK_INFINITE_LOOP
+#undef OPCODE_CASE
+#undef OPCODE_DEFAULT
+
 reg_t *ObjVarRef::getPointer(SegManager *segMan) const {
 	Object *o = segMan->getObject(obj);
 	return o ? &o->getVariableRef(varindex) : nullptr;
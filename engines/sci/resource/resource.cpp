@@ -25,6 +25,7 @@
 #include "common/file.h"
 #include "common/fs.h"
 #include "common/macresman.h"
+#include "common/system.h"
 #include "common/textconsole.h"
 #include "common/translation.h"
 #ifdef ENABLE_SCI32
@@ -208,6 +209,7 @@ Resource::Resource(ResourceManager *resMan, ResourceId id) : SciSpan<const byte>
 	_status = kResStatusNoMalloc;
 	_lockers = 0;
 	_source = nullptr;
+	_compression = kCompNone;
 	_header = nullptr;
 	_headerSize = 0;
 }
@@ -419,10 +421,14 @@ void ResourceManager::disposeVolumeFileStream(Common::SeekableReadStream *fileSt
 }
 
 void ResourceManager::loadResource(Resource *res) {
+	const uint32 loadStart = g_system->getMillis();
+
 	res->_source->loadResource(this, res);
 	if (_patcher) {
 		_patcher->applyPatch(*res);
 	};
+
+	_cacheStats.loadTime += g_system->getMillis() - loadStart;
 }
 
 
@@ -1010,6 +1016,11 @@ void ResourceManager::init() {
 	_memoryLocked = 0;
 	_memoryLRU = 0;
 	_LRU.clear();
+	_cacheStats.hits = 0;
+	_cacheStats.misses = 0;
+	_cacheStats.evictions = 0;
+	_cacheStats.prefetches = 0;
+	_cacheStats.loadTime = 0;
 	_resMap.clear();
 	_audioMapSCI1 = nullptr;
 #ifdef ENABLE_SCI32
@@ -1083,6 +1094,12 @@ void ResourceManager::init() {
 		_maxMemoryLRU = 4096 * 1024; // 4MiB
 	}
 
+	// Hosts with plenty of memory may raise the budget further, to avoid
+	// decompressing the same views and pics again on every room change
+	if (!_detectionMode && ConfMan.getInt("sci_resource_cache_size") > 0) {
+		_maxMemoryLRU = ConfMan.getInt("sci_resource_cache_size") * 1024;
+	}
+
 	switch (_viewType) {
 	case kViewEga:
 		debugC(1, kDebugLevelResMan, "resMan: Detected EGA graphic resources");
@@ -1149,18 +1166,88 @@ void ResourceManager::addToLRU(Resource *res) {
 	res->_status = kResStatusEnqueued;
 }
 
+/**
+ * Returns the relative cost of loading a resource with the given compression
+ * again, per byte.
+ */
+static int getReloadCost(ResourceCompression compression) {
+	switch (compression) {
+	case kCompNone:
+		return 1;
+	case kCompLZW1View:
+	case kCompLZW1Pic:
+		// These are reordered after decompression
+		return 6;
+	default:
+		return 4;
+	}
+}
+
+Resource *ResourceManager::findEvictionCandidate() const {
+	// Among the least recently used resources, pick the one which is the
+	// cheapest to load again, so that compressed views and pics are not
+	// decompressed again and again while uncompressed data is around.
+	// Ties go to the least recently used resource.
+	enum { kEvictionWindow = 8 };
+
+	Resource *candidate = nullptr;
+	int candidateCost = 0;
+	int window = kEvictionWindow;
+	for (Common::List<Resource *>::const_iterator it = _LRU.reverse_begin(); it != _LRU.end() && window > 0; --it, --window) {
+		const int cost = getReloadCost((*it)->_compression);
+		if (!candidate || cost < candidateCost) {
+			candidate = *it;
+			candidateCost = cost;
+		}
+	}
+
+	return candidate;
+}
+
 void ResourceManager::freeOldResources() {
 	while (_maxMemoryLRU < _memoryLRU) {
 		assert(!_LRU.empty());
-		Resource *goner = _LRU.back();
+		Resource *goner = findEvictionCandidate();
 		removeFromLRU(goner);
 		goner->unalloc();
+		_cacheStats.evictions++;
 #ifdef SCI_VERBOSE_RESMAN
 		debug("resMan-debug: LRU: Freeing %s (%d bytes)", goner->_id.toString().c_str(), goner->size);
 #endif
 	}
 }
 
+void ResourceManager::setMaxMemoryLRU(int maxMemory) {
+	_maxMemoryLRU = maxMemory;
+	freeOldResources();
+}
+
+void ResourceManager::prefetchResources(uint16 number) {
+	static const ResourceType prefetchTypes[] = {
+		kResourceTypePic, kResourceTypePalette, kResourceTypeView, kResourceTypeMessage
+	};
+
+	for (int i = 0; i < ARRAYSIZE(prefetchTypes); i++) {
+		// Only use the part of the budget which is likely to be free, so
+		// that prefetching does not push out resources which are in use
+		if (_memoryLRU >= _maxMemoryLRU / 2)
+			return;
+
+		Resource *res = testResource(ResourceId(prefetchTypes[i], number));
+		if (!res || res->_status != kResStatusNoMalloc)
+			continue;
+
+		loadResource(res);
+		if (res->_status != kResStatusAllocated)
+			continue;
+
+		debugC(2, kDebugLevelResMan, "[resMan] Prefetched %s", res->_id.toString().c_str());
+		addToLRU(res);
+		_cacheStats.prefetches++;
+		freeOldResources();
+	}
+}
+
 Common::List<ResourceId> ResourceManager::listResources(ResourceType type, int mapNumber) {
 	Common::List<ResourceId> resources;
 
@@ -1197,15 +1284,19 @@ Resource *ResourceManager::findResource(ResourceId id, bool lock) {
 	if (!retval)
 		return nullptr;
 
-	if (retval->_status == kResStatusNoMalloc)
+	if (retval->_status == kResStatusNoMalloc) {
+		_cacheStats.misses++;
 		loadResource(retval);
-	else if (retval->_status == kResStatusEnqueued)
-		// The resource is removed from its current position
-		// in the LRU list because it has been requested
-		// again. Below, it will either be locked, or it
-		// will be added back to the LRU list at the 'most
-		// recent' position.
-		removeFromLRU(retval);
+	} else {
+		_cacheStats.hits++;
+		if (retval->_status == kResStatusEnqueued)
+			// The resource is removed from its current position
+			// in the LRU list because it has been requested
+			// again. Below, it will either be locked, or it
+			// will be added back to the LRU list at the 'most
+			// recent' position.
+			removeFromLRU(retval);
+	}
 
 	// Unless an error occurred, the resource is now either
 	// locked or allocated, but never queued or freed.
@@ -2399,6 +2490,7 @@ int Resource::decompress(ResVersion volVersion, Common::SeekableReadStream *file
 	byte *ptr = new byte[_size];
 	_data = ptr;
 	_status = kResStatusAllocated;
+	_compression = compression;
 	errorNum = ptr ? dec->unpack(file, ptr, szPacked, _size) : SCI_ERROR_RESOURCE_TOO_BIG;
 	if (errorNum) {
 		unalloc();
@@ -311,6 +311,7 @@ protected:
 	uint16 _lockers; /**< Number of places where this resource was locked */
 	ResourceSource *_source;
 	ResourceManager *_resMan;
+	ResourceCompression _compression; /**< Compression of the resource in its volume, used to estimate the cost of reloading it */
 
 	bool loadPatch(Common::SeekableReadStream *file);
 	bool loadFromPatchFile();
@@ -394,6 +395,35 @@ public:
 	 */
 	Resource *testResource(const ResourceId &id) const;
 
+	/**
+	 * Loads resources which are likely to be needed soon, into the free part
+	 * of the LRU budget. This is called when a script is loaded, and loads
+	 * the pic, palette, view and message resources sharing its number, since
+	 * room scripts usually use these.
+	 * @param number	The number of the script being loaded
+	 */
+	void prefetchResources(uint16 number);
+
+	/** Statistics of the resource cache, shown by the resource_cache console command. */
+	struct CacheStats {
+		uint32 hits;		///< Number of findResource() calls served from memory
+		uint32 misses;		///< Number of findResource() calls which had to load the resource
+		uint32 evictions;	///< Number of resources freed to stay within the LRU budget
+		uint32 prefetches;	///< Number of resources loaded by prefetchResources()
+		uint32 loadTime;	///< Time spent loading and decompressing resources, in ms
+	};
+
+	const CacheStats &getCacheStats() const { return _cacheStats; }
+	int getMemoryLRU() const { return _memoryLRU; }
+	int getMemoryLocked() const { return _memoryLocked; }
+	int getMaxMemoryLRU() const { return _maxMemoryLRU; }
+
+	/**
+	 * Changes the amount of memory used by resources under LRU control,
+	 * evicting resources if necessary.
+	 */
+	void setMaxMemoryLRU(int maxMemory);
+
 	/**
 	 * Returns a list of all resources of the specified type.
 	 * @param type		The resource type to look for
@@ -501,6 +531,7 @@ protected:
 	int _memoryLocked;	///< Amount of resource bytes in locked memory
 	int _memoryLRU;		///< Amount of resource bytes under LRU control
 	Common::List<Resource *> _LRU; ///< Last Resource Used list
+	CacheStats _cacheStats;
 	ResourceMap _resMap;
 	Common::List<Common::File *> _volumeFiles; ///< list of opened volume files
 	ResourceSource *_audioMapSCI1; ///< Currently loaded audio map for SCI1
@@ -562,6 +593,7 @@ protected:
 	void disposeVolumeFileStream(Common::SeekableReadStream *fileStream, ResourceSource *source);
 	void loadResource(Resource *res);
 	void freeOldResources();
+	Resource *findEvictionCandidate() const;
 	bool validateResource(const ResourceId &resourceId, const Common::Path &sourceMapLocation, const Common::Path &sourceName, const uint32 offset, const uint32 size, const uint32 sourceSize) const;
 	Resource *addResource(ResourceId resId, ResourceSource *src, uint32 offset, uint32 size = 0, const Common::Path &sourceMapLocation = Common::Path("(no map location)"));
 	Resource *updateResource(ResourceId resId, ResourceSource *src, uint32 size, const Common::Path &sourceMapLocation = Common::Path("(no map location)"));
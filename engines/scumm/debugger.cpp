@@ -39,6 +39,8 @@
 
 namespace Scumm {
 
+extern const char *nameOfResType(ResType type);
+
 void debugC(int channel, const char *s, ...) {
 	char buf[STRINGBUFLEN];
 	va_list va;
@@ -87,6 +89,7 @@ ScummDebugger::ScummDebugger(ScummEngine *s)
 	registerCmd("cosdump",   WRAP_METHOD(ScummDebugger, Cmd_Cosdump));
 	registerCmd("scripts",   WRAP_METHOD(ScummDebugger, Cmd_PrintScript));
 	registerCmd("importres", WRAP_METHOD(ScummDebugger, Cmd_ImportRes));
+	registerCmd("heap",      WRAP_METHOD(ScummDebugger, Cmd_Heap));
 
 	if (_vm->_game.id == GID_LOOM)
 		registerCmd("drafts",  WRAP_METHOD(ScummDebugger, Cmd_PrintDraft));
@@ -1408,6 +1411,43 @@ bool ScummDebugger::Cmd_Passcode(int argc, const char **argv) {
 	return false;
 }
 
+bool ScummDebugger::Cmd_Heap(int argc, const char **argv) {
+	ResourceManager *res = _vm->_res;
+	uint32 totalSize = 0, lockedSize = 0, expirableSize = 0;
+
+	debugPrintf("Type           Loaded       Size  Locked  Locked size  Expirable\n");
+	for (ResType type = rtFirst; type <= rtLast; type = ResType(type + 1)) {
+		uint32 loaded = 0, size = 0, locked = 0, typeLockedSize = 0, expirable = 0;
+
+		for (ResId idx = 0; idx < res->_types[type].size(); idx++) {
+			const ResourceManager::Resource &tmp = res->_types[type][idx];
+			if (!tmp._address || tmp.isOffHeap())
+				continue;
+
+			loaded++;
+			size += tmp._size;
+			if (tmp.isLocked()) {
+				locked++;
+				typeLockedSize += tmp._size;
+			} else if (res->_types[type]._mode != kDynamicResTypeMode) {
+				expirable += tmp._size;
+			}
+		}
+
+		if (!loaded)
+			continue;
+
+		debugPrintf("%-12s %8u %10u %7u %12u %10u\n", nameOfResType(type), loaded, size, locked, typeLockedSize, expirable);
+		totalSize += size;
+		lockedSize += typeLockedSize;
+		expirableSize += expirable;
+	}
+
+	debugPrintf("Total: %u bytes, %u locked, %u expirable\n", totalSize, lockedSize, expirableSize);
+	debugPrintf("Heap size %u, thresholds %u - %u\n", res->getHeapSize(), res->getMinHeapThreshold(), res->getMaxHeapThreshold());
+	return true;
+}
+
 bool ScummDebugger::Cmd_ResetCursors(int argc, const char **argv) {
 	_vm->resetCursors();
 	detach();
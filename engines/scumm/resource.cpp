@@ -19,6 +19,7 @@
  *
  */
 
+#include "common/algorithm.h"
 #include "common/md5.h"
 #include "common/str.h"
 #include "common/memstream.h"
@@ -543,6 +544,8 @@ void ResourceManager::allocResTypeData(ResType type, uint32 tag, int num, ResTyp
 
 	// If there was data in there, let's clear it out completely. This is important
 	// in case we are restarting the game.
+	for (ResId idx = 0; idx < _types[type].size(); idx++)
+		unlinkExpireList(_types[type][idx]);
 	_types[type].clear();
 	_types[type].resize(num);
 
@@ -823,6 +826,45 @@ void ResourceManager::increaseResourceCounters() {
 
 void ResourceManager::setResourceCounter(ResType type, ResId idx, byte counter) {
 	_types[type][idx].setResourceCounter(counter);
+	updateExpireList(type, idx);
+}
+
+void ResourceManager::updateExpireList(ResType type, ResId idx) {
+	Resource &res = _types[type][idx];
+
+	byte list = kNotExpirable;
+	if (res._address && !res.isLocked() && !res.isOffHeap() && _types[type]._mode != kDynamicResTypeMode)
+		list = res.getResourceCounter();
+
+	if (list == res._expireList)
+		return;
+
+	unlinkExpireList(res);
+	if (list == kNotExpirable)
+		return;
+
+	const uint32 ref = expireRef(type, idx);
+	res._expireList = list;
+	res._expirePrev = 0;
+	res._expireNext = _expireLists[list];
+	if (res._expireNext)
+		getExpireRes(res._expireNext)._expirePrev = ref;
+	_expireLists[list] = ref;
+}
+
+void ResourceManager::unlinkExpireList(Resource &res) {
+	if (res._expireList == kNotExpirable)
+		return;
+
+	if (res._expirePrev)
+		getExpireRes(res._expirePrev)._expireNext = res._expireNext;
+	else
+		_expireLists[res._expireList] = res._expireNext;
+	if (res._expireNext)
+		getExpireRes(res._expireNext)._expirePrev = res._expirePrev;
+
+	res._expireList = kNotExpirable;
+	res._expirePrev = res._expireNext = 0;
 }
 
 void ResourceManager::Resource::setResourceCounter(byte counter) {
@@ -883,6 +925,8 @@ ResourceManager::Resource::Resource() {
 	_status = 0;
 	_roomno = 0;
 	_roomoffs = 0;
+	_expireList = ResourceManager::kNotExpirable;
+	_expirePrev = _expireNext = 0;
 }
 
 ResourceManager::Resource::~Resource() {
@@ -911,6 +955,7 @@ ResourceManager::ResourceManager(ScummEngine *vm) : _vm(vm) {
 	_maxHeapThreshold = 0;
 	_minHeapThreshold = 0;
 	_expireCounter = 0;
+	memset(_expireLists, 0, sizeof(_expireLists));
 }
 
 ResourceManager::~ResourceManager() {
@@ -938,6 +983,7 @@ void ResourceManager::nukeResource(ResType type, ResId idx) {
 		debugC(DEBUG_RESOURCE, "nukeResource(%s,%d)", nameOfResType(type), idx);
 		_allocatedSize -= _types[type][idx]._size;
 		_types[type][idx].nuke();
+		updateExpireList(type, idx);
 	}
 }
 
@@ -970,12 +1016,14 @@ void ResourceManager::lock(ResType type, ResId idx) {
 	if (!validateResource("Locking", type, idx))
 		return;
 	_types[type][idx].lock();
+	updateExpireList(type, idx);
 }
 
 void ResourceManager::unlock(ResType type, ResId idx) {
 	if (!validateResource("Unlocking", type, idx))
 		return;
 	_types[type][idx].unlock();
+	updateExpireList(type, idx);
 }
 
 bool ResourceManager::isLocked(ResType type, ResId idx) const {
@@ -1037,12 +1085,14 @@ void ResourceManager::setOffHeap(ResType type, ResId idx) {
 	if (!validateResource("setOffHeap", type, idx))
 		return;
 	_types[type][idx].setOffHeap();
+	updateExpireList(type, idx);
 }
 
 void ResourceManager::setOnHeap(ResType type, ResId idx) {
 	if (!validateResource("setOnHeap", type, idx))
 		return;
 	_types[type][idx].setOnHeap();
+	updateExpireList(type, idx);
 }
 
 bool ResourceManager::isModified(ResType type, ResId idx) const {
@@ -1078,9 +1128,6 @@ void ResourceManager::Resource::setOnHeap() {
 }
 
 void ResourceManager::expireResources(uint32 size) {
-	byte best_counter;
-	ResType best_type;
-	int best_res = 0;
 	uint32 oldAllocatedSize;
 
 	if (_expireCounter != 0xFF) {
@@ -1093,31 +1140,34 @@ void ResourceManager::expireResources(uint32 size) {
 
 	oldAllocatedSize = _allocatedSize;
 
-	do {
-		best_type = rtInvalid;
-		best_counter = 2;
-
-		for (ResType type = rtFirst; type <= rtLast; type = ResType(type + 1)) {
-			if (_types[type]._mode != kDynamicResTypeMode) {
-				// Resources of this type can be reloaded from the data files,
-				// so we can potentially unload them to free memory.
-				ResId idx = _types[type].size();
-				while (idx-- > 0) {
-					Resource &tmp = _types[type][idx];
-					byte counter = tmp.getResourceCounter();
-					if (!tmp.isLocked() && counter >= best_counter && tmp._address && !_vm->isResourceInUse(type, idx) && !tmp.isOffHeap()) {
-						best_counter = counter;
-						best_type = type;
-						best_res = idx;
-					}
-				}
-			}
+	// Nuke the resources with the highest counter first, and among those
+	// the ones of the highest type and the lowest index. The counters don't
+	// change while resources are nuked, so the resources of each list can be
+	// sorted once.
+	Common::Array<uint32> refs;
+	for (int counter = kExpireLists - 1; counter >= 2; counter--) {
+		refs.clear();
+		for (uint32 ref = _expireLists[counter]; ref; ref = getExpireRes(ref)._expireNext)
+			refs.push_back(ref);
+
+		Common::sort(refs.begin(), refs.end(), [](uint32 a, uint32 b) {
+			return (a >> 16) != (b >> 16) ? (a >> 16) > (b >> 16) : (a & 0xFFFF) < (b & 0xFFFF);
+		});
+
+		for (uint i = 0; i < refs.size(); i++) {
+			const ResType type = ResType(refs[i] >> 16);
+			const ResId idx = refs[i] & 0xFFFF;
+			if (_vm->isResourceInUse(type, idx))
+				continue;
+
+			nukeResource(type, idx);
+			if (size + _allocatedSize <= _minHeapThreshold)
+				break;
 		}
 
-		if (!best_type)
+		if (size + _allocatedSize <= _minHeapThreshold)
 			break;
-		nukeResource(best_type, best_res);
-	} while (size + _allocatedSize > _minHeapThreshold);
+	}
 
 	increaseResourceCounters();
 
@@ -80,6 +80,7 @@ protected:
 
 public:
 	class Resource {
+	friend class ResourceManager;
 	public:
 		/**
 		 * Pointer to the data contained in this resource
@@ -109,6 +110,15 @@ public:
 		 */
 		byte _status;
 
+		/**
+		 * The expiry list this resource is in, which is its counter, or
+		 * kNotExpirable if it can't be expired. The lists are linked
+		 * through _expirePrev and _expireNext, which refer to the other
+		 * resources as returned by ResourceManager::expireRef().
+		 */
+		byte _expireList;
+		uint32 _expirePrev, _expireNext;
+
 	public:
 		/**
 		 * The id of the room (resp. the disk) the resource is contained in.
@@ -175,12 +185,36 @@ protected:
 	uint32 _maxHeapThreshold, _minHeapThreshold;
 	byte _expireCounter;
 
+	enum {
+		kExpireLists = 128,
+		kNotExpirable = 0xFF
+	};
+
+	/**
+	 * The resources which expireResources() may nuke, that is the loaded,
+	 * unlocked and on heap resources of the types which can be reloaded,
+	 * in a doubly linked list for each counter value. This saves looking
+	 * through all resources for the ones with the highest counter.
+	 */
+	uint32 _expireLists[kExpireLists];
+
+	static uint32 expireRef(ResType type, ResId idx) { return (type << 16) | idx; }
+	Resource &getExpireRes(uint32 ref) { return _types[ref >> 16][ref & 0xFFFF]; }
+
+	/**
+	 * Move the resource to the expiry list matching its state.
+	 */
+	void updateExpireList(ResType type, ResId idx);
+	void unlinkExpireList(Resource &res);
+
 public:
 	ResourceManager(ScummEngine *vm);
 	~ResourceManager();
 
 	void setHeapThreshold(int min, int max);
 	uint32 getHeapSize() { return _allocatedSize; }
+	uint32 getMinHeapThreshold() const { return _minHeapThreshold; }
+	uint32 getMaxHeapThreshold() const { return _maxHeapThreshold; }
 
 	void allocResTypeData(ResType type, uint32 tag, int num, ResTypeMode mode);
 	void freeResources();
@@ -84,6 +84,9 @@ void FMVScreen::play(const Common::Path &name) {
 		error("Could not open %s", name.toString().c_str());
 	}
 	_decoder->setOutputPixelFormat(_bitmap->getBestPixelFormat());
+	// Decode a few frames ahead on a worker thread, high resolution videos
+	// have frames that take longer to decode than others
+	_decoder->setDecodeAhead(4);
 	_decoder->start();
 }
 
@@ -121,7 +121,9 @@ Common::ArchiveMemberPtr PackageManager::getArchiveMember(const Common::String &
 bool PackageManager::loadPackage(const Common::Path &fileName, const Common::String &mountPosition) {
 	debug(3, "loadPackage(%s, %s)", fileName.toString(Common::Path::kNativeSeparator).c_str(), mountPosition.c_str());
 
-	Common::Archive *zipFile = Common::makeZipArchive(fileName);
+	// Packages are big and can contain large files, which are better
+	// decompressed on the fly than loaded into memory at once
+	Common::Archive *zipFile = Common::makeZipArchive(fileName, false, Common::kZipDefaultStreamingThreshold);
 	if (zipFile == NULL) {
 		error("Unable to mount file \"%s\" to \"%s\"", fileName.toString(Common::Path::kNativeSeparator).c_str(), mountPosition.c_str());
 		return false;
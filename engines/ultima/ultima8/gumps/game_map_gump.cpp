@@ -383,6 +383,11 @@ void GameMapGump::IncSortOrder(int count) {
 	_displayList->IncSortLimit(count);
 }
 
+void GameMapGump::GetSortStats(uint32 &items, uint32 &comparisons) const {
+	items = _displayList->getItemCount();
+	comparisons = _displayList->getComparisonCount();
+}
+
 bool GameMapGump::StartDraggingItem(Item *item, int mx, int my) {
 //	ParentToGump(mx, my);
 
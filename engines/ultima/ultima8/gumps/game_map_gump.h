@@ -75,6 +75,7 @@ public:
 	void        onMouseDouble(int button, int32 mx, int32 my) override;
 
 	void IncSortOrder(int count);
+	void GetSortStats(uint32 &items, uint32 &comparisons) const;
 
 	bool loadData(Common::ReadStream *rs, uint32 version);
 	void saveData(Common::WriteStream *ws) override;
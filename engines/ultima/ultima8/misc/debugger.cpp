@@ -140,6 +140,7 @@ Debugger::Debugger() : GUI::Debugger() {
 	registerCmd("GameMapGump::dumpAllMaps", WRAP_METHOD(Debugger, cmdDumpAllMaps));
 	registerCmd("GameMapGump::incrementSortOrder", WRAP_METHOD(Debugger, cmdIncrementSortOrder));
 	registerCmd("GameMapGump::decrementSortOrder", WRAP_METHOD(Debugger, cmdDecrementSortOrder));
+	registerCmd("GameMapGump::sortStats", WRAP_METHOD(Debugger, cmdSortStats));
 
 	registerCmd("Kernel::processTypes", WRAP_METHOD(Debugger, cmdProcessTypes));
 	registerCmd("Kernel::processInfo", WRAP_METHOD(Debugger, cmdProcessInfo));
@@ -859,6 +860,19 @@ bool Debugger::cmdDecrementSortOrder(int argc, const char **argv) {
 	return false;
 }
 
+bool Debugger::cmdSortStats(int argc, const char **argv) {
+	GameMapGump *gump = Ultima8Engine::get_instance()->getGameMapGump();
+	if (!gump) {
+		debugPrintf("No game map gump\n");
+		return true;
+	}
+
+	uint32 items, comparisons;
+	gump->GetSortStats(items, comparisons);
+	debugPrintf("Sorted %u items with %u overlap checks in the last frame\n", items, comparisons);
+	return true;
+}
+
 
 bool Debugger::cmdProcessTypes(int argc, const char **argv) {
 	Kernel::get_instance()->processTypes();
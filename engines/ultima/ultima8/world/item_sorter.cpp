@@ -45,10 +45,13 @@ namespace Ultima8 {
 static const uint32 TRANSPARENT_COLOR = TEX32_PACK_RGBA(0x7F, 0x00, 0x00, 0x7F);
 static const uint32 HIGHLIGHT_COLOR = TEX32_PACK_RGBA(0xFF, 0xFF, 0x00, 0x1F);
 
+static const int32 GRID_CELL_SIZE = 64;
+
 ItemSorter::ItemSorter(int capacity) :
 	_shapes(nullptr), _clipWindow(0, 0, 0, 0), _items(nullptr), _itemsTail(nullptr),
 	_itemsUnused(nullptr), _painted(nullptr), _camSx(0), _camSy(0),
-	_sortLimit(0), _sortLimitChanged(false) {
+	_sortLimit(0), _sortLimitChanged(false), _gridCols(0), _gridRows(0),
+	_gridStamp(0), _itemCount(0), _comparisons(0) {
 	int i = capacity;
 	while (i--) {
 		SortItem *next = _itemsUnused;
@@ -88,6 +91,16 @@ void ItemSorter::BeginDisplayList(const Rect &clipWindow, int32 camx, int32 camy
 	_itemsTail = nullptr;
 	_painted = nullptr;
 
+	// Reset the grid, keeping the memory of the cells
+	_gridCols = MAX<int32>((clipWindow.width() + GRID_CELL_SIZE - 1) / GRID_CELL_SIZE, 1);
+	_gridRows = MAX<int32>((clipWindow.height() + GRID_CELL_SIZE - 1) / GRID_CELL_SIZE, 1);
+	_grid.resize(_gridCols * _gridRows);
+	for (uint i = 0; i < _grid.size(); i++)
+		_grid[i].resize(0);
+
+	_itemCount = 0;
+	_comparisons = 0;
+
 	// Screenspace bounding box bottom x coord (RNB x coord)
 	int32 camSx = (camx - camy) / 4;
 	// Screenspace bounding box bottom extent  (RNB y coord)
@@ -187,6 +200,24 @@ void ItemSorter::AddItem(int32 x, int32 y, int32 z, uint32 shapeNum, uint32 fram
 	// are never deleted
 	si->_depends.clear();
 
+	// Mark the items in the grid cells we touch, only these can overlap us
+	int32 gx1, gy1, gx2, gy2;
+	getGridRange(si->_sr, gx1, gy1, gx2, gy2);
+
+	_gridStamp++;
+	uint32 candidates = 0;
+	for (int32 gy = gy1; gy <= gy2; gy++) {
+		for (int32 gx = gx1; gx <= gx2; gx++) {
+			const Common::Array<SortItem *> &cell = _grid[gy * _gridCols + gx];
+			for (uint i = 0; i < cell.size(); i++) {
+				if (cell[i]->_gridStamp != _gridStamp) {
+					cell[i]->_gridStamp = _gridStamp;
+					candidates++;
+				}
+			}
+		}
+	}
+
 	// Iterate the list and compare _shapes
 
 	// Ok,
@@ -196,6 +227,15 @@ void ItemSorter::AddItem(int32 x, int32 y, int32 z, uint32 shapeNum, uint32 fram
 		if (!addpoint && si->listLessThan(*si2))
 			addpoint = si2;
 
+		// The list order of the checks matters, so the marked items are
+		// visited while walking the list up to the last of them
+		if (si2->_gridStamp != _gridStamp) {
+			if (addpoint && !candidates)
+				break;
+			continue;
+		}
+		candidates--;
+
 		if (si2->_occluded)
 			continue;
 
@@ -221,6 +261,7 @@ void ItemSorter::AddItem(int32 x, int32 y, int32 z, uint32 shapeNum, uint32 fram
 #endif // SORTITEM_OCCLUSION_EXPERIMENTAL
 
 		// Attempt to find paint dependency order
+		_comparisons++;
 		if (si->overlap(*si2)) {
 			if (si->below(*si2)) {
 				if (si2->_occl && si2->occludes(*si)) {
@@ -267,6 +308,17 @@ void ItemSorter::AddItem(int32 x, int32 y, int32 z, uint32 shapeNum, uint32 fram
 		si->_prev = _itemsTail;
 		_itemsTail = si;
 	}
+
+	_itemCount++;
+
+	// Occluded items are skipped by the checks, so leave them out of the grid
+	if (!si->_occluded) {
+		for (int32 gy = gy1; gy <= gy2; gy++) {
+			for (int32 gx = gx1; gx <= gx2; gx++) {
+				_grid[gy * _gridCols + gx].push_back(si);
+			}
+		}
+	}
 }
 
 void ItemSorter::AddItem(const Item *add) {
@@ -626,6 +678,14 @@ uint16 ItemSorter::Trace(int32 x, int32 y, HitFace *face, bool item_highlight) {
 	return 0;
 }
 
+void ItemSorter::getGridRange(const Rect &r, int32 &x1, int32 &y1, int32 &x2, int32 &y2) const {
+	// Parts outside of the clip window end up in the border cells
+	x1 = CLIP<int32>((r.left - _clipWindow.left) / GRID_CELL_SIZE, 0, _gridCols - 1);
+	y1 = CLIP<int32>((r.top - _clipWindow.top) / GRID_CELL_SIZE, 0, _gridRows - 1);
+	x2 = CLIP<int32>((r.right - 1 - _clipWindow.left) / GRID_CELL_SIZE, 0, _gridCols - 1);
+	y2 = CLIP<int32>((r.bottom - 1 - _clipWindow.top) / GRID_CELL_SIZE, 0, _gridRows - 1);
+}
+
 void ItemSorter::IncSortLimit(int count) {
 	_sortLimit += count;
 	_sortLimitChanged = true;
@@ -22,6 +22,7 @@
 #ifndef ULTIMA8_WORLD_ITEMSORTER_H
 #define ULTIMA8_WORLD_ITEMSORTER_H
 
+#include "common/array.h"
 #include "ultima/ultima8/misc/rect.h"
 
 namespace Ultima {
@@ -45,6 +46,16 @@ class ItemSorter {
 	int32       _sortLimit;
 	bool        _sortLimitChanged;
 
+	// Screenspace grid of the listed items, so added items are only
+	// compared against the items which can overlap them
+	Common::Array<Common::Array<SortItem *> > _grid;
+	int32       _gridCols, _gridRows;
+	uint32      _gridStamp;
+
+	// Statistics of the current display list
+	uint32      _itemCount;
+	uint32      _comparisons;
+
 public:
 	ItemSorter(int capacity);
 	~ItemSorter();
@@ -68,8 +79,15 @@ public:
 
 	void IncSortLimit(int count);
 
+	// Number of items and of overlap checks done for the current display list
+	uint32 getItemCount() const { return _itemCount; }
+	uint32 getComparisonCount() const { return _comparisons; }
+
 private:
 	bool PaintSortItem(RenderSurface *surf, SortItem *si, bool showFootpad);
+
+	// Get the range of grid cells touched by a screenspace rect
+	void getGridRange(const Rect &r, int32 &x1, int32 &y1, int32 &x2, int32 &y2) const;
 };
 
 } // End of namespace Ultima8
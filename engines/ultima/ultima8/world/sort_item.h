@@ -50,7 +50,7 @@ struct SortItem {
 			_occl(false), _solid(false), _draw(false), _roof(false),
 			_noisy(false), _anim(false), _trans(false), _fixed(false),
 			_land(false), _occluded(false), _sprite(false),
-			_invitem(false) { }
+			_invitem(false), _gridStamp(0) { }
 
 	SortItem                *_next;
 	SortItem                *_prev;
@@ -120,6 +120,8 @@ struct SortItem {
 
 	int32   _order;      // Rendering _order. -1 is not yet drawn
 
+	uint32  _gridStamp;  // Last ItemSorter::AddItem call which found this in the grid
+
 	// Note that Std::priority_queue could be used here, BUT there is no guarentee that it's implementation
 	// will be friendly to insertions
 	// Alternatively i could use Std::list, BUT there is no guarentee that it will keep wont delete
@@ -0,0 +1,182 @@
+/* ScummVM - Graphic Adventure Engine
+ *
+ * ScummVM is the legal property of its developers, whose names
+ * are too numerous to list here. Please refer to the COPYRIGHT
+ * file distributed with this source distribution.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include "common/scummsys.h"
+
+#include "graphics/blit/blit-convert.h"
+
+#include <immintrin.h>
+
+#ifdef __GNUC__
+#pragma GCC push_options
+#pragma GCC target("avx2")
+#endif
+
+namespace Graphics {
+
+static FORCEINLINE __m256i avx2_load(const byte *src, int size) {
+	if (size == 2)
+		return _mm256_cvtepu16_epi32(_mm_loadu_si128((const __m128i *)src));
+	return _mm256_loadu_si256((const __m256i *)src);
+}
+
+static FORCEINLINE void avx2_store(byte *dst, __m256i pixels, int size) {
+	if (size == 2) {
+		// Packing works within each 128 bit lane, so gather the packed
+		// halves of both lanes afterwards
+		pixels = _mm256_permute4x64_epi64(_mm256_packus_epi32(pixels, pixels), _MM_SHUFFLE(3, 1, 2, 0));
+		_mm_storeu_si128((__m128i *)dst, _mm256_castsi256_si128(pixels));
+	} else {
+		_mm256_storeu_si256((__m256i *)dst, pixels);
+	}
+}
+
+template<int SrcSize, int DstSize, bool hasKey>
+struct ConvertKernelAVX2 : public CrossBlitSIMD::PixelConverter<SrcSize, DstSize, hasKey> {
+	enum { kPixels = 8 };
+
+	ConvertKernelAVX2(const CrossBlitSIMD::Params &params, uint32 key) : CrossBlitSIMD::PixelConverter<SrcSize, DstSize, hasKey>(params, key) {
+		_channels = params.channels;
+		for (uint i = 0; i < _channels; i++) {
+			if (SrcSize == 4) {
+				// The components of 32 bpp sources have 8 bits, so they can
+				// be reduced while they are extracted
+				_srcShift[i] = _mm_cvtsi32_si128(params.srcShift[i] + params.dstLoss[i]);
+				_srcMask[i] = _mm256_set1_epi32(params.srcMask[i] >> params.dstLoss[i]);
+			} else {
+				_srcShift[i] = _mm_cvtsi32_si128(params.srcShift[i]);
+				_srcMask[i] = _mm256_set1_epi32(params.srcMask[i]);
+			}
+			_srcBits[i] = _mm_cvtsi32_si128(params.srcBits[i]);
+			_expandShift[i] = _mm_cvtsi32_si128(params.expandShift[i]);
+			_dstLoss[i] = _mm_cvtsi32_si128(params.dstLoss[i]);
+			_dstShift[i] = _mm_cvtsi32_si128(params.dstShift[i]);
+		}
+		_fill = _mm256_set1_epi32(params.fill);
+		_keyVec = _mm256_set1_epi32(key);
+	}
+
+	inline void convert(byte *dst, const byte *src) const {
+		const __m256i color = avx2_load(src, SrcSize);
+		__m256i result = _fill;
+
+		for (uint i = 0; i < _channels; i++) {
+			__m256i value = _mm256_and_si256(_mm256_srl_epi32(color, _srcShift[i]), _srcMask[i]);
+			if (SrcSize == 2) {
+				value = _mm256_sll_epi32(value, _expandShift[i]);
+				value = _mm256_or_si256(value, _mm256_srl_epi32(value, _srcBits[i]));
+				value = _mm256_srl_epi32(value, _dstLoss[i]);
+			}
+			result = _mm256_or_si256(result, _mm256_sll_epi32(value, _dstShift[i]));
+		}
+
+		if (hasKey)
+			result = _mm256_blendv_epi8(result, avx2_load(dst, DstSize), _mm256_cmpeq_epi32(color, _keyVec));
+
+		avx2_store(dst, result, DstSize);
+	}
+
+	uint _channels;
+	__m128i _srcShift[4], _srcBits[4], _expandShift[4];
+	__m128i _dstLoss[4], _dstShift[4];
+	__m256i _srcMask[4];
+	__m256i _fill, _keyVec;
+};
+
+// Reorder the bytes of 32 bpp pixels with 8 bit components
+template<bool hasKey>
+struct ShuffleKernelAVX2 : public CrossBlitSIMD::PixelConverter<4, 4, hasKey> {
+	enum { kPixels = 8 };
+
+	ShuffleKernelAVX2(const CrossBlitSIMD::Params &params, uint32 key) : CrossBlitSIMD::PixelConverter<4, 4, hasKey>(params, key) {
+		const __m128i shuffle = _mm_loadu_si128((const __m128i *)params.shuffle);
+		_shuffle = _mm256_inserti128_si256(_mm256_castsi128_si256(shuffle), shuffle, 1);
+		_fill = _mm256_set1_epi32(params.fill);
+		_keyVec = _mm256_set1_epi32(key);
+	}
+
+	inline void convert(byte *dst, const byte *src) const {
+		const __m256i color = _mm256_loadu_si256((const __m256i *)src);
+		__m256i result = _mm256_or_si256(_mm256_shuffle_epi8(color, _shuffle), _fill);
+
+		if (hasKey)
+			result = _mm256_blendv_epi8(result, _mm256_loadu_si256((const __m256i *)dst), _mm256_cmpeq_epi32(color, _keyVec));
+
+		_mm256_storeu_si256((__m256i *)dst, result);
+	}
+
+	__m256i _shuffle, _fill, _keyVec;
+};
+
+struct MapKernelAVX2 : public CrossBlitSIMD::MapConverter {
+	enum { kPixels = 8 };
+
+	MapKernelAVX2(const uint32 *map) : CrossBlitSIMD::MapConverter(map) {}
+
+	inline void convert(byte *dst, const byte *src) const {
+		const __m256i index = _mm256_cvtepu8_epi32(_mm_loadl_epi64((const __m128i *)src));
+		_mm256_storeu_si256((__m256i *)dst, _mm256_i32gather_epi32((const int *)_map, index, 4));
+	}
+};
+
+template<int SrcSize, int DstSize, bool hasKey>
+static void convertAVX2(byte *dst, const byte *src, const uint dstPitch, const uint srcPitch,
+						const uint w, const uint h, const CrossBlitSIMD::Params &params, const uint32 key) {
+	const ConvertKernelAVX2<SrcSize, DstSize, hasKey> kernel(params, key);
+	CrossBlitSIMD::convertRect<ConvertKernelAVX2<SrcSize, DstSize, hasKey>, SrcSize, DstSize>(kernel, dst, src, dstPitch, srcPitch, w, h);
+}
+
+template<bool hasKey>
+static void shuffleAVX2(byte *dst, const byte *src, const uint dstPitch, const uint srcPitch,
+						const uint w, const uint h, const CrossBlitSIMD::Params &params, const uint32 key) {
+	const ShuffleKernelAVX2<hasKey> kernel(params, key);
+	CrossBlitSIMD::convertRect<ShuffleKernelAVX2<hasKey>, 4, 4>(kernel, dst, src, dstPitch, srcPitch, w, h);
+}
+
+static void mapAVX2(byte *dst, const byte *src, const uint dstPitch, const uint srcPitch,
+					const uint w, const uint h, const uint32 *map) {
+	const MapKernelAVX2 kernel(map);
+	CrossBlitSIMD::convertRect<MapKernelAVX2, 1, 4>(kernel, dst, src, dstPitch, srcPitch, w, h);
+}
+
+template<bool hasKey>
+static CrossBlitSIMD::ConvertFunc getConvertFuncForKey(const CrossBlitSIMD::Params &params) {
+	if (params.byteShuffle)
+		return shuffleAVX2<hasKey>;
+	if (params.srcBytesPerPixel == 2)
+		return (params.dstBytesPerPixel == 2) ? convertAVX2<2, 2, hasKey> : convertAVX2<2, 4, hasKey>;
+	else
+		return (params.dstBytesPerPixel == 2) ? convertAVX2<4, 2, hasKey> : convertAVX2<4, 4, hasKey>;
+}
+
+CrossBlitSIMD::ConvertFunc CrossBlitSIMD::getConvertFuncAVX2(const Params &params, bool hasKey) {
+	return hasKey ? getConvertFuncForKey<true>(params) : getConvertFuncForKey<false>(params);
+}
+
+CrossBlitSIMD::MapFunc CrossBlitSIMD::getMapFuncAVX2(uint bytesPerPixel) {
+	return (bytesPerPixel == 4) ? mapAVX2 : nullptr;
+}
+
+} // End of namespace Graphics
+
+#ifdef __GNUC__
+#pragma GCC pop_options
+#endif
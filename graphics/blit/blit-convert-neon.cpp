@@ -0,0 +1,178 @@
+/* ScummVM - Graphic Adventure Engine
+ *
+ * ScummVM is the legal property of its developers, whose names
+ * are too numerous to list here. Please refer to the COPYRIGHT
+ * file distributed with this source distribution.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include "common/scummsys.h"
+
+#ifdef SCUMMVM_NEON
+
+#include "graphics/blit/blit-convert.h"
+
+#include <arm_neon.h>
+
+#ifdef __GNUC__
+#pragma GCC push_options
+
+#if !defined(__aarch64__)
+#pragma GCC target("fpu=neon")
+#endif // !defined(__aarch64__)
+
+#endif // __GNUC__
+
+namespace Graphics {
+
+static FORCEINLINE uint32x4_t neon_load(const byte *src, int size) {
+	if (size == 2)
+		return vmovl_u16(vld1_u16((const uint16 *)src));
+	return vld1q_u32((const uint32 *)src);
+}
+
+static FORCEINLINE void neon_store(byte *dst, uint32x4_t pixels, int size) {
+	if (size == 2)
+		vst1_u16((uint16 *)dst, vmovn_u32(pixels));
+	else
+		vst1q_u32((uint32 *)dst, pixels);
+}
+
+template<int SrcSize, int DstSize, bool hasKey>
+struct ConvertKernelNEON : public CrossBlitSIMD::PixelConverter<SrcSize, DstSize, hasKey> {
+	enum { kPixels = 4 };
+
+	// NEON only shifts left by a vector, so the right shifts are negative
+	ConvertKernelNEON(const CrossBlitSIMD::Params &params, uint32 key) : CrossBlitSIMD::PixelConverter<SrcSize, DstSize, hasKey>(params, key) {
+		_channels = params.channels;
+		for (uint i = 0; i < _channels; i++) {
+			if (SrcSize == 4) {
+				// The components of 32 bpp sources have 8 bits, so they can
+				// be reduced while they are extracted
+				_srcShift[i] = vdupq_n_s32(-(int32)(params.srcShift[i] + params.dstLoss[i]));
+				_srcMask[i] = vdupq_n_u32(params.srcMask[i] >> params.dstLoss[i]);
+			} else {
+				_srcShift[i] = vdupq_n_s32(-(int32)params.srcShift[i]);
+				_srcMask[i] = vdupq_n_u32(params.srcMask[i]);
+			}
+			_srcBits[i] = vdupq_n_s32(-(int32)params.srcBits[i]);
+			_expandShift[i] = vdupq_n_s32(params.expandShift[i]);
+			_dstLoss[i] = vdupq_n_s32(-(int32)params.dstLoss[i]);
+			_dstShift[i] = vdupq_n_s32(params.dstShift[i]);
+		}
+		_fill = vdupq_n_u32(params.fill);
+		_keyVec = vdupq_n_u32(key);
+	}
+
+	inline void convert(byte *dst, const byte *src) const {
+		const uint32x4_t color = neon_load(src, SrcSize);
+		uint32x4_t result = _fill;
+
+		for (uint i = 0; i < _channels; i++) {
+			uint32x4_t value = vandq_u32(vshlq_u32(color, _srcShift[i]), _srcMask[i]);
+			if (SrcSize == 2) {
+				value = vshlq_u32(value, _expandShift[i]);
+				value = vorrq_u32(value, vshlq_u32(value, _srcBits[i]));
+				value = vshlq_u32(value, _dstLoss[i]);
+			}
+			result = vorrq_u32(result, vshlq_u32(value, _dstShift[i]));
+		}
+
+		if (hasKey)
+			result = vbslq_u32(vceqq_u32(color, _keyVec), neon_load(dst, DstSize), result);
+
+		neon_store(dst, result, DstSize);
+	}
+
+	uint _channels;
+	int32x4_t _srcShift[4], _srcBits[4], _expandShift[4];
+	int32x4_t _dstLoss[4], _dstShift[4];
+	uint32x4_t _srcMask[4];
+	uint32x4_t _fill, _keyVec;
+};
+
+// Reorder the bytes of 32 bpp pixels with 8 bit components. Table lookups
+// with indices out of range return zero, like the 0x80 entries expect.
+template<bool hasKey>
+struct ShuffleKernelNEON : public CrossBlitSIMD::PixelConverter<4, 4, hasKey> {
+	enum { kPixels = 4 };
+
+	ShuffleKernelNEON(const CrossBlitSIMD::Params &params, uint32 key) : CrossBlitSIMD::PixelConverter<4, 4, hasKey>(params, key) {
+		_shuffle = vld1q_u8(params.shuffle);
+		_fill = vdupq_n_u32(params.fill);
+		_keyVec = vdupq_n_u32(key);
+	}
+
+	inline void convert(byte *dst, const byte *src) const {
+		const uint8x16_t bytes = vld1q_u8(src);
+#ifdef __aarch64__
+		const uint8x16_t shuffled = vqtbl1q_u8(bytes, _shuffle);
+#else
+		const uint8x8x2_t table = {{ vget_low_u8(bytes), vget_high_u8(bytes) }};
+		const uint8x16_t shuffled = vcombine_u8(vtbl2_u8(table, vget_low_u8(_shuffle)), vtbl2_u8(table, vget_high_u8(_shuffle)));
+#endif
+		uint32x4_t result = vorrq_u32(vreinterpretq_u32_u8(shuffled), _fill);
+
+		if (hasKey)
+			result = vbslq_u32(vceqq_u32(vreinterpretq_u32_u8(bytes), _keyVec), vld1q_u32((const uint32 *)dst), result);
+
+		vst1q_u32((uint32 *)dst, result);
+	}
+
+	uint8x16_t _shuffle;
+	uint32x4_t _fill, _keyVec;
+};
+
+template<int SrcSize, int DstSize, bool hasKey>
+static void convertNEON(byte *dst, const byte *src, const uint dstPitch, const uint srcPitch,
+						const uint w, const uint h, const CrossBlitSIMD::Params &params, const uint32 key) {
+	const ConvertKernelNEON<SrcSize, DstSize, hasKey> kernel(params, key);
+	CrossBlitSIMD::convertRect<ConvertKernelNEON<SrcSize, DstSize, hasKey>, SrcSize, DstSize>(kernel, dst, src, dstPitch, srcPitch, w, h);
+}
+
+template<bool hasKey>
+static void shuffleNEON(byte *dst, const byte *src, const uint dstPitch, const uint srcPitch,
+						const uint w, const uint h, const CrossBlitSIMD::Params &params, const uint32 key) {
+	const ShuffleKernelNEON<hasKey> kernel(params, key);
+	CrossBlitSIMD::convertRect<ShuffleKernelNEON<hasKey>, 4, 4>(kernel, dst, src, dstPitch, srcPitch, w, h);
+}
+
+template<bool hasKey>
+static CrossBlitSIMD::ConvertFunc getConvertFuncForKey(const CrossBlitSIMD::Params &params) {
+	if (params.byteShuffle)
+		return shuffleNEON<hasKey>;
+	if (params.srcBytesPerPixel == 2)
+		return (params.dstBytesPerPixel == 2) ? convertNEON<2, 2, hasKey> : convertNEON<2, 4, hasKey>;
+	else
+		return (params.dstBytesPerPixel == 2) ? convertNEON<4, 2, hasKey> : convertNEON<4, 4, hasKey>;
+}
+
+CrossBlitSIMD::ConvertFunc CrossBlitSIMD::getConvertFuncNEON(const Params &params, bool hasKey) {
+	return hasKey ? getConvertFuncForKey<true>(params) : getConvertFuncForKey<false>(params);
+}
+
+CrossBlitSIMD::MapFunc CrossBlitSIMD::getMapFuncNEON(uint bytesPerPixel) {
+	// Without gathers, the palette lookups are no faster than the generic code
+	return nullptr;
+}
+
+} // End of namespace Graphics
+
+#ifdef __GNUC__
+#pragma GCC pop_options
+#endif
+
+#endif // SCUMMVM_NEON
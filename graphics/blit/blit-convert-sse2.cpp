@@ -0,0 +1,134 @@
+/* ScummVM - Graphic Adventure Engine
+ *
+ * ScummVM is the legal property of its developers, whose names
+ * are too numerous to list here. Please refer to the COPYRIGHT
+ * file distributed with this source distribution.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include "common/scummsys.h"
+
+#include "graphics/blit/blit-convert.h"
+
+#include <emmintrin.h>
+
+#ifdef __GNUC__
+#pragma GCC push_options
+
+#ifndef __x86_64__
+#pragma GCC target("sse2")
+#endif
+
+#endif
+
+namespace Graphics {
+
+// SSE2 has no byte shuffle, so all conversions move the components with
+// shifts and masks.
+template<int SrcSize, int DstSize, bool hasKey>
+struct ConvertKernelSSE2 : public CrossBlitSIMD::PixelConverter<SrcSize, DstSize, hasKey> {
+	enum { kPixels = 4 };
+
+	ConvertKernelSSE2(const CrossBlitSIMD::Params &params, uint32 key) : CrossBlitSIMD::PixelConverter<SrcSize, DstSize, hasKey>(params, key) {
+		_channels = params.channels;
+		for (uint i = 0; i < _channels; i++) {
+			if (SrcSize == 4) {
+				// The components of 32 bpp sources have 8 bits, so they can
+				// be reduced while they are extracted
+				_srcShift[i] = _mm_cvtsi32_si128(params.srcShift[i] + params.dstLoss[i]);
+				_srcMask[i] = _mm_set1_epi32(params.srcMask[i] >> params.dstLoss[i]);
+			} else {
+				_srcShift[i] = _mm_cvtsi32_si128(params.srcShift[i]);
+				_srcMask[i] = _mm_set1_epi32(params.srcMask[i]);
+			}
+			_srcBits[i] = _mm_cvtsi32_si128(params.srcBits[i]);
+			_expandShift[i] = _mm_cvtsi32_si128(params.expandShift[i]);
+			_dstLoss[i] = _mm_cvtsi32_si128(params.dstLoss[i]);
+			_dstShift[i] = _mm_cvtsi32_si128(params.dstShift[i]);
+		}
+		_fill = _mm_set1_epi32(params.fill);
+		_keyVec = _mm_set1_epi32(key);
+	}
+
+	static FORCEINLINE __m128i load(const byte *src, int size) {
+		if (size == 2)
+			return _mm_unpacklo_epi16(_mm_loadl_epi64((const __m128i *)src), _mm_setzero_si128());
+		return _mm_loadu_si128((const __m128i *)src);
+	}
+
+	inline void convert(byte *dst, const byte *src) const {
+		const __m128i color = load(src, SrcSize);
+		__m128i result = _fill;
+
+		for (uint i = 0; i < _channels; i++) {
+			__m128i value = _mm_and_si128(_mm_srl_epi32(color, _srcShift[i]), _srcMask[i]);
+			if (SrcSize == 2) {
+				value = _mm_sll_epi32(value, _expandShift[i]);
+				value = _mm_or_si128(value, _mm_srl_epi32(value, _srcBits[i]));
+				value = _mm_srl_epi32(value, _dstLoss[i]);
+			}
+			result = _mm_or_si128(result, _mm_sll_epi32(value, _dstShift[i]));
+		}
+
+		if (hasKey) {
+			const __m128i isKey = _mm_cmpeq_epi32(color, _keyVec);
+			result = _mm_or_si128(_mm_andnot_si128(isKey, result), _mm_and_si128(isKey, load(dst, DstSize)));
+		}
+
+		if (DstSize == 2) {
+			// Sign extend the pixels, so that packing them doesn't saturate
+			result = _mm_srai_epi32(_mm_slli_epi32(result, 16), 16);
+			_mm_storel_epi64((__m128i *)dst, _mm_packs_epi32(result, result));
+		} else {
+			_mm_storeu_si128((__m128i *)dst, result);
+		}
+	}
+
+	uint _channels;
+	__m128i _srcShift[4], _srcMask[4], _srcBits[4], _expandShift[4];
+	__m128i _dstLoss[4], _dstShift[4];
+	__m128i _fill, _keyVec;
+};
+
+template<int SrcSize, int DstSize, bool hasKey>
+static void convertSSE2(byte *dst, const byte *src, const uint dstPitch, const uint srcPitch,
+						const uint w, const uint h, const CrossBlitSIMD::Params &params, const uint32 key) {
+	const ConvertKernelSSE2<SrcSize, DstSize, hasKey> kernel(params, key);
+	CrossBlitSIMD::convertRect<ConvertKernelSSE2<SrcSize, DstSize, hasKey>, SrcSize, DstSize>(kernel, dst, src, dstPitch, srcPitch, w, h);
+}
+
+template<bool hasKey>
+static CrossBlitSIMD::ConvertFunc getConvertFuncForKey(const CrossBlitSIMD::Params &params) {
+	if (params.srcBytesPerPixel == 2)
+		return (params.dstBytesPerPixel == 2) ? convertSSE2<2, 2, hasKey> : convertSSE2<2, 4, hasKey>;
+	else
+		return (params.dstBytesPerPixel == 2) ? convertSSE2<4, 2, hasKey> : convertSSE2<4, 4, hasKey>;
+}
+
+CrossBlitSIMD::ConvertFunc CrossBlitSIMD::getConvertFuncSSE2(const Params &params, bool hasKey) {
+	return hasKey ? getConvertFuncForKey<true>(params) : getConvertFuncForKey<false>(params);
+}
+
+CrossBlitSIMD::MapFunc CrossBlitSIMD::getMapFuncSSE2(uint bytesPerPixel) {
+	// Without gathers, the palette lookups are no faster than the generic code
+	return nullptr;
+}
+
+} // End of namespace Graphics
+
+#ifdef __GNUC__
+#pragma GCC pop_options
+#endif
@@ -0,0 +1,194 @@
+/* ScummVM - Graphic Adventure Engine
+ *
+ * ScummVM is the legal property of its developers, whose names
+ * are too numerous to list here. Please refer to the COPYRIGHT
+ * file distributed with this source distribution.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#ifndef GRAPHICS_BLIT_CONVERT_H
+#define GRAPHICS_BLIT_CONVERT_H
+
+#include "graphics/pixelformat.h"
+
+namespace Graphics {
+
+/**
+ * SIMD kernels of crossBlit(), crossKeyBlit() and crossBlitMap().
+ *
+ * The kernels convert between 16 bpp and 32 bpp formats by moving each
+ * color component with shifts and masks, expanding components of less than
+ * 8 bits exactly like PixelFormat::colorToARGB(). Conversions between 32 bpp
+ * formats with 8 bit components are done with byte shuffles where the CPU
+ * has them. CLUT8 images are converted to 32 bpp with gathers.
+ *
+ * The kernel is picked at runtime, depending on the SIMD extensions
+ * supported by the CPU. Formats the kernels do not handle are left to the
+ * generic code.
+ */
+class CrossBlitSIMD {
+public:
+	enum Extension {
+		kExtensionUnknown,
+		kExtensionNone,
+		kExtensionNEON,
+		kExtensionSSE2,
+		kExtensionAVX2
+	};
+
+	/** The SIMD extension used by the blitting functions, detected on first use */
+	static Extension extension;
+
+	/** The conversion of each color component between two formats */
+	struct Params {
+		Params(const PixelFormat &dstFmt, const PixelFormat &srcFmt);
+
+		/** Whether the kernels can convert between the formats */
+		bool supported;
+
+		/**
+		 * Whether the conversion only moves whole bytes. This requires
+		 * 32 bpp formats and 8 bit components.
+		 */
+		bool byteShuffle;
+
+		uint srcBytesPerPixel, dstBytesPerPixel;
+
+		/** The number of components copied from the source */
+		uint channels;
+
+		/**
+		 * The component is extracted with srcShift and srcMask, expanded to
+		 * 8 bits by shifting it by expandShift and replicating its srcBits
+		 * top bits, and stored with dstLoss and dstShift.
+		 */
+		uint32 srcShift[4], srcMask[4], srcBits[4], expandShift[4];
+		uint32 dstLoss[4], dstShift[4];
+
+		/** The bits set in every destination pixel, for an opaque alpha */
+		uint32 fill;
+
+		/** The source byte of each byte of four destination pixels, or 0x80 */
+		byte shuffle[16];
+	};
+
+	/** Convert a rectangle, skipping the source pixels equal to key if the kernel uses a color key */
+	typedef void (*ConvertFunc)(byte *dst, const byte *src, const uint dstPitch, const uint srcPitch,
+								const uint w, const uint h, const Params &params, const uint32 key);
+
+	/** Convert a rectangle of palette indices */
+	typedef void (*MapFunc)(byte *dst, const byte *src, const uint dstPitch, const uint srcPitch,
+							const uint w, const uint h, const uint32 *map);
+
+	/**
+	 * Return the fastest kernel for the given conversion, or nullptr if
+	 * only the generic code can do it.
+	 */
+	static ConvertFunc getConvertFunc(const Params &params, bool hasKey);
+	static MapFunc getMapFunc(uint bytesPerPixel);
+
+#ifdef SCUMMVM_NEON
+	static ConvertFunc getConvertFuncNEON(const Params &params, bool hasKey);
+	static MapFunc getMapFuncNEON(uint bytesPerPixel);
+#endif
+#ifdef SCUMMVM_SSE2
+	static ConvertFunc getConvertFuncSSE2(const Params &params, bool hasKey);
+	static MapFunc getMapFuncSSE2(uint bytesPerPixel);
+#endif
+#ifdef SCUMMVM_AVX2
+	static ConvertFunc getConvertFuncAVX2(const Params &params, bool hasKey);
+	static MapFunc getMapFuncAVX2(uint bytesPerPixel);
+#endif
+
+	/** Convert a pixel without SIMD, for the pixels left over by the vectors */
+	template<int SrcSize, int DstSize, bool hasKey>
+	struct PixelConverter {
+		PixelConverter(const Params &params, uint32 key) : _params(params), _key(key) {}
+
+		inline void convertPixel(byte *dst, const byte *src) const {
+			const uint32 color = (SrcSize == 2) ? *(const uint16 *)src : *(const uint32 *)src;
+			if (hasKey && color == _key)
+				return;
+
+			uint32 result = _params.fill;
+			for (uint i = 0; i < _params.channels; i++) {
+				uint32 value = ((color >> _params.srcShift[i]) & _params.srcMask[i]) << _params.expandShift[i];
+				value |= value >> _params.srcBits[i];
+				result |= (value >> _params.dstLoss[i]) << _params.dstShift[i];
+			}
+
+			if (DstSize == 2)
+				*(uint16 *)dst = result;
+			else
+				*(uint32 *)dst = result;
+		}
+
+		const Params &_params;
+		const uint32 _key;
+	};
+
+	struct MapConverter {
+		MapConverter(const uint32 *map) : _map(map) {}
+
+		inline void convertPixel(byte *dst, const byte *src) const {
+			*(uint32 *)dst = _map[*src];
+		}
+
+		const uint32 *_map;
+	};
+
+	/**
+	 * Convert a rectangle with a kernel, which converts kernel.kPixels
+	 * pixels at a time with convert() and single pixels with convertPixel().
+	 *
+	 * When the destination pixels are larger, the rectangle is converted
+	 * from the bottom right to the top left, so that the conversion can be
+	 * done in place like in crossBlit(). Each vector of source pixels is
+	 * read before its destination pixels are written.
+	 */
+	template<class Kernel, int SrcSize, int DstSize>
+	static inline void convertRect(const Kernel &kernel, byte *dst, const byte *src, const uint dstPitch, const uint srcPitch, const uint w, const uint h) {
+		if (DstSize > SrcSize) {
+			for (uint y = h; y-- > 0;) {
+				byte *dstRow = dst + y * dstPitch;
+				const byte *srcRow = src + y * srcPitch;
+
+				uint x = w;
+				while (x >= Kernel::kPixels) {
+					x -= Kernel::kPixels;
+					kernel.convert(dstRow + x * DstSize, srcRow + x * SrcSize);
+				}
+				while (x-- > 0)
+					kernel.convertPixel(dstRow + x * DstSize, srcRow + x * SrcSize);
+			}
+		} else {
+			for (uint y = 0; y < h; y++) {
+				uint x = 0;
+				for (; x + Kernel::kPixels <= w; x += Kernel::kPixels)
+					kernel.convert(dst + x * DstSize, src + x * SrcSize);
+				for (; x < w; x++)
+					kernel.convertPixel(dst + x * DstSize, src + x * SrcSize);
+
+				dst += dstPitch;
+				src += srcPitch;
+			}
+		}
+	}
+};
+
+} // End of namespace Graphics
+
+#endif
@@ -20,8 +20,10 @@
  */
 
 #include "graphics/blit.h"
+#include "graphics/blit/blit-convert.h"
 #include "graphics/pixelformat.h"
 #include "common/endian.h"
+#include "common/system.h"
 
 namespace Graphics {
 
@@ -265,6 +267,124 @@ inline void crossBlitLogic1BppSource(byte *dst, const byte *src, const byte *mas
 
 } // End of anonymous namespace
 
+// Initialize this to unknown, the extension is detected on first use
+CrossBlitSIMD::Extension CrossBlitSIMD::extension = CrossBlitSIMD::kExtensionUnknown;
+
+CrossBlitSIMD::Params::Params(const PixelFormat &dstFmt, const PixelFormat &srcFmt) {
+	srcBytesPerPixel = srcFmt.bytesPerPixel;
+	dstBytesPerPixel = dstFmt.bytesPerPixel;
+	supported = (srcBytesPerPixel == 2 || srcBytesPerPixel == 4) && (dstBytesPerPixel == 2 || dstBytesPerPixel == 4);
+#ifdef SCUMM_BIG_ENDIAN
+	byteShuffle = false;
+#else
+	byteShuffle = (srcBytesPerPixel == 4 && dstBytesPerPixel == 4);
+#endif
+	channels = 0;
+	fill = 0;
+	memset(shuffle, 0x80, sizeof(shuffle));
+
+	const uint srcBitsPerChannel[4] = { srcFmt.rBits(), srcFmt.gBits(), srcFmt.bBits(), srcFmt.aBits() };
+	const uint srcShifts[4] = { srcFmt.rShift, srcFmt.gShift, srcFmt.bShift, srcFmt.aShift };
+	const uint dstLosses[4] = { dstFmt.rLoss, dstFmt.gLoss, dstFmt.bLoss, dstFmt.aLoss };
+	const uint dstShifts[4] = { dstFmt.rShift, dstFmt.gShift, dstFmt.bShift, dstFmt.aShift };
+
+	for (int i = 0; i < 4; i++) {
+		const uint bits = srcBitsPerChannel[i];
+
+		// colorToARGB() returns an opaque alpha for formats without one
+		if (bits == 0) {
+			if (i == 3)
+				fill |= (0xFF >> dstLosses[i]) << dstShifts[i];
+			continue;
+		}
+
+		if (dstLosses[i] >= 8)
+			continue;
+
+		// Components of less than 4 bits aren't expanded by replicating
+		// their bits once, and 32 bpp sources need 8 bit components
+		if (bits < 4 || (srcBytesPerPixel == 4 && bits != 8)) {
+			supported = false;
+			break;
+		}
+
+		srcShift[channels] = srcShifts[i];
+		srcMask[channels] = (1 << bits) - 1;
+		srcBits[channels] = bits;
+		expandShift[channels] = 8 - bits;
+		dstLoss[channels] = dstLosses[i];
+		dstShift[channels] = dstShifts[i];
+		channels++;
+
+		if (bits != 8 || dstLosses[i] != 0 || (srcShifts[i] & 7) != 0 || (dstShifts[i] & 7) != 0) {
+			byteShuffle = false;
+		} else {
+			for (int p = 0; p < 4; p++)
+				shuffle[p * 4 + dstShifts[i] / 8] = p * 4 + srcShifts[i] / 8;
+		}
+	}
+}
+
+static CrossBlitSIMD::Extension getCrossBlitExtension() {
+	// If no extension has been selected yet, detect and select
+	if (CrossBlitSIMD::extension == CrossBlitSIMD::kExtensionUnknown && g_system) {
+		CrossBlitSIMD::Extension extension = CrossBlitSIMD::kExtensionNone;
+#ifdef SCUMMVM_NEON
+		if (g_system->hasFeature(OSystem::kFeatureCpuNEON)) extension = CrossBlitSIMD::kExtensionNEON;
+#endif
+#ifdef SCUMMVM_SSE2
+		if (g_system->hasFeature(OSystem::kFeatureCpuSSE2)) extension = CrossBlitSIMD::kExtensionSSE2;
+#endif
+#ifdef SCUMMVM_AVX2
+		if (g_system->hasFeature(OSystem::kFeatureCpuAVX2)) extension = CrossBlitSIMD::kExtensionAVX2;
+#endif
+		CrossBlitSIMD::extension = extension;
+	}
+
+	return CrossBlitSIMD::extension;
+}
+
+CrossBlitSIMD::ConvertFunc CrossBlitSIMD::getConvertFunc(const Params &params, bool hasKey) {
+	if (!params.supported)
+		return nullptr;
+
+	switch (getCrossBlitExtension()) {
+#ifdef SCUMMVM_NEON
+	case kExtensionNEON:
+		return getConvertFuncNEON(params, hasKey);
+#endif
+#ifdef SCUMMVM_SSE2
+	case kExtensionSSE2:
+		return getConvertFuncSSE2(params, hasKey);
+#endif
+#ifdef SCUMMVM_AVX2
+	case kExtensionAVX2:
+		return getConvertFuncAVX2(params, hasKey);
+#endif
+	default:
+		return nullptr;
+	}
+}
+
+CrossBlitSIMD::MapFunc CrossBlitSIMD::getMapFunc(uint bytesPerPixel) {
+	switch (getCrossBlitExtension()) {
+#ifdef SCUMMVM_NEON
+	case kExtensionNEON:
+		return getMapFuncNEON(bytesPerPixel);
+#endif
+#ifdef SCUMMVM_SSE2
+	case kExtensionSSE2:
+		return getMapFuncSSE2(bytesPerPixel);
+#endif
+#ifdef SCUMMVM_AVX2
+	case kExtensionAVX2:
+		return getMapFuncAVX2(bytesPerPixel);
+#endif
+	default:
+		return nullptr;
+	}
+}
+
 // Function to blit a rect from one color format to another
 bool crossBlit(byte *dst, const byte *src,
 			   const uint dstPitch, const uint srcPitch,
@@ -281,6 +401,14 @@ bool crossBlit(byte *dst, const byte *src,
 		return true;
 	}
 
+	// Use a SIMD kernel for the formats it handles
+	const CrossBlitSIMD::Params params(dstFmt, srcFmt);
+	CrossBlitSIMD::ConvertFunc convertFunc = CrossBlitSIMD::getConvertFunc(params, false);
+	if (convertFunc) {
+		convertFunc(dst, src, dstPitch, srcPitch, w, h, params, 0);
+		return true;
+	}
+
 	// Faster, but larger, to provide optimized handling for each case.
 	const uint srcDelta = (srcPitch - w * srcFmt.bytesPerPixel);
 	const uint dstDelta = (dstPitch - w * dstFmt.bytesPerPixel);
@@ -353,6 +481,14 @@ bool crossKeyBlit(byte *dst, const byte *src,
 		return true;
 	}
 
+	// Use a SIMD kernel for the formats it handles
+	const CrossBlitSIMD::Params params(dstFmt, srcFmt);
+	CrossBlitSIMD::ConvertFunc convertFunc = CrossBlitSIMD::getConvertFunc(params, true);
+	if (convertFunc) {
+		convertFunc(dst, src, dstPitch, srcPitch, w, h, params, key);
+		return true;
+	}
+
 	// Faster, but larger, to provide optimized handling for each case.
 	const uint srcDelta = (srcPitch - w * srcFmt.bytesPerPixel);
 	const uint dstDelta = (dstPitch - w * dstFmt.bytesPerPixel);
@@ -491,6 +627,13 @@ bool crossBlitMap(byte *dst, const byte *src,
 	if (!bytesPerPixel)
 		return false;
 
+	// Use a SIMD kernel for the formats it handles
+	CrossBlitSIMD::MapFunc mapFunc = CrossBlitSIMD::getMapFunc(bytesPerPixel);
+	if (mapFunc) {
+		mapFunc(dst, src, dstPitch, srcPitch, w, h, map);
+		return true;
+	}
+
 	// Faster, but larger, to provide optimized handling for each case.
 	const uint srcDelta = (srcPitch - w);
 	const uint dstDelta = (dstPitch - w * bytesPerPixel);
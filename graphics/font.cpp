@@ -55,7 +55,8 @@ Common::Rect getBoundingBoxImpl(const Font &font, const StringType &str, int x,
 	// that we do allow an empty width to be specified here. This allows us
 	// to obtain the complete bounding box of a string.
 	const int leftX = x, rightX = w ? (x + w + 1) : 0x7FFFFFFF;
-	int width = font.getStringWidth(str);
+	const Font::TextRun *run = font.getTextRun(str);
+	int width = run ? run->width : font.getStringWidth(str);
 
 	if (align == kTextAlignCenter)
 		x = x + (w - width)/2;
@@ -66,6 +67,26 @@ Common::Rect getBoundingBoxImpl(const Font &font, const StringType &str, int x,
 	bool first = true;
 	Common::Rect bbox;
 
+	if (run) {
+		for (uint i = 0; i < run->boxes.size(); ++i) {
+			Common::Rect charBox = run->boxes[i];
+			const int charX = x + run->penX[i];
+			if (charX + charBox.right > rightX)
+				break;
+			if (charX + charBox.right >= leftX) {
+				charBox.translate(charX, y);
+				if (first) {
+					bbox = charBox;
+					first = false;
+				} else {
+					bbox.extend(charBox);
+				}
+			}
+		}
+
+		return bbox;
+	}
+
 	typename StringType::unsigned_type last = 0;
 	for (typename StringType::const_iterator i = str.begin(), end = str.end(); i != end; ++i) {
 		const typename StringType::unsigned_type cur = *i;
@@ -93,6 +114,10 @@ Common::Rect getBoundingBoxImpl(const Font &font, const StringType &str, int x,
 
 template<class StringType>
 int getStringWidthImpl(const Font &font, const StringType &str) {
+	const Font::TextRun *run = font.getTextRun(str);
+	if (run)
+		return run->width;
+
 	int space = 0;
 	typename StringType::unsigned_type last = 0;
 
@@ -112,7 +137,8 @@ void drawStringImpl(const Font &font, SurfaceType *dst, const StringType &str, i
 	assert(dst != 0);
 
 	const int leftX = x, rightX = x + w + 1;
-	int width = font.getStringWidth(str);
+	const Font::TextRun *run = font.getTextRun(str);
+	int width = run ? run->width : font.getStringWidth(str);
 
 	if (align == kTextAlignCenter)
 		x = x + (w - width)/2;
@@ -120,6 +146,17 @@ void drawStringImpl(const Font &font, SurfaceType *dst, const StringType &str, i
 		x = x + w - width;
 	x += deltax;
 
+	if (run) {
+		for (uint i = 0; i < run->boxes.size(); ++i) {
+			const int charX = x + run->penX[i];
+			if (charX + run->boxes[i].right > rightX)
+				break;
+			if (charX + run->boxes[i].right >= leftX)
+				font.drawChar(dst, (typename StringType::unsigned_type)str[i], charX, y, color);
+		}
+		return;
+	}
+
 	typename StringType::unsigned_type last = 0;
 	for (typename StringType::const_iterator i = str.begin(), end = str.end(); i != end; ++i) {
 		const typename StringType::unsigned_type cur = *i;
@@ -22,6 +22,7 @@
 #ifndef GRAPHICS_FONT_H
 #define GRAPHICS_FONT_H
 
+#include "common/array.h"
 #include "common/str.h"
 #include "common/ustr.h"
 #include "common/rect.h"
@@ -212,6 +213,30 @@ public:
 	virtual void drawChar(Surface *dst, uint32 chr, int x, int y, uint32 color) const = 0;
 	virtual void drawChar(ManagedSurface *dst, uint32 chr, int x, int y, uint32 color) const;
 
+	/**
+	 * Pre-computed layout of a single line of text.
+	 * @see getTextRun
+	 */
+	struct TextRun {
+		int width;                          ///< Logical width, as returned by getStringWidth.
+		Common::Array<int> penX;            ///< Pen position of each character, kerning included.
+		Common::Array<Common::Rect> boxes;  ///< Bounding box of each character, relative to its pen position.
+	};
+
+	/**
+	 * Return the layout of the string @p str if this font caches them.
+	 *
+	 * drawString, getStringWidth and getBoundingBox use the run, when there is
+	 * one, instead of querying the width, kerning and bounding box of every
+	 * character. The returned run stays valid until the next call to
+	 * getTextRun on this font.
+	 *
+	 * @return The run, or nullptr when the font does not cache layouts.
+	 */
+	virtual const TextRun *getTextRun(const Common::String &str) const { return nullptr; }
+	/** @overload */
+	virtual const TextRun *getTextRun(const Common::U32String &str) const { return nullptr; }
+
 	/** @overload */
 
 	/**
@@ -227,14 +252,16 @@ public:
 	 * @param deltax  Offset to the x starting position of the string.
 	 * @param useEllipsis  Use ellipsis if needed to fit the string in the area.
 	 *
+	 * Fonts can override this to draw a whole line at once, for example from
+	 * a cached text run.
 	 */
-	void drawString(Surface *dst, const Common::String &str, int x, int y, int w, uint32 color, TextAlign align = kTextAlignLeft, int deltax = 0, bool useEllipsis = false) const;
+	virtual void drawString(Surface *dst, const Common::String &str, int x, int y, int w, uint32 color, TextAlign align = kTextAlignLeft, int deltax = 0, bool useEllipsis = false) const;
 	/** @overload */
-	void drawString(Surface *dst, const Common::U32String &str, int x, int y, int w, uint32 color, TextAlign align = kTextAlignLeft, int deltax = 0, bool useEllipsis = false) const;
+	virtual void drawString(Surface *dst, const Common::U32String &str, int x, int y, int w, uint32 color, TextAlign align = kTextAlignLeft, int deltax = 0, bool useEllipsis = false) const;
 	/** @overload */
-	void drawString(ManagedSurface *dst, const Common::String &str, int x, int _y, int w, uint32 color, TextAlign align = kTextAlignLeft, int deltax = 0, bool useEllipsis = false) const;
+	virtual void drawString(ManagedSurface *dst, const Common::String &str, int x, int _y, int w, uint32 color, TextAlign align = kTextAlignLeft, int deltax = 0, bool useEllipsis = false) const;
 	/** @overload */
-	void drawString(ManagedSurface *dst, const Common::U32String &str, int x, int y, int w, uint32 color, TextAlign align = kTextAlignLeft, int deltax = 0, bool useEllipsis = false) const;
+	virtual void drawString(ManagedSurface *dst, const Common::U32String &str, int x, int y, int w, uint32 color, TextAlign align = kTextAlignLeft, int deltax = 0, bool useEllipsis = false) const;
 
 	/**
 	 * Compute and return the width of the string @p str when rendered using this font.
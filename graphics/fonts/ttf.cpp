@@ -161,6 +161,14 @@ public:
 	void drawChar(Surface *dst, uint32 chr, int x, int y, uint32 color) const override;
 	void drawChar(ManagedSurface *dst, uint32 chr, int x, int y, uint32 color) const override;
 
+	const TextRun *getTextRun(const Common::String &str) const override;
+	const TextRun *getTextRun(const Common::U32String &str) const override;
+
+	void drawString(Surface *dst, const Common::String &str, int x, int y, int w, uint32 color, TextAlign align = kTextAlignLeft, int deltax = 0, bool useEllipsis = false) const override;
+	void drawString(Surface *dst, const Common::U32String &str, int x, int y, int w, uint32 color, TextAlign align = kTextAlignLeft, int deltax = 0, bool useEllipsis = false) const override;
+	void drawString(ManagedSurface *dst, const Common::String &str, int x, int y, int w, uint32 color, TextAlign align = kTextAlignLeft, int deltax = 0, bool useEllipsis = false) const override;
+	void drawString(ManagedSurface *dst, const Common::U32String &str, int x, int y, int w, uint32 color, TextAlign align = kTextAlignLeft, int deltax = 0, bool useEllipsis = false) const override;
+
 private:
 	bool _initialized;
 	FT_Face _face;
@@ -184,6 +192,48 @@ private:
 	bool _allowLateCaching;
 	void assureCached(uint32 chr) const;
 
+	enum {
+		kAtlasPageSize = 256,
+		kMaxCachedRuns = 128
+	};
+
+	// Glyph images are views into shared atlas pages, which are filled
+	// shelf by shelf. Only the last page is open for new glyphs.
+	mutable Common::Array<Surface *> _atlas;
+	mutable int _atlasX, _atlasY, _atlasShelfHeight;
+	void allocateGlyphImage(Surface &image, int w, int h) const;
+
+	// Runs are kept in a doubly linked list, most recently used first, and
+	// indexed by their string. Single-byte and Unicode strings have separate
+	// indices, so looking a string up never converts it.
+	struct CachedRun {
+		TextRun run;
+		Common::Array<const Glyph *> glyphs;
+		Common::String key;
+		Common::U32String u32Key;
+		bool isU32;
+		CachedRun *prev, *next;
+	};
+	typedef Common::HashMap<Common::String, CachedRun *> RunIndex;
+	typedef Common::HashMap<Common::U32String, CachedRun *> U32RunIndex;
+	mutable RunIndex _runIndex;
+	mutable U32RunIndex _u32RunIndex;
+	mutable CachedRun *_runHead, *_runTail;
+	mutable uint _runCount;
+
+	const CachedRun &findRun(const Common::String &str) const;
+	const CachedRun &findRun(const Common::U32String &str) const;
+	template<class StringType>
+	void layoutRun(CachedRun &cached, const StringType &str) const;
+	CachedRun *allocateRun() const;
+	void touchRun(CachedRun *cached) const;
+	void unlinkRun(CachedRun *cached) const;
+
+	Common::Rect drawRun(Surface *dst, const CachedRun &cached, int x, int y, int w, uint32 color,
+		TextAlign align, int deltax, const uint32 *transparentColor) const;
+	void drawGlyph(Surface *dst, const Glyph &glyph, int x, int y, uint32 color,
+		const uint32 *transparentColor) const;
+
 	Common::SeekableReadStream *readTTFTable(FT_ULong tag) const;
 
 	int computePointSize(int size, TTFSizeMode sizeMode) const;
@@ -203,7 +253,8 @@ private:
 TTFFont::TTFFont()
 	: _initialized(false), _face(), _ttfFile(0), _size(0), _width(0), _height(0), _ascent(0),
 	  _descent(0), _glyphs(), _loadFlags(FT_LOAD_TARGET_NORMAL), _renderMode(FT_RENDER_MODE_NORMAL),
-	  _hasKerning(false), _allowLateCaching(false), _fakeBold(false), _fakeItalic(false) {
+	  _hasKerning(false), _allowLateCaching(false), _atlasX(0), _atlasY(0), _atlasShelfHeight(0),
+	  _runHead(nullptr), _runTail(nullptr), _runCount(0), _fakeBold(false), _fakeItalic(false) {
 }
 
 TTFFont::~TTFFont() {
@@ -213,11 +264,19 @@ TTFFont::~TTFFont() {
 		delete[] _ttfFile;
 		_ttfFile = 0;
 
-		for (GlyphCache::iterator i = _glyphs.begin(), end = _glyphs.end(); i != end; ++i)
-			i->_value.image.free();
-
 		_initialized = false;
 	}
+
+	for (uint i = 0; i < _atlas.size(); ++i) {
+		_atlas[i]->free();
+		delete _atlas[i];
+	}
+
+	while (_runHead) {
+		CachedRun *next = _runHead->next;
+		delete _runHead;
+		_runHead = next;
+	}
 }
 
 bool TTFFont::load(Common::SeekableReadStream &stream, int size, TTFSizeMode sizeMode,
@@ -679,8 +738,11 @@ void TTFFont::drawChar(Surface * dst, uint32 chr, int x, int y, uint32 color,
 	if (glyphEntry == _glyphs.end())
 		return;
 
-	const Glyph &glyph = glyphEntry->_value;
+	drawGlyph(dst, glyphEntry->_value, x, y, color, transparentColor);
+}
 
+void TTFFont::drawGlyph(Surface *dst, const Glyph &glyph, int x, int y, uint32 color,
+		const uint32 *transparentColor) const {
 	x += glyph.xOffset;
 	y += glyph.yOffset;
 
@@ -813,7 +875,12 @@ bool TTFFont::cacheGlyph(Glyph &glyph, uint32 chr) const {
 	}
 
 
-	glyph.image.create(bitmap->width, bitmap->rows, PixelFormat::createFormatCLUT8());
+	if (bitmap->pixel_mode != FT_PIXEL_MODE_MONO && bitmap->pixel_mode != FT_PIXEL_MODE_GRAY) {
+		warning("TTFFont::cacheGlyph: Unsupported pixel mode %d", bitmap->pixel_mode);
+		return false;
+	}
+
+	allocateGlyphImage(glyph.image, bitmap->width, bitmap->rows);
 
 	const uint8 *src = bitmap->buffer;
 	int srcPitch = bitmap->pitch;
@@ -822,11 +889,10 @@ bool TTFFont::cacheGlyph(Glyph &glyph, uint32 chr) const {
 		srcPitch = -srcPitch;
 	}
 
-	uint8 *dst = (uint8 *)glyph.image.getPixels();
+	for (int y = 0; y < (int)bitmap->rows; ++y) {
+		uint8 *dst = (uint8 *)glyph.image.getBasePtr(0, y);
 
-	switch (bitmap->pixel_mode) {
-	case FT_PIXEL_MODE_MONO:
-		for (int y = 0; y < (int)bitmap->rows; ++y) {
+		if (bitmap->pixel_mode == FT_PIXEL_MODE_MONO) {
 			const uint8 *curSrc = src;
 			uint8 mask = 0;
 
@@ -840,23 +906,11 @@ bool TTFFont::cacheGlyph(Glyph &glyph, uint32 chr) const {
 				mask <<= 1;
 				++dst;
 			}
-
-			src += srcPitch;
-		}
-		break;
-
-	case FT_PIXEL_MODE_GRAY:
-		for (int y = 0; y < (int)bitmap->rows; ++y) {
+		} else {
 			memcpy(dst, src, bitmap->width);
-			dst += glyph.image.pitch;
-			src += srcPitch;
 		}
-		break;
 
-	default:
-		warning("TTFFont::cacheGlyph: Unsupported pixel mode %d", bitmap->pixel_mode);
-		glyph.image.free();
-		return false;
+		src += srcPitch;
 	}
 
 #if FAKE_BOLD == 1
@@ -868,6 +922,255 @@ bool TTFFont::cacheGlyph(Glyph &glyph, uint32 chr) const {
 	return true;
 }
 
+void TTFFont::allocateGlyphImage(Surface &image, int w, int h) const {
+	if (w <= 0 || h <= 0) {
+		image.init(w, h, 0, nullptr, PixelFormat::createFormatCLUT8());
+		return;
+	}
+
+	Surface *page = _atlas.empty() ? nullptr : _atlas.back();
+	if (page && _atlasX + w > page->w) {
+		// Start a new shelf
+		_atlasY += _atlasShelfHeight;
+		_atlasX = 0;
+		_atlasShelfHeight = 0;
+	}
+
+	if (!page || _atlasX + w > page->w || _atlasY + h > page->h) {
+		// Oversized glyphs get a page of their own size. The atlas pages are
+		// zero-filled, which the monochrome conversion depends on.
+		page = new Surface();
+		page->create(MAX<int>(w, kAtlasPageSize), MAX<int>(h, kAtlasPageSize), PixelFormat::createFormatCLUT8());
+		_atlas.push_back(page);
+		_atlasX = _atlasY = _atlasShelfHeight = 0;
+	}
+
+	image = page->getSubArea(Common::Rect(_atlasX, _atlasY, _atlasX + w, _atlasY + h));
+	_atlasX += w;
+	_atlasShelfHeight = MAX(_atlasShelfHeight, h);
+}
+
+const Font::TextRun *TTFFont::getTextRun(const Common::String &str) const {
+	return &findRun(str).run;
+}
+
+const Font::TextRun *TTFFont::getTextRun(const Common::U32String &str) const {
+	return &findRun(str).run;
+}
+
+const TTFFont::CachedRun &TTFFont::findRun(const Common::String &str) const {
+	RunIndex::const_iterator entry = _runIndex.find(str);
+	if (entry != _runIndex.end()) {
+		touchRun(entry->_value);
+		return *entry->_value;
+	}
+
+	CachedRun *cached = allocateRun();
+	cached->key = str;
+	cached->isU32 = false;
+	_runIndex[str] = cached;
+	layoutRun(*cached, str);
+	return *cached;
+}
+
+const TTFFont::CachedRun &TTFFont::findRun(const Common::U32String &str) const {
+	U32RunIndex::const_iterator entry = _u32RunIndex.find(str);
+	if (entry != _u32RunIndex.end()) {
+		touchRun(entry->_value);
+		return *entry->_value;
+	}
+
+	CachedRun *cached = allocateRun();
+	cached->u32Key = str;
+	cached->isU32 = true;
+	_u32RunIndex[str] = cached;
+	layoutRun(*cached, str);
+	return *cached;
+}
+
+TTFFont::CachedRun *TTFFont::allocateRun() const {
+	CachedRun *cached;
+	if (_runCount >= kMaxCachedRuns) {
+		// Reuse the least recently used run
+		cached = _runTail;
+		unlinkRun(cached);
+		if (cached->isU32)
+			_u32RunIndex.erase(cached->u32Key);
+		else
+			_runIndex.erase(cached->key);
+		cached->key.clear();
+		cached->u32Key.clear();
+	} else {
+		cached = new CachedRun();
+		_runCount++;
+	}
+
+	cached->prev = nullptr;
+	cached->next = _runHead;
+	if (_runHead)
+		_runHead->prev = cached;
+	else
+		_runTail = cached;
+	_runHead = cached;
+	return cached;
+}
+
+void TTFFont::touchRun(CachedRun *cached) const {
+	if (cached == _runHead)
+		return;
+
+	unlinkRun(cached);
+	cached->prev = nullptr;
+	cached->next = _runHead;
+	_runHead->prev = cached;
+	_runHead = cached;
+}
+
+void TTFFont::unlinkRun(CachedRun *cached) const {
+	if (cached->prev)
+		cached->prev->next = cached->next;
+	else
+		_runHead = cached->next;
+
+	if (cached->next)
+		cached->next->prev = cached->prev;
+	else
+		_runTail = cached->prev;
+}
+
+template<class StringType>
+void TTFFont::layoutRun(CachedRun &cached, const StringType &str) const {
+	// This follows the per-character logic of Font::drawString and
+	// Font::getStringWidth, with one glyph lookup per character.
+	TextRun &run = cached.run;
+	run.penX.resize(str.size());
+	run.boxes.resize(str.size());
+	cached.glyphs.resize(str.size());
+
+	// Like getKerningOffset(0, chr), the first character is kerned
+	// against the glyph of character 0 if the mapping has one.
+	GlyphCache::const_iterator nullEntry = _glyphs.find(0);
+	FT_UInt lastSlot = (nullEntry != _glyphs.end()) ? nullEntry->_value.slot : 0;
+	int x = 0;
+	for (uint i = 0; i < str.size(); ++i) {
+		const uint32 chr = (typename StringType::unsigned_type)str[i];
+		assureCached(chr);
+		GlyphCache::const_iterator glyphEntry = _glyphs.find(chr);
+		if (glyphEntry == _glyphs.end()) {
+			run.penX[i] = x;
+			run.boxes[i] = Common::Rect();
+			cached.glyphs[i] = nullptr;
+			lastSlot = 0;
+			continue;
+		}
+
+		// Glyph cache entries are never removed, and the hash map does not
+		// move them when it grows.
+		const Glyph &glyph = glyphEntry->_value;
+		if (_hasKerning && lastSlot && glyph.slot) {
+			FT_Vector kerningVector;
+			FT_Get_Kerning(_face, lastSlot, glyph.slot, FT_KERNING_DEFAULT, &kerningVector);
+			x += kerningVector.x / 64;
+		}
+		lastSlot = glyph.slot;
+
+		run.penX[i] = x;
+		run.boxes[i] = Common::Rect(glyph.xOffset, glyph.yOffset, glyph.xOffset + glyph.image.w, glyph.yOffset + glyph.image.h);
+		cached.glyphs[i] = &glyph;
+		x += glyph.advance;
+	}
+	run.width = x;
+}
+
+Common::Rect TTFFont::drawRun(Surface *dst, const CachedRun &cached, int x, int y, int w, uint32 color,
+		TextAlign align, int deltax, const uint32 *transparentColor) const {
+	// Same placement and clipping as Font::drawString, but the glyphs were
+	// resolved when the run was laid out, so every one is blitted straight
+	// from its atlas page. Returns the area drawn to.
+	const TextRun &run = cached.run;
+	const int leftX = x, rightX = x + w + 1;
+
+	if (align == kTextAlignCenter)
+		x = x + (w - run.width)/2;
+	else if (align == kTextAlignRight)
+		x = x + w - run.width;
+	x += deltax;
+
+	Common::Rect drawn;
+	for (uint i = 0; i < run.boxes.size(); ++i) {
+		const int charX = x + run.penX[i];
+		if (charX + run.boxes[i].right > rightX)
+			break;
+		if (charX + run.boxes[i].right < leftX || !cached.glyphs[i])
+			continue;
+
+		drawGlyph(dst, *cached.glyphs[i], charX, y, color, transparentColor);
+
+		Common::Rect charBox = run.boxes[i];
+		if (charBox.isEmpty())
+			continue;
+		charBox.translate(charX, y);
+		if (drawn.isEmpty())
+			drawn = charBox;
+		else
+			drawn.extend(charBox);
+	}
+
+	return drawn;
+}
+
+void TTFFont::drawString(Surface *dst, const Common::String &str, int x, int y, int w, uint32 color, TextAlign align, int deltax, bool useEllipsis) const {
+	// Shortened strings are rare, and take the generic path
+	if (useEllipsis) {
+		Font::drawString(dst, str, x, y, w, color, align, deltax, useEllipsis);
+		return;
+	}
+
+	assert(dst != 0);
+	drawRun(dst, findRun(str), x, y, w, color, align, deltax, nullptr);
+}
+
+void TTFFont::drawString(Surface *dst, const Common::U32String &str, int x, int y, int w, uint32 color, TextAlign align, int deltax, bool useEllipsis) const {
+	if (useEllipsis) {
+		Font::drawString(dst, str, x, y, w, color, align, deltax, useEllipsis);
+		return;
+	}
+
+	assert(dst != 0);
+	drawRun(dst, findRun(str), x, y, w, color, align, deltax, nullptr);
+}
+
+void TTFFont::drawString(ManagedSurface *dst, const Common::String &str, int x, int y, int w, uint32 color, TextAlign align, int deltax, bool useEllipsis) const {
+	if (useEllipsis) {
+		Font::drawString(dst, str, x, y, w, color, align, deltax, useEllipsis);
+		return;
+	}
+
+	assert(dst != 0);
+	const uint32 transColor = dst->getTransparentColor();
+	const Common::Rect drawn = drawRun(dst->surfacePtr(), findRun(str), x, y, w, color, align, deltax,
+		dst->hasTransparentColor() ? &transColor : nullptr);
+
+	// One dirty rect for the whole line, rather than one per character
+	if (!drawn.isEmpty())
+		dst->addDirtyRect(drawn);
+}
+
+void TTFFont::drawString(ManagedSurface *dst, const Common::U32String &str, int x, int y, int w, uint32 color, TextAlign align, int deltax, bool useEllipsis) const {
+	if (useEllipsis) {
+		Font::drawString(dst, str, x, y, w, color, align, deltax, useEllipsis);
+		return;
+	}
+
+	assert(dst != 0);
+	const uint32 transColor = dst->getTransparentColor();
+	const Common::Rect drawn = drawRun(dst->surfacePtr(), findRun(str), x, y, w, color, align, deltax,
+		dst->hasTransparentColor() ? &transColor : nullptr);
+
+	if (!drawn.isEmpty())
+		dst->addDirtyRect(drawn);
+}
+
 void TTFFont::assureCached(uint32 chr) const {
 	if (!chr || !_allowLateCaching || _glyphs.contains(chr)) {
 		return;
@@ -144,15 +144,21 @@ endif
 
 ifdef SCUMMVM_NEON
 MODULE_OBJS += \
-	blit/blit-neon.o
+	blit/blit-neon.o \
+	blit/blit-convert-neon.o \
+	yuv_to_rgb_neon.o
 endif
 ifdef SCUMMVM_SSE2
 MODULE_OBJS += \
-	blit/blit-sse2.o
+	blit/blit-sse2.o \
+	blit/blit-convert-sse2.o \
+	yuv_to_rgb_sse2.o
 endif
 ifdef SCUMMVM_AVX2
 MODULE_OBJS += \
-	blit/blit-avx2.o
+	blit/blit-avx2.o \
+	blit/blit-convert-avx2.o \
+	yuv_to_rgb_avx2.o
 endif
 
 # Include common rules
@@ -67,6 +67,7 @@ void Context::reset() {
 	packedPixelsSupported = false;
 	packedDepthStencilSupported = false;
 	unpackSubImageSupported = false;
+	pixelBufferObjectSupported = false;
 	OESDepth24 = false;
 	textureEdgeClampSupported = false;
 	textureBorderClampSupported = false;
@@ -276,6 +277,10 @@ void Context::initialize(ContextType contextType) {
 		if (isGLVersionOrHigher(1, 4)) {
 			textureMirrorRepeatSupported = true;
 		}
+		// OpenGL 2.1 adds pixel buffer objects
+		if (isGLVersionOrHigher(2, 1)) {
+			pixelBufferObjectSupported = true;
+		}
 		debug(5, "OpenGL: GL context initialized");
 	} else {
 		warning("OpenGL: Unknown context initialized");
@@ -301,6 +306,7 @@ void Context::initialize(ContextType contextType) {
 	debug(5, "OpenGL: Packed pixels support: %d", packedPixelsSupported);
 	debug(5, "OpenGL: Packed depth stencil support: %d", packedDepthStencilSupported);
 	debug(5, "OpenGL: Unpack subimage support: %d", unpackSubImageSupported);
+	debug(5, "OpenGL: Pixel buffer object support: %d", pixelBufferObjectSupported);
 	debug(5, "OpenGL: OpenGL ES depth 24 support: %d", OESDepth24);
 	debug(5, "OpenGL: Texture edge clamping support: %d", textureEdgeClampSupported);
 	debug(5, "OpenGL: Texture border clamping support: %d", textureBorderClampSupported);
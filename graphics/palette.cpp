@@ -22,6 +22,23 @@
 
 namespace Graphics {
 
+static inline uint32 naiveColorDistance(const byte *entry, byte cr, byte cg, byte cb) {
+	int r = entry[0] - cr;
+	int g = entry[1] - cg;
+	int b = entry[2] - cb;
+
+	return 3 * r * r + 5 * g * g + 2 * b * b;
+}
+
+static inline uint32 colorDistance(const byte *entry, byte cr, byte cg, byte cb) {
+	int rmean = (entry[0] + cr) / 2;
+	int r = entry[0] - cr;
+	int g = entry[1] - cg;
+	int b = entry[2] - cb;
+
+	return (((512 + rmean) * r * r) >> 8) + 4 * g * g + (((767 - rmean) * b * b) >> 8);
+}
+
 Palette::Palette(uint size) : _data(nullptr), _size(size) {
 	if (_size > 0) {
 		_data = new byte[_size * 3]();
@@ -74,11 +91,7 @@ byte Palette::findBestColor(byte cr, byte cg, byte cb, bool useNaiveAlg) const {
 
 	if (useNaiveAlg) {
 		for (uint i = 0; i < _size; i++) {
-			int r = _data[3 * i + 0] - cr;
-			int g = _data[3 * i + 1] - cg;
-			int b = _data[3 * i + 2] - cb;
-
-			uint32 distWeighted = 3 * r * r + 5 * g * g + 2 * b * b;
+			uint32 distWeighted = naiveColorDistance(&_data[3 * i], cr, cg, cb);
 			if (distWeighted < min) {
 				bestColor = i;
 				min = distWeighted;
@@ -86,12 +99,7 @@ byte Palette::findBestColor(byte cr, byte cg, byte cb, bool useNaiveAlg) const {
 		}
 	} else {
 		for (uint i = 0; i < _size; ++i) {
-			int rmean = (_data[3 * i + 0] + cr) / 2;
-			int r = _data[3 * i + 0] - cr;
-			int g = _data[3 * i + 1] - cg;
-			int b = _data[3 * i + 2] - cb;
-
-			uint32 distSquared = (((512 + rmean) * r * r) >> 8) + 4 * g * g + (((767 - rmean) * b * b) >> 8);
+			uint32 distSquared = colorDistance(&_data[3 * i], cr, cg, cb);
 			if (distSquared < min) {
 				bestColor = i;
 				min = distSquared;
@@ -144,7 +152,10 @@ bool PaletteLookup::setPalette(const byte *palette, uint len)  {
 
 	_paletteSize = len;
 	_palette.set(palette, 0, len);
-	_colorHash.clear();
+	_cellTables[0].cells.clear();
+	_cellTables[0].entries.clear();
+	_cellTables[1].cells.clear();
+	_cellTables[1].entries.clear();
 
 	return true;
 }
@@ -155,17 +166,112 @@ byte PaletteLookup::findBestColor(byte cr, byte cg, byte cb, bool useNaiveAlg) {
 		return 0;
 	}
 
-	uint32 color = cr << 16 | cg << 8 | cb;
+	return lookupColor(cr, cg, cb, useNaiveAlg);
+}
+
+void PaletteLookup::findBestColors(byte *dst, const byte *src, uint count, bool useNaiveAlg) {
+	if (_paletteSize == 0) {
+		warning("PaletteLookup::findBestColors(): Palette was not set");
+		memset(dst, 0, count);
+		return;
+	}
 
-	if (_colorHash.contains(color))
-		return _colorHash[color];
+	// Neighbouring pixels often have the same color
+	uint32 lastColor = 0xFFFFFFFF;
+	byte lastIndex = 0;
+
+	for (uint i = 0; i < count; i++, src += 3) {
+		const uint32 color = src[0] << 16 | src[1] << 8 | src[2];
+		if (color != lastColor) {
+			lastIndex = lookupColor(src[0], src[1], src[2], useNaiveAlg);
+			lastColor = color;
+		}
+		dst[i] = lastIndex;
+	}
+}
 
-	uint bestColor = _palette.findBestColor(cr, cg, cb, useNaiveAlg);
-	_colorHash[color] = bestColor;
+byte PaletteLookup::lookupColor(byte cr, byte cg, byte cb, bool useNaiveAlg) {
+	CellTable &table = _cellTables[useNaiveAlg ? 1 : 0];
+	if (table.cells.empty())
+		table.cells.resize(kCellCount);
+
+	const uint cell = (cr >> kCellShift) << (2 * kCellBits) | (cg >> kCellShift) << kCellBits | (cb >> kCellShift);
+	uint32 entries = table.cells[cell];
+	if (!entries)
+		entries = fillCell(table, cell, useNaiveAlg);
+
+	const byte *entry = &table.entries[entries >> 9];
+	const uint num = entries & 0x1FF;
+	if (num == 1)
+		return *entry;
+
+	// Compare the candidates in the order of the palette, so that ties
+	// resolve to the same entry as Palette::findBestColor()
+	const byte *data = _palette.data();
+	uint bestColor = 0;
+	uint32 min = 0xFFFFFFFF;
+
+	for (uint i = 0; i < num; i++) {
+		const uint32 dist = useNaiveAlg ? naiveColorDistance(&data[3 * entry[i]], cr, cg, cb) : colorDistance(&data[3 * entry[i]], cr, cg, cb);
+		if (dist < min) {
+			bestColor = entry[i];
+			min = dist;
+		}
+	}
 
 	return bestColor;
 }
 
+uint32 PaletteLookup::fillCell(CellTable &table, uint cell, bool useNaiveAlg) {
+	const int lo[3] = {
+		(int)(cell >> (2 * kCellBits)) << kCellShift,
+		(int)((cell >> kCellBits) & ((1 << kCellBits) - 1)) << kCellShift,
+		(int)(cell & ((1 << kCellBits) - 1)) << kCellShift
+	};
+	const int hi[3] = { lo[0] + (1 << kCellShift) - 1, lo[1] + (1 << kCellShift) - 1, lo[2] + (1 << kCellShift) - 1 };
+
+	// Bound the distance of each entry to the colors of the cell. An entry
+	// can only be the closest one if it is no further than the entry with
+	// the lowest upper bound.
+	const byte *data = _palette.data();
+	const uint size = _palette.size();
+	uint32 lower[256];
+	uint32 minUpper = 0xFFFFFFFF;
+
+	for (uint i = 0; i < size; i++) {
+		const int r = data[3 * i + 0], g = data[3 * i + 1], b = data[3 * i + 2];
+
+		const int rMin = MAX(lo[0] - r, 0) + MAX(r - hi[0], 0);
+		const int gMin = MAX(lo[1] - g, 0) + MAX(g - hi[1], 0);
+		const int bMin = MAX(lo[2] - b, 0) + MAX(b - hi[2], 0);
+		const int rMax = MAX(r - lo[0], hi[0] - r);
+		const int gMax = MAX(g - lo[1], hi[1] - g);
+		const int bMax = MAX(b - lo[2], hi[2] - b);
+
+		uint32 upper;
+		if (useNaiveAlg) {
+			lower[i] = 3 * rMin * rMin + 5 * gMin * gMin + 2 * bMin * bMin;
+			upper = 3 * rMax * rMax + 5 * gMax * gMax + 2 * bMax * bMax;
+		} else {
+			const int rmeanLo = (r + lo[0]) / 2;
+			const int rmeanHi = (r + hi[0]) / 2;
+			lower[i] = (((512 + rmeanLo) * rMin * rMin) >> 8) + 4 * gMin * gMin + (((767 - rmeanHi) * bMin * bMin) >> 8);
+			upper = (((512 + rmeanHi) * rMax * rMax) >> 8) + 4 * gMax * gMax + (((767 - rmeanLo) * bMax * bMax) >> 8);
+		}
+		minUpper = MIN(minUpper, upper);
+	}
+
+	const uint32 offset = table.entries.size();
+	for (uint i = 0; i < size; i++) {
+		if (lower[i] <= minUpper)
+			table.entries.push_back(i);
+	}
+
+	const uint32 entries = offset << 9 | (table.entries.size() - offset);
+	table.cells[cell] = entries;
+	return entries;
+}
+
 uint32 *PaletteLookup::createMap(const byte *srcPalette, uint len, bool useNaiveAlg) {
 	if (len <= _paletteSize && memcmp(_palette.data(), srcPalette, len * 3) == 0)
 		return nullptr;
@@ -22,7 +22,7 @@
 #ifndef GRAPHICS_PALETTE_H
 #define GRAPHICS_PALETTE_H
 
-#include "common/hashmap.h"
+#include "common/array.h"
 
 namespace Graphics {
 
@@ -171,6 +171,17 @@ public:
 	 */
 	byte findBestColor(byte r, byte g, byte b, bool useNaiveAlg = false);
 
+	/**
+	 * @brief This method returns the closest colors from the palette
+	 *        for a row of colors, like findBestColor()
+	 *
+	 * @param dst                    the palette indices
+	 * @param src                    the colors, in interleaved RGB format
+	 * @param count                  the number of colors
+	 * @param useNaiveAlg            if true, use a simpler algorithm
+	 */
+	void findBestColors(byte *dst, const byte *src, uint count, bool useNaiveAlg = false);
+
 	/**
 	 * @brief This method creates a map from the given palette
 	 *        that can be used by crossBlitMap().
@@ -184,9 +195,29 @@ public:
 	uint32 *createMap(const byte *srcPalette, uint len, bool useNaiveAlg = false);
 
 private:
+	/**
+	 * The colors are split into cells of 16x16x16 colors. Each cell lists the
+	 * palette entries which can be the closest one to any of its colors, so
+	 * only these have to be compared. The cells are filled on first use.
+	 */
+	enum {
+		kCellBits = 4,
+		kCellShift = 8 - kCellBits,
+		kCellCount = 1 << (3 * kCellBits)
+	};
+
+	struct CellTable {
+		/** The offset of the entries of each cell shifted left by 9, plus their number, or 0 if not filled yet */
+		Common::Array<uint32> cells;
+		Common::Array<byte> entries;
+	};
+
+	byte lookupColor(byte r, byte g, byte b, bool useNaiveAlg);
+	uint32 fillCell(CellTable &table, uint cell, bool useNaiveAlg);
+
 	Palette _palette;
 	uint _paletteSize;
-	Common::HashMap<int, byte> _colorHash;
+	CellTable _cellTables[2];
 };
 
 } //  // end of namespace Graphics
@@ -85,6 +85,17 @@ static inline void stage_scale4x(void* dst0, void* dst1, void* dst2, void* dst3,
 	stage_scale2x(dst2, dst3, src1, src2, src3, pixel, 2 * pixel_per_row);
 }
 
+/**
+ * Replicate the first and last pixel of a buffer row into the padding around
+ * it. The optimized versions of scale2x read one pixel past both ends of their
+ * source rows, which for the buffer rows of scale4x must not depend on whatever
+ * the memory next to the row happens to contain.
+ */
+static inline void pad_row(unsigned char* row, unsigned pixel, unsigned pixel_per_row) {
+	memcpy(row - pixel, row, pixel);
+	memcpy(row + pixel_per_row * pixel, row + (pixel_per_row - 1) * pixel, pixel);
+}
+
 #define SCDST(i) (dst+(i)*dst_slice)
 #define SCSRC(i) (src+(i)*src_slice)
 #define SCMID(i) (mid[(i)])
@@ -167,7 +178,7 @@ static void scale3x(void* void_dst, unsigned dst_slice, const void* void_src, un
  * note that the resulting size is exactly 4x4 times the size of the source bitmap.
  * \note This function requires also a small buffer bitmap used internally to store
  * intermediate results. This bitmap must have at least a horizontal size in bytes of 2*width*pixel,
- * and a vertical size of 6 rows. The memory of this buffer must not be allocated
+ * plus 8 bytes of padding before and after each row, and a vertical size of 6 rows. The memory of this buffer must not be allocated
  * in video memory because it's also read and not only written. Generally
  * a heap (malloc) or a stack (alloca) buffer is the best choices.
  * @param void_dst Pointer at the first pixel of the destination bitmap.
@@ -200,10 +211,14 @@ static void scale4x_buf(void* void_dst, unsigned dst_slice, void* void_mid, unsi
 
 	stage_scale2x(SCMID(0), SCMID(1), SCSRC(0), SCSRC(1), SCSRC(2), pixel, width);
 	stage_scale2x(SCMID(2), SCMID(3), SCSRC(1), SCSRC(2), SCSRC(3), pixel, width);
+	for (unsigned i = 0; i < 4; ++i)
+		pad_row(SCMID(i), pixel, 2 * width);
 	while (count) {
 		unsigned char* tmp;
 
 		stage_scale2x(SCMID(4), SCMID(5), SCSRC(2), SCSRC(3), SCSRC(4), pixel, width);
+		pad_row(SCMID(4), pixel, 2 * width);
+		pad_row(SCMID(5), pixel, 2 * width);
 		stage_scale4x(SCDST(0), SCDST(1), SCDST(2), SCDST(3), SCMID(1), SCMID(2), SCMID(3), SCMID(4), pixel, width);
 
 		dst = SCDST(4);
@@ -246,7 +261,7 @@ static void scale4x(void* void_dst, unsigned dst_slice, const void* void_src, un
 	unsigned mid_slice;
 	void* mid;
 
-	mid_slice = 2 * pixel * width; /* required space for 1 row buffer */
+	mid_slice = 2 * pixel * width + 2 * 8; /* required space for 1 row buffer and its padding */
 
 	mid_slice = (mid_slice + 0x7) & ~0x7; /* align to 8 bytes */
 
@@ -261,7 +276,7 @@ static void scale4x(void* void_dst, unsigned dst_slice, const void* void_src, un
 		return;
 #endif
 
-	scale4x_buf(void_dst, dst_slice, mid, mid_slice, void_src, src_slice, pixel, width, height);
+	scale4x_buf(void_dst, dst_slice, (unsigned char*)mid + 8, mid_slice, void_src, src_slice, pixel, width, height);
 
 #if !defined(HAVE_ALLOCA)
 	free(mid);
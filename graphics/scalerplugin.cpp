@@ -20,6 +20,8 @@
 
 #include "graphics/scalerplugin.h"
 
+#include "common/threadpool.h"
+
 namespace {
 /**
  * Trivial 'scaler' - in fact it doesn't do any scaling but just copies the
@@ -40,6 +42,12 @@ void Normal1x(const uint8 *srcPtr, uint32 srcPitch, uint8 *dstPtr, uint32 dstPit
 		dstPtr += dstPitch;
 	}
 }
+
+/**
+ * The minimal number of source rows in a band. Splitting rects any further
+ * costs more in scheduling than it saves.
+ */
+const int kMinBandHeight = 16;
 } // End of anonymous namespace
 
 void Scaler::scale(const uint8 *srcPtr, uint32 srcPitch, uint8 *dstPtr,
@@ -57,6 +65,29 @@ void Scaler::scale(const uint8 *srcPtr, uint32 srcPitch, uint8 *dstPtr,
 	}
 }
 
+void Scaler::scaleBands(Common::ThreadPool &pool, Scaler *const *bandScalers, uint numBands,
+                        const uint8 *srcPtr, uint32 srcPitch, uint8 *dstPtr,
+                        uint32 dstPitch, int width, int height, int x, int y) {
+	numBands = MIN<uint>(numBands, height / kMinBandHeight);
+	if (_factor == 1 || numBands < 2) {
+		scale(srcPtr, srcPitch, dstPtr, dstPitch, width, height, x, y);
+		return;
+	}
+
+	for (uint i = 0; i < numBands; ++i)
+		bandScalers[i]->setFactor(_factor);
+
+	pool.parallelFor(0, numBands, [&](uint band) {
+		const int top = height * band / numBands;
+		const int bottom = height * (band + 1) / numBands;
+		bandScalers[band]->scaleBand(*this, srcPtr + top * srcPitch, srcPitch,
+		                             dstPtr + top * _factor * dstPitch, dstPitch,
+		                             width, bottom - top, x, y + top);
+	});
+
+	finishBands(srcPtr, srcPitch, dstPtr, dstPitch, width, height, x, y);
+}
+
 SourceScaler::SourceScaler(const Graphics::PixelFormat &format) : Scaler(format), _width(0), _height(0), _oldSrc(NULL), _enable(false) {
 }
 
@@ -95,7 +126,16 @@ uint SourceScaler::setFactor(uint factor) {
 
 void SourceScaler::scaleIntern(const uint8 *srcPtr, uint32 srcPitch, uint8 *dstPtr,
 						 uint32 dstPitch, int width, int height, int x, int y) {
-	if (!_enable) {
+	scaleBand(*this, srcPtr, srcPitch, dstPtr, dstPitch, width, height, x, y);
+	finishBands(srcPtr, srcPitch, dstPtr, dstPitch, width, height, x, y);
+}
+
+void SourceScaler::scaleBand(const Scaler &owner, const uint8 *srcPtr, uint32 srcPitch,
+                             uint8 *dstPtr, uint32 dstPitch, int width, int height, int x, int y) {
+	// The old source belongs to the scaler the whole rect is scaled with,
+	// and is only updated once all of its bands are done
+	const SourceScaler &source = static_cast<const SourceScaler &>(owner);
+	if (!source._enable) {
 		// Do not pass _oldSrc, do not update _oldSrc
 		internScale(srcPtr, srcPitch,
 		            dstPtr, dstPitch,
@@ -104,13 +144,21 @@ void SourceScaler::scaleIntern(const uint8 *srcPtr, uint32 srcPitch, uint8 *dstP
 		            NULL, 0);
 		return;
 	}
-	int offset = (_padding + x) * _format.bytesPerPixel + (_padding + y) * srcPitch;
+	int offset = (source._padding + x) * _format.bytesPerPixel + (source._padding + y) * srcPitch;
 	// Call user defined scale function
 	internScale(srcPtr, srcPitch,
 	            dstPtr, dstPitch,
-	            _oldSrc + offset, srcPitch,
+	            source._oldSrc + offset, srcPitch,
 	            width, height,
-	            (uint8 *)_bufferedOutput.getBasePtr(x * _factor, y * _factor), _bufferedOutput.pitch);
+	            (const uint8 *)source._bufferedOutput.getBasePtr(x * _factor, y * _factor), source._bufferedOutput.pitch);
+}
+
+void SourceScaler::finishBands(const uint8 *srcPtr, uint32 srcPitch, const uint8 *dstPtr,
+                               uint32 dstPitch, int width, int height, int x, int y) {
+	if (!_enable)
+		return;
+
+	int offset = (_padding + x) * _format.bytesPerPixel + (_padding + y) * srcPitch;
 
 	// Update the destination buffer
 	byte *buffer = (byte *)_bufferedOutput.getBasePtr(x * _factor, y * _factor);
@@ -25,6 +25,10 @@
 #include "graphics/pixelformat.h"
 #include "graphics/surface.h"
 
+namespace Common {
+class ThreadPool;
+}
+
 class Scaler {
 public:
 	Scaler(const Graphics::PixelFormat &format) : _format(format) {}
@@ -45,6 +49,28 @@ public:
 	void scale(const uint8 *srcPtr, uint32 srcPitch, uint8 *dstPtr,
 	           uint32 dstPitch, int width, int height, int x, int y);
 
+	/**
+	 * Scale a rect like scale(), but split it into horizontal bands which
+	 * are scaled concurrently by the given thread pool. Every band still
+	 * reads the source pixels around it, so the result is identical to
+	 * calling scale().
+	 *
+	 * Scalers keep scratch data in their instance, so each band is scaled
+	 * by its own instance. These must have been created by the same plugin
+	 * with the same format as this scaler, and should not have their old
+	 * source enabled; the old source of this scaler is used instead.
+	 *
+	 * @param pool        The thread pool to scale the bands on.
+	 * @param bandScalers The scalers to use for the bands.
+	 * @param numBands    The number of band scalers, and so the maximum
+	 *                    number of bands.
+	 *
+	 * @see scale
+	 */
+	void scaleBands(Common::ThreadPool &pool, Scaler *const *bandScalers, uint numBands,
+	                const uint8 *srcPtr, uint32 srcPitch, uint8 *dstPtr,
+	                uint32 dstPitch, int width, int height, int x, int y);
+
 	/**
 	 * Increase the factor of scaling.
 	 * @return The new factor
@@ -101,6 +127,25 @@ protected:
 	virtual void scaleIntern(const uint8 *srcPtr, uint32 srcPitch, uint8 *dstPtr,
 	                         uint32 dstPitch, int width, int height, int x, int y) = 0;
 
+	/**
+	 * Scale one band of a rect for scaleBands(). May be called from any
+	 * thread, but only for one band at a time.
+	 *
+	 * @param owner The scaler scaleBands() was called on.
+	 * @see scaleBands
+	 */
+	virtual void scaleBand(const Scaler &owner, const uint8 *srcPtr, uint32 srcPitch,
+	                       uint8 *dstPtr, uint32 dstPitch, int width, int height, int x, int y) {
+		scaleIntern(srcPtr, srcPitch, dstPtr, dstPitch, width, height, x, y);
+	}
+
+	/**
+	 * Called by scaleBands() on the main thread once all bands of the rect
+	 * have been scaled.
+	 */
+	virtual void finishBands(const uint8 *srcPtr, uint32 srcPitch, const uint8 *dstPtr,
+	                         uint32 dstPitch, int width, int height, int x, int y) {}
+
 	uint _factor;
 	Graphics::PixelFormat _format;
 };
@@ -127,6 +172,12 @@ protected:
 	virtual void scaleIntern(const uint8 *srcPtr, uint32 srcPitch, uint8 *dstPtr,
 	                         uint32 dstPitch, int width, int height, int x, int y) final;
 
+	virtual void scaleBand(const Scaler &owner, const uint8 *srcPtr, uint32 srcPitch,
+	                       uint8 *dstPtr, uint32 dstPitch, int width, int height, int x, int y) final;
+
+	virtual void finishBands(const uint8 *srcPtr, uint32 srcPitch, const uint8 *dstPtr,
+	                         uint32 dstPitch, int width, int height, int x, int y) final;
+
 	/**
 	 * Scalers must implement this function. It will be called by oldSrcScale.
 	 * If by comparing the src and oldsrc images it is discovered that no change
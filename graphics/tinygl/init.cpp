@@ -27,6 +27,7 @@
 
 #include "common/singleton.h"
 #include "common/array.h"
+#include "common/config-manager.h"
 
 #include "graphics/tinygl/tinygl.h"
 #include "graphics/tinygl/zgl.h"
@@ -354,6 +355,16 @@ void GLContext::init(int screenW, int screenH, Graphics::PixelFormat pixelFormat
 	_debugRectsEnabled = false;
 	_profilingEnabled = false;
 
+	// Rendering on worker threads can be turned off with "tinygl_threads"
+	_tileRenderer = nullptr;
+	if (!ConfMan.hasKey("tinygl_threads") || ConfMan.getBool("tinygl_threads")) {
+		_tileRenderer = new TileRenderer(this);
+		if (!_tileRenderer->isAvailable()) {
+			delete _tileRenderer;
+			_tileRenderer = nullptr;
+		}
+	}
+
 	TinyGL::Internal::tglBlitResetScissorRect();
 }
 
@@ -367,6 +378,7 @@ void GLContext::deinit() {
 	free_texture(default_texture);
 	endSharedState();
 	gl_free(vertex);
+	delete _tileRenderer;
 	delete fb;
 }
 
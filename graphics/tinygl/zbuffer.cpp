@@ -53,18 +53,29 @@ FrameBuffer::FrameBuffer(int width, int height, const Graphics::PixelFormat &for
 	_offscreenBuffer.pbuf = _pbuf;
 	_offscreenBuffer.zbuf = _zbuf;
 
+	_ownsBuffers = true;
+
 	_currentTexture = nullptr;
 
 	_enableScissor = false;
 }
 
 FrameBuffer::~FrameBuffer() {
+	if (!_ownsBuffers)
+		return;
+
 	gl_free(_pbuf);
 	gl_free(_zbuf);
 	if (_sbuf)
 		gl_free(_sbuf);
 }
 
+FrameBuffer *FrameBuffer::createView() const {
+	FrameBuffer *view = new FrameBuffer(*this);
+	view->_ownsBuffers = false;
+	return view;
+}
+
 Buffer *FrameBuffer::genOffscreenBuffer() {
 	Buffer *buf = (Buffer *)gl_malloc(sizeof(Buffer));
 	buf->pbuf = (byte *)gl_zalloc(_pbufHeight * _pbufPitch);
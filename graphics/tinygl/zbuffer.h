@@ -106,6 +106,12 @@ struct FrameBuffer {
 	FrameBuffer(int width, int height, const Graphics::PixelFormat &format, bool enableStencilBuffer);
 	~FrameBuffer();
 
+	/**
+	 * Create a frame buffer drawing into the buffers of this one, with a copy
+	 * of its rendering state. The buffers stay owned by this frame buffer.
+	 */
+	FrameBuffer *createView() const;
+
 	Graphics::PixelFormat getPixelFormat() {
 		return _pbufFormat;
 	}
@@ -750,6 +756,7 @@ private:
 
 	uint *_zbuf;
 	byte *_sbuf;
+	bool _ownsBuffers;
 
 	bool _enableStencil;
 	int _textureSize;
@@ -22,6 +22,7 @@
 #include "graphics/tinygl/zdirtyrect.h"
 #include "graphics/tinygl/zgl.h"
 #include "graphics/tinygl/gl.h"
+#include "graphics/tinygl/zbuffer.h"
 
 #include "common/debug.h"
 #include "common/math.h"
@@ -193,12 +194,20 @@ void GLContext::presentBufferDirtyRects(Common::List<Common::Rect> &dirtyAreas)
 		}
 
 		// Execute draw calls.
-		for (DrawCallIterator it = _drawCallsQueue.begin(); it != _drawCallsQueue.end(); ++it) {
-			Common::Rect drawCallRegion = (*it)->getDirtyRegion();
+		if (useTileRenderer()) {
+			Common::List<Common::Rect> regions;
 			for (RectangleIterator itRect = rectangles.begin(); itRect != rectangles.end(); ++itRect) {
-				Common::Rect dirtyRegion = (*itRect).rectangle;
-				if (dirtyRegion.intersects(drawCallRegion)) {
-					(*it)->execute(dirtyRegion, true);
+				regions.push_back((*itRect).rectangle);
+			}
+			_tileRenderer->execute(_drawCallsQueue, regions);
+		} else {
+			for (DrawCallIterator it = _drawCallsQueue.begin(); it != _drawCallsQueue.end(); ++it) {
+				Common::Rect drawCallRegion = (*it)->getDirtyRegion();
+				for (RectangleIterator itRect = rectangles.begin(); itRect != rectangles.end(); ++itRect) {
+					Common::Rect dirtyRegion = (*itRect).rectangle;
+					if (dirtyRegion.intersects(drawCallRegion)) {
+						(*it)->execute(dirtyRegion, true);
+					}
 				}
 			}
 		}
@@ -240,8 +249,15 @@ void GLContext::presentBufferSimple(Common::List<Common::Rect> &dirtyAreas) {
 
 	dirtyAreas.push_back(Common::Rect(fb->getPixelBufferWidth(), fb->getPixelBufferHeight()));
 
+	if (useTileRenderer()) {
+		_tileRenderer->execute(_drawCallsQueue, dirtyAreas);
+	} else {
+		for (DrawCallIterator it = _drawCallsQueue.begin(); it != _drawCallsQueue.end(); ++it) {
+			(*it)->execute(true);
+		}
+	}
+
 	for (DrawCallIterator it = _drawCallsQueue.begin(); it != _drawCallsQueue.end(); ++it) {
-		(*it)->execute(true);
 		delete *it;
 	}
 
@@ -252,6 +268,11 @@ void GLContext::presentBufferSimple(Common::List<Common::Rect> &dirtyAreas) {
 	_drawCallAllocator[_currentAllocatorIndex].reset();
 }
 
+bool GLContext::useTileRenderer() const {
+	// The profiling counters and the selection buffer are not thread safe
+	return _tileRenderer && !_profilingEnabled && render_mode != TGL_SELECT;
+}
+
 void presentBuffer(Common::List<Common::Rect> &dirtyAreas) {
 	GLContext *c = gl_get_context();
 	if (c->_enableDirtyRectangles) {
@@ -294,7 +315,7 @@ RasterizationDrawCall::RasterizationDrawCall() : DrawCall(DrawCall_Rasterization
 	_drawTriangleFront = c->draw_triangle_front;
 	_drawTriangleBack = c->draw_triangle_back;
 	memcpy(_vertex, c->vertex, sizeof(GLVertex) * _vertexCount);
-	_state = captureState();
+	_state = captureState(c);
 	if (c->_enableDirtyRectangles) {
 		computeDirtyRegion();
 	}
@@ -338,14 +359,34 @@ void RasterizationDrawCall::execute(bool restoreState) const {
 
 	RasterizationDrawCall::RasterizationState backupState;
 	if (restoreState) {
-		backupState = captureState();
+		backupState = captureState(c);
 	}
-	applyState(_state);
+	applyState(c, _state);
 
 	GLVertex *prevVertex = c->vertex;
 	int prevVertexCount = c->vertex_cnt;
 
-	c->vertex = _vertex;
+	draw(c, _vertex);
+
+	c->vertex = prevVertex;
+	c->vertex_cnt = prevVertexCount;
+
+	if (restoreState) {
+		applyState(c, backupState);
+	}
+}
+
+void RasterizationDrawCall::executeTile(GLContext *tileContext, const Common::Rect &clippingRectangle, GLVertex *vertexBuffer) const {
+	memcpy(vertexBuffer, _vertex, sizeof(GLVertex) * _vertexCount);
+	applyState(tileContext, _state);
+
+	tileContext->fb->setScissorRectangle(clippingRectangle);
+	draw(tileContext, vertexBuffer);
+	tileContext->fb->resetScissorRectangle();
+}
+
+void RasterizationDrawCall::draw(GLContext *c, GLVertex *vertex) const {
+	c->vertex = vertex;
 	c->vertex_cnt = _vertexCount;
 	c->draw_triangle_front = (gl_draw_triangle_func)_drawTriangleFront;
 	c->draw_triangle_back = (gl_draw_triangle_func)_drawTriangleBack;
@@ -424,18 +465,10 @@ void RasterizationDrawCall::execute(bool restoreState) const {
 	default:
 		error("glBegin: type %x not handled", c->begin_type);
 	}
-
-	c->vertex = prevVertex;
-	c->vertex_cnt = prevVertexCount;
-
-	if (restoreState) {
-		applyState(backupState);
-	}
 }
 
-RasterizationDrawCall::RasterizationState RasterizationDrawCall::captureState() const {
+RasterizationDrawCall::RasterizationState RasterizationDrawCall::captureState(GLContext *c) const {
 	RasterizationState state;
-	GLContext *c = gl_get_context();
 	state.enableBlending = c->blending_enabled;
 	state.sfactor = c->source_blending_factor;
 	state.dfactor = c->destination_blending_factor;
@@ -484,8 +517,7 @@ RasterizationDrawCall::RasterizationState RasterizationDrawCall::captureState()
 	return state;
 }
 
-void RasterizationDrawCall::applyState(const RasterizationDrawCall::RasterizationState &state) const {
-	GLContext *c = gl_get_context();
+void RasterizationDrawCall::applyState(GLContext *c, const RasterizationDrawCall::RasterizationState &state) const {
 	c->fb->enableBlending(state.enableBlending);
 	c->fb->setBlendingFactors(state.sfactor, state.dfactor);
 	c->fb->enableAlphaTest(state.alphaTestEnabled);
@@ -708,6 +740,12 @@ void ClearBufferDrawCall::execute(const Common::Rect &clippingRectangle, bool re
 	                   _clearStencilBuffer, _stencilValue);
 }
 
+void ClearBufferDrawCall::executeTile(GLContext *tileContext, const Common::Rect &clippingRectangle) const {
+	tileContext->fb->clearRegion(clippingRectangle.left, clippingRectangle.top, clippingRectangle.width(), clippingRectangle.height(),
+	                             _clearZBuffer, _zValue, _clearColorBuffer, _rValue, _gValue, _bValue,
+	                             _clearStencilBuffer, _stencilValue);
+}
+
 bool ClearBufferDrawCall::operator==(const ClearBufferDrawCall &other) const {
 	return
 		_clearZBuffer == other._clearZBuffer &&
@@ -769,6 +807,133 @@ bool RasterizationDrawCall::RasterizationState::operator==(const RasterizationSt
 		viewportScaling[2] == other.viewportScaling[2];
 }
 
+TileRenderer::TileRenderer(GLContext *c) : _context(c) {
+}
+
+TileRenderer::~TileRenderer() {
+	for (uint i = 0; i < _tiles.size(); i++) {
+		delete _tiles[i].context->fb;
+		delete _tiles[i].context;
+	}
+}
+
+void TileRenderer::setupTiles() {
+	const int width = _context->fb->getPixelBufferWidth();
+	const int height = _context->fb->getPixelBufferHeight();
+	const uint numTiles = (height + kTileHeight - 1) / kTileHeight;
+
+	if (_tiles.size() != numTiles) {
+		for (uint i = numTiles; i < _tiles.size(); i++) {
+			delete _tiles[i].context->fb;
+			delete _tiles[i].context;
+		}
+
+		const uint oldSize = _tiles.size();
+		_tiles.resize(numTiles);
+		for (uint i = oldSize; i < numTiles; i++) {
+			_tiles[i].context = new GLContext;
+			_tiles[i].context->fb = nullptr;
+		}
+	}
+
+	for (uint i = 0; i < numTiles; i++) {
+		Tile &tile = _tiles[i];
+		tile.rect = Common::Rect(0, i * kTileHeight, width, MIN<int>((i + 1) * kTileHeight, height));
+
+		// The frame buffer may have switched to other buffers since the last frame
+		GLContext *tileContext = tile.context;
+		delete tileContext->fb;
+		tileContext->fb = _context->fb->createView();
+
+		// The state used for rasterizing which is not recorded by the draw calls
+		tileContext->_textureSize = _context->_textureSize;
+		tileContext->current_cull_face = _context->current_cull_face;
+		tileContext->render_mode = _context->render_mode;
+		tileContext->vertex_n = _context->vertex_n;
+		tileContext->_profilingEnabled = false;
+	}
+}
+
+void TileRenderer::execute(const Common::List<DrawCall *> &drawCalls, const Common::List<Common::Rect> &regions) {
+	typedef Common::List<DrawCall *>::const_iterator DrawCallIterator;
+	typedef Common::List<Common::Rect>::const_iterator RectangleIterator;
+
+	setupTiles();
+
+	for (DrawCallIterator it = drawCalls.begin(); it != drawCalls.end(); ++it) {
+		const DrawCall *drawCall = *it;
+		const Common::Rect drawCallRegion = drawCall->getDirtyRegion();
+
+		if (drawCall->getType() == DrawCall::DrawCall_Blitting) {
+			flushTiles();
+
+			for (RectangleIterator itRect = regions.begin(); itRect != regions.end(); ++itRect) {
+				if (!_context->_enableDirtyRectangles) {
+					drawCall->execute(true);
+				} else if ((*itRect).intersects(drawCallRegion)) {
+					drawCall->execute(*itRect, true);
+				}
+			}
+			continue;
+		}
+
+		if (drawCall->getType() == DrawCall::DrawCall_Rasterization) {
+			const uint vertexCount = ((const RasterizationDrawCall *)drawCall)->getVertexCount();
+			for (uint i = 0; i < _tiles.size(); i++) {
+				if (_tiles[i].vertexBuffer.size() < vertexCount)
+					_tiles[i].vertexBuffer.resize(vertexCount);
+			}
+		}
+
+		for (RectangleIterator itRect = regions.begin(); itRect != regions.end(); ++itRect) {
+			Common::Rect region = *itRect;
+			if (_context->_enableDirtyRectangles) {
+				if (!region.intersects(drawCallRegion))
+					continue;
+
+				// Clearing is limited to the dirty region, like in ClearBufferDrawCall::execute()
+				if (drawCall->getType() == DrawCall::DrawCall_Clear)
+					region = region.findIntersectingRect(drawCallRegion);
+			}
+
+			for (uint i = 0; i < _tiles.size(); i++) {
+				const Common::Rect clippingRectangle = region.findIntersectingRect(_tiles[i].rect);
+				if (!clippingRectangle.isEmpty())
+					_tiles[i].drawCalls.push_back(TileDrawCall(drawCall, clippingRectangle));
+			}
+		}
+	}
+
+	flushTiles();
+}
+
+void TileRenderer::flushTiles() {
+	_pool.parallelFor(0, _tiles.size(), [this](uint i) {
+		renderTile(_tiles[i]);
+	});
+
+	for (uint i = 0; i < _tiles.size(); i++) {
+		_tiles[i].drawCalls.clear();
+	}
+}
+
+void TileRenderer::renderTile(Tile &tile) {
+	for (uint i = 0; i < tile.drawCalls.size(); i++) {
+		const TileDrawCall &call = tile.drawCalls[i];
+
+		switch (call.drawCall->getType()) {
+		case DrawCall::DrawCall_Rasterization:
+			((const RasterizationDrawCall *)call.drawCall)->executeTile(tile.context, call.clippingRectangle, tile.vertexBuffer.begin());
+			break;
+		case DrawCall::DrawCall_Clear:
+			((const ClearBufferDrawCall *)call.drawCall)->executeTile(tile.context, call.clippingRectangle);
+			break;
+		default:
+			break;
+		}
+	}
+}
+
 void *Internal::allocateFrame(int size) {
 	GLContext *c = gl_get_context();
 	return c->_drawCallAllocator[c->_currentAllocatorIndex].allocate(size);
@@ -25,6 +25,8 @@
 #include "common/types.h"
 #include "common/rect.h"
 #include "common/array.h"
+#include "common/list.h"
+#include "common/threadpool.h"
 
 #include "graphics/tinygl/zblit.h"
 
@@ -37,6 +39,7 @@ void *allocateFrame(int size);
 struct GLContext;
 struct GLVertex;
 struct GLTexture;
+struct FrameBuffer;
 
 class DrawCall {
 public:
@@ -71,6 +74,12 @@ public:
 	virtual void execute(bool restoreState) const;
 	virtual void execute(const Common::Rect &clippingRectangle, bool restoreState) const;
 
+	/**
+	 * Clear a tile of the frame with the context of the tile.
+	 * The clipping rectangle must be within the dirty region.
+	 */
+	void executeTile(GLContext *tileContext, const Common::Rect &clippingRectangle) const;
+
 	void *operator new(size_t size) {
 		return Internal::allocateFrame(size);
 	}
@@ -90,6 +99,15 @@ public:
 	virtual void execute(bool restoreState) const;
 	virtual void execute(const Common::Rect &clippingRectangle, bool restoreState) const;
 
+	/**
+	 * Rasterize into a tile of the frame with the context of the tile.
+	 * The vertices are copied to vertexBuffer first, since rasterizing
+	 * writes to them.
+	 */
+	void executeTile(GLContext *tileContext, const Common::Rect &clippingRectangle, GLVertex *vertexBuffer) const;
+
+	int getVertexCount() const { return _vertexCount; }
+
 	void *operator new(size_t size) {
 		return Internal::allocateFrame(size);
 	}
@@ -97,6 +115,7 @@ public:
 	void operator delete(void *p) { }
 private:
 	void computeDirtyRegion();
+	void draw(GLContext *c, GLVertex *vertex) const;
 	typedef void (*gl_draw_triangle_func_ptr)(GLContext *c, TinyGL::GLVertex *p0, TinyGL::GLVertex *p1, TinyGL::GLVertex *p2);
 	int _vertexCount;
 	GLVertex *_vertex;
@@ -150,8 +169,8 @@ private:
 
 	RasterizationState _state;
 
-	RasterizationState captureState() const;
-	void applyState(const RasterizationState &state) const;
+	RasterizationState captureState(GLContext *c) const;
+	void applyState(GLContext *c, const RasterizationState &state) const;
 };
 
 // Encapsulate a blit call: it might execute either a color buffer or z buffer blit.
@@ -208,6 +227,55 @@ private:
 	BlittingState _blitState;
 };
 
+// Executes the draw calls of a frame in horizontal tiles of the screen, on
+// worker threads. Each tile has its own context and rendering state, and only
+// draws into its own rows of the shared buffers, so the draw calls keep their
+// order within each tile. Blitting draw calls use the global blitting state,
+// so all tiles are finished before one is executed on the calling thread.
+class TileRenderer {
+public:
+	TileRenderer(GLContext *c);
+	~TileRenderer();
+
+	/** Whether there are worker threads to render with. */
+	bool isAvailable() const { return _pool.getWorkerCount() != 0; }
+
+	/**
+	 * Execute the draw calls clipped to the given regions, in the same order
+	 * as executing each of them in every region in turn. Without dirty
+	 * rectangles, the draw calls are executed on the whole regions.
+	 */
+	void execute(const Common::List<DrawCall *> &drawCalls, const Common::List<Common::Rect> &regions);
+
+private:
+	enum {
+		kTileHeight = 32
+	};
+
+	struct TileDrawCall {
+		TileDrawCall() : drawCall(nullptr) {}
+		TileDrawCall(const DrawCall *call, const Common::Rect &rect) : drawCall(call), clippingRectangle(rect) {}
+
+		const DrawCall *drawCall;
+		Common::Rect clippingRectangle;
+	};
+
+	struct Tile {
+		Common::Rect rect;
+		GLContext *context;
+		Common::Array<GLVertex> vertexBuffer;
+		Common::Array<TileDrawCall> drawCalls;
+	};
+
+	void setupTiles();
+	void flushTiles();
+	void renderTile(Tile &tile);
+
+	GLContext *_context;
+	Common::ThreadPool _pool;
+	Common::Array<Tile> _tiles;
+};
+
 } // end of namespace TinyGL
 
 #endif
@@ -463,6 +463,10 @@ struct GLContext {
 	bool _debugRectsEnabled;
 	bool _profilingEnabled;
 
+	// Executes the draw calls on worker threads, if there are any
+	TileRenderer *_tileRenderer;
+	bool useTileRenderer() const;
+
 	void gl_vertex_transform(GLVertex *v);
 	void gl_calc_fog_factor(GLVertex *v);
 
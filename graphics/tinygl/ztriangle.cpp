@@ -424,7 +424,9 @@ void FrameBuffer::fillTriangle(ZBufferPoint *p0, ZBufferPoint *p1, ZBufferPoint
 		// we draw all the scan line of the part
 		while (nb_lines > 0) {
 			int x = x1;
-			if (!kInterpRGB) {
+			if (kEnableScissor && (y < _clipRectangle.top || y >= _clipRectangle.bottom)) {
+				// the whole scan line is scissored, only step the edges
+			} else if (!kInterpRGB) {
 				int n;
 				uint *pz;
 				byte *ps = nullptr;
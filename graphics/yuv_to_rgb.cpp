@@ -82,8 +82,11 @@
 // BASIS, AND BROWN UNIVERSITY HAS NO OBLIGATION TO PROVIDE MAINTENANCE,
 // SUPPORT, UPDATES, ENHANCEMENTS, OR MODIFICATIONS.
 
+#include "common/system.h"
+
 #include "graphics/surface.h"
 #include "graphics/yuv_to_rgb.h"
+#include "graphics/yuv_to_rgb_intern.h"
 
 namespace Common {
 DECLARE_SINGLETON(Graphics::YUVToRGBManager);
@@ -100,17 +103,28 @@ public:
 	const int16 *getColorTable() const { return _colorTab; }
 	const byte *getClipTable() const { return _clipTable; }
 
+	const YUVToRGBSIMD::Params &getSIMDParams() const { return _simdParams; }
+	YUVToRGBSIMD::RowFunc getRowFunc444() const { return _rowFunc444; }
+	YUVToRGBSIMD::RowFunc getRowFunc422() const { return _rowFunc422; }
+
 private:
 	Graphics::PixelFormat _format;
 	YUVToRGBManager::LuminanceScale _scale;
 	int16 _colorTab[4 * 256]; // 2048 bytes
 	byte _clipTable[3 * 768];
+
+	YUVToRGBSIMD::Params _simdParams;
+	YUVToRGBSIMD::RowFunc _rowFunc444;
+	YUVToRGBSIMD::RowFunc _rowFunc422;
 };
 
-YUVToRGBLookup::YUVToRGBLookup(Graphics::PixelFormat format, YUVToRGBManager::LuminanceScale scale) {
+YUVToRGBLookup::YUVToRGBLookup(Graphics::PixelFormat format, YUVToRGBManager::LuminanceScale scale) : _simdParams(format) {
 	_format = format;
 	_scale = scale;
 
+	_rowFunc444 = YUVToRGBSIMD::getRowFunc(format, scale, false);
+	_rowFunc422 = YUVToRGBSIMD::getRowFunc(format, scale, true);
+
 	// Generate the tables for the display surface
 
 	uint r_offset = 0;
@@ -181,6 +195,38 @@ YUVToRGBLookup::YUVToRGBLookup(Graphics::PixelFormat format, YUVToRGBManager::Lu
 	}
 }
 
+YUVToRGBSIMD::Params::Params(const Graphics::PixelFormat &format) {
+	rLoss = format.rLoss;
+	gLoss = format.gLoss;
+	bLoss = format.bLoss;
+	rShift = format.rShift;
+	gShift = format.gShift;
+	bShift = format.bShift;
+	aMask = (0xFF >> format.aLoss) << format.aShift;
+}
+
+YUVToRGBSIMD::RowFunc YUVToRGBSIMD::getRowFunc(const Graphics::PixelFormat &format, YUVToRGBManager::LuminanceScale scale, bool subsampled) {
+	RowFunc func = nullptr;
+
+	if (format.bytesPerPixel != 2 && format.bytesPerPixel != 4)
+		return func;
+
+#ifdef SCUMMVM_NEON
+	if (!func && g_system->hasFeature(OSystem::kFeatureCpuNEON))
+		func = getRowFuncNEON(format.bytesPerPixel, scale, subsampled);
+#endif
+#ifdef SCUMMVM_AVX2
+	if (!func && g_system->hasFeature(OSystem::kFeatureCpuAVX2))
+		func = getRowFuncAVX2(format.bytesPerPixel, scale, subsampled);
+#endif
+#ifdef SCUMMVM_SSE2
+	if (!func && g_system->hasFeature(OSystem::kFeatureCpuSSE2))
+		func = getRowFuncSSE2(format.bytesPerPixel, scale, subsampled);
+#endif
+
+	return func;
+}
+
 YUVToRGBManager::YUVToRGBManager() {
 	_lookup = 0;
 }
@@ -238,6 +284,23 @@ void convertYUV444ToRGB(byte *dstPtr, int dstPitch, const YUVToRGBLookup *lookup
 	}
 }
 
+template<typename PixelInt>
+void convertYUV444ToRGBSIMD(byte *dstPtr, int dstPitch, const YUVToRGBLookup *lookup, const byte *ySrc, const byte *uSrc, const byte *vSrc, int yWidth, int yHeight, int yPitch, int uvPitch) {
+	YUVToRGBSIMD::RowFunc rowFunc = lookup->getRowFunc444();
+
+	for (int h = 0; h < yHeight; h++) {
+		// Convert the pixels left over by the SIMD kernel with the lookup tables
+		int x = rowFunc(dstPtr, ySrc, uSrc, vSrc, yWidth, lookup->getSIMDParams());
+		if (x < yWidth)
+			convertYUV444ToRGB<PixelInt>(dstPtr + x * sizeof(PixelInt), dstPitch, lookup, ySrc + x, uSrc + x, vSrc + x, yWidth - x, 1, yPitch, uvPitch);
+
+		dstPtr += dstPitch;
+		ySrc += yPitch;
+		uSrc += uvPitch;
+		vSrc += uvPitch;
+	}
+}
+
 void YUVToRGBManager::convert444(Graphics::Surface *dst, YUVToRGBManager::LuminanceScale scale, const byte *ySrc, const byte *uSrc, const byte *vSrc, int yWidth, int yHeight, int yPitch, int uvPitch) {
 	// Sanity checks
 	assert(dst && dst->getPixels());
@@ -246,6 +309,14 @@ void YUVToRGBManager::convert444(Graphics::Surface *dst, YUVToRGBManager::Lumina
 
 	const YUVToRGBLookup *lookup = getLookup(dst->format, scale);
 
+	if (lookup->getRowFunc444()) {
+		if (dst->format.bytesPerPixel == 2)
+			convertYUV444ToRGBSIMD<uint16>((byte *)dst->getPixels(), dst->pitch, lookup, ySrc, uSrc, vSrc, yWidth, yHeight, yPitch, uvPitch);
+		else
+			convertYUV444ToRGBSIMD<uint32>((byte *)dst->getPixels(), dst->pitch, lookup, ySrc, uSrc, vSrc, yWidth, yHeight, yPitch, uvPitch);
+		return;
+	}
+
 	// Use a templated function to avoid an if check on every pixel
 	if (dst->format.bytesPerPixel == 2)
 		convertYUV444ToRGB<uint16>((byte *)dst->getPixels(), dst->pitch, lookup, ySrc, uSrc, vSrc, yWidth, yHeight, yPitch, uvPitch);
@@ -294,6 +365,26 @@ void convertYUV422ToRGB(byte *dstPtr, int dstPitch, const YUVToRGBLookup *lookup
 	}
 }
 
+// Convert a YUV422 image, or a YUV420 one with uvRowShift set to 1
+template<typename PixelInt>
+void convertYUV422ToRGBSIMD(byte *dstPtr, int dstPitch, const YUVToRGBLookup *lookup, const byte *ySrc, const byte *uSrc, const byte *vSrc, int yWidth, int yHeight, int yPitch, int uvPitch, int uvRowShift) {
+	YUVToRGBSIMD::RowFunc rowFunc = lookup->getRowFunc422();
+
+	for (int h = 0; h < yHeight; h++) {
+		const byte *uRow = uSrc + (h >> uvRowShift) * uvPitch;
+		const byte *vRow = vSrc + (h >> uvRowShift) * uvPitch;
+
+		// Convert the pixels left over by the SIMD kernel with the lookup
+		// tables. The kernels always convert an even number of pixels.
+		int x = rowFunc(dstPtr, ySrc, uRow, vRow, yWidth, lookup->getSIMDParams());
+		if (x < yWidth)
+			convertYUV422ToRGB<PixelInt>(dstPtr + x * sizeof(PixelInt), dstPitch, lookup, ySrc + x, uRow + x / 2, vRow + x / 2, yWidth - x, 1, yPitch, uvPitch);
+
+		dstPtr += dstPitch;
+		ySrc += yPitch;
+	}
+}
+
 void YUVToRGBManager::convert422(Graphics::Surface *dst, YUVToRGBManager::LuminanceScale scale, const byte *ySrc, const byte *uSrc, const byte *vSrc, int yWidth, int yHeight, int yPitch, int uvPitch) {
 	// Sanity checks
 	assert(dst && dst->getPixels());
@@ -303,6 +394,14 @@ void YUVToRGBManager::convert422(Graphics::Surface *dst, YUVToRGBManager::Lumina
 
 	const YUVToRGBLookup *lookup = getLookup(dst->format, scale);
 
+	if (lookup->getRowFunc422()) {
+		if (dst->format.bytesPerPixel == 2)
+			convertYUV422ToRGBSIMD<uint16>((byte *)dst->getPixels(), dst->pitch, lookup, ySrc, uSrc, vSrc, yWidth, yHeight, yPitch, uvPitch, 0);
+		else
+			convertYUV422ToRGBSIMD<uint32>((byte *)dst->getPixels(), dst->pitch, lookup, ySrc, uSrc, vSrc, yWidth, yHeight, yPitch, uvPitch, 0);
+		return;
+	}
+
 	// Use a templated function to avoid an if check on every pixel
 	if (dst->format.bytesPerPixel == 2)
 		convertYUV422ToRGB<uint16>((byte *)dst->getPixels(), dst->pitch, lookup, ySrc, uSrc, vSrc, yWidth, yHeight, yPitch, uvPitch);
@@ -364,6 +463,15 @@ void YUVToRGBManager::convert420(Graphics::Surface *dst, YUVToRGBManager::Lumina
 
 	const YUVToRGBLookup *lookup = getLookup(dst->format, scale);
 
+	// Each chroma row covers two rows of the image
+	if (lookup->getRowFunc422()) {
+		if (dst->format.bytesPerPixel == 2)
+			convertYUV422ToRGBSIMD<uint16>((byte *)dst->getPixels(), dst->pitch, lookup, ySrc, uSrc, vSrc, yWidth, yHeight, yPitch, uvPitch, 1);
+		else
+			convertYUV422ToRGBSIMD<uint32>((byte *)dst->getPixels(), dst->pitch, lookup, ySrc, uSrc, vSrc, yWidth, yHeight, yPitch, uvPitch, 1);
+		return;
+	}
+
 	// Use a templated function to avoid an if check on every pixel
 	if (dst->format.bytesPerPixel == 2)
 		convertYUV420ToRGB<uint16>((byte *)dst->getPixels(), dst->pitch, lookup, ySrc, uSrc, vSrc, yWidth, yHeight, yPitch, uvPitch);
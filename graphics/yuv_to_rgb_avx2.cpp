@@ -0,0 +1,137 @@
+/* ScummVM - Graphic Adventure Engine
+ *
+ * ScummVM is the legal property of its developers, whose names
+ * are too numerous to list here. Please refer to the COPYRIGHT
+ * file distributed with this source distribution.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include "common/scummsys.h"
+
+#include "graphics/yuv_to_rgb_intern.h"
+
+#include <immintrin.h>
+
+#ifdef __GNUC__
+#pragma GCC push_options
+#pragma GCC target("avx2")
+#endif
+
+namespace Graphics {
+
+// Multiply the doubled chroma magnitudes by a factor, and restore the sign
+// of the chroma values. This truncates towards zero like the lookup tables.
+static FORCEINLINE __m256i avx2_chroma(__m256i mag2, __m256i sign, int factor) {
+	__m256i product = _mm256_mulhi_epu16(mag2, _mm256_set1_epi16((int16)factor));
+	return _mm256_sub_epi16(_mm256_xor_si256(product, sign), sign);
+}
+
+template<bool itu>
+static FORCEINLINE __m256i avx2_clip(__m256i x) {
+	if (itu) {
+		x = _mm256_sub_epi16(_mm256_min_epi16(_mm256_max_epi16(x, _mm256_set1_epi16(16)), _mm256_set1_epi16(235)), _mm256_set1_epi16(16));
+		return _mm256_add_epi16(x, _mm256_mulhi_epu16(x, _mm256_set1_epi16((int16)YUVToRGBSIMD::kITUStretch)));
+	}
+
+	return _mm256_min_epi16(_mm256_max_epi16(x, _mm256_setzero_si256()), _mm256_set1_epi16(255));
+}
+
+static FORCEINLINE __m256i avx2_loadChroma(const byte *src, bool subsampled) {
+	if (subsampled) {
+		// Use each value for two pixels
+		__m128i c = _mm_loadl_epi64((const __m128i *)src);
+		return _mm256_cvtepu8_epi16(_mm_unpacklo_epi8(c, c));
+	}
+
+	return _mm256_cvtepu8_epi16(_mm_loadu_si128((const __m128i *)src));
+}
+
+// Combine the components of eight pixels into 32-bit pixels
+static FORCEINLINE __m256i avx2_pack32(__m128i r, __m128i g, __m128i b, __m128i rShift, __m128i gShift, __m128i bShift, __m256i aMask) {
+	return _mm256_or_si256(_mm256_or_si256(_mm256_sll_epi32(_mm256_cvtepu16_epi32(r), rShift), _mm256_sll_epi32(_mm256_cvtepu16_epi32(g), gShift)),
+	                       _mm256_or_si256(_mm256_sll_epi32(_mm256_cvtepu16_epi32(b), bShift), aMask));
+}
+
+template<typename PixelInt, bool subsampled, bool itu>
+static int convertRowAVX2(byte *dst, const byte *ySrc, const byte *uSrc, const byte *vSrc, int width, const YUVToRGBSIMD::Params &params) {
+	const __m256i bias = _mm256_set1_epi16(128);
+	const __m128i rLoss = _mm_cvtsi32_si128(params.rLoss);
+	const __m128i gLoss = _mm_cvtsi32_si128(params.gLoss);
+	const __m128i bLoss = _mm_cvtsi32_si128(params.bLoss);
+	const __m128i rShift = _mm_cvtsi32_si128(params.rShift);
+	const __m128i gShift = _mm_cvtsi32_si128(params.gShift);
+	const __m128i bShift = _mm_cvtsi32_si128(params.bShift);
+
+	int x = 0;
+
+	for (; x + 16 <= width; x += 16) {
+		const int uvX = subsampled ? (x >> 1) : x;
+
+		__m256i y = _mm256_cvtepu8_epi16(_mm_loadu_si128((const __m128i *)(ySrc + x)));
+		__m256i u = _mm256_sub_epi16(avx2_loadChroma(uSrc + uvX, subsampled), bias);
+		__m256i v = _mm256_sub_epi16(avx2_loadChroma(vSrc + uvX, subsampled), bias);
+
+		__m256i uSign = _mm256_srai_epi16(u, 15);
+		__m256i vSign = _mm256_srai_epi16(v, 15);
+		__m256i uMag2 = _mm256_slli_epi16(_mm256_abs_epi16(u), 1);
+		__m256i vMag2 = _mm256_slli_epi16(_mm256_abs_epi16(v), 1);
+
+		__m256i r = _mm256_add_epi16(y, avx2_chroma(vMag2, vSign, YUVToRGBSIMD::kCrR));
+		__m256i g = _mm256_sub_epi16(_mm256_sub_epi16(y, avx2_chroma(vMag2, vSign, YUVToRGBSIMD::kCrG)), avx2_chroma(uMag2, uSign, YUVToRGBSIMD::kCbG));
+		__m256i b = _mm256_add_epi16(y, avx2_chroma(uMag2, uSign, YUVToRGBSIMD::kCbB));
+
+		r = _mm256_srl_epi16(avx2_clip<itu>(r), rLoss);
+		g = _mm256_srl_epi16(avx2_clip<itu>(g), gLoss);
+		b = _mm256_srl_epi16(avx2_clip<itu>(b), bLoss);
+
+		if (sizeof(PixelInt) == 2) {
+			__m256i pixels = _mm256_or_si256(_mm256_or_si256(_mm256_sll_epi16(r, rShift), _mm256_sll_epi16(g, gShift)),
+			                                 _mm256_or_si256(_mm256_sll_epi16(b, bShift), _mm256_set1_epi16((int16)params.aMask)));
+			_mm256_storeu_si256((__m256i *)(dst + x * 2), pixels);
+		} else {
+			// Widen each 128-bit half on its own, since unpacking would
+			// interleave the two lanes
+			const __m256i aMask = _mm256_set1_epi32(params.aMask);
+			__m256i lo = avx2_pack32(_mm256_castsi256_si128(r), _mm256_castsi256_si128(g), _mm256_castsi256_si128(b), rShift, gShift, bShift, aMask);
+			__m256i hi = avx2_pack32(_mm256_extracti128_si256(r, 1), _mm256_extracti128_si256(g, 1), _mm256_extracti128_si256(b, 1), rShift, gShift, bShift, aMask);
+			_mm256_storeu_si256((__m256i *)(dst + x * 4), lo);
+			_mm256_storeu_si256((__m256i *)(dst + x * 4 + 32), hi);
+		}
+	}
+
+	return x;
+}
+
+template<typename PixelInt>
+static YUVToRGBSIMD::RowFunc getRowFuncForScale(YUVToRGBManager::LuminanceScale scale, bool subsampled) {
+	if (scale == YUVToRGBManager::kScaleITU)
+		return subsampled ? convertRowAVX2<PixelInt, true, true> : convertRowAVX2<PixelInt, false, true>;
+	else
+		return subsampled ? convertRowAVX2<PixelInt, true, false> : convertRowAVX2<PixelInt, false, false>;
+}
+
+YUVToRGBSIMD::RowFunc YUVToRGBSIMD::getRowFuncAVX2(uint bytesPerPixel, YUVToRGBManager::LuminanceScale scale, bool subsampled) {
+	if (bytesPerPixel == 2)
+		return getRowFuncForScale<uint16>(scale, subsampled);
+	else
+		return getRowFuncForScale<uint32>(scale, subsampled);
+}
+
+} // End of namespace Graphics
+
+#ifdef __GNUC__
+#pragma GCC pop_options
+#endif
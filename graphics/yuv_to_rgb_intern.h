@@ -0,0 +1,98 @@
+/* ScummVM - Graphic Adventure Engine
+ *
+ * ScummVM is the legal property of its developers, whose names
+ * are too numerous to list here. Please refer to the COPYRIGHT
+ * file distributed with this source distribution.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#ifndef GRAPHICS_YUV_TO_RGB_INTERN_H
+#define GRAPHICS_YUV_TO_RGB_INTERN_H
+
+#include "graphics/pixelformat.h"
+#include "graphics/yuv_to_rgb.h"
+
+namespace Graphics {
+
+/**
+ * SIMD row kernels of the YUV to RGB conversion.
+ *
+ * The kernels compute the color components in fixed point, with the same
+ * truncation as the lookup tables of YUVToRGBManager, and convert as many
+ * pixels of a row as fit into their vectors. The remaining pixels are left
+ * to the lookup tables. The kernel is picked at runtime, depending on the
+ * SIMD extensions supported by the CPU.
+ */
+class YUVToRGBSIMD {
+public:
+	/** The output layout of a row kernel */
+	struct Params {
+		Params(const Graphics::PixelFormat &format);
+
+		byte rLoss, gLoss, bLoss;
+		byte rShift, gShift, bShift;
+		uint32 aMask;
+	};
+
+	/**
+	 * Convert the first pixels of a row.
+	 *
+	 * For subsampled chroma, each u and v value covers two pixels of the row.
+	 *
+	 * @return the number of pixels converted
+	 */
+	typedef int (*RowFunc)(byte *dst, const byte *ySrc, const byte *uSrc, const byte *vSrc, int width, const Params &params);
+
+	/**
+	 * Return the fastest row kernel for the given output, or nullptr if
+	 * only the lookup tables can convert to it.
+	 */
+	static RowFunc getRowFunc(const Graphics::PixelFormat &format, YUVToRGBManager::LuminanceScale scale, bool subsampled);
+
+#ifdef SCUMMVM_NEON
+	static RowFunc getRowFuncNEON(uint bytesPerPixel, YUVToRGBManager::LuminanceScale scale, bool subsampled);
+#endif
+#ifdef SCUMMVM_SSE2
+	static RowFunc getRowFuncSSE2(uint bytesPerPixel, YUVToRGBManager::LuminanceScale scale, bool subsampled);
+#endif
+#ifdef SCUMMVM_AVX2
+	static RowFunc getRowFuncAVX2(uint bytesPerPixel, YUVToRGBManager::LuminanceScale scale, bool subsampled);
+#endif
+
+	/**
+	 * The chroma factors in 0.16 fixed point, applied to twice the
+	 * magnitude of the chroma value. Rounding down the product gives the
+	 * same values as the lookup tables for every chroma value.
+	 */
+	enum {
+		kCrR = 45900, ///< 0.419 / 0.299, added to red
+		kCrG = 23386, ///< 0.299 / 0.419, subtracted from green
+		kCbG = 11284, ///< 0.114 / 0.331, subtracted from green
+		kCbB = 58110  ///< 0.587 / 0.331, added to blue
+	};
+
+	/**
+	 * Stretching [0, 219] to [0, 255] adds the value times this factor in
+	 * 0.16 fixed point, rounded down like (x - 16) * 255 / 219.
+	 */
+	enum {
+		kITUStretch = 10776
+	};
+};
+
+} // End of namespace Graphics
+
+#endif
@@ -0,0 +1,146 @@
+/* ScummVM - Graphic Adventure Engine
+ *
+ * ScummVM is the legal property of its developers, whose names
+ * are too numerous to list here. Please refer to the COPYRIGHT
+ * file distributed with this source distribution.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include "common/scummsys.h"
+
+#ifdef SCUMMVM_NEON
+
+#include "graphics/yuv_to_rgb_intern.h"
+
+#include <arm_neon.h>
+
+#ifdef __GNUC__
+#pragma GCC push_options
+
+#if !defined(__aarch64__)
+#pragma GCC target("fpu=neon")
+#endif // !defined(__aarch64__)
+
+#endif // __GNUC__
+
+namespace Graphics {
+
+// Multiply the doubled chroma magnitudes by a factor, and restore the sign
+// of the chroma values. This truncates towards zero like the lookup tables.
+static FORCEINLINE int16x8_t neon_chroma(uint16x8_t mag2, int16x8_t sign, uint16 factor) {
+	uint16x8_t product = vcombine_u16(vshrn_n_u32(vmull_n_u16(vget_low_u16(mag2), factor), 16),
+	                                  vshrn_n_u32(vmull_n_u16(vget_high_u16(mag2), factor), 16));
+	return vsubq_s16(veorq_s16(vreinterpretq_s16_u16(product), sign), sign);
+}
+
+template<bool itu>
+static FORCEINLINE uint16x8_t neon_clip(int16x8_t x) {
+	if (itu) {
+		uint16x8_t c = vreinterpretq_u16_s16(vsubq_s16(vminq_s16(vmaxq_s16(x, vdupq_n_s16(16)), vdupq_n_s16(235)), vdupq_n_s16(16)));
+		uint16x8_t stretch = vcombine_u16(vshrn_n_u32(vmull_n_u16(vget_low_u16(c), YUVToRGBSIMD::kITUStretch), 16),
+		                                  vshrn_n_u32(vmull_n_u16(vget_high_u16(c), YUVToRGBSIMD::kITUStretch), 16));
+		return vaddq_u16(c, stretch);
+	}
+
+	return vreinterpretq_u16_s16(vminq_s16(vmaxq_s16(x, vdupq_n_s16(0)), vdupq_n_s16(255)));
+}
+
+static FORCEINLINE int16x8_t neon_loadChroma(const byte *src, bool subsampled) {
+	uint8x8_t c;
+
+	if (subsampled) {
+		// Use each value for two pixels
+		c = vreinterpret_u8_u32(vdup_n_u32(READ_UINT32(src)));
+		c = vzip_u8(c, c).val[0];
+	} else {
+		c = vld1_u8(src);
+	}
+
+	return vsubq_s16(vreinterpretq_s16_u16(vmovl_u8(c)), vdupq_n_s16(128));
+}
+
+template<typename PixelInt, bool subsampled, bool itu>
+static int convertRowNEON(byte *dst, const byte *ySrc, const byte *uSrc, const byte *vSrc, int width, const YUVToRGBSIMD::Params &params) {
+	// Shifting by a negative amount shifts right
+	const int16x8_t rLoss = vdupq_n_s16(-params.rLoss);
+	const int16x8_t gLoss = vdupq_n_s16(-params.gLoss);
+	const int16x8_t bLoss = vdupq_n_s16(-params.bLoss);
+
+	int x = 0;
+
+	for (; x + 8 <= width; x += 8) {
+		const int uvX = subsampled ? (x >> 1) : x;
+
+		int16x8_t y = vreinterpretq_s16_u16(vmovl_u8(vld1_u8(ySrc + x)));
+		int16x8_t u = neon_loadChroma(uSrc + uvX, subsampled);
+		int16x8_t v = neon_loadChroma(vSrc + uvX, subsampled);
+
+		int16x8_t uSign = vshrq_n_s16(u, 15);
+		int16x8_t vSign = vshrq_n_s16(v, 15);
+		uint16x8_t uMag2 = vshlq_n_u16(vreinterpretq_u16_s16(vabsq_s16(u)), 1);
+		uint16x8_t vMag2 = vshlq_n_u16(vreinterpretq_u16_s16(vabsq_s16(v)), 1);
+
+		int16x8_t r = vaddq_s16(y, neon_chroma(vMag2, vSign, YUVToRGBSIMD::kCrR));
+		int16x8_t g = vsubq_s16(vsubq_s16(y, neon_chroma(vMag2, vSign, YUVToRGBSIMD::kCrG)), neon_chroma(uMag2, uSign, YUVToRGBSIMD::kCbG));
+		int16x8_t b = vaddq_s16(y, neon_chroma(uMag2, uSign, YUVToRGBSIMD::kCbB));
+
+		uint16x8_t rc = vshlq_u16(neon_clip<itu>(r), rLoss);
+		uint16x8_t gc = vshlq_u16(neon_clip<itu>(g), gLoss);
+		uint16x8_t bc = vshlq_u16(neon_clip<itu>(b), bLoss);
+
+		if (sizeof(PixelInt) == 2) {
+			uint16x8_t pixels = vorrq_u16(vorrq_u16(vshlq_u16(rc, vdupq_n_s16(params.rShift)), vshlq_u16(gc, vdupq_n_s16(params.gShift))),
+			                              vorrq_u16(vshlq_u16(bc, vdupq_n_s16(params.bShift)), vdupq_n_u16((uint16)params.aMask)));
+			vst1q_u16((uint16 *)(dst + x * 2), pixels);
+		} else {
+			const int32x4_t rShift = vdupq_n_s32(params.rShift);
+			const int32x4_t gShift = vdupq_n_s32(params.gShift);
+			const int32x4_t bShift = vdupq_n_s32(params.bShift);
+			const uint32x4_t aMask = vdupq_n_u32(params.aMask);
+			uint32x4_t lo = vorrq_u32(vorrq_u32(vshlq_u32(vmovl_u16(vget_low_u16(rc)), rShift), vshlq_u32(vmovl_u16(vget_low_u16(gc)), gShift)),
+			                          vorrq_u32(vshlq_u32(vmovl_u16(vget_low_u16(bc)), bShift), aMask));
+			uint32x4_t hi = vorrq_u32(vorrq_u32(vshlq_u32(vmovl_u16(vget_high_u16(rc)), rShift), vshlq_u32(vmovl_u16(vget_high_u16(gc)), gShift)),
+			                          vorrq_u32(vshlq_u32(vmovl_u16(vget_high_u16(bc)), bShift), aMask));
+			vst1q_u32((uint32 *)(dst + x * 4), lo);
+			vst1q_u32((uint32 *)(dst + x * 4 + 16), hi);
+		}
+	}
+
+	return x;
+}
+
+template<typename PixelInt>
+static YUVToRGBSIMD::RowFunc getRowFuncForScale(YUVToRGBManager::LuminanceScale scale, bool subsampled) {
+	if (scale == YUVToRGBManager::kScaleITU)
+		return subsampled ? convertRowNEON<PixelInt, true, true> : convertRowNEON<PixelInt, false, true>;
+	else
+		return subsampled ? convertRowNEON<PixelInt, true, false> : convertRowNEON<PixelInt, false, false>;
+}
+
+YUVToRGBSIMD::RowFunc YUVToRGBSIMD::getRowFuncNEON(uint bytesPerPixel, YUVToRGBManager::LuminanceScale scale, bool subsampled) {
+	if (bytesPerPixel == 2)
+		return getRowFuncForScale<uint16>(scale, subsampled);
+	else
+		return getRowFuncForScale<uint32>(scale, subsampled);
+}
+
+} // End of namespace Graphics
+
+#ifdef __GNUC__
+#pragma GCC pop_options
+#endif
+
+#endif // SCUMMVM_NEON
@@ -0,0 +1,137 @@
+/* ScummVM - Graphic Adventure Engine
+ *
+ * ScummVM is the legal property of its developers, whose names
+ * are too numerous to list here. Please refer to the COPYRIGHT
+ * file distributed with this source distribution.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include "common/scummsys.h"
+
+#include "graphics/yuv_to_rgb_intern.h"
+
+#include <emmintrin.h>
+
+#ifdef __GNUC__
+#pragma GCC push_options
+
+#ifndef __x86_64__
+#pragma GCC target("sse2")
+#endif
+
+#endif
+
+namespace Graphics {
+
+// Multiply the doubled chroma magnitudes by a factor, and restore the sign
+// of the chroma values. This truncates towards zero like the lookup tables.
+static FORCEINLINE __m128i sse2_chroma(__m128i mag2, __m128i sign, int factor) {
+	__m128i product = _mm_mulhi_epu16(mag2, _mm_set1_epi16((int16)factor));
+	return _mm_sub_epi16(_mm_xor_si128(product, sign), sign);
+}
+
+template<bool itu>
+static FORCEINLINE __m128i sse2_clip(__m128i x) {
+	if (itu) {
+		x = _mm_sub_epi16(_mm_min_epi16(_mm_max_epi16(x, _mm_set1_epi16(16)), _mm_set1_epi16(235)), _mm_set1_epi16(16));
+		return _mm_add_epi16(x, _mm_mulhi_epu16(x, _mm_set1_epi16((int16)YUVToRGBSIMD::kITUStretch)));
+	}
+
+	return _mm_min_epi16(_mm_max_epi16(x, _mm_setzero_si128()), _mm_set1_epi16(255));
+}
+
+static FORCEINLINE __m128i sse2_loadChroma(const byte *src, bool subsampled) {
+	if (subsampled) {
+		// Use each value for two pixels
+		__m128i c = _mm_cvtsi32_si128(READ_UINT32(src));
+		c = _mm_unpacklo_epi8(c, c);
+		return _mm_unpacklo_epi8(c, _mm_setzero_si128());
+	}
+
+	return _mm_unpacklo_epi8(_mm_loadl_epi64((const __m128i *)src), _mm_setzero_si128());
+}
+
+template<typename PixelInt, bool subsampled, bool itu>
+static int convertRowSSE2(byte *dst, const byte *ySrc, const byte *uSrc, const byte *vSrc, int width, const YUVToRGBSIMD::Params &params) {
+	const __m128i zero = _mm_setzero_si128();
+	const __m128i bias = _mm_set1_epi16(128);
+	const __m128i rLoss = _mm_cvtsi32_si128(params.rLoss);
+	const __m128i gLoss = _mm_cvtsi32_si128(params.gLoss);
+	const __m128i bLoss = _mm_cvtsi32_si128(params.bLoss);
+	const __m128i rShift = _mm_cvtsi32_si128(params.rShift);
+	const __m128i gShift = _mm_cvtsi32_si128(params.gShift);
+	const __m128i bShift = _mm_cvtsi32_si128(params.bShift);
+
+	int x = 0;
+
+	for (; x + 8 <= width; x += 8) {
+		const int uvX = subsampled ? (x >> 1) : x;
+
+		__m128i y = _mm_unpacklo_epi8(_mm_loadl_epi64((const __m128i *)(ySrc + x)), zero);
+		__m128i u = _mm_sub_epi16(sse2_loadChroma(uSrc + uvX, subsampled), bias);
+		__m128i v = _mm_sub_epi16(sse2_loadChroma(vSrc + uvX, subsampled), bias);
+
+		__m128i uSign = _mm_srai_epi16(u, 15);
+		__m128i vSign = _mm_srai_epi16(v, 15);
+		__m128i uMag2 = _mm_slli_epi16(_mm_sub_epi16(_mm_xor_si128(u, uSign), uSign), 1);
+		__m128i vMag2 = _mm_slli_epi16(_mm_sub_epi16(_mm_xor_si128(v, vSign), vSign), 1);
+
+		__m128i r = _mm_add_epi16(y, sse2_chroma(vMag2, vSign, YUVToRGBSIMD::kCrR));
+		__m128i g = _mm_sub_epi16(_mm_sub_epi16(y, sse2_chroma(vMag2, vSign, YUVToRGBSIMD::kCrG)), sse2_chroma(uMag2, uSign, YUVToRGBSIMD::kCbG));
+		__m128i b = _mm_add_epi16(y, sse2_chroma(uMag2, uSign, YUVToRGBSIMD::kCbB));
+
+		r = _mm_srl_epi16(sse2_clip<itu>(r), rLoss);
+		g = _mm_srl_epi16(sse2_clip<itu>(g), gLoss);
+		b = _mm_srl_epi16(sse2_clip<itu>(b), bLoss);
+
+		if (sizeof(PixelInt) == 2) {
+			__m128i pixels = _mm_or_si128(_mm_or_si128(_mm_sll_epi16(r, rShift), _mm_sll_epi16(g, gShift)),
+			                              _mm_or_si128(_mm_sll_epi16(b, bShift), _mm_set1_epi16((int16)params.aMask)));
+			_mm_storeu_si128((__m128i *)(dst + x * 2), pixels);
+		} else {
+			const __m128i aMask = _mm_set1_epi32(params.aMask);
+			__m128i lo = _mm_or_si128(_mm_or_si128(_mm_sll_epi32(_mm_unpacklo_epi16(r, zero), rShift), _mm_sll_epi32(_mm_unpacklo_epi16(g, zero), gShift)),
+			                          _mm_or_si128(_mm_sll_epi32(_mm_unpacklo_epi16(b, zero), bShift), aMask));
+			__m128i hi = _mm_or_si128(_mm_or_si128(_mm_sll_epi32(_mm_unpackhi_epi16(r, zero), rShift), _mm_sll_epi32(_mm_unpackhi_epi16(g, zero), gShift)),
+			                          _mm_or_si128(_mm_sll_epi32(_mm_unpackhi_epi16(b, zero), bShift), aMask));
+			_mm_storeu_si128((__m128i *)(dst + x * 4), lo);
+			_mm_storeu_si128((__m128i *)(dst + x * 4 + 16), hi);
+		}
+	}
+
+	return x;
+}
+
+template<typename PixelInt>
+static YUVToRGBSIMD::RowFunc getRowFuncForScale(YUVToRGBManager::LuminanceScale scale, bool subsampled) {
+	if (scale == YUVToRGBManager::kScaleITU)
+		return subsampled ? convertRowSSE2<PixelInt, true, true> : convertRowSSE2<PixelInt, false, true>;
+	else
+		return subsampled ? convertRowSSE2<PixelInt, true, false> : convertRowSSE2<PixelInt, false, false>;
+}
+
+YUVToRGBSIMD::RowFunc YUVToRGBSIMD::getRowFuncSSE2(uint bytesPerPixel, YUVToRGBManager::LuminanceScale scale, bool subsampled) {
+	if (bytesPerPixel == 2)
+		return getRowFuncForScale<uint16>(scale, subsampled);
+	else
+		return getRowFuncForScale<uint32>(scale, subsampled);
+}
+
+} // End of namespace Graphics
+
+#ifdef __GNUC__
+#pragma GCC pop_options
+#endif
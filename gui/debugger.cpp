@@ -76,6 +76,7 @@ Debugger::Debugger() {
 	registerCmd("clear",			WRAP_METHOD(Debugger, cmdClearLog));
 	registerCmd("cls",			WRAP_METHOD(Debugger, cmdClearLog)); // alias
 	registerCmd("exec",				WRAP_METHOD(Debugger, cmdExecFile));
+	registerCmd("searchman",		WRAP_METHOD(Debugger, cmdSearchMan));
 
 	registerCmd("debuglevel",		WRAP_METHOD(Debugger, cmdDebugLevel));
 	registerCmd("debugflag_list",		WRAP_METHOD(Debugger, cmdDebugFlagsList));
@@ -841,6 +842,32 @@ bool Debugger::cmdExecFile(int argc, const char **argv) {
 	return true;
 }
 
+bool Debugger::cmdSearchMan(int argc, const char **argv) {
+	if (argc > 1) {
+		if (!scumm_stricmp(argv[1], "reset")) {
+			SearchMan.resetArchiveStats();
+			debugPrintf("Reset the lookup counters\n");
+		} else if (!scumm_stricmp(argv[1], "index") && argc > 2) {
+			const bool useIndex = !scumm_stricmp(argv[2], "on");
+			SearchMan.setUseIndex(useIndex);
+			debugPrintf("Member index %s\n", useIndex ? "enabled" : "disabled");
+		} else {
+			debugPrintf("Usage: %s [reset | index <on | off>]\n", argv[0]);
+		}
+		return true;
+	}
+
+	Common::Array<Common::SearchSet::ArchiveStats> stats;
+	SearchMan.getArchiveStats(stats);
+
+	debugPrintf("Priority   Lookups      Hits  Archive\n");
+	debugPrintf("--------------------------------------\n");
+	for (uint i = 0; i < stats.size(); i++) {
+		debugPrintf("%8d %9u %9u  %s\n", stats[i].priority, stats[i].lookups, stats[i].hits, stats[i].name.c_str());
+	}
+	return true;
+}
+
 bool Debugger::cmdDebugFlagDisable(int argc, const char **argv) {
 	if (argc < 2) {
 		debugPrintf("debugflag_disable [<flag> | all]\n");
@@ -277,6 +277,7 @@ protected:
 	bool cmdDebugFlagDisable(int argc, const char **argv);
 	bool cmdClearLog(int argc, const char **argv);
 	bool cmdExecFile(int argc, const char **argv);
+	bool cmdSearchMan(int argc, const char **argv);
 
 #ifndef USE_TEXT_CONSOLE_FOR_DEBUGGER
 private:
@@ -1653,6 +1653,8 @@ void LauncherGrid::build() {
 
 	// Add list with game titles
 	_grid = new GridWidget(this, "LauncherGrid.IconArea");
+	// Thumbnails arrive from worker threads, the grid picks them up on tickles
+	setTickleWidget(_grid);
 	// Populate the list
 	updateListing();
 
@@ -280,6 +280,9 @@ void MassAddDialog::handleTickle() {
 		// Enable the OK button
 		_okButton->setEnabled(true);
 
+		// Make sure all newly computed MD5s are on disk
+		ADCacheMan.flushPersistentMD5Cache(true);
+
 		buf = _("Scan complete!");
 		_dirProgressText->setLabel(buf);
 
@@ -20,7 +20,12 @@
  */
 
 #include "common/system.h"
+#include "common/config-manager.h"
 #include "common/file.h"
+#include "common/fs.h"
+#include "common/memstream.h"
+#include "common/savefile.h"
+#include "common/compression/deflate.h"
 #include "common/language.h"
 #include "common/platform.h"
 #include "common/tokenizer.h"
@@ -394,6 +399,332 @@ Graphics::ManagedSurface *loadSurfaceFromFile(const Common::String &name, int re
 
 #pragma mark -
 
+#define GRID_THUMBNAIL_CACHE_FILENAME "scummvm-gridthumbs.dat"
+#define GRID_THUMBNAIL_CACHE_VERSION 1
+
+enum {
+	kThumbnailThreads = 2
+};
+
+// Scaled thumbnails survive across launcher sessions in a file in the save
+// directory. The cache is dropped as a whole when any icons pack changes.
+class GridThumbnailCache {
+public:
+	GridThumbnailCache();
+	~GridThumbnailCache();
+
+	bool read(const Common::String &key, Common::Array<byte> &data);
+	void add(const Common::String &key, const Common::Array<byte> &data);
+	// Rewrites the file if anything was added, keeping only keys with the given suffix
+	void save(const Common::String &keySuffix);
+
+private:
+	struct Entry {
+		uint32 offset;
+		uint32 size;
+	};
+
+	Common::InSaveFile *_file;
+	Common::String _signature;
+	Common::HashMap<Common::String, Entry> _entries;
+	Common::HashMap<Common::String, Common::Array<byte> > _added;
+};
+
+// Mirrors the pack files Common::generateZipSet() loads the icons set from
+static Common::String getIconsSetSignature() {
+	Common::FSList packs;
+
+	if (!ConfMan.getPath("iconspath").empty()) {
+		Common::FSNode iconDir(ConfMan.getPath("iconspath"));
+		Common::FSList files;
+		if (iconDir.getChildren(files, Common::FSNode::kListFilesOnly)) {
+			for (Common::FSList::const_iterator i = files.begin(); i != files.end(); ++i) {
+				if (i->getName().matchString("gui-icons*.dat", true))
+					packs.push_back(*i);
+			}
+		}
+		Common::sort(packs.begin(), packs.end());
+	}
+
+	if (ConfMan.hasKey("themepath"))
+		packs.push_back(Common::FSNode(ConfMan.getPath("themepath").join("gui-icons.dat").normalize()));
+
+	Common::String signature;
+	for (Common::FSList::const_iterator i = packs.begin(); i != packs.end(); ++i) {
+		int64 size = -1, modificationTime = -1;
+		if (!i->getFileStats(size, modificationTime))
+			continue;
+		signature += Common::String::format("%s:%lld:%lld;", i->getName().c_str(), (long long)size, (long long)modificationTime);
+	}
+	return signature;
+}
+
+static Common::String readCacheString(Common::SeekableReadStream *stream) {
+	uint32 len = stream->readUint32BE();
+	if (len > (uint32)(stream->size() - stream->pos()))
+		return Common::String();
+	Common::String str;
+	for (uint32 i = 0; i < len; i++)
+		str += (char)stream->readByte();
+	return str;
+}
+
+static void writeCacheString(Common::WriteStream *stream, const Common::String &str) {
+	stream->writeUint32BE(str.size());
+	stream->writeString(str);
+}
+
+GridThumbnailCache::GridThumbnailCache() : _file(nullptr) {
+	_signature = getIconsSetSignature();
+
+	Common::SaveFileManager *saveFileMan = g_system->getSavefileManager();
+	if (!saveFileMan)
+		return;
+
+	_file = saveFileMan->openRawFile(GRID_THUMBNAIL_CACHE_FILENAME);
+	if (!_file)
+		return;
+
+	if (_file->readUint32BE() != MKTAG('G', 'T', 'H', 'C') ||
+		_file->readUint32BE() != GRID_THUMBNAIL_CACHE_VERSION ||
+		readCacheString(_file) != _signature) {
+		debug(2, "GridThumbnailCache: Discarding outdated thumbnail cache");
+		delete _file;
+		_file = nullptr;
+		return;
+	}
+
+	// Only the index is read here, thumbnails are read as they are needed
+	uint32 count = _file->readUint32BE();
+	for (uint32 i = 0; i < count && !_file->eos() && !_file->err(); i++) {
+		Common::String key = readCacheString(_file);
+		Entry entry;
+		entry.size = _file->readUint32BE();
+		entry.offset = _file->pos();
+		if (key.empty() || entry.offset + entry.size > _file->size())
+			break;
+		_entries[key] = entry;
+		_file->skip(entry.size);
+	}
+
+	debug(2, "GridThumbnailCache: Loaded %u entries", _entries.size());
+}
+
+GridThumbnailCache::~GridThumbnailCache() {
+	delete _file;
+}
+
+bool GridThumbnailCache::read(const Common::String &key, Common::Array<byte> &data) {
+	Common::HashMap<Common::String, Common::Array<byte> >::const_iterator added = _added.find(key);
+	if (added != _added.end()) {
+		data = added->_value;
+		return true;
+	}
+
+	Common::HashMap<Common::String, Entry>::const_iterator entry = _entries.find(key);
+	if (!_file || entry == _entries.end())
+		return false;
+
+	data.resize(entry->_value.size);
+	return _file->seek(entry->_value.offset) && _file->read(data.begin(), data.size()) == data.size();
+}
+
+void GridThumbnailCache::add(const Common::String &key, const Common::Array<byte> &data) {
+	_added[key] = data;
+}
+
+void GridThumbnailCache::save(const Common::String &keySuffix) {
+	Common::SaveFileManager *saveFileMan = g_system->getSavefileManager();
+	if (_added.empty() || !saveFileMan)
+		return;
+
+	// The new file replaces the one still open for reading, so keep what
+	// is left of it in memory first
+	for (Common::HashMap<Common::String, Entry>::const_iterator i = _entries.begin(); i != _entries.end(); ++i) {
+		if (_added.contains(i->_key) || !i->_key.hasSuffix(keySuffix))
+			continue;
+		Common::Array<byte> data;
+		if (read(i->_key, data))
+			_added[i->_key] = data;
+	}
+	_entries.clear();
+	delete _file;
+	_file = nullptr;
+
+	Common::OutSaveFile *saveFile = saveFileMan->openForSaving(GRID_THUMBNAIL_CACHE_FILENAME, false);
+	if (!saveFile)
+		return;
+
+	saveFile->writeUint32BE(MKTAG('G', 'T', 'H', 'C'));
+	saveFile->writeUint32BE(GRID_THUMBNAIL_CACHE_VERSION);
+	writeCacheString(saveFile, _signature);
+
+	uint32 count = 0;
+	for (Common::HashMap<Common::String, Common::Array<byte> >::const_iterator i = _added.begin(); i != _added.end(); ++i) {
+		if (i->_key.hasSuffix(keySuffix))
+			count++;
+	}
+	saveFile->writeUint32BE(count);
+
+	for (Common::HashMap<Common::String, Common::Array<byte> >::const_iterator i = _added.begin(); i != _added.end(); ++i) {
+		if (!i->_key.hasSuffix(keySuffix))
+			continue;
+		writeCacheString(saveFile, i->_key);
+		saveFile->writeUint32BE(i->_value.size());
+		saveFile->write(i->_value.begin(), i->_value.size());
+	}
+
+	saveFile->finalize();
+	if (saveFile->err())
+		warning("GridThumbnailCache: Failed to write '%s'", GRID_THUMBNAIL_CACHE_FILENAME);
+	delete saveFile;
+	_added.clear();
+}
+
+static Common::String getThumbnailCacheKey(const Common::String &thumbPath, int width, int height) {
+	return Common::String::format("%s@%dx%d", thumbPath.c_str(), width, height);
+}
+
+static Graphics::ManagedSurface *decodeCachedThumbnail(const Common::Array<byte> &data) {
+	Common::SeekableReadStream *stream = Common::wrapCompressedReadStream(new Common::MemoryReadStream(data.begin(), data.size()));
+	if (!stream)
+		return nullptr;
+
+	int width = stream->readUint16BE();
+	int height = stream->readUint16BE();
+	byte format[9];
+	stream->read(format, sizeof(format));
+	Graphics::PixelFormat pixelFormat(format[0], format[1], format[2], format[3], format[4], format[5], format[6], format[7], format[8]);
+	if (stream->err() || stream->eos() || !width || !height || pixelFormat.bytesPerPixel < 2 || pixelFormat.bytesPerPixel > 4) {
+		delete stream;
+		return nullptr;
+	}
+
+	Graphics::ManagedSurface *surf = new Graphics::ManagedSurface(width, height, pixelFormat);
+	for (int y = 0; y < height; y++)
+		stream->read(surf->getBasePtr(0, y), width * pixelFormat.bytesPerPixel);
+
+	if (stream->err() || stream->eos()) {
+		delete surf;
+		surf = nullptr;
+	}
+	delete stream;
+	return surf;
+}
+
+static void encodeCachedThumbnail(const Graphics::ManagedSurface &surf, Common::Array<byte> &data) {
+	Common::MemoryWriteStreamDynamic *buffer = new Common::MemoryWriteStreamDynamic(DisposeAfterUse::NO);
+	Common::WriteStream *stream = Common::wrapCompressedWriteStream(buffer);
+
+	const Graphics::PixelFormat &format = surf.format;
+	stream->writeUint16BE(surf.w);
+	stream->writeUint16BE(surf.h);
+	stream->writeByte(format.bytesPerPixel);
+	stream->writeByte(format.rBits());
+	stream->writeByte(format.gBits());
+	stream->writeByte(format.bBits());
+	stream->writeByte(format.aBits());
+	stream->writeByte(format.rShift);
+	stream->writeByte(format.gShift);
+	stream->writeByte(format.bShift);
+	stream->writeByte(format.aShift);
+	for (int y = 0; y < surf.h; y++)
+		stream->write(surf.getBasePtr(0, y), surf.w * format.bytesPerPixel);
+	stream->finalize();
+
+	byte *compressed = buffer->getData();
+	if (!stream->err()) {
+		data.resize(buffer->size());
+		memcpy(data.begin(), compressed, data.size());
+	}
+	delete stream;
+	free(compressed);
+}
+
+// Thumbnail to load on a worker thread. It is only used by the job, so
+// its strings never share storage with the ones of the GUI thread.
+struct GridThumbnailRequest {
+	Common::String engineId, gameId;
+	Common::Array<byte> cacheData;
+	int width, height;
+
+	GridThumbnailRequest(const char *engine, const char *game, int w, int h) :
+		engineId(engine), gameId(game), width(w), height(h) {}
+};
+
+// Runs on a worker thread. Only the reads from the icons set are done
+// while holding its lock, PNG decoding happens outside of it. Messages are
+// logged later by the GUI thread, as the worker must not use OSystem.
+static Graphics::ManagedSurface *loadThumbnailSource(const Common::String &name, GridThumbnailResult &result) {
+#ifdef USE_PNG
+	Common::Path path(name);
+	Common::SeekableReadStream *stream = nullptr;
+	g_gui.lockIconsSet();
+	if (g_gui.getIconsSet().hasFile(path)) {
+		Common::SeekableReadStream *member = g_gui.getIconsSet().createReadStreamForMember(path);
+		if (member) {
+			stream = member->readStream(member->size());
+			delete member;
+		}
+	}
+	g_gui.unlockIconsSet();
+
+	if (!stream) {
+		result.debugMessages.push_back(Common::String::format("GridWidget: Cannot read file '%s'", name.c_str()));
+		return nullptr;
+	}
+
+	Graphics::ManagedSurface *surf = nullptr;
+	Image::PNGDecoder decoder;
+	if (!decoder.loadStream(*stream)) {
+		result.warnings.push_back("Error decoding PNG");
+	} else if (!decoder.getSurface()) {
+		result.warnings.push_back(Common::String::format("Failed to load surface : %s", name.c_str()));
+	} else if (decoder.getSurface()->format.bytesPerPixel != 1) {
+		surf = new Graphics::ManagedSurface(decoder.getSurface());
+	}
+	delete stream;
+	return surf;
+#else
+	return nullptr;
+#endif
+}
+
+// Runs on a worker thread, and takes ownership of the request
+static GridThumbnailResult loadThumbnail(GridThumbnailRequest *request) {
+	GridThumbnailResult result;
+	result.width = request->width;
+	result.height = request->height;
+
+	if (!request->cacheData.empty())
+		result.surface = decodeCachedThumbnail(request->cacheData);
+
+	if (!result.surface) {
+		const Common::String gamePath = Common::String::format("icons/%s-%s.png", request->engineId.c_str(), request->gameId.c_str());
+		const Common::String enginePath = Common::String::format("icons/%s.png", request->engineId.c_str());
+
+		Graphics::ManagedSurface *surf = loadThumbnailSource(gamePath, result);
+		if (!surf)
+			surf = loadThumbnailSource(enginePath, result);
+
+		if (surf) {
+			const Graphics::ManagedSurface *scSurf = scaleGfx(surf, request->width, request->height, true);
+			if (surf != scSurf) {
+				surf->free();
+				delete surf;
+			}
+
+			result.surface = const_cast<Graphics::ManagedSurface *>(scSurf);
+			encodeCachedThumbnail(*result.surface, result.cacheData);
+		}
+	}
+
+	delete request;
+	return result;
+}
+
+#pragma mark -
+
 GridWidget::GridWidget(GuiObject *boss, const Common::String &name)
 	: ContainerWidget(boss, name), CommandSender(boss) {
 
@@ -439,9 +770,26 @@ GridWidget::GridWidget(GuiObject *boss, const Common::String &name)
 
 	_selectedEntry = nullptr;
 	_isGridInvalid = true;
+
+	_thumbnailPool = new Common::ThreadPool(kThumbnailThreads + 1);
+	_thumbnailCache = nullptr;
+
+	setFlags(WIDGET_WANT_TICKLE);
 }
 
 GridWidget::~GridWidget() {
+	for (Common::HashMap<Common::String, Common::Future<GridThumbnailResult> >::iterator i = _pendingThumbnails.begin(); i != _pendingThumbnails.end(); ++i)
+		delete i->_value.get().surface;
+	_pendingThumbnails.clear();
+	delete _thumbnailPool;
+
+	if (_thumbnailCache) {
+		const int thumbnailWidth = MAX(_thumbnailWidth - 2 * _thumbnailMargin, 0);
+		const int thumbnailHeight = MAX(_thumbnailHeight - 2 * _thumbnailMargin, 0);
+		_thumbnailCache->save(getThumbnailCacheKey("", thumbnailWidth, thumbnailHeight));
+		delete _thumbnailCache;
+	}
+
 	unloadSurfaces(_platformIcons);
 	unloadSurfaces(_languageIcons);
 	unloadSurfaces(_extraIcons);
@@ -688,40 +1036,73 @@ void GridWidget::setGroupHeaderFormat(const Common::U32String &prefix, const Com
 void GridWidget::reloadThumbnails() {
 	const int thumbnailWidth = MAX(_thumbnailWidth - 2 * _thumbnailMargin, 0);
 	const int thumbnailHeight = MAX(_thumbnailHeight - 2 * _thumbnailMargin, 0);
+
+	if (!_thumbnailCache)
+		_thumbnailCache = new GridThumbnailCache();
+
 	for (Common::Array<GridItemInfo *>::iterator iter = _visibleEntryList.begin(); iter != _visibleEntryList.end(); ++iter) {
 		GridItemInfo *entry = *iter;
 		if (entry->thumbPath.empty())
 			continue;
 
-		if (!_loadedSurfaces.contains(entry->thumbPath)) {
-			_loadedSurfaces[entry->thumbPath] = nullptr;
-			Common::String path = Common::String::format("icons/%s-%s.png", entry->engineid.c_str(), entry->gameid.c_str());
-			Graphics::ManagedSurface *surf = loadSurfaceFromFile(path);
-			if (!surf) {
-				path = Common::String::format("icons/%s.png", entry->engineid.c_str());
-				if (!_loadedSurfaces.contains(path)) {
-					surf = loadSurfaceFromFile(path);
-				} else {
-					const Graphics::ManagedSurface *scSurf = _loadedSurfaces[path];
-					_loadedSurfaces[entry->thumbPath] = new Graphics::ManagedSurface(*scSurf);
-				}
-			}
+		if (_loadedSurfaces.contains(entry->thumbPath) || _pendingThumbnails.contains(entry->thumbPath))
+			continue;
 
-			if (surf) {
-				const Graphics::ManagedSurface *scSurf(scaleGfx(surf, thumbnailWidth, thumbnailHeight, true));
-				_loadedSurfaces[entry->thumbPath] = scSurf;
+		GridThumbnailRequest *request = new GridThumbnailRequest(entry->engineid.c_str(), entry->gameid.c_str(), thumbnailWidth, thumbnailHeight);
+		_thumbnailCache->read(getThumbnailCacheKey(entry->thumbPath, thumbnailWidth, thumbnailHeight), request->cacheData);
+		_pendingThumbnails[entry->thumbPath] = _thumbnailPool->submit([request]() {
+			return loadThumbnail(request);
+		});
+	}
 
-				if (path != entry->thumbPath) {
-					_loadedSurfaces[path] = new Graphics::ManagedSurface(*scSurf);
-				}
+	collectThumbnails();
+}
 
-				if (surf != scSurf) {
-					surf->free();
-					delete surf;
-				}
-			}
+void GridWidget::collectThumbnails() {
+	const int thumbnailWidth = MAX(_thumbnailWidth - 2 * _thumbnailMargin, 0);
+	const int thumbnailHeight = MAX(_thumbnailHeight - 2 * _thumbnailMargin, 0);
+
+	Common::Array<Common::String> readyPaths;
+	for (Common::HashMap<Common::String, Common::Future<GridThumbnailResult> >::iterator i = _pendingThumbnails.begin(); i != _pendingThumbnails.end(); ++i) {
+		if (i->_value.isReady())
+			readyPaths.push_back(i->_key);
+	}
+
+	if (readyPaths.empty())
+		return;
+
+	Common::HashMap<Common::String, bool> loadedPaths;
+	bool isStale = false;
+	for (Common::Array<Common::String>::iterator i = readyPaths.begin(); i != readyPaths.end(); ++i) {
+		GridThumbnailResult result = _pendingThumbnails[*i].get();
+		_pendingThumbnails.erase(*i);
+
+		for (uint k = 0; k < result.debugMessages.size(); k++)
+			debug(5, "%s", result.debugMessages[k].c_str());
+		for (uint k = 0; k < result.warnings.size(); k++)
+			warning("%s", result.warnings[k].c_str());
+
+		// The thumbnail size changed while this one was loading
+		if (result.width != thumbnailWidth || result.height != thumbnailHeight) {
+			delete result.surface;
+			isStale = true;
+			continue;
 		}
+
+		if (!result.cacheData.empty())
+			_thumbnailCache->add(getThumbnailCacheKey(*i, thumbnailWidth, thumbnailHeight), result.cacheData);
+
+		_loadedSurfaces[*i] = result.surface;
+		loadedPaths[*i] = true;
+	}
+
+	for (uint k = 0; k < _visibleEntryList.size() && k < _gridItems.size(); k++) {
+		if (loadedPaths.contains(_visibleEntryList[k]->thumbPath))
+			_gridItems[k]->update();
 	}
+
+	if (isStale)
+		reloadThumbnails();
 }
 
 void GridWidget::loadFlagIcons() {
@@ -1005,6 +1386,11 @@ void GridWidget::calcEntrySizes() {
 	}
 }
 
+void GridWidget::handleTickle() {
+	if (!_pendingThumbnails.empty())
+		collectThumbnails();
+}
+
 void GridWidget::reflowLayout() {
 	Widget::reflowLayout();
 	destroyItems();
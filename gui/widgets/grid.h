@@ -25,6 +25,7 @@
 #include "gui/dialog.h"
 #include "gui/widgets/scrollbar.h"
 #include "common/str.h"
+#include "common/threadpool.h"
 
 #include "image/bmp.h"
 #include "image/png.h"
@@ -35,6 +36,7 @@ namespace GUI {
 class ScrollBarWidget;
 class GridItemWidget;
 class GridWidget;
+class GridThumbnailCache;
 
 enum {
 	kPlayButtonCmd = 'PLAY',
@@ -75,6 +77,19 @@ struct GridItemInfo {
 	}
 };
 
+/* GridThumbnailResult */
+struct GridThumbnailResult {
+	Graphics::ManagedSurface	*surface;
+	// Compressed copy of a newly scaled thumbnail, for the on-disk cache
+	Common::Array<byte>			cacheData;
+	int							width, height;
+	// Messages of the worker thread, logged by the GUI thread
+	Common::Array<Common::String>	debugMessages;
+	Common::Array<Common::String>	warnings;
+
+	GridThumbnailResult() : surface(nullptr), width(0), height(0) {}
+};
+
 /* GridItemTray */
 class GridItemTray: public Dialog, public CommandSender {
 	int				_entryID;
@@ -105,6 +120,11 @@ protected:
 	Graphics::ManagedSurface *_disabledIconOverlay;
 	// Images are mapped by filename -> surface.
 	Common::HashMap<Common::String, const Graphics::ManagedSurface *> _loadedSurfaces;
+	// Thumbnails are loaded and scaled on worker threads. Until a thumbnail
+	// is ready, its item shows the game title instead.
+	Common::ThreadPool *_thumbnailPool;
+	Common::HashMap<Common::String, Common::Future<GridThumbnailResult> > _pendingThumbnails;
+	GridThumbnailCache *_thumbnailCache;
 
 	Common::Array<GridItemInfo>			_dataEntryList;
 	Common::Array<GridItemInfo>			_headerEntryList;
@@ -195,6 +215,7 @@ public:
 	void saveClosedGroups(const Common::U32String &groupName);
 
 	void reloadThumbnails();
+	void collectThumbnails();
 	void loadFlagIcons();
 	void loadPlatformIcons();
 	void loadExtraIcons();
@@ -216,6 +237,7 @@ public:
 
 	void handleMouseWheel(int x, int y, int direction) override;
 	void handleCommand(CommandSender *sender, uint32 cmd, uint32 data) override;
+	void handleTickle() override;
 	void reflowLayout() override;
 
 	bool wantsFocus() override { return true; }
@@ -0,0 +1,74 @@
+#include <cxxtest/TestSuite.h>
+#include "test/instrset_detect.h"
+
+#if defined(HAVE_CONFIG_H)
+#include "config.h"
+#endif
+
+#include "audio/rate_intern.h"
+#include "common/random.h"
+
+class RateConverterMixTestSuite : public CxxTest::TestSuite {
+private:
+	enum {
+		kNumFrames = 131 // Not a multiple of any vector size, to exercise the scalar tails
+	};
+
+	void compareMixFunc(Audio::RateConverterMix::MixFunc (*getMixFunc)(bool, bool, bool)) {
+		static const Audio::st_volume_t volumes[] = { 0, 1, 127, 128, 255, 256, 300 };
+		Common::RandomSource rnd("rate");
+
+		Audio::st_sample_t in[kNumFrames * 2];
+		Audio::st_sample_t outScalar[kNumFrames * 2], outSIMD[kNumFrames * 2];
+
+		for (int layout = 0; layout < 8; layout++) {
+			const bool inStereo = (layout & 1) != 0;
+			const bool outStereo = (layout & 2) != 0;
+			const bool reverseStereo = (layout & 4) != 0;
+
+			Audio::RateConverterMix::MixFunc generic = Audio::RateConverterMix::getMixFuncGeneric(inStereo, outStereo, reverseStereo);
+			Audio::RateConverterMix::MixFunc simd = getMixFunc(inStereo, outStereo, reverseStereo);
+			if (!simd)
+				continue;
+
+			for (int v = 0; v < ARRAYSIZE(volumes) * ARRAYSIZE(volumes); v++) {
+				const Audio::st_volume_t volL = volumes[v % ARRAYSIZE(volumes)];
+				const Audio::st_volume_t volR = volumes[v / ARRAYSIZE(volumes)];
+
+				// Include the extreme values to check rounding and saturation
+				for (int i = 0; i < kNumFrames * 2; i++) {
+					in[i] = (i % 17 == 0) ? -32768 : (i % 19 == 0) ? 32767 : (int16)rnd.getRandomNumber(65535);
+					outScalar[i] = outSIMD[i] = (i % 13 == 0) ? -32768 : (i % 11 == 0) ? 32767 : (int16)rnd.getRandomNumber(65535);
+				}
+
+				for (uint numFrames = 0; numFrames <= kNumFrames; numFrames += 31) {
+					generic(outScalar, in, numFrames, volL, volR);
+					simd(outSIMD, in, numFrames, volL, volR);
+				}
+
+				TS_ASSERT_EQUALS(memcmp(outScalar, outSIMD, sizeof(outScalar)), 0);
+			}
+		}
+	}
+
+public:
+	void test_mix_sse2() {
+#ifdef SCUMMVM_SSE2
+		if (instrset_detect() >= 2)
+			compareMixFunc(Audio::RateConverterMix::getMixFuncSSE2);
+#endif
+	}
+
+	void test_mix_avx2() {
+#ifdef SCUMMVM_AVX2
+		if (instrset_detect() >= 8)
+			compareMixFunc(Audio::RateConverterMix::getMixFuncAVX2);
+#endif
+	}
+
+	void test_mix_neon() {
+#ifdef SCUMMVM_NEON
+		compareMixFunc(Audio::RateConverterMix::getMixFuncNEON);
+#endif
+	}
+};
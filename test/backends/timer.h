@@ -0,0 +1,192 @@
+#include <cxxtest/TestSuite.h>
+
+#include "backends/timer/default/default-timer.h"
+
+#include "../null_osystem.h"
+
+namespace {
+
+// Timer manager running on a clock set by the test
+class FakeClockTimerManager : public DefaultTimerManager {
+public:
+	FakeClockTimerManager(uint32 millis = 0) : _millis(millis) {}
+
+	// Advance the clock one millisecond at a time, as a timer thread would
+	void advance(uint32 millis) {
+		for (uint32 i = 0; i < millis; i++) {
+			_millis++;
+			handler();
+		}
+	}
+
+	uint32 _millis;
+
+protected:
+	uint32 getMillis() const override { return _millis; }
+};
+
+struct TimerLog {
+	TimerLog() : count(0), manager(nullptr), removeAfter(0) {}
+
+	Common::Array<char> order;
+	int count;
+	FakeClockTimerManager *manager;
+	int removeAfter;
+};
+
+void timerA(void *refCon) {
+	((TimerLog *)refCon)->count++;
+	((TimerLog *)refCon)->order.push_back('A');
+}
+
+void timerB(void *refCon) {
+	((TimerLog *)refCon)->order.push_back('B');
+}
+
+void selfRemovingTimer(void *refCon) {
+	TimerLog *log = (TimerLog *)refCon;
+	if (++log->count == log->removeAfter)
+		log->manager->removeTimerProc(selfRemovingTimer);
+}
+
+} // End of anonymous namespace
+
+class DefaultTimerTestSuite : public CxxTest::TestSuite {
+public:
+	void test_microsecond_intervals() {
+#if NULL_OSYSTEM_IS_AVAILABLE
+		Common::install_null_g_system();
+		FakeClockTimerManager manager;
+		TimerLog log;
+
+		manager.installTimerProc(timerA, 2500, &log, "a");
+		manager.handler();
+		manager.advance(100);
+
+		// Fires at 2.5, 5, ..., 97.5 ms, without rounding to milliseconds
+		TS_ASSERT_EQUALS(log.count, 39);
+
+		Common::Array<DefaultTimerManager::TimerStats> stats;
+		manager.getStats(stats);
+		TS_ASSERT_EQUALS(stats.size(), 1u);
+		TS_ASSERT_EQUALS(stats[0].id, "a");
+		TS_ASSERT_EQUALS(stats[0].interval, 2500u);
+		TS_ASSERT_EQUALS(stats[0].fireCount, 39u);
+		TS_ASSERT_LESS_THAN_EQUALS(stats[0].maxLateness, 1000u);
+
+		manager.removeTimerProc(timerA);
+		manager.advance(10);
+		TS_ASSERT_EQUALS(log.count, 39);
+#endif
+	}
+
+	void test_same_fire_time() {
+#if NULL_OSYSTEM_IS_AVAILABLE
+		Common::install_null_g_system();
+		FakeClockTimerManager manager;
+		TimerLog log;
+
+		// Timers due at the same time fire in the order they were scheduled
+		manager.installTimerProc(timerA, 10000, &log, "a");
+		manager.installTimerProc(timerB, 10000, &log, "b");
+		manager.handler();
+		manager.advance(25);
+
+		TS_ASSERT_EQUALS(log.order.size(), 4u);
+		if (log.order.size() == 4) {
+			TS_ASSERT_EQUALS(log.order[0], 'A');
+			TS_ASSERT_EQUALS(log.order[1], 'B');
+			TS_ASSERT_EQUALS(log.order[2], 'A');
+			TS_ASSERT_EQUALS(log.order[3], 'B');
+		}
+#endif
+	}
+
+	void test_late_ticks() {
+#if NULL_OSYSTEM_IS_AVAILABLE
+		Common::install_null_g_system();
+		FakeClockTimerManager manager;
+		TimerLog log;
+
+		manager.installTimerProc(timerA, 10000, &log, "a");
+		manager.handler();
+
+		// A late tick catches up on the missed periods, and the following
+		// ones keep to the original schedule
+		manager._millis = 35;
+		manager.handler();
+		TS_ASSERT_EQUALS(log.count, 3);
+		manager._millis = 45;
+		manager.handler();
+		TS_ASSERT_EQUALS(log.count, 4);
+
+		Common::Array<DefaultTimerManager::TimerStats> stats;
+		manager.getStats(stats);
+		TS_ASSERT_EQUALS(stats.size(), 1u);
+		TS_ASSERT_EQUALS(stats[0].fireCount, 4u);
+		TS_ASSERT_EQUALS(stats[0].meanLateness, (25000u + 15000u + 5000u + 5000u) / 4);
+		TS_ASSERT_EQUALS(stats[0].maxLateness, 25000u);
+#endif
+	}
+
+	void test_clock_wrap() {
+#if NULL_OSYSTEM_IS_AVAILABLE
+		Common::install_null_g_system();
+		FakeClockTimerManager manager(0xFFFFFFF0);
+		TimerLog log;
+
+		manager.handler();
+		manager.installTimerProc(timerA, 10000, &log, "a");
+		manager.handler();
+		manager.advance(32);
+		TS_ASSERT_EQUALS(log.count, 3);
+#endif
+	}
+
+	void test_remove_from_callback() {
+#if NULL_OSYSTEM_IS_AVAILABLE
+		Common::install_null_g_system();
+		FakeClockTimerManager manager;
+		TimerLog log;
+		log.manager = &manager;
+		log.removeAfter = 2;
+
+		manager.installTimerProc(selfRemovingTimer, 1000, &log, "self");
+		manager.handler();
+		manager.advance(10);
+		TS_ASSERT_EQUALS(log.count, 2);
+
+		Common::Array<DefaultTimerManager::TimerStats> stats;
+		manager.getStats(stats);
+		TS_ASSERT(stats.empty());
+
+		// The name can be reused once the timer is removed
+		log.count = 0;
+		log.removeAfter = 1;
+		manager.installTimerProc(selfRemovingTimer, 1000, &log, "self");
+		manager.advance(10);
+		TS_ASSERT_EQUALS(log.count, 1);
+#endif
+	}
+
+	void test_many_requests() {
+#if NULL_OSYSTEM_IS_AVAILABLE
+		Common::install_null_g_system();
+		FakeClockTimerManager manager;
+		TimerLog log;
+
+		// More requests than the queue holds, without a handler call to
+		// process them
+		for (int i = 0; i < 200; i++) {
+			manager.installTimerProc(timerA, 1000, &log, "a");
+			manager.removeTimerProc(timerA);
+		}
+		manager.installTimerProc(timerB, 1000, &log, "b");
+		manager.handler();
+		manager.advance(5);
+
+		TS_ASSERT_EQUALS(log.count, 0);
+		TS_ASSERT_EQUALS(log.order.size(), 4u);
+#endif
+	}
+};
@@ -1,7 +1,49 @@
 #include <cxxtest/TestSuite.h>
 
+#include "common/debug.h"
+#include "common/flat-hashmap.h"
 #include "common/hashmap.h"
 #include "common/hash-str.h"
+#include "common/system.h"
+
+#include "../null_osystem.h"
+
+#if NULL_OSYSTEM_IS_AVAILABLE
+#define BENCHMARK_TIME 1
+#else
+#define BENCHMARK_TIME 0
+#endif
+
+/**
+ * Run an insert / lookup / iterate / erase workload on a map, and return
+ * a checksum of the values seen so that implementations can be compared.
+ */
+template<class Map, class Key>
+static uint32 runHashMapWorkload(const Common::Array<Key> &keys, int iters) {
+	uint32 checksum = 0;
+
+	for (int iter = 0; iter < iters; iter++) {
+		Map map;
+		for (uint i = 0; i < keys.size(); i++)
+			map[keys[i]] = i;
+
+		// Successful lookups, in a different order than the insertions
+		for (uint i = 0; i < keys.size(); i++)
+			checksum += map.getVal(keys[(i * 7) % keys.size()]);
+
+		for (typename Map::const_iterator it = map.begin(); it != map.end(); ++it)
+			checksum ^= it->_value;
+
+		// Erase half of the keys and look all of them up again, to also
+		// measure unsuccessful lookups past deleted entries
+		for (uint i = 0; i < keys.size(); i += 2)
+			map.erase(keys[i]);
+		for (uint i = 0; i < keys.size(); i++)
+			checksum += map.contains(keys[i]) ? 1 : 0;
+	}
+
+	return checksum;
+}
 
 class HashMapTestSuite : public CxxTest::TestSuite
 {
@@ -230,5 +272,139 @@ class HashMapTestSuite : public CxxTest::TestSuite
 		TS_ASSERT(found == 16+8+4);
 }
 
+	void test_flat_add_remove() {
+		Common::FlatHashMap<int, int> container;
+		TS_ASSERT(container.empty());
+		for (int i = 0; i < 1000; i++)
+			container[i * 16] = i;
+		TS_ASSERT_EQUALS(container.size(), 1000u);
+
+		for (int i = 0; i < 1000; i += 2)
+			container.erase(i * 16);
+		TS_ASSERT_EQUALS(container.size(), 500u);
+
+		for (int i = 0; i < 1000; i++) {
+			TS_ASSERT_EQUALS(container.contains(i * 16), (i & 1) != 0);
+			TS_ASSERT_EQUALS(container.getValOrDefault(i * 16, -1), (i & 1) ? i : -1);
+		}
+
+		// Reinsert into the deleted slots
+		for (int i = 0; i < 1000; i += 2)
+			container.setVal(i * 16, -i);
+		for (int i = 0; i < 1000; i++)
+			TS_ASSERT_EQUALS(container[i * 16], (i & 1) ? i : -i);
+
+		container.clear(true);
+		TS_ASSERT(container.empty());
+		TS_ASSERT_EQUALS(container.begin(), container.end());
+	}
+
+	void test_flat_collision() {
+		// Keys which all hash into the same group
+		Common::FlatHashMap<int, int> h;
+		for (int i = 0; i < 64; i++)
+			h[5 + i * 1024] = i;
+		for (int i = 0; i < 64; i += 3)
+			h.erase(5 + i * 1024);
+		for (int i = 0; i < 64; i++)
+			TS_ASSERT_EQUALS(h.contains(5 + i * 1024), (i % 3) != 0);
+		for (int i = 0; i < 64; i += 3)
+			h[5 + i * 1024] = i;
+		for (int i = 0; i < 64; i++)
+			TS_ASSERT_EQUALS(h[5 + i * 1024], i);
+	}
+
+	void test_flat_iterator_erase() {
+		Common::FlatHashMap<int, int> container;
+		for (int i = 0; i < 100; i++)
+			container[i] = i;
+
+		// Erasing the current entry while iterating is allowed
+		for (Common::FlatHashMap<int, int>::iterator i = container.begin(); i != container.end(); ++i) {
+			if (i->_key % 10)
+				container.erase(i);
+		}
+
+		int found = 0;
+		for (Common::FlatHashMap<int, int>::const_iterator j = container.begin(); j != container.end(); ++j) {
+			TS_ASSERT_EQUALS(j->_key % 10, 0);
+			TS_ASSERT_EQUALS(j->_value, j->_key);
+			found++;
+		}
+		TS_ASSERT_EQUALS(found, 10);
+		TS_ASSERT_EQUALS(container.size(), 10u);
+	}
+
+	void test_flat_string_copy() {
+		Common::FlatHashMap<Common::String, Common::String, Common::IgnoreCase_Hash, Common::IgnoreCase_EqualTo> map1;
+		for (int i = 0; i < 200; i++)
+			map1[Common::String::format("Key%d", i)] = Common::String::format("Value%d", i);
+		map1.erase("key17");
+
+		Common::FlatHashMap<Common::String, Common::String, Common::IgnoreCase_Hash, Common::IgnoreCase_EqualTo> map2(map1);
+		map1.clear();
+		TS_ASSERT_EQUALS(map2.size(), 199u);
+		TS_ASSERT(!map2.contains("KEY17"));
+		TS_ASSERT_EQUALS(map2["KEY42"], "Value42");
+		TS_ASSERT_EQUALS(map2.find("key199")->_value, "Value199");
+		TS_ASSERT_EQUALS(map2.find("key200"), map2.end());
+
+		map1 = map2;
+		TS_ASSERT_EQUALS(map1.size(), 199u);
+		TS_ASSERT_EQUALS(map1["key0"], "Value0");
+	}
+
+	void test_flat_speed() {
+		// Pseudo-random keys, since Hash<int> is the identity and a dense
+		// key range would make any table collision free
+		Common::Array<int> intKeys;
+		uint32 seed = 1;
+		for (int i = 0; i < 20000; i++) {
+			seed = seed * 1103515245 + 12345;
+			intKeys.push_back(seed >> 1);
+		}
+
+		Common::Array<Common::String> stringKeys;
+		for (int i = 0; i < 20000; i++)
+			stringKeys.push_back(Common::String::format("engines/data/resource%05d.dat", i * 13));
+
+#ifdef SLOW_TESTS
+		const int iters = 100;
+#else
+		const int iters = 1;
+#endif
+#if BENCHMARK_TIME
+		Common::install_null_g_system();
+		uint32 start = g_system->getMillis();
+#endif
+		uint32 intChecksum = runHashMapWorkload<Common::HashMap<int, int> >(intKeys, iters);
+#if BENCHMARK_TIME
+		uint32 intTime = g_system->getMillis() - start;
+		start = g_system->getMillis();
+#endif
+		uint32 intFlatChecksum = runHashMapWorkload<Common::FlatHashMap<int, int> >(intKeys, iters);
+#if BENCHMARK_TIME
+		uint32 intFlatTime = g_system->getMillis() - start;
+		start = g_system->getMillis();
+#endif
+		uint32 strChecksum = runHashMapWorkload<Common::HashMap<Common::String, uint, Common::IgnoreCase_Hash, Common::IgnoreCase_EqualTo> >(stringKeys, iters);
+#if BENCHMARK_TIME
+		uint32 strTime = g_system->getMillis() - start;
+		start = g_system->getMillis();
+#endif
+		uint32 strFlatChecksum = runHashMapWorkload<Common::FlatHashMap<Common::String, uint, Common::IgnoreCase_Hash, Common::IgnoreCase_EqualTo> >(stringKeys, iters);
+#if BENCHMARK_TIME
+		uint32 strFlatTime = g_system->getMillis() - start;
+
+		debug("HashMap<int> time for %d iters (in milliseconds): %u\n", iters, intTime);
+		debug("FlatHashMap<int> time for %d iters (in milliseconds): %u\n", iters, intFlatTime);
+		debug("HashMap<String> time for %d iters (in milliseconds): %u\n", iters, strTime);
+		debug("FlatHashMap<String> time for %d iters (in milliseconds): %u\n", iters, strFlatTime);
+#endif
+
+		TS_ASSERT_EQUALS(intChecksum, intFlatChecksum);
+		TS_ASSERT_EQUALS(strChecksum, strFlatChecksum);
+	}
+
 	// TODO: Add test cases for iterators, find, ...
 };
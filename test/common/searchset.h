@@ -0,0 +1,168 @@
+#include <cxxtest/TestSuite.h>
+
+#include "common/archive.h"
+#include "common/array.h"
+#include "common/memstream.h"
+
+// An archive serving the given members, each containing the archive name
+class SearchSetTestArchive : public Common::Archive {
+public:
+	SearchSetTestArchive(const char *name, const char *const *members) : _name(name) {
+		for (; *members; members++)
+			_members.push_back(Common::Path(*members));
+	}
+
+	void addMember(const char *path) {
+		_members.push_back(Common::Path(path));
+	}
+
+	bool hasFile(const Common::Path &path) const override {
+		for (uint i = 0; i < _members.size(); i++) {
+			if (_members[i].equalsIgnoreCase(path))
+				return true;
+		}
+		return false;
+	}
+
+	int listMembers(Common::ArchiveMemberList &list) const override {
+		for (uint i = 0; i < _members.size(); i++)
+			list.push_back(Common::ArchiveMemberPtr(new Common::GenericArchiveMember(_members[i], *this)));
+		return _members.size();
+	}
+
+	const Common::ArchiveMemberPtr getMember(const Common::Path &path) const override {
+		if (!hasFile(path))
+			return Common::ArchiveMemberPtr();
+		return Common::ArchiveMemberPtr(new Common::GenericArchiveMember(path, *this));
+	}
+
+	Common::SeekableReadStream *createReadStreamForMember(const Common::Path &path) const override {
+		if (!hasFile(path))
+			return nullptr;
+		return new Common::MemoryReadStream((const byte *)_name, strlen(_name));
+	}
+
+private:
+	const char *_name;
+	Common::Array<Common::Path> _members;
+};
+
+class SearchSetTestSuite : public CxxTest::TestSuite {
+	static const char *readArchiveName(const Common::SearchSet &set, const char *path) {
+		static char name[16];
+		Common::SeekableReadStream *stream = set.createReadStreamForMember(Common::Path(path));
+		if (!stream)
+			return "";
+		uint32 size = stream->read(name, sizeof(name) - 1);
+		name[size] = 0;
+		delete stream;
+		return name;
+	}
+
+	static void addArchives(Common::SearchSet &set) {
+		static const char *const low[] = { "shared.dat", "low.dat", "dir/file.dat", nullptr };
+		static const char *const high[] = { "SHARED.DAT", "high.dat", nullptr };
+		set.add("low", new SearchSetTestArchive("low", low), 0);
+		set.add("high", new SearchSetTestArchive("high", high), 10);
+	}
+
+	void checkLookups(Common::SearchSet &set) {
+		TS_ASSERT(set.hasFile(Common::Path("shared.dat")));
+		TS_ASSERT(set.hasFile(Common::Path("Low.dat")));
+		TS_ASSERT(set.hasFile(Common::Path("dir/file.dat")));
+		TS_ASSERT(!set.hasFile(Common::Path("missing.dat")));
+		TS_ASSERT(!set.hasFile(Common::Path("dir")));
+
+		TS_ASSERT_EQUALS(Common::String(readArchiveName(set, "shared.dat")), "high");
+		TS_ASSERT_EQUALS(Common::String(readArchiveName(set, "low.dat")), "low");
+		TS_ASSERT_EQUALS(Common::String(readArchiveName(set, "missing.dat")), "");
+
+		Common::Archive *container = nullptr;
+		TS_ASSERT(set.getMember(Common::Path("high.dat"), &container));
+		TS_ASSERT_EQUALS(container, set.getArchive("high"));
+		TS_ASSERT(!set.getMember(Common::Path("missing.dat")));
+	}
+
+public:
+	void test_lookups() {
+		Common::SearchSet set;
+		addArchives(set);
+		checkLookups(set);
+
+		set.setUseIndex(true);
+		checkLookups(set);
+
+		// Priority changes take effect immediately
+		set.setPriority("low", 20);
+		TS_ASSERT_EQUALS(Common::String(readArchiveName(set, "shared.dat")), "low");
+		set.remove("low");
+		TS_ASSERT_EQUALS(Common::String(readArchiveName(set, "shared.dat")), "high");
+		TS_ASSERT(!set.hasFile(Common::Path("low.dat")));
+	}
+
+	void test_index_invalidation() {
+		Common::SearchSet set;
+		addArchives(set);
+		set.setUseIndex(true);
+
+		SearchSetTestArchive *low = (SearchSetTestArchive *)set.getArchive("low");
+		TS_ASSERT(!set.hasFile(Common::Path("new.dat")));
+		low->addMember("new.dat");
+		TS_ASSERT(!set.hasFile(Common::Path("new.dat")));
+		set.invalidateIndex();
+		TS_ASSERT(set.hasFile(Common::Path("new.dat")));
+	}
+
+	void test_copy() {
+		static const char *const low[] = { "shared.dat", "low.dat", nullptr };
+		static const char *const high[] = { "shared.dat", "high.dat", nullptr };
+		SearchSetTestArchive lowArchive("low", low), highArchive("high", high);
+
+		Common::SearchSet set;
+		set.add("low", &lowArchive, 0, false);
+		set.add("high", &highArchive, 10, false);
+		set.setUseIndex(true);
+		TS_ASSERT_EQUALS(Common::String(readArchiveName(set, "shared.dat")), "high");
+
+		// The copy must not use the index of the original, which refers to
+		// archives the original no longer has
+		Common::SearchSet copy(set);
+		Common::SearchSet assigned;
+		assigned = set;
+		set.remove("high");
+		TS_ASSERT_EQUALS(Common::String(readArchiveName(copy, "shared.dat")), "high");
+		TS_ASSERT_EQUALS(Common::String(readArchiveName(assigned, "shared.dat")), "high");
+		TS_ASSERT(copy.hasFile(Common::Path("high.dat")));
+
+		assigned = Common::SearchSet();
+		TS_ASSERT(!assigned.hasFile(Common::Path("low.dat")));
+	}
+
+	void test_archive_stats() {
+		Common::SearchSet set;
+		addArchives(set);
+
+		Common::Array<Common::SearchSet::ArchiveStats> stats;
+		TS_ASSERT(set.hasFile(Common::Path("low.dat")));
+		TS_ASSERT(!set.hasFile(Common::Path("missing.dat")));
+		set.getArchiveStats(stats);
+		TS_ASSERT_EQUALS(stats.size(), 2u);
+		TS_ASSERT_EQUALS(stats[0].name, "high");
+		TS_ASSERT_EQUALS(stats[0].priority, 10);
+		TS_ASSERT_EQUALS(stats[0].lookups, 2u);
+		TS_ASSERT_EQUALS(stats[0].hits, 0u);
+		TS_ASSERT_EQUALS(stats[1].lookups, 2u);
+		TS_ASSERT_EQUALS(stats[1].hits, 1u);
+
+		// With the index, only the archive serving the member is asked
+		set.resetArchiveStats();
+		set.setUseIndex(true);
+		TS_ASSERT(set.hasFile(Common::Path("low.dat")));
+		TS_ASSERT(!set.hasFile(Common::Path("missing.dat")));
+		stats.clear();
+		set.getArchiveStats(stats);
+		TS_ASSERT_EQUALS(stats[0].lookups, 0u);
+		TS_ASSERT_EQUALS(stats[1].lookups, 1u);
+		TS_ASSERT_EQUALS(stats[1].hits, 1u);
+	}
+};
@@ -0,0 +1,61 @@
+#include <cxxtest/TestSuite.h>
+
+#include "common/spscqueue.h"
+
+class SPSCQueueTestSuite : public CxxTest::TestSuite {
+public:
+	void test_empty() {
+		Common::SPSCQueue<int, 4> queue;
+		int x = 0;
+
+		TS_ASSERT(queue.empty());
+		TS_ASSERT_EQUALS(queue.size(), 0U);
+		TS_ASSERT_EQUALS(queue.capacity(), 4U);
+		TS_ASSERT(!queue.pop(x));
+	}
+
+	void test_push_pop() {
+		Common::SPSCQueue<int, 4> queue;
+		int x = 0;
+
+		TS_ASSERT(queue.push(42));
+		TS_ASSERT(queue.push(-23));
+		TS_ASSERT_EQUALS(queue.size(), 2U);
+
+		TS_ASSERT(queue.pop(x));
+		TS_ASSERT_EQUALS(x, 42);
+		TS_ASSERT(queue.pop(x));
+		TS_ASSERT_EQUALS(x, -23);
+		TS_ASSERT(queue.empty());
+	}
+
+	void test_full() {
+		Common::SPSCQueue<int, 4> queue;
+		int x = 0;
+
+		for (int i = 0; i < 4; ++i)
+			TS_ASSERT(queue.push(i));
+		TS_ASSERT(!queue.push(4));
+		TS_ASSERT_EQUALS(queue.size(), 4U);
+
+		TS_ASSERT(queue.pop(x));
+		TS_ASSERT_EQUALS(x, 0);
+		TS_ASSERT(queue.push(4));
+		TS_ASSERT(!queue.push(5));
+	}
+
+	void test_wrap_around() {
+		Common::SPSCQueue<int, 4> queue;
+		int x = 0;
+
+		for (int i = 0; i < 100; ++i) {
+			TS_ASSERT(queue.push(i));
+			TS_ASSERT(queue.push(i * 2));
+			TS_ASSERT(queue.pop(x));
+			TS_ASSERT_EQUALS(x, i);
+			TS_ASSERT(queue.pop(x));
+			TS_ASSERT_EQUALS(x, i * 2);
+		}
+		TS_ASSERT(queue.empty());
+	}
+};
@@ -1,10 +1,48 @@
 #include <cxxtest/TestSuite.h>
 
+#include "common/array.h"
+#include "common/debug.h"
 #include "common/str.h"
+#include "common/system.h"
 #include "common/ustr.h"
 
 #include "test/common/str-helper.h"
 
+#include "../null_osystem.h"
+
+#if NULL_OSYSTEM_IS_AVAILABLE
+#define BENCHMARK_TIME 1
+#else
+#define BENCHMARK_TIME 0
+#endif
+
+/**
+ * Copy, modify and destroy strings which don't fit into the builtin
+ * storage, and return a checksum of their contents.
+ */
+static uint32 runStringChurn(int iters) {
+	uint32 checksum = 0;
+
+	for (int iter = 0; iter < iters; iter++) {
+		Common::Array<Common::String> names;
+		for (int i = 0; i < 500; i++)
+			names.push_back(Common::String::format("engines/data/resources/resource%05d.dat", i));
+
+		// Share the storage of every string, then unshare half of it
+		Common::Array<Common::String> copies(names);
+		for (uint i = 0; i < copies.size(); i += 2)
+			copies[i].setChar('E', 0);
+
+		for (uint i = 0; i < copies.size(); i++) {
+			Common::String str = copies[i];
+			str += ".bak";
+			checksum += str.size() + str[0];
+		}
+	}
+
+	return checksum;
+}
+
 class StringTestSuite : public CxxTest::TestSuite
 {
 	public:
@@ -745,4 +783,53 @@ class StringTestSuite : public CxxTest::TestSuite
 		TS_ASSERT(a > c);
 		TS_ASSERT(c < a);
 	}
+
+	void test_shared_storage() {
+		// Long enough to be stored on the heap
+		Common::String a("this string does not fit into the builtin storage");
+		Common::String b(a);
+		Common::String c;
+		c = b;
+
+		TS_ASSERT_EQUALS(a.c_str(), b.c_str());
+		TS_ASSERT_EQUALS(a.c_str(), c.c_str());
+
+		// Modifying a copy must not change the others
+		b.setChar('T', 0);
+		TS_ASSERT_EQUALS(b, "This string does not fit into the builtin storage");
+		TS_ASSERT_EQUALS(a, "this string does not fit into the builtin storage");
+		TS_ASSERT_EQUALS(a.c_str(), c.c_str());
+
+		// The storage must outlive the string which allocated it
+		a.clear();
+		TS_ASSERT_EQUALS(c, "this string does not fit into the builtin storage");
+		c += "!";
+		TS_ASSERT_EQUALS(c.lastChar(), '!');
+
+		Common::U32String u("this string does not fit into the builtin storage");
+		Common::U32String v(u);
+		v.setChar('T', 0);
+		TS_ASSERT_EQUALS(u[0], (Common::u32char_type_t)'t');
+		TS_ASSERT_EQUALS(v[0], (Common::u32char_type_t)'T');
+	}
+
+	void test_string_churn() {
+#ifdef SLOW_TESTS
+		const int iters = 100;
+#else
+		const int iters = 1;
+#endif
+#if BENCHMARK_TIME
+		Common::install_null_g_system();
+		uint32 start = g_system->getMillis();
+#endif
+		uint32 checksum = runStringChurn(iters);
+#if BENCHMARK_TIME
+		uint32 time = g_system->getMillis() - start;
+
+		debug("String churn time for %d iters (in milliseconds): %u\n", iters, time);
+#endif
+
+		TS_ASSERT_EQUALS(checksum, runStringChurn(1) * iters);
+	}
 };
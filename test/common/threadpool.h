@@ -0,0 +1,102 @@
+#include <cxxtest/TestSuite.h>
+
+#include "common/threadpool.h"
+#include "../null_osystem.h"
+
+// The pool needs OSystem for its mutex. Without thread support in the
+// backend, as with the null backend, jobs run synchronously. The threaded
+// null backend runs them on real worker threads.
+class ThreadPoolTestSuite : public CxxTest::TestSuite {
+public:
+	void test_submit() {
+#if NULL_OSYSTEM_IS_AVAILABLE
+		Common::install_null_g_system();
+		Common::ThreadPool pool(4);
+
+		int value = 0;
+		Common::Future<void> job = pool.submit([&value]() { value = 42; });
+		Common::Future<int> result = pool.submit([]() { return 7 * 6; });
+
+		TS_ASSERT(job.isValid());
+		job.wait();
+		TS_ASSERT(job.isReady());
+		TS_ASSERT_EQUALS(value, 42);
+		TS_ASSERT_EQUALS(result.get(), 42);
+
+		// Futures can be copied and outlive the original handle
+		Common::Future<int> copy;
+		TS_ASSERT(!copy.isValid());
+		copy = result;
+		result = Common::Future<int>();
+		TS_ASSERT_EQUALS(copy.get(), 42);
+#endif
+	}
+
+	void test_parallel_for() {
+#if NULL_OSYSTEM_IS_AVAILABLE
+		Common::install_null_g_system();
+		Common::ThreadPool pool(4);
+
+		const uint count = 1000;
+		uint visits[count] = { 0 };
+		pool.parallelFor(10, count, [&visits](uint i) { visits[i]++; });
+
+		for (uint i = 0; i < count; i++)
+			TS_ASSERT_EQUALS(visits[i], i < 10 ? 0u : 1u);
+
+		// Empty ranges do nothing
+		pool.parallelFor(5, 5, [&visits](uint i) { visits[i]++; });
+		TS_ASSERT_EQUALS(visits[5], 0u);
+#endif
+	}
+
+	void test_nested() {
+#if NULL_OSYSTEM_IS_AVAILABLE
+		Common::install_null_g_system();
+		Common::ThreadPool pool(4);
+
+		// Jobs may wait for other jobs of the same pool
+		Common::Future<int> outer = pool.submit([&pool]() {
+			Common::Future<int> inner = pool.submit([]() { return 1; });
+			return inner.get() + 1;
+		});
+		TS_ASSERT_EQUALS(outer.get(), 2);
+#endif
+	}
+
+	void test_workers() {
+#if THREADED_NULL_OSYSTEM_IS_AVAILABLE
+		Common::install_threaded_null_g_system();
+		Common::Atomic<uint32> sum(0);
+		{
+			Common::ThreadPool pool(4);
+			TS_ASSERT_EQUALS(pool.getWorkerCount(), 3u);
+
+			// Each job waits for the others to start, which only finishes if
+			// they all run at the same time
+			const uint32 numJobs = 3;
+			Common::Atomic<uint32> started(0);
+			Common::Array<Common::Future<uint32> > jobs;
+			for (uint32 i = 0; i < numJobs; i++) {
+				jobs.push_back(pool.submit([&started, i]() {
+					started.fetchAdd(1);
+					while (started.load() < numJobs) {
+					}
+					return i;
+				}));
+			}
+			for (uint32 i = 0; i < numJobs; i++)
+				TS_ASSERT_EQUALS(jobs[i].get(), i);
+
+			pool.parallelFor(0, 1000, [&sum](uint i) { sum.fetchAdd(i); });
+			TS_ASSERT_EQUALS(sum.load(), 999u * 1000u / 2u);
+
+			// Jobs still queued when the pool is destroyed are finished first
+			for (uint32 i = 0; i < 100; i++)
+				pool.submit([&sum]() { sum.fetchAdd(1); });
+		}
+		TS_ASSERT_EQUALS(sum.load(), 999u * 1000u / 2u + 100u);
+		Common::install_null_g_system();
+#endif
+	}
+};
@@ -0,0 +1,189 @@
+#include <cxxtest/TestSuite.h>
+
+#if defined(HAVE_CONFIG_H)
+#include "config.h"
+#endif
+
+#include "common/archive.h"
+#include "common/array.h"
+#include "common/crc.h"
+#include "common/memstream.h"
+#include "common/ptr.h"
+#include "common/compression/deflate.h"
+#include "common/compression/unzip.h"
+
+struct ZipTestMember {
+	const char *name;
+	Common::Array<byte> data;
+	Common::Array<byte> compressed;
+	bool deflate;
+	uint32 crc;
+	uint32 offset;
+};
+
+static void makeZipTestData(Common::Array<byte> &data, uint32 size, uint32 seed) {
+	// Compressible but not trivially so
+	data.resize(size);
+	for (uint32 i = 0; i < size; i++) {
+		seed = seed * 1103515245 + 12345;
+		data[i] = (byte)((i / 7) + ((seed >> 16) & 3));
+	}
+}
+
+static void compressZipTestMember(ZipTestMember &member) {
+#ifndef USE_ZLIB
+	// Without zlib there is no deflate compressor
+	member.deflate = false;
+#endif
+	if (!member.deflate) {
+		member.compressed = member.data;
+		return;
+	}
+
+	// The gzip writer produces a raw deflate stream between a 10 byte header
+	// and an 8 byte trailer
+	Common::MemoryWriteStreamDynamic *gzip = new Common::MemoryWriteStreamDynamic(DisposeAfterUse::YES);
+	Common::WriteStream *writer = Common::wrapCompressedWriteStream(gzip);
+	writer->write(member.data.data(), member.data.size());
+	writer->finalize();
+
+	member.compressed.resize(gzip->size() - 18);
+	memcpy(member.compressed.data(), gzip->getData() + 10, member.compressed.size());
+	delete writer;
+}
+
+static Common::SeekableReadStream *makeZipTestArchive(Common::Array<ZipTestMember> &members) {
+	Common::MemoryWriteStreamDynamic zip(DisposeAfterUse::NO);
+	Common::CRC32 crc;
+
+	for (uint i = 0; i < members.size(); i++) {
+		ZipTestMember &member = members[i];
+		compressZipTestMember(member);
+		member.crc = crc.crcFast(member.data.data(), member.data.size());
+		member.offset = zip.pos();
+
+		zip.writeUint32LE(0x04034b50);
+		zip.writeUint16LE(20);
+		zip.writeUint16LE(0);
+		zip.writeUint16LE(member.deflate ? 8 : 0);
+		zip.writeUint32LE(0);
+		zip.writeUint32LE(member.crc);
+		zip.writeUint32LE(member.compressed.size());
+		zip.writeUint32LE(member.data.size());
+		zip.writeUint16LE(strlen(member.name));
+		zip.writeUint16LE(0);
+		zip.writeString(member.name);
+		zip.write(member.compressed.data(), member.compressed.size());
+	}
+
+	const uint32 centralDirOffset = zip.pos();
+	for (uint i = 0; i < members.size(); i++) {
+		const ZipTestMember &member = members[i];
+		zip.writeUint32LE(0x02014b50);
+		zip.writeUint16LE(20);
+		zip.writeUint16LE(20);
+		zip.writeUint16LE(0);
+		zip.writeUint16LE(member.deflate ? 8 : 0);
+		zip.writeUint32LE(0);
+		zip.writeUint32LE(member.crc);
+		zip.writeUint32LE(member.compressed.size());
+		zip.writeUint32LE(member.data.size());
+		zip.writeUint16LE(strlen(member.name));
+		zip.writeUint16LE(0);
+		zip.writeUint16LE(0);
+		zip.writeUint16LE(0);
+		zip.writeUint16LE(0);
+		zip.writeUint32LE(0);
+		zip.writeUint32LE(member.offset);
+		zip.writeString(member.name);
+	}
+	const uint32 centralDirSize = zip.pos() - centralDirOffset;
+
+	zip.writeUint32LE(0x06054b50);
+	zip.writeUint16LE(0);
+	zip.writeUint16LE(0);
+	zip.writeUint16LE(members.size());
+	zip.writeUint16LE(members.size());
+	zip.writeUint32LE(centralDirSize);
+	zip.writeUint32LE(centralDirOffset);
+	zip.writeUint16LE(0);
+
+	return new Common::MemoryReadStream(zip.getData(), zip.size(), DisposeAfterUse::YES);
+}
+
+static bool checkZipTestRead(Common::SeekableReadStream *stream, const Common::Array<byte> &data, uint32 offset, uint32 len) {
+	Common::Array<byte> buf(len);
+	if (!stream->seek(offset, SEEK_SET) || stream->pos() != offset)
+		return false;
+	if (stream->read(buf.data(), len) != len)
+		return false;
+	return memcmp(buf.data(), data.data() + offset, len) == 0;
+}
+
+class ZipArchiveTestSuite : public CxxTest::TestSuite {
+	Common::Array<ZipTestMember> _members;
+
+public:
+	void setUp() {
+		_members.resize(3);
+		_members[0].name = "big.bin";
+		_members[0].deflate = true;
+		makeZipTestData(_members[0].data, 5 * 1024 * 1024 + 123, 1);
+		_members[1].name = "small.bin";
+		_members[1].deflate = true;
+		makeZipTestData(_members[1].data, 1000, 2);
+		_members[2].name = "stored.bin";
+		_members[2].deflate = false;
+		makeZipTestData(_members[2].data, 3 * 1024 * 1024, 3);
+	}
+
+	void test_memcached() {
+		Common::ScopedPtr<Common::Archive> zip(Common::makeZipArchive(makeZipTestArchive(_members)));
+		TS_ASSERT(zip);
+
+		for (uint i = 0; i < _members.size(); i++) {
+			Common::ScopedPtr<Common::SeekableReadStream> stream(zip->createReadStreamForMember(_members[i].name));
+			TS_ASSERT(stream);
+			TS_ASSERT_EQUALS(stream->size(), (int64)_members[i].data.size());
+			TS_ASSERT(checkZipTestRead(stream.get(), _members[i].data, 0, _members[i].data.size()));
+		}
+	}
+
+	void test_streaming() {
+		Common::ScopedPtr<Common::Archive> zip(Common::makeZipArchive(makeZipTestArchive(_members), false, 2048));
+		TS_ASSERT(zip);
+
+		const Common::Array<byte> &big = _members[0].data;
+		Common::ScopedPtr<Common::SeekableReadStream> stream(zip->createReadStreamForMember("big.bin"));
+		Common::ScopedPtr<Common::SeekableReadStream> stored(zip->createReadStreamForMember("stored.bin"));
+		TS_ASSERT(stream);
+		TS_ASSERT(stored);
+		TS_ASSERT_EQUALS(stream->size(), (int64)big.size());
+
+		// Sequential read through the whole member
+		TS_ASSERT(checkZipTestRead(stream.get(), big, 0, big.size()));
+		TS_ASSERT(!stream->eos());
+		byte b;
+		TS_ASSERT_EQUALS(stream->read(&b, 1), 0u);
+		TS_ASSERT(stream->eos());
+		TS_ASSERT(!stream->err());
+
+		// Seeking backwards, and forwards across checkpoints
+		TS_ASSERT(checkZipTestRead(stream.get(), big, 3 * 1024 * 1024 + 17, 4096));
+		TS_ASSERT(checkZipTestRead(stream.get(), big, 100, 2 * 1024 * 1024));
+		TS_ASSERT(checkZipTestRead(stream.get(), big, big.size() - 10, 10));
+		TS_ASSERT(checkZipTestRead(stream.get(), big, 1024 * 1024 - 1, 2));
+
+		// Interleaved reads from another member of the same archive
+		TS_ASSERT(checkZipTestRead(stored.get(), _members[2].data, 12345, 1000));
+		TS_ASSERT(checkZipTestRead(stream.get(), big, 4 * 1024 * 1024, 1000));
+		TS_ASSERT(checkZipTestRead(stored.get(), _members[2].data, 5, 10));
+
+		TS_ASSERT(!stream->seek(big.size() + 1, SEEK_SET));
+
+		// Members below the threshold are still cached in memory
+		Common::ScopedPtr<Common::SeekableReadStream> small(zip->createReadStreamForMember("small.bin"));
+		TS_ASSERT(small);
+		TS_ASSERT(checkZipTestRead(small.get(), _members[1].data, 0, _members[1].data.size()));
+	}
+};
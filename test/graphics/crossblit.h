@@ -0,0 +1,295 @@
+#include <cxxtest/TestSuite.h>
+#include "test/instrset_detect.h"
+
+#if defined(HAVE_CONFIG_H)
+#include "config.h"
+#endif
+
+#include "common/debug.h"
+#include "common/random.h"
+#include "common/system.h"
+
+#include "graphics/blit.h"
+#include "graphics/blit/blit-convert.h"
+
+#include "../null_osystem.h"
+
+#if NULL_OSYSTEM_IS_AVAILABLE
+#define BENCHMARK_TIME 1
+#else
+#define BENCHMARK_TIME 0
+#endif
+
+class CrossBlitTestSuite : public CxxTest::TestSuite {
+private:
+	enum {
+		kWidth = 37, // Not a multiple of any vector size
+		kHeight = 5,
+		kPadding = 12,
+		kBufferSize = (kWidth * 4 + kPadding * 2) * kHeight
+	};
+
+	static Graphics::PixelFormat getFormat(int i) {
+		static const Graphics::PixelFormat formats[] = {
+			Graphics::PixelFormat(4, 8, 8, 8, 8, 24, 16, 8, 0), // RGBA8888
+			Graphics::PixelFormat(4, 8, 8, 8, 8, 0, 8, 16, 24), // ABGR8888
+			Graphics::PixelFormat(4, 8, 8, 8, 8, 16, 8, 0, 24), // ARGB8888
+			Graphics::PixelFormat(4, 8, 8, 8, 0, 16, 8, 0, 0),  // XRGB8888
+			Graphics::PixelFormat(2, 5, 6, 5, 0, 11, 5, 0, 0),  // RGB565
+			Graphics::PixelFormat(2, 5, 5, 5, 0, 10, 5, 0, 0),  // RGB555
+			Graphics::PixelFormat(2, 4, 4, 4, 4, 12, 8, 4, 0)   // RGBA4444
+		};
+		return formats[i];
+	}
+
+	static const int kNumFormats = 7;
+
+	static uint32 readPixel(const byte *src, uint bytesPerPixel) {
+		return (bytesPerPixel == 2) ? *(const uint16 *)src : *(const uint32 *)src;
+	}
+
+	static void writePixel(byte *dst, uint32 color, uint bytesPerPixel) {
+		if (bytesPerPixel == 2)
+			*(uint16 *)dst = color;
+		else
+			*(uint32 *)dst = color;
+	}
+
+	// The conversion done by the generic code of crossBlit
+	static uint32 convertPixel(uint32 color, const Graphics::PixelFormat &dstFmt, const Graphics::PixelFormat &srcFmt) {
+		byte a, r, g, b;
+		srcFmt.colorToARGB(color, a, r, g, b);
+		return dstFmt.ARGBToColor(a, r, g, b);
+	}
+
+	static void fillSource(byte *src, uint pitch, const Graphics::PixelFormat &format, uint32 key, Common::RandomSource &rnd) {
+		for (int y = 0; y < kHeight; y++) {
+			for (int x = 0; x < kWidth; x++) {
+				uint32 color = rnd.getRandomNumber(0xFFFFFFFF);
+				if (format.bytesPerPixel == 2)
+					color &= 0xFFFF;
+				if ((x + y) % 5 == 0)
+					color = key;
+				writePixel(src + y * pitch + x * format.bytesPerPixel, color, format.bytesPerPixel);
+			}
+		}
+	}
+
+	void compareConvertFunc(Graphics::CrossBlitSIMD::ConvertFunc (*getConvertFunc)(const Graphics::CrossBlitSIMD::Params &, bool)) {
+		Common::RandomSource rnd("crossblit");
+
+		for (int s = 0; s < kNumFormats; s++) {
+			for (int d = 0; d < kNumFormats; d++) {
+				if (s == d)
+					continue;
+
+				const Graphics::PixelFormat srcFmt = getFormat(s);
+				const Graphics::PixelFormat dstFmt = getFormat(d);
+				const Graphics::CrossBlitSIMD::Params params(dstFmt, srcFmt);
+				TS_ASSERT(params.supported);
+
+				const uint srcPitch = kWidth * srcFmt.bytesPerPixel + kPadding;
+				const uint dstPitch = kWidth * dstFmt.bytesPerPixel + kPadding;
+				const uint32 key = (srcFmt.bytesPerPixel == 2) ? 0xF81F : 0xFF00FF00;
+
+				byte src[kBufferSize];
+				byte dst[kBufferSize];
+				fillSource(src, srcPitch, srcFmt, key, rnd);
+
+				for (int hasKey = 0; hasKey < 2; hasKey++) {
+					memset(dst, 0xA5, sizeof(dst));
+					getConvertFunc(params, hasKey != 0)(dst, src, dstPitch, srcPitch, kWidth, kHeight, params, key);
+
+					for (int y = 0; y < kHeight; y++) {
+						for (int x = 0; x < kWidth; x++) {
+							const uint32 color = readPixel(src + y * srcPitch + x * srcFmt.bytesPerPixel, srcFmt.bytesPerPixel);
+							const uint32 actual = readPixel(dst + y * dstPitch + x * dstFmt.bytesPerPixel, dstFmt.bytesPerPixel);
+							uint32 expected = convertPixel(color, dstFmt, srcFmt);
+							if (hasKey && color == key)
+								expected = 0xA5A5A5A5;
+							if (dstFmt.bytesPerPixel == 2)
+								expected &= 0xFFFF;
+							TS_ASSERT_EQUALS(actual, expected);
+						}
+					}
+
+					// The padding must be left alone
+					TS_ASSERT_EQUALS(dst[kWidth * dstFmt.bytesPerPixel], 0xA5);
+				}
+
+				// Convert in place, like Surface::convertToInPlace
+				if (dstFmt.bytesPerPixel >= srcFmt.bytesPerPixel) {
+					const uint pitch = srcPitch * dstFmt.bytesPerPixel / srcFmt.bytesPerPixel;
+					memset(dst, 0, sizeof(dst));
+					for (int y = 0; y < kHeight; y++)
+						memcpy(dst + y * srcPitch, src + y * srcPitch, kWidth * srcFmt.bytesPerPixel);
+
+					getConvertFunc(params, false)(dst, dst, pitch, srcPitch, kWidth, kHeight, params, 0);
+
+					for (int y = 0; y < kHeight; y++) {
+						for (int x = 0; x < kWidth; x++) {
+							const uint32 color = readPixel(src + y * srcPitch + x * srcFmt.bytesPerPixel, srcFmt.bytesPerPixel);
+							const uint32 actual = readPixel(dst + y * pitch + x * dstFmt.bytesPerPixel, dstFmt.bytesPerPixel);
+							uint32 expected = convertPixel(color, dstFmt, srcFmt);
+							if (dstFmt.bytesPerPixel == 2)
+								expected &= 0xFFFF;
+							TS_ASSERT_EQUALS(actual, expected);
+						}
+					}
+				}
+			}
+		}
+	}
+
+	void compareMapFunc(Graphics::CrossBlitSIMD::MapFunc (*getMapFunc)(uint)) {
+		Graphics::CrossBlitSIMD::MapFunc mapFunc = getMapFunc(4);
+		if (!mapFunc)
+			return;
+
+		Common::RandomSource rnd("crossblitmap");
+
+		uint32 map[256];
+		for (int i = 0; i < 256; i++)
+			map[i] = rnd.getRandomNumber(0xFFFFFFFF);
+
+		// Convert in place, like Surface::convertToInPlace
+		byte src[kWidth * kHeight];
+		byte dst[kWidth * kHeight * 4];
+		for (int i = 0; i < kWidth * kHeight; i++)
+			src[i] = dst[i] = rnd.getRandomNumber(255);
+
+		mapFunc(dst, dst, kWidth * 4, kWidth, kWidth, kHeight, map);
+
+		for (int i = 0; i < kWidth * kHeight; i++)
+			TS_ASSERT_EQUALS(*(uint32 *)(dst + i * 4), map[src[i]]);
+	}
+
+public:
+	void test_params() {
+		// Conversions between 32 bpp formats with 8 bit components move whole bytes
+		const Graphics::CrossBlitSIMD::Params rgbaToArgb(getFormat(2), getFormat(0));
+		TS_ASSERT(rgbaToArgb.supported);
+#ifndef SCUMM_BIG_ENDIAN
+		TS_ASSERT(rgbaToArgb.byteShuffle);
+#endif
+
+		const Graphics::CrossBlitSIMD::Params rgb565ToXrgb(getFormat(3), getFormat(4));
+		TS_ASSERT(rgb565ToXrgb.supported);
+		TS_ASSERT(!rgb565ToXrgb.byteShuffle);
+
+		// A single alpha bit isn't expanded like the other components
+		const Graphics::CrossBlitSIMD::Params argb1555ToRgba(getFormat(0), Graphics::PixelFormat(2, 5, 5, 5, 1, 10, 5, 0, 15));
+		TS_ASSERT(!argb1555ToRgba.supported);
+
+		const Graphics::CrossBlitSIMD::Params rgb888ToRgba(getFormat(0), Graphics::PixelFormat(3, 8, 8, 8, 0, 16, 8, 0, 0));
+		TS_ASSERT(!rgb888ToRgba.supported);
+	}
+
+	void test_convert_sse2() {
+#ifdef SCUMMVM_SSE2
+		if (instrset_detect() >= 2) {
+			compareConvertFunc(Graphics::CrossBlitSIMD::getConvertFuncSSE2);
+			compareMapFunc(Graphics::CrossBlitSIMD::getMapFuncSSE2);
+		}
+#endif
+	}
+
+	void test_convert_avx2() {
+#ifdef SCUMMVM_AVX2
+		if (instrset_detect() >= 8) {
+			compareConvertFunc(Graphics::CrossBlitSIMD::getConvertFuncAVX2);
+			compareMapFunc(Graphics::CrossBlitSIMD::getMapFuncAVX2);
+		}
+#endif
+	}
+
+	void test_convert_neon() {
+#ifdef SCUMMVM_NEON
+		compareConvertFunc(Graphics::CrossBlitSIMD::getConvertFuncNEON);
+		compareMapFunc(Graphics::CrossBlitSIMD::getMapFuncNEON);
+#endif
+	}
+
+	void test_crossblit_speed() {
+#if BENCHMARK_TIME
+		Common::install_null_g_system();
+
+		Graphics::CrossBlitSIMD::Extension best = Graphics::CrossBlitSIMD::kExtensionNone;
+#ifdef SCUMMVM_NEON
+		best = Graphics::CrossBlitSIMD::kExtensionNEON;
+#endif
+#ifdef SCUMMVM_SSE2
+		if (instrset_detect() >= 2)
+			best = Graphics::CrossBlitSIMD::kExtensionSSE2;
+#endif
+#ifdef SCUMMVM_AVX2
+		if (instrset_detect() >= 8)
+			best = Graphics::CrossBlitSIMD::kExtensionAVX2;
+#endif
+
+		const int w = 640, h = 480;
+#ifdef SLOW_TESTS
+		const int iters = 500;
+#else
+		const int iters = 1;
+#endif
+		byte *src = new byte[w * h * 4];
+		byte *dst = new byte[w * h * 4];
+		byte *expected = new byte[w * h * 4];
+
+		Common::RandomSource rnd("crossblitspeed");
+		for (int i = 0; i < w * h * 4; i++)
+			src[i] = rnd.getRandomNumber(255);
+
+		uint32 map[256];
+		for (int i = 0; i < 256; i++)
+			map[i] = rnd.getRandomNumber(0xFFFFFFFF);
+
+		static const struct {
+			const char *name;
+			int dst, src;
+		} pairs[] = {
+			{ "RGBA8888 -> ABGR8888", 1, 0 },
+			{ "RGBA8888 -> ARGB8888", 2, 0 },
+			{ "RGB565 -> XRGB8888", 3, 4 },
+			{ "XRGB8888 -> RGB565", 4, 3 },
+			{ "CLUT8 -> RGBA8888", -1, -1 }
+		};
+
+		for (int p = 0; p < ARRAYSIZE(pairs); p++) {
+			uint32 times[2];
+
+			for (int simd = 0; simd < 2; simd++) {
+				Graphics::CrossBlitSIMD::extension = simd ? best : Graphics::CrossBlitSIMD::kExtensionNone;
+
+				const uint32 start = g_system->getMillis();
+				for (int i = 0; i < iters; i++) {
+					if (pairs[p].src < 0) {
+						Graphics::crossBlitMap(dst, src, w * 4, w, w, h, 4, map);
+					} else {
+						const Graphics::PixelFormat dstFmt = getFormat(pairs[p].dst);
+						const Graphics::PixelFormat srcFmt = getFormat(pairs[p].src);
+						Graphics::crossBlit(dst, src, w * dstFmt.bytesPerPixel, w * srcFmt.bytesPerPixel, w, h, dstFmt, srcFmt);
+					}
+				}
+				times[simd] = g_system->getMillis() - start;
+
+				if (simd) {
+					TS_ASSERT_EQUALS(memcmp(dst, expected, w * h * 4), 0);
+				} else {
+					memcpy(expected, dst, w * h * 4);
+				}
+			}
+
+			debug("%s generic time for %d iters (in milliseconds): %u\n", pairs[p].name, iters, times[0]);
+			debug("%s SIMD time for %d iters (in milliseconds): %u\n", pairs[p].name, iters, times[1]);
+		}
+
+		Graphics::CrossBlitSIMD::extension = Graphics::CrossBlitSIMD::kExtensionUnknown;
+
+		delete[] src;
+		delete[] dst;
+		delete[] expected;
+#endif
+	}
+};
@@ -0,0 +1,160 @@
+#include <cxxtest/TestSuite.h>
+
+#include "common/debug.h"
+#include "common/random.h"
+#include "common/system.h"
+
+#include "graphics/palette.h"
+
+#include "../null_osystem.h"
+
+#if NULL_OSYSTEM_IS_AVAILABLE
+#define BENCHMARK_TIME 1
+#else
+#define BENCHMARK_TIME 0
+#endif
+
+class PaletteLookupTestSuite : public CxxTest::TestSuite {
+private:
+	static void makePalette(byte *palette, uint len, Common::RandomSource &rnd) {
+		for (uint i = 0; i < len * 3; i++)
+			palette[i] = rnd.getRandomNumber(255);
+
+		// Duplicate entries must resolve to the first one
+		if (len > 10)
+			memcpy(palette + 9 * 3, palette + 3 * 3, 3);
+	}
+
+	void checkColors(const byte *palette, uint len, Common::RandomSource &rnd) {
+		// The lookup searches all 256 entries, even the ones not set
+		Graphics::Palette reference(256);
+		reference.set(palette, 0, len);
+
+		Graphics::PaletteLookup lookup(palette, len);
+
+		for (int naive = 0; naive < 2; naive++) {
+			for (uint i = 0; i < 4096; i++) {
+				// A grid of colors including the cell corners, then random ones
+				byte r = (i >> 8) * 17, g = ((i >> 4) & 15) * 17, b = (i & 15) * 17;
+				if (i & 1) {
+					r = rnd.getRandomNumber(255);
+					g = rnd.getRandomNumber(255);
+					b = rnd.getRandomNumber(255);
+				}
+
+				const byte expected = reference.findBestColor(r, g, b, naive);
+				TS_ASSERT_EQUALS(lookup.findBestColor(r, g, b, naive), expected);
+			}
+		}
+	}
+
+public:
+	void test_find_best_color() {
+		Common::RandomSource rnd("palettelookup");
+		byte palette[256 * 3];
+
+		static const uint lengths[] = { 256, 16, 2, 1 };
+		for (int i = 0; i < ARRAYSIZE(lengths); i++) {
+			makePalette(palette, lengths[i], rnd);
+			checkColors(palette, lengths[i], rnd);
+		}
+
+		// A palette with an even spread of colors
+		for (uint i = 0; i < 256; i++) {
+			palette[i * 3 + 0] = (i >> 5) * 36;
+			palette[i * 3 + 1] = ((i >> 2) & 7) * 36;
+			palette[i * 3 + 2] = (i & 3) * 85;
+		}
+		checkColors(palette, 256, rnd);
+	}
+
+	void test_set_palette() {
+		Common::RandomSource rnd("palettelookup");
+		byte palette[256 * 3];
+		makePalette(palette, 256, rnd);
+
+		Graphics::PaletteLookup lookup(palette, 256);
+		const byte before = lookup.findBestColor(10, 20, 30);
+
+		// The table has to be rebuilt for the new palette
+		memcpy(palette + before * 3, palette + (byte)(before + 1) * 3, 3);
+		TS_ASSERT(lookup.setPalette(palette, 256));
+		TS_ASSERT(!lookup.setPalette(palette, 256));
+
+		Graphics::Palette reference(palette, 256);
+		TS_ASSERT_EQUALS(lookup.findBestColor(10, 20, 30), reference.findBestColor(10, 20, 30));
+	}
+
+	void test_find_best_colors() {
+		Common::RandomSource rnd("palettelookup");
+		byte palette[256 * 3];
+		makePalette(palette, 256, rnd);
+
+		Graphics::PaletteLookup lookup(palette, 256);
+
+		byte src[64 * 3];
+		for (int i = 0; i < ARRAYSIZE(src); i++)
+			src[i] = rnd.getRandomNumber(255);
+		// A run of the same color
+		for (int i = 10; i < 20; i++)
+			memcpy(src + i * 3, src + 9 * 3, 3);
+
+		for (int naive = 0; naive < 2; naive++) {
+			byte dst[64];
+			lookup.findBestColors(dst, src, 64, naive);
+			for (int i = 0; i < 64; i++)
+				TS_ASSERT_EQUALS(dst[i], lookup.findBestColor(src[i * 3], src[i * 3 + 1], src[i * 3 + 2], naive));
+		}
+	}
+
+	void test_find_best_colors_speed() {
+#if BENCHMARK_TIME
+		Common::install_null_g_system();
+
+		const int w = 320, h = 240;
+#ifdef SLOW_TESTS
+		const int iters = 100;
+#else
+		const int iters = 1;
+#endif
+		Common::RandomSource rnd("palettelookupspeed");
+
+		byte palette[256 * 3];
+		makePalette(palette, 256, rnd);
+		Graphics::Palette reference(palette, 256);
+
+		// A noisy gradient, which has a lot of distinct colors
+		byte *src = new byte[w * h * 3];
+		for (int y = 0; y < h; y++) {
+			for (int x = 0; x < w; x++) {
+				byte *pixel = src + (y * w + x) * 3;
+				pixel[0] = x * 255 / w;
+				pixel[1] = y * 255 / h;
+				pixel[2] = rnd.getRandomNumber(255);
+			}
+		}
+
+		byte *dst = new byte[w];
+
+		uint32 start = g_system->getMillis();
+		for (int i = 0; i < iters; i++) {
+			for (int p = 0; p < w * h; p++)
+				dst[p % w] = reference.findBestColor(src[p * 3], src[p * 3 + 1], src[p * 3 + 2]);
+		}
+		const uint32 scanTime = g_system->getMillis() - start;
+
+		start = g_system->getMillis();
+		for (int i = 0; i < iters; i++) {
+			Graphics::PaletteLookup lookup(palette, 256);
+			for (int y = 0; y < h; y++)
+				lookup.findBestColors(dst, src + y * w * 3, w);
+		}
+		const uint32 lookupTime = g_system->getMillis() - start;
+
+		debug("Palette::findBestColor: %d ms, PaletteLookup::findBestColors: %d ms", scanTime, lookupTime);
+
+		delete[] src;
+		delete[] dst;
+#endif
+	}
+};
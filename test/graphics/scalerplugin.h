@@ -0,0 +1,130 @@
+/* ScummVM - Graphic Adventure Engine
+ *
+ * ScummVM is the legal property of its developers, whose names
+ * are too numerous to list here. Please refer to the COPYRIGHT
+ * file distributed with this source distribution.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include <cxxtest/TestSuite.h>
+
+#include "common/array.h"
+#include "common/threadpool.h"
+
+#include "graphics/scalerplugin.h"
+#ifdef USE_SCALERS
+#include "graphics/scaler/scalebit.h"
+#include "graphics/scaler/sai.h"
+#include "graphics/scaler/tv.h"
+#endif
+#ifdef USE_HQ_SCALERS
+#include "graphics/scaler/hq.h"
+#endif
+#ifdef USE_EDGE_SCALERS
+#include "graphics/scaler/edge.h"
+#endif
+
+#include "../null_osystem.h"
+
+class ScalerPluginTestSuite : public CxxTest::TestSuite {
+	static const int kWidth = 160;
+	static const int kHeight = 120;
+	static const int kPadding = 4;
+	static const int kNumBands = 4;
+
+	/**
+	 * Scale a few rects of a changing image with scale() and scaleBands()
+	 * and check that both produce the same pixels.
+	 */
+	template<class S>
+	void checkBands(const Graphics::PixelFormat &format, uint factor, bool oldSource) {
+		const int bpp = format.bytesPerPixel;
+		const uint32 srcPitch = (kWidth + 2 * kPadding) * bpp;
+		const uint32 dstPitch = kWidth * factor * bpp;
+
+		Common::Array<byte> src(srcPitch * (kHeight + 2 * kPadding));
+		uint32 seed = 1;
+		for (uint i = 0; i < src.size(); i++) {
+			seed = seed * 1103515245 + 12345;
+			// Mix flat areas with noise, so edge detecting scalers do some work
+			src[i] = ((i / bpp / 5) % 4) ? (byte)(i / srcPitch * 8) : (byte)(seed >> 16);
+		}
+
+		S serial(format), banded(format);
+		Common::Array<Scaler *> bands;
+		for (int i = 0; i < kNumBands; i++)
+			bands.push_back(new S(format));
+
+		serial.setFactor(factor);
+		banded.setFactor(factor);
+		if (oldSource) {
+			serial.enableSource(true);
+			serial.setSource(src.begin(), srcPitch, kWidth, kHeight, kPadding);
+			banded.enableSource(true);
+			banded.setSource(src.begin(), srcPitch, kWidth, kHeight, kPadding);
+		}
+
+		Common::Array<byte> serialDst(dstPitch * kHeight * factor);
+		Common::Array<byte> bandedDst(dstPitch * kHeight * factor);
+
+		Common::ThreadPool pool;
+		for (int frame = 0; frame < 3; frame++) {
+			const int x = frame * 8;
+			const int y = frame * 5;
+			const int w = kWidth - x - 3;
+			const int h = kHeight - y - 2;
+			const byte *srcPtr = src.begin() + (kPadding + y) * srcPitch + (kPadding + x) * bpp;
+			const uint32 dstOffset = y * factor * dstPitch + x * factor * bpp;
+
+			serial.scale(srcPtr, srcPitch, serialDst.begin() + dstOffset, dstPitch, w, h, x, y);
+			banded.scaleBands(pool, bands.begin(), bands.size(), srcPtr, srcPitch, bandedDst.begin() + dstOffset, dstPitch, w, h, x, y);
+			TS_ASSERT(serialDst == bandedDst);
+
+			for (int i = 0; i < 500; i++) {
+				seed = seed * 1103515245 + 12345;
+				src[kPadding * srcPitch + (seed >> 8) % (kHeight * srcPitch)] ^= (byte)(seed >> 16);
+			}
+		}
+
+		for (uint i = 0; i < bands.size(); i++)
+			delete bands[i];
+	}
+
+public:
+	void test_scale_bands() {
+		Common::install_null_g_system();
+
+		const Graphics::PixelFormat format16(2, 5, 6, 5, 0, 11, 5, 0, 0);
+		const Graphics::PixelFormat format32(4, 8, 8, 8, 8, 24, 16, 8, 0);
+
+#ifdef USE_SCALERS
+		checkBands<AdvMameScaler>(format16, 2, false);
+		checkBands<AdvMameScaler>(format16, 3, false);
+		checkBands<AdvMameScaler>(format16, 4, false);
+		checkBands<AdvMameScaler>(format32, 4, false);
+		checkBands<SuperSAIScaler>(format16, 2, false);
+		checkBands<TVScaler>(format32, 2, false);
+#endif
+#ifdef USE_HQ_SCALERS
+		checkBands<HQScaler>(format16, 2, false);
+		checkBands<HQScaler>(format32, 3, false);
+#endif
+#ifdef USE_EDGE_SCALERS
+		checkBands<EdgeScaler>(format16, 2, true);
+		checkBands<EdgeScaler>(format32, 3, true);
+#endif
+	}
+};
@@ -0,0 +1,115 @@
+#include <cxxtest/TestSuite.h>
+
+#include "common/config-manager.h"
+#include "common/scummsys.h"
+
+#include "graphics/surface.h"
+
+#include "../null_osystem.h"
+
+#if defined(USE_TINYGL) && THREADED_NULL_OSYSTEM_IS_AVAILABLE
+#define TEST_TINYGL 1
+#include "graphics/tinygl/tinygl.h"
+#include "graphics/tinygl/zgl.h"
+#else
+#define TEST_TINYGL 0
+#endif
+
+class TinyGLTestSuite : public CxxTest::TestSuite {
+#if TEST_TINYGL
+private:
+	enum {
+		kWidth = 80,
+		kHeight = 100 // Not a multiple of the tile height
+	};
+
+	static void drawTriangle(float x, float y, float size, float z, float r, float g, float b, float a) {
+		tglBegin(TGL_TRIANGLES);
+		tglColor4f(r, g, b, a);
+		tglVertex3f(x, y + size, z);
+		tglColor4f(g, b, r, a);
+		tglVertex3f(x - size, y - size, z);
+		tglColor4f(b, r, g, a);
+		tglVertex3f(x + size, y - size, z);
+		tglEnd();
+	}
+
+	// Renders a few frames with depth testing, blending and a blit, and
+	// appends their pixels to the frames array
+	void renderFrames(bool threads, bool dirtyRects, Common::Array<byte> &frames) {
+		ConfMan.setBool("tinygl_threads", threads, Common::ConfigManager::kTransientDomain);
+
+		const Graphics::PixelFormat format(4, 8, 8, 8, 8, 24, 16, 8, 0);
+		TinyGL::createContext(kWidth, kHeight, format, 256, true, dirtyRects);
+		TS_ASSERT_EQUALS(TinyGL::gl_get_context()->_tileRenderer != nullptr, threads);
+
+		Graphics::Surface image;
+		image.create(16, 40, format);
+		for (int y = 0; y < image.h; y++) {
+			for (int x = 0; x < image.w; x++)
+				image.setPixel(x, y, format.ARGBToColor(255, x * 16, y * 6, 128));
+		}
+		TinyGL::BlitImage *blitImage = tglGenBlitImage();
+		tglUploadBlitImage(blitImage, image, 0, false);
+		image.free();
+
+		tglViewport(0, 0, kWidth, kHeight);
+		tglMatrixMode(TGL_PROJECTION);
+		tglLoadIdentity();
+		tglMatrixMode(TGL_MODELVIEW);
+		tglLoadIdentity();
+
+		for (int frame = 0; frame < 3; frame++) {
+			tglClearColor(0.1f, 0.2f, 0.3f, 1.0f);
+			tglClearDepth(1.0);
+			tglClear(TGL_COLOR_BUFFER_BIT | TGL_DEPTH_BUFFER_BIT);
+
+			tglEnable(TGL_DEPTH_TEST);
+			tglDepthFunc(TGL_LESS);
+			tglDisable(TGL_BLEND);
+			drawTriangle(-0.2f + frame * 0.1f, 0.1f, 0.7f, 0.5f, 1.0f, 0.5f, 0.0f, 1.0f);
+			drawTriangle(0.3f, -0.2f, 0.6f, 0.0f, 0.0f, 0.8f, 0.3f, 1.0f);
+
+			// Blits are executed between the tiled draw calls
+			tglBlit(blitImage, 10 + frame * 7, 30);
+
+			tglEnable(TGL_BLEND);
+			tglBlendFunc(TGL_SRC_ALPHA, TGL_ONE_MINUS_SRC_ALPHA);
+			tglDisable(TGL_DEPTH_TEST);
+			drawTriangle(0.0f, 0.0f, 0.9f, -0.5f, 0.2f, 0.4f, 1.0f, 0.5f);
+
+			TinyGL::presentBuffer();
+
+			Graphics::Surface surface;
+			TinyGL::getSurfaceRef(surface);
+			for (int y = 0; y < surface.h; y++) {
+				const byte *row = (const byte *)surface.getBasePtr(0, y);
+				for (int x = 0; x < surface.w * surface.format.bytesPerPixel; x++)
+					frames.push_back(row[x]);
+			}
+		}
+
+		tglDeleteBlitImage(blitImage);
+		TinyGL::destroyContext();
+	}
+#endif
+
+public:
+	void test_tiled_rendering() {
+#if TEST_TINYGL
+		Common::install_threaded_null_g_system();
+
+		for (int dirtyRects = 0; dirtyRects < 2; dirtyRects++) {
+			Common::Array<byte> expected, actual;
+			renderFrames(false, dirtyRects, expected);
+			renderFrames(true, dirtyRects, actual);
+
+			TS_ASSERT_EQUALS(expected.size(), actual.size());
+			if (expected.size() == actual.size())
+				TS_ASSERT_SAME_DATA(expected.begin(), actual.begin(), expected.size());
+		}
+
+		ConfMan.removeKey("tinygl_threads", Common::ConfigManager::kTransientDomain);
+#endif
+	}
+};
@@ -0,0 +1,157 @@
+#include <cxxtest/TestSuite.h>
+
+#include "common/file.h"
+#include "common/scummsys.h"
+
+#include "graphics/font.h"
+#include "graphics/fonts/ttf.h"
+#include "graphics/surface.h"
+
+#include "../null_osystem.h"
+
+#if NULL_OSYSTEM_IS_AVAILABLE && defined(USE_FREETYPE2)
+#define TEST_TTF 1
+#else
+#define TEST_TTF 0
+#endif
+
+class TTFFontTestSuite : public CxxTest::TestSuite {
+#if TEST_TTF
+private:
+	Graphics::Font *loadFont() {
+		Common::install_null_g_system();
+
+		Common::File file;
+		if (!file.open("LiberationSans-Regular.ttf")) {
+			TS_FAIL("LiberationSans-Regular.ttf not found");
+			return nullptr;
+		}
+		return Graphics::loadTTFFont(file, 16);
+	}
+
+	// Lays the string out one character at a time, the way Font does for
+	// fonts without text runs
+	template<class StringType>
+	void checkRun(const Graphics::Font &font, const StringType &str) {
+		const Graphics::Font::TextRun *run = font.getTextRun(str);
+		TS_ASSERT(run);
+		if (!run)
+			return;
+
+		TS_ASSERT_EQUALS(run->penX.size(), str.size());
+		TS_ASSERT_EQUALS(run->boxes.size(), str.size());
+		if (run->penX.size() != str.size() || run->boxes.size() != str.size())
+			return;
+
+		int x = 0;
+		uint32 last = 0;
+		for (uint i = 0; i < str.size(); ++i) {
+			const uint32 cur = (typename StringType::unsigned_type)str[i];
+			x += font.getKerningOffset(last, cur);
+			last = cur;
+
+			TS_ASSERT_EQUALS(run->penX[i], x);
+			TS_ASSERT_EQUALS(run->boxes[i], font.getBoundingBox(cur));
+			x += font.getCharWidth(cur);
+		}
+		TS_ASSERT_EQUALS(run->width, x);
+	}
+
+	void drawReference(const Graphics::Font &font, Graphics::Surface &dst, const Common::String &str,
+			int x, int y, int w, uint32 color, Graphics::TextAlign align) {
+		const int leftX = x, rightX = x + w + 1;
+		int width = 0;
+		uint32 last = 0;
+		for (uint i = 0; i < str.size(); ++i) {
+			const uint32 cur = (byte)str[i];
+			width += font.getKerningOffset(last, cur) + font.getCharWidth(cur);
+			last = cur;
+		}
+
+		if (align == Graphics::kTextAlignCenter)
+			x = x + (w - width) / 2;
+		else if (align == Graphics::kTextAlignRight)
+			x = x + w - width;
+
+		last = 0;
+		for (uint i = 0; i < str.size(); ++i) {
+			const uint32 cur = (byte)str[i];
+			x += font.getKerningOffset(last, cur);
+			last = cur;
+
+			const Common::Rect charBox = font.getBoundingBox(cur);
+			if (x + charBox.right > rightX)
+				break;
+			if (x + charBox.right >= leftX)
+				font.drawChar(&dst, cur, x, y, color);
+			x += font.getCharWidth(cur);
+		}
+	}
+#endif
+
+public:
+	void test_text_run_layout() {
+#if TEST_TTF
+		Graphics::Font *font = loadFont();
+		if (!font)
+			return;
+
+		static const char *const lines[] = {
+			"", "A", "AVATAR", "Wave To", "Hello, World!", "fi ffl \xe9t\xe9"
+		};
+
+		for (int i = 0; i < ARRAYSIZE(lines); ++i) {
+			checkRun(*font, Common::String(lines[i]));
+			checkRun(*font, Common::U32String(lines[i], Common::kISO8859_1));
+			TS_ASSERT_EQUALS(font->getStringWidth(lines[i]), font->getTextRun(Common::String(lines[i]))->width);
+		}
+
+		// More strings than the cache holds, twice, so runs get evicted and
+		// laid out again
+		for (int pass = 0; pass < 2; ++pass) {
+			for (int i = 0; i < 300; ++i)
+				checkRun(*font, Common::String::format("Line %d: AVA", i));
+		}
+
+		delete font;
+#endif
+	}
+
+	void test_draw_string() {
+#if TEST_TTF
+		Graphics::Font *font = loadFont();
+		if (!font)
+			return;
+
+		static const Graphics::TextAlign aligns[] = {
+			Graphics::kTextAlignLeft, Graphics::kTextAlignCenter, Graphics::kTextAlignRight
+		};
+		static const int widths[] = { 200, 60 };
+		const Common::String str("AVATAR, Wave To!");
+
+		for (int format = 0; format < 2; ++format) {
+			const Graphics::PixelFormat pixelFormat = format ? Graphics::PixelFormat(4, 8, 8, 8, 8, 24, 16, 8, 0) : Graphics::PixelFormat::createFormatCLUT8();
+			const uint32 color = format ? pixelFormat.ARGBToColor(255, 255, 255, 255) : 15;
+
+			for (int a = 0; a < ARRAYSIZE(aligns); ++a) {
+				for (int w = 0; w < ARRAYSIZE(widths); ++w) {
+					Graphics::Surface expected, actual;
+					expected.create(240, 30, pixelFormat);
+					actual.create(240, 30, pixelFormat);
+
+					drawReference(*font, expected, str, 10, 5, widths[w], color, aligns[a]);
+					font->drawString(&actual, str, 10, 5, widths[w], color, aligns[a]);
+
+					for (int y = 0; y < expected.h; ++y)
+						TS_ASSERT_SAME_DATA(expected.getBasePtr(0, y), actual.getBasePtr(0, y), expected.w * pixelFormat.bytesPerPixel);
+
+					expected.free();
+					actual.free();
+				}
+			}
+		}
+
+		delete font;
+#endif
+	}
+};
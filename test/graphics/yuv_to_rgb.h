@@ -0,0 +1,149 @@
+/* ScummVM - Graphic Adventure Engine
+ *
+ * ScummVM is the legal property of its developers, whose names
+ * are too numerous to list here. Please refer to the COPYRIGHT
+ * file distributed with this source distribution.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include <cxxtest/TestSuite.h>
+#include "test/instrset_detect.h"
+
+#if defined(HAVE_CONFIG_H)
+#include "config.h"
+#endif
+
+#include "common/random.h"
+
+#include "graphics/yuv_to_rgb.h"
+#include "graphics/yuv_to_rgb_intern.h"
+
+class YUVToRGBTestSuite : public CxxTest::TestSuite {
+private:
+	enum {
+		kWidth = 70, // Not a multiple of any vector size
+		kHeight = 6,
+		kPitch = kWidth + 3
+	};
+
+	// The conversion done by the lookup tables of YUVToRGBManager
+	static uint32 convertPixel(byte y, byte u, byte v, Graphics::YUVToRGBManager::LuminanceScale scale, const Graphics::PixelFormat &format) {
+		const int cb = u - 128, cr = v - 128;
+		int rgb[3] = {
+			y + (int16)((0.419 / 0.299) * cr),
+			y + (int16)(-(0.299 / 0.419) * cr) + (int16)(-(0.114 / 0.331) * cb),
+			y + (int16)((0.587 / 0.331) * cb)
+		};
+
+		for (int i = 0; i < 3; i++) {
+			if (scale == Graphics::YUVToRGBManager::kScaleITU)
+				rgb[i] = (CLIP(rgb[i], 16, 235) - 16) * 255 / 219;
+			else
+				rgb[i] = CLIP(rgb[i], 0, 255);
+		}
+
+		return format.RGBToColor(rgb[0], rgb[1], rgb[2]);
+	}
+
+	// Compare the components of two pixels, allowing the SIMD kernels to round differently
+	static bool closeEnough(uint32 a, uint32 b, const Graphics::PixelFormat &format) {
+		const uint shifts[] = { format.rShift, format.gShift, format.bShift, format.aShift };
+		const uint losses[] = { format.rLoss, format.gLoss, format.bLoss, format.aLoss };
+
+		for (int i = 0; i < 4; i++) {
+			const int mask = 0xFF >> losses[i];
+			const int diff = (int)((a >> shifts[i]) & mask) - (int)((b >> shifts[i]) & mask);
+			if (ABS(diff) > 1)
+				return false;
+		}
+
+		return true;
+	}
+
+	void compareRowFunc(Graphics::YUVToRGBSIMD::RowFunc (*getRowFunc)(uint, Graphics::YUVToRGBManager::LuminanceScale, bool)) {
+		static const Graphics::PixelFormat formats[] = {
+			Graphics::PixelFormat(2, 5, 6, 5, 0, 11, 5, 0, 0),
+			Graphics::PixelFormat(2, 5, 5, 5, 1, 10, 5, 0, 15),
+			Graphics::PixelFormat(4, 8, 8, 8, 8, 24, 16, 8, 0),
+			Graphics::PixelFormat(4, 8, 8, 8, 8, 16, 8, 0, 24),
+			Graphics::PixelFormat(4, 8, 8, 8, 0, 0, 8, 16, 0)
+		};
+
+		Common::RandomSource rnd("yuv_to_rgb");
+
+		// The chroma planes of 444 need a full row of values
+		byte ySrc[kPitch * kHeight], uSrc[kPitch * kHeight], vSrc[kPitch * kHeight];
+
+		// Include the extreme values to check clipping
+		for (int i = 0; i < kPitch * kHeight; i++) {
+			ySrc[i] = (i % 17 == 0) ? 0 : (i % 19 == 0) ? 255 : rnd.getRandomNumber(255);
+			uSrc[i] = (i % 13 == 0) ? 0 : (i % 11 == 0) ? 255 : rnd.getRandomNumber(255);
+			vSrc[i] = (i % 7 == 0) ? 0 : (i % 23 == 0) ? 255 : rnd.getRandomNumber(255);
+		}
+
+		for (int f = 0; f < ARRAYSIZE(formats); f++) {
+			const Graphics::PixelFormat &format = formats[f];
+			const Graphics::YUVToRGBSIMD::Params params(format);
+
+			for (int s = 0; s < 2; s++) {
+				const Graphics::YUVToRGBManager::LuminanceScale scale = s ? Graphics::YUVToRGBManager::kScaleITU : Graphics::YUVToRGBManager::kScaleFull;
+
+				for (int subsampled = 0; subsampled < 2; subsampled++) {
+					Graphics::YUVToRGBSIMD::RowFunc simd = getRowFunc(format.bytesPerPixel, scale, subsampled != 0);
+					if (!simd)
+						continue;
+
+					Graphics::Surface actual;
+					actual.create(kWidth, kHeight, format);
+
+					for (int y = 0; y < kHeight; y++) {
+						const int width = simd((byte *)actual.getBasePtr(0, y), ySrc + y * kPitch, uSrc + y * kPitch, vSrc + y * kPitch, kWidth, params);
+						TS_ASSERT_LESS_THAN_EQUALS(kWidth - 16, width);
+
+						for (int x = 0; x < width; x++) {
+							const int uvX = subsampled ? (x >> 1) : x;
+							const uint32 expected = convertPixel(ySrc[y * kPitch + x], uSrc[y * kPitch + uvX], vSrc[y * kPitch + uvX], scale, format);
+							TS_ASSERT(closeEnough(expected, actual.getPixel(x, y), format));
+						}
+					}
+
+					actual.free();
+				}
+			}
+		}
+	}
+
+public:
+	void test_convert_sse2() {
+#ifdef SCUMMVM_SSE2
+		if (instrset_detect() >= 2)
+			compareRowFunc(Graphics::YUVToRGBSIMD::getRowFuncSSE2);
+#endif
+	}
+
+	void test_convert_avx2() {
+#ifdef SCUMMVM_AVX2
+		if (instrset_detect() >= 8)
+			compareRowFunc(Graphics::YUVToRGBSIMD::getRowFuncAVX2);
+#endif
+	}
+
+	void test_convert_neon() {
+#ifdef SCUMMVM_NEON
+		compareRowFunc(Graphics::YUVToRGBSIMD::getRowFuncNEON);
+#endif
+	}
+};
@@ -5,7 +5,7 @@
 #
 ######################################################################
 
-TESTS        := $(srcdir)/test/common/*.h $(srcdir)/test/common/formats/*.h $(srcdir)/test/audio/*.h $(srcdir)/test/math/*.h $(srcdir)/test/image/*.h
+TESTS        := $(srcdir)/test/common/*.h $(srcdir)/test/common/formats/*.h $(srcdir)/test/audio/*.h $(srcdir)/test/math/*.h $(srcdir)/test/image/*.h $(srcdir)/test/graphics/*.h $(srcdir)/test/video/*.h $(srcdir)/test/backends/*.h
 TEST_LIBS    :=
 
 ifdef POSIX
@@ -15,7 +15,8 @@ TEST_LIBS += test/null_osystem.o \
 	backends/fs/posix/posix-iostream.o \
 	backends/fs/abstract-fs.o \
 	backends/fs/stdiostream.o \
-	backends/modular-backend.o
+	backends/modular-backend.o \
+	backends/timer/default/default-timer.o
 endif
 
 ifdef WIN32
@@ -25,10 +26,11 @@ TEST_LIBS += test/null_osystem.o \
 	backends/fs/abstract-fs.o \
 	backends/fs/stdiostream.o \
 	backends/modular-backend.o \
+	backends/timer/default/default-timer.o \
 	backends/platform/sdl/win32/win32_wrapper.o
 endif
 
-TEST_LIBS +=	audio/libaudio.a math/libmath.a common/formats/libformats.a common/compression/libcompression.a common/libcommon.a image/libimage.a graphics/libgraphics.a
+TEST_LIBS +=	video/libvideo.a audio/libaudio.a math/libmath.a common/formats/libformats.a common/compression/libcompression.a common/libcommon.a image/libimage.a graphics/libgraphics.a
 
 ifeq ($(ENABLE_WINTERMUTE), STATIC_PLUGIN)
 	TESTS += $(srcdir)/test/engines/wintermute/*.h
@@ -81,13 +83,17 @@ test/runner.cpp: $(TESTS) $(srcdir)/test/module.mk
 
 clean: clean-test
 clean-test:
-	-$(RM) test/runner.cpp test/runner test/engine-data/encoding.dat test/null_osystem.o
+	-$(RM) test/runner.cpp test/runner test/engine-data/encoding.dat test/engine-data/LiberationSans-Regular.ttf test/null_osystem.o
 	-rmdir test/engine-data
 
 test/engine-data/encoding.dat: $(srcdir)/dists/engine-data/encoding.dat
 	$(MKDIR) test/engine-data
 	$(CP) $(srcdir)/dists/engine-data/encoding.dat test/engine-data/encoding.dat
 
-copy-dat: test/engine-data/encoding.dat
+test/engine-data/LiberationSans-Regular.ttf: $(srcdir)/gui/themes/fonts/LiberationSans-Regular.ttf
+	$(MKDIR) test/engine-data
+	$(CP) $(srcdir)/gui/themes/fonts/LiberationSans-Regular.ttf test/engine-data/LiberationSans-Regular.ttf
+
+copy-dat: test/engine-data/encoding.dat test/engine-data/LiberationSans-Regular.ttf
 
 .PHONY: test clean-test copy-dat
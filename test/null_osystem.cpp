@@ -2,6 +2,10 @@
 #define NULL_DRIVER_USE_FOR_TEST 1
 #include "null_osystem.h"
 #include "../backends/platform/null/null.cpp"
+#ifdef POSIX
+#include "../backends/mutex/pthread/pthread-mutex.cpp"
+#include "../backends/threads/pthread/pthread-threads.cpp"
+#endif
 
 //#define DISPLAY_ERROR_MESSAGES
 
@@ -15,6 +19,18 @@ void Common::install_null_g_system() {
 	g_system = OSystem_NULL_create(silenceLogs);
 }
 
+#ifdef POSIX
+void Common::install_threaded_null_g_system() {
+#ifdef DISPLAY_ERROR_MESSAGES
+	const bool silenceLogs = false;
+#else
+	const bool silenceLogs = true;
+#endif
+
+	g_system = OSystem_NULL_create(silenceLogs, true);
+}
+#endif
+
 bool BaseBackend::setScaler(const char *name, int factor) {
 	return false;
 }
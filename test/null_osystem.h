@@ -7,5 +7,13 @@ void install_null_g_system();
 #else
 #define NULL_OSYSTEM_IS_AVAILABLE 0
 #endif
+
+// Same as install_null_g_system(), with real threads and mutexes
+#if defined(POSIX)
+void install_threaded_null_g_system();
+#define THREADED_NULL_OSYSTEM_IS_AVAILABLE 1
+#else
+#define THREADED_NULL_OSYSTEM_IS_AVAILABLE 0
+#endif
 }
 #endif
@@ -0,0 +1,181 @@
+#include <cxxtest/TestSuite.h>
+
+#include "video/video_decoder.h"
+#include "graphics/surface.h"
+#include "../null_osystem.h"
+
+namespace {
+
+// Video with a single track, whose frames are filled with their number.
+// With packets, the track only decodes the frames read by readNextPacket().
+class TestVideoDecoder : public Video::VideoDecoder {
+public:
+	TestVideoDecoder() : _packets(false), _packetsRead(0) {}
+	~TestVideoDecoder() override { close(); }
+
+	bool loadStream(Common::SeekableReadStream *stream) override { return false; }
+
+	void load(int frameCount, bool packets = false) {
+		close();
+		_packets = packets;
+		_packetsRead = 0;
+		addTrack(new TestVideoTrack(frameCount, packets));
+	}
+
+	int getPacketsRead() const { return _packetsRead; }
+
+protected:
+	bool canDecodeAhead() const override { return !_packets; }
+	bool canReadPacketsAhead() const override { return _packets; }
+
+	void readNextPacket() override {
+		TestVideoTrack *track = (TestVideoTrack *)getTrack(0);
+		if (!_packets || track->endOfTrack())
+			return;
+
+		track->_packet = track->getCurFrame() + 1;
+		_packetsRead++;
+	}
+
+private:
+	bool _packets;
+	int _packetsRead;
+
+	class TestVideoTrack : public VideoTrack {
+	public:
+		TestVideoTrack(int frameCount, bool packets) : _frameCount(frameCount), _curFrame(-1), _packets(packets), _packet(-1) {
+			_surface.create(4, 4, Graphics::PixelFormat::createFormatCLUT8());
+		}
+		~TestVideoTrack() override { _surface.free(); }
+
+		bool endOfTrack() const override { return _curFrame + 1 >= _frameCount; }
+		uint16 getWidth() const override { return _surface.w; }
+		uint16 getHeight() const override { return _surface.h; }
+		Graphics::PixelFormat getPixelFormat() const override { return _surface.format; }
+		int getCurFrame() const override { return _curFrame; }
+		int getFrameCount() const override { return _frameCount; }
+		uint32 getNextFrameStartTime() const override { return (_curFrame + 1) * 10; }
+		bool isRewindable() const override { return true; }
+		bool rewind() override { _curFrame = -1; return true; }
+
+		const Graphics::Surface *decodeNextFrame() override {
+			_curFrame++;
+			// Without its packet, the frame is left with the wrong number
+			if (!_packets || _packet == _curFrame)
+				_surface.fillRect(Common::Rect(_surface.w, _surface.h), (uint32)_curFrame);
+			_packet = -1;
+			return &_surface;
+		}
+
+	private:
+		Graphics::Surface _surface;
+		int _frameCount;
+		int _curFrame;
+		bool _packets;
+
+	public:
+		int _packet;
+	};
+};
+
+} // End of anonymous namespace
+
+class DecodeAheadTestSuite : public CxxTest::TestSuite {
+public:
+	// Check that the next frames are the given ones, as seen by the caller
+	void checkFrames(TestVideoDecoder &decoder, int first, int last) {
+		for (int i = first; i <= last; i++) {
+			TS_ASSERT(!decoder.endOfVideo());
+			TS_ASSERT_EQUALS(decoder.getCurFrame(), i - 1);
+
+			const Graphics::Surface *frame = decoder.decodeNextFrame();
+			TS_ASSERT(frame);
+			if (!frame)
+				return;
+
+			TS_ASSERT_EQUALS(*(const byte *)frame->getPixels(), i);
+			TS_ASSERT_EQUALS(decoder.getCurFrame(), i);
+		}
+	}
+
+	void test_synchronous() {
+#if NULL_OSYSTEM_IS_AVAILABLE
+		Common::install_null_g_system();
+		TestVideoDecoder decoder;
+		decoder.load(10);
+
+		// Without threads, frames are decoded when they are needed
+		TS_ASSERT(!decoder.setDecodeAhead(3));
+		checkFrames(decoder, 0, 9);
+		TS_ASSERT(decoder.endOfVideo());
+		TS_ASSERT_EQUALS(decoder.getDecodeStats().framesDecoded, 10u);
+#endif
+	}
+
+	void test_decode_ahead() {
+#if THREADED_NULL_OSYSTEM_IS_AVAILABLE
+		Common::install_threaded_null_g_system();
+		{
+			TestVideoDecoder decoder;
+			decoder.load(20);
+
+			TS_ASSERT(decoder.setDecodeAhead(3));
+			checkFrames(decoder, 0, 9);
+
+			// Frames decoded ahead are dropped when rewinding
+			TS_ASSERT(decoder.rewind());
+			checkFrames(decoder, 0, 19);
+			TS_ASSERT(decoder.endOfVideo());
+			TS_ASSERT(!decoder.decodeNextFrame());
+
+			Video::VideoDecoder::DecodeStats stats = decoder.getDecodeStats();
+			TS_ASSERT_EQUALS(stats.framesDecoded, 30u);
+			TS_ASSERT_LESS_THAN_EQUALS(stats.maxQueueDepth, 3u);
+		}
+		Common::install_null_g_system();
+#endif
+	}
+
+	void test_decode_ahead_packets() {
+#if THREADED_NULL_OSYSTEM_IS_AVAILABLE
+		Common::install_threaded_null_g_system();
+		{
+			TestVideoDecoder decoder;
+			decoder.load(20, true);
+
+			// The worker thread reads the packets along with the frames,
+			// and decodeNextFrame() does not read them a second time
+			TS_ASSERT(decoder.setDecodeAhead(3));
+			checkFrames(decoder, 0, 9);
+			TS_ASSERT(!decoder.setDecodeAhead(0));
+			checkFrames(decoder, 10, 19);
+			TS_ASSERT(decoder.endOfVideo());
+			TS_ASSERT_EQUALS(decoder.getPacketsRead(), 20);
+		}
+		Common::install_null_g_system();
+#endif
+	}
+
+	void test_stop_decode_ahead() {
+#if THREADED_NULL_OSYSTEM_IS_AVAILABLE
+		Common::install_threaded_null_g_system();
+		{
+			TestVideoDecoder decoder;
+			decoder.load(20);
+
+			// Frames decoded ahead before stopping are not skipped
+			TS_ASSERT(decoder.setDecodeAhead(5));
+			checkFrames(decoder, 0, 4);
+			TS_ASSERT(!decoder.setDecodeAhead(0));
+			checkFrames(decoder, 5, 12);
+
+			// Resuming continues after the frames decoded synchronously,
+			// with a different queue size
+			TS_ASSERT(decoder.setDecodeAhead(2));
+			checkFrames(decoder, 13, 19);
+			TS_ASSERT(decoder.endOfVideo());
+		}
+		Common::install_null_g_system();
+#endif
+	}
+};
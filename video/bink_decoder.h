@@ -78,6 +78,9 @@ public:
 
 protected:
 	void readNextPacket();
+	// Packets are read from our own stream, and audio is queued into
+	// QueuingAudioStreams, so frames can be read and decoded ahead
+	bool canReadPacketsAhead() const { return true; }
 	bool supportsAudioTrackSwitching() const { return true; }
 	AudioTrack *getAudioTrack(int index);
 	bool seekIntern(const Audio::Timestamp &time);
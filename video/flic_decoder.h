@@ -53,11 +53,14 @@ public:
 
 	virtual bool loadStream(Common::SeekableReadStream *stream);
 
+	// These access the video track, and must not be used while decoding ahead
 	const Common::List<Common::Rect> *getDirtyRects() const;
 	void clearDirtyRects();
 	void copyDirtyRectsToBuffer(uint8 *dst, uint pitch);
 
 protected:
+	virtual bool canDecodeAhead() const { return true; }
+
 	class FlicVideoTrack : public VideoTrack {
 	public:
 		FlicVideoTrack(Common::SeekableReadStream *stream, uint16 frameCount, uint16 width, uint16 height, bool skipHeader = false);
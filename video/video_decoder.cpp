@@ -26,10 +26,300 @@
 
 #include "common/rational.h"
 #include "common/file.h"
+#include "common/mutex.h"
 #include "common/system.h"
+#include "common/threadpool.h"
+
+#include "graphics/surface.h"
 
 namespace Video {
 
+namespace {
+
+void addDecodedFrame(VideoDecoder::DecodeStats &stats, uint32 decodeTime) {
+	stats.framesDecoded++;
+	stats.totalDecodeTime += decodeTime;
+	stats.maxDecodeTime = MAX(stats.maxDecodeTime, decodeTime);
+}
+
+} // End of anonymous namespace
+
+/**
+ * Frames of a video track decoded ahead on a worker thread.
+ *
+ * Every job decodes a single frame and queues the next job itself while
+ * there is room left, so only one job uses the track at a time. The main
+ * thread only touches the track again after stop(). Jobs only call the
+ * video track, and readNextPacket() for decoders supporting it, and do not
+ * measure time, as they must not use OSystem.
+ */
+class VideoDecoder::DecodeAheadQueue {
+public:
+	struct Frame {
+		Frame() : hasSurface(false), curFrame(-1), nextFrameStartTime(0), endOfTrack(false), dirtyPalette(false) {}
+
+		Graphics::Surface surface;
+		bool hasSurface;
+		// The state of the track after decoding this frame
+		int curFrame;
+		uint32 nextFrameStartTime;
+		bool endOfTrack;
+		bool dirtyPalette;
+		byte palette[256 * 3];
+	};
+
+	DecodeAheadQueue(VideoDecoder *decoder, VideoTrack *track, bool readPackets);
+	~DecodeAheadQueue();
+
+	bool hasWorker() const { return _pool.getWorkerCount() != 0; }
+	VideoTrack *getTrack() const { return _track; }
+
+	/** Whether the worker thread also calls readNextPacket() for every frame. */
+	bool readsPackets() const { return _readPackets; }
+
+	/**
+	 * Set the maximum number of frames decoded ahead. Frames already in the
+	 * queue are kept. Must only be called while stopped.
+	 */
+	void setSize(uint numFrames);
+	uint getSize() const { return _size; }
+
+	/** Start decoding ahead from the current state of the track. */
+	void start();
+
+	/**
+	 * Wait for the worker thread to finish. The frames decoded so far are
+	 * kept, and still returned by nextFrame().
+	 */
+	void stop();
+
+	/** Stop, and drop all queued frames. */
+	void flush();
+
+	/** Whether the worker thread may be decoding frames ahead. */
+	bool isDecoding() const { return !_stop; }
+
+	/**
+	 * Whether the state of the track is ahead of the frame last returned,
+	 * because frames are decoded ahead or are still queued.
+	 */
+	bool isRunning() const { return _running; }
+
+	/**
+	 * Take the next frame from the queue, waiting for it to be decoded if
+	 * needed. It stays valid until the next call.
+	 *
+	 * @return the frame, or 0 if the whole track has been decoded or the
+	 *         queue has been drained after stop()
+	 */
+	const Frame *nextFrame();
+
+	/** The frame last returned by nextFrame() */
+	const Frame &getCurrent() const { return _current; }
+
+	/** The palette of the frames returned so far */
+	const byte *getPalette() const { return _palette; }
+
+	DecodeStats getStats() const;
+
+private:
+	void decodeFrame();
+	void submit();
+
+	VideoDecoder *_decoder;
+	VideoTrack *_track;
+	bool _readPackets;
+
+	Common::ThreadPool _pool;
+	mutable Common::Mutex _mutex;
+	Common::Future<void> _job;
+	bool _jobActive;
+	bool _stop;
+	bool _ended;
+
+	Common::Array<Frame> _queue;
+	uint _head;
+	uint _count;
+	uint _size;
+
+	bool _running;
+	Frame _current;
+	byte _palette[256 * 3];
+};
+
+// Only one job runs at a time, so a single worker thread is enough. The
+// pool counts the thread waiting for the frames as one of its threads.
+VideoDecoder::DecodeAheadQueue::DecodeAheadQueue(VideoDecoder *decoder, VideoTrack *track, bool readPackets) :
+		_decoder(decoder), _track(track), _readPackets(readPackets), _pool(2),
+		_jobActive(false), _stop(true), _ended(false),
+		_head(0), _count(0), _size(0), _running(false) {
+	memset(_palette, 0, sizeof(_palette));
+}
+
+VideoDecoder::DecodeAheadQueue::~DecodeAheadQueue() {
+	stop();
+
+	for (uint i = 0; i < _queue.size(); i++)
+		_queue[i].surface.free();
+	_current.surface.free();
+}
+
+void VideoDecoder::DecodeAheadQueue::setSize(uint numFrames) {
+	assert(_stop);
+
+	// Keep the queued frames in order at the start of the new queue
+	Common::Array<Frame> queue(MAX(numFrames, _count));
+	for (uint i = 0; i < _count; i++)
+		SWAP(queue[i], _queue[(_head + i) % _queue.size()]);
+
+	for (uint i = 0; i < _queue.size(); i++)
+		_queue[i].surface.free();
+
+	_queue = queue;
+	_head = 0;
+	_size = numFrames;
+}
+
+void VideoDecoder::DecodeAheadQueue::start() {
+	assert(_size != 0);
+
+	if (!_running) {
+		_current.curFrame = _track->getCurFrame();
+		_current.nextFrameStartTime = _track->getNextFrameStartTime();
+		_current.endOfTrack = _track->endOfTrack();
+		_running = true;
+	}
+
+	// The track is past the frames still queued
+	Common::StackLock lock(_mutex);
+	_stop = false;
+	_ended = _track->endOfTrack();
+	if (!_ended && _count < _size)
+		submit();
+}
+
+void VideoDecoder::DecodeAheadQueue::stop() {
+	_mutex.lock();
+	_stop = true;
+	while (_jobActive) {
+		Common::Future<void> job = _job;
+		_mutex.unlock();
+		job.wait();
+		_mutex.lock();
+	}
+	_mutex.unlock();
+
+	if (_count == 0)
+		_running = false;
+}
+
+void VideoDecoder::DecodeAheadQueue::flush() {
+	stop();
+
+	Common::StackLock lock(_mutex);
+	_head = _count = 0;
+	_ended = false;
+	_track->_decodeStats.queueDepth = 0;
+	_running = false;
+}
+
+const VideoDecoder::DecodeAheadQueue::Frame *VideoDecoder::DecodeAheadQueue::nextFrame() {
+	const uint32 startTime = g_system->getMillis();
+
+	_mutex.lock();
+
+	DecodeStats &stats = _track->_decodeStats;
+	if (_count == 0 && _jobActive)
+		stats.underruns++;
+
+	while (_count == 0 && _jobActive) {
+		Common::Future<void> job = _job;
+		_mutex.unlock();
+		job.wait();
+		_mutex.lock();
+	}
+
+	if (_count == 0) {
+		// Once drained, the track is back at the frame last returned
+		if (_stop)
+			_running = false;
+		_mutex.unlock();
+		return 0;
+	}
+
+	SWAP(_current, _queue[_head]);
+	_head = (_head + 1) % _queue.size();
+	_count--;
+	stats.queueDepth = _count;
+
+	// The time spent on the frame is the time this thread had to wait for it
+	addDecodedFrame(stats, g_system->getMillis() - startTime);
+
+	if (!_stop && !_jobActive && !_ended)
+		submit();
+
+	_mutex.unlock();
+
+	if (_current.dirtyPalette)
+		memcpy(_palette, _current.palette, sizeof(_palette));
+
+	return &_current;
+}
+
+VideoDecoder::DecodeStats VideoDecoder::DecodeAheadQueue::getStats() const {
+	Common::StackLock lock(_mutex);
+	return _track->_decodeStats;
+}
+
+void VideoDecoder::DecodeAheadQueue::submit() {
+	_jobActive = true;
+	_job = _pool.submit([this]() { decodeFrame(); });
+}
+
+void VideoDecoder::DecodeAheadQueue::decodeFrame() {
+	uint slot;
+
+	{
+		Common::StackLock lock(_mutex);
+		if (_stop || _ended || _count >= _size) {
+			_jobActive = false;
+			return;
+		}
+
+		slot = (_head + _count) % _queue.size();
+	}
+
+	// The slot is not part of the queue yet, so it can be written unlocked
+	Frame &frame = _queue[slot];
+	if (_readPackets)
+		_decoder->readNextPacket();
+	const Graphics::Surface *surface = _track->decodeNextFrame();
+
+	frame.hasSurface = surface != 0;
+	if (surface)
+		frame.surface.copyFrom(*surface);
+
+	frame.curFrame = _track->getCurFrame();
+	frame.nextFrameStartTime = _track->getNextFrameStartTime();
+	frame.endOfTrack = _track->endOfTrack();
+	frame.dirtyPalette = _track->hasDirtyPalette();
+	if (frame.dirtyPalette)
+		memcpy(frame.palette, _track->getPalette(), sizeof(frame.palette));
+
+	Common::StackLock lock(_mutex);
+	_count++;
+	_ended = frame.endOfTrack;
+
+	DecodeStats &stats = _track->_decodeStats;
+	stats.queueDepth = _count;
+	stats.maxQueueDepth = MAX(stats.maxQueueDepth, _count);
+
+	if (!_stop && !_ended && _count < _size)
+		submit();
+	else
+		_jobActive = false;
+}
+
 VideoDecoder::VideoDecoder() {
 	_startTime = 0;
 	_dirtyPalette = false;
@@ -47,9 +337,16 @@ VideoDecoder::VideoDecoder() {
 	_mainAudioTrack = 0;
 	_canSetDither = true;
 	_canSetDefaultFormat = true;
+	_decodeAhead = 0;
+}
+
+VideoDecoder::~VideoDecoder() {
+	stopDecodeAhead();
 }
 
 void VideoDecoder::close() {
+	stopDecodeAhead();
+
 	if (isPlaying())
 		stop();
 
@@ -204,7 +501,46 @@ const Graphics::Surface *VideoDecoder::decodeNextFrame() {
 	_canSetDither = false;
 	_canSetDefaultFormat = false;
 
-	readNextPacket();
+	const uint32 startTime = g_system->getMillis();
+
+	bool packetRead = false;
+
+	if (_decodeAhead) {
+		if (!_decodeAhead->isDecoding() && _decodeAhead->getSize() != 0)
+			_decodeAhead->start();
+
+		if (_decodeAhead->isRunning()) {
+			// Unless the worker thread reads the packets of the frames it
+			// decodes, it only decodes the video track
+			if (!_decodeAhead->readsPackets()) {
+				readNextPacket();
+				packetRead = true;
+			}
+
+			const DecodeAheadQueue::Frame *frame = _decodeAhead->nextFrame();
+			if (frame) {
+				if (frame->dirtyPalette) {
+					_palette = _decodeAhead->getPalette();
+					_dirtyPalette = true;
+				}
+
+				_nextVideoTrack = frame->endOfTrack ? 0 : _decodeAhead->getTrack();
+				return frame->hasSurface ? &frame->surface : 0;
+			}
+
+			// The whole video track has been decoded
+			if (_decodeAhead->isRunning()) {
+				_nextVideoTrack = 0;
+				return 0;
+			}
+
+			// Decoding ahead was stopped, and all frames decoded ahead have
+			// been returned, so continue with the track itself
+		}
+	}
+
+	if (!packetRead)
+		readNextPacket();
 
 	// If we have no next video track at this point, there shouldn't be
 	// any frame available for us to display.
@@ -212,6 +548,7 @@ const Graphics::Surface *VideoDecoder::decodeNextFrame() {
 		return 0;
 
 	const Graphics::Surface *frame = _nextVideoTrack->decodeNextFrame();
+	addDecodedFrame(_nextVideoTrack->_decodeStats, g_system->getMillis() - startTime);
 
 	if (_nextVideoTrack->hasDirtyPalette()) {
 		_palette = _nextVideoTrack->getPalette();
@@ -229,6 +566,10 @@ bool VideoDecoder::setReverse(bool reverse) {
 	if (reverse && hasAudio())
 		return false;
 
+	// Frames are only decoded ahead when playing forward
+	if (reverse && _decodeAhead && (_decodeAhead->getSize() != 0 || _decodeAhead->isRunning()))
+		return false;
+
 	// Attempt to make sure all the tracks are in the requested direction
 	for (TrackList::iterator it = _tracks.begin(); it != _tracks.end(); it++) {
 		if ((*it)->getTrackType() == Track::kTrackTypeVideo && ((VideoTrack *)*it)->isReversed() != reverse) {
@@ -253,7 +594,7 @@ int VideoDecoder::getCurFrame() const {
 
 	for (TrackList::const_iterator it = _tracks.begin(); it != _tracks.end(); it++)
 		if ((*it)->getTrackType() == Track::kTrackTypeVideo)
-			frame += ((VideoTrack *)*it)->getCurFrame() + 1;
+			frame += getVideoTrackCurFrame((const VideoTrack *)*it) + 1;
 
 	return frame;
 }
@@ -294,7 +635,7 @@ uint32 VideoDecoder::getTimeToNextFrame() const {
 		return 0;
 
 	uint32 currentTime = getTime();
-	uint32 nextFrameStartTime = _nextVideoTrack->getNextFrameStartTime();
+	uint32 nextFrameStartTime = getVideoTrackNextFrameStartTime(_nextVideoTrack);
 
 	if (_nextVideoTrack->isReversed()) {
 		// For reversed videos, we need to handle the time difference the opposite way.
@@ -315,8 +656,15 @@ bool VideoDecoder::endOfVideo() const {
 	for (TrackList::const_iterator it = _tracks.begin(); it != _tracks.end(); it++) {
 		const Track *track = *it;
 
-		bool videoEndTimeReached = _endTimeSet && track->getTrackType() == Track::kTrackTypeVideo && ((const VideoTrack *)track)->getNextFrameStartTime() >= (uint)_endTime.msecs();
-		bool endReached = track->endOfTrack() || (isPlaying() && videoEndTimeReached);
+		bool endReached;
+		if (track->getTrackType() == Track::kTrackTypeVideo) {
+			const VideoTrack *videoTrack = (const VideoTrack *)track;
+			bool videoEndTimeReached = _endTimeSet && getVideoTrackNextFrameStartTime(videoTrack) >= (uint)_endTime.msecs();
+			endReached = videoTrackEnded(videoTrack) || (isPlaying() && videoEndTimeReached);
+		} else {
+			endReached = track->endOfTrack();
+		}
+
 		if (!endReached)
 			return false;
 	}
@@ -339,6 +687,10 @@ bool VideoDecoder::rewind() {
 	if (!isRewindable())
 		return false;
 
+	// Drop the frames decoded from the old position
+	if (_decodeAhead)
+		_decodeAhead->flush();
+
 	// Stop all tracks so they can be rewound
 	if (isPlaying())
 		stopAudio();
@@ -373,6 +725,10 @@ bool VideoDecoder::seek(const Audio::Timestamp &time) {
 	if (!isSeekable())
 		return false;
 
+	// Drop the frames decoded from the old position
+	if (_decodeAhead)
+		_decodeAhead->flush();
+
 	// Stop all tracks so they can be seeked
 	if (isPlaying())
 		stopAudio();
@@ -568,6 +924,84 @@ bool VideoDecoder::Track::isRewindable() const {
 	return isSeekable();
 }
 
+bool VideoDecoder::setDecodeAhead(uint numFrames) {
+	// Frames already decoded ahead are still returned by decodeNextFrame()
+	// before decoding from the track again, so none are skipped
+	if (_decodeAhead) {
+		_decodeAhead->stop();
+		_decodeAhead->setSize(0);
+	}
+
+	if (numFrames == 0 || !(canDecodeAhead() || canReadPacketsAhead()))
+		return false;
+
+	VideoTrack *track = 0;
+
+	for (TrackList::iterator it = _tracks.begin(); it != _tracks.end(); it++) {
+		if ((*it)->getTrackType() == Track::kTrackTypeVideo) {
+			// We only decode ahead when one video track is present
+			if (track)
+				return false;
+
+			track = (VideoTrack *)*it;
+		}
+	}
+
+	if (!track || track->isReversed())
+		return false;
+
+	if (!_decodeAhead) {
+		_decodeAhead = new DecodeAheadQueue(this, track, !canDecodeAhead());
+		if (!_decodeAhead->hasWorker()) {
+			stopDecodeAhead();
+			return false;
+		}
+	}
+
+	_decodeAhead->setSize(numFrames);
+	return true;
+}
+
+VideoDecoder::DecodeStats VideoDecoder::getDecodeStats(uint track) const {
+	for (TrackList::const_iterator it = _tracks.begin(); it != _tracks.end(); it++) {
+		if ((*it)->getTrackType() != Track::kTrackTypeVideo || track-- != 0)
+			continue;
+
+		if (_decodeAhead && _decodeAhead->getTrack() == *it)
+			return _decodeAhead->getStats();
+
+		return ((const VideoTrack *)*it)->getDecodeStats();
+	}
+
+	return DecodeStats();
+}
+
+void VideoDecoder::stopDecodeAhead() {
+	delete _decodeAhead;
+	_decodeAhead = 0;
+}
+
+int VideoDecoder::getVideoTrackCurFrame(const VideoTrack *track) const {
+	if (_decodeAhead && _decodeAhead->isRunning() && _decodeAhead->getTrack() == track)
+		return _decodeAhead->getCurrent().curFrame;
+
+	return track->getCurFrame();
+}
+
+uint32 VideoDecoder::getVideoTrackNextFrameStartTime(const VideoTrack *track) const {
+	if (_decodeAhead && _decodeAhead->isRunning() && _decodeAhead->getTrack() == track)
+		return _decodeAhead->getCurrent().nextFrameStartTime;
+
+	return track->getNextFrameStartTime();
+}
+
+bool VideoDecoder::videoTrackEnded(const VideoTrack *track) const {
+	if (_decodeAhead && _decodeAhead->isRunning() && _decodeAhead->getTrack() == track)
+		return _decodeAhead->getCurrent().endOfTrack;
+
+	return track->endOfTrack();
+}
+
 bool VideoDecoder::Track::rewind() {
 	return seek(Audio::Timestamp(0, 1000));
 }
@@ -939,7 +1373,7 @@ const VideoDecoder::Track *VideoDecoder::getTrack(uint track) const {
 
 bool VideoDecoder::endOfVideoTracks() const {
 	for (TrackList::const_iterator it = _tracks.begin(); it != _tracks.end(); it++)
-		if ((*it)->getTrackType() == Track::kTrackTypeVideo && !(*it)->endOfTrack())
+		if ((*it)->getTrackType() == Track::kTrackTypeVideo && !videoTrackEnded((const VideoTrack *)*it))
 			return false;
 
 	return true;
@@ -950,9 +1384,9 @@ VideoDecoder::VideoTrack *VideoDecoder::findNextVideoTrack() {
 	uint32 bestTime = 0xFFFFFFFF;
 
 	for (TrackList::iterator it = _tracks.begin(); it != _tracks.end(); it++) {
-		if ((*it)->getTrackType() == Track::kTrackTypeVideo && !(*it)->endOfTrack()) {
+		if ((*it)->getTrackType() == Track::kTrackTypeVideo && !videoTrackEnded((const VideoTrack *)*it)) {
 			VideoTrack *track = (VideoTrack *)*it;
-			uint32 time = track->getNextFrameStartTime();
+			uint32 time = getVideoTrackNextFrameStartTime(track);
 
 			if (time < bestTime) {
 				bestTime = time;
@@ -1006,8 +1440,8 @@ bool VideoDecoder::hasFramesLeft() const {
 
 		const VideoTrack *track = (const VideoTrack *)*it;
 
-		bool videoEndTimeReached = _endTimeSet && track->getNextFrameStartTime() >= (uint)_endTime.msecs();
-		bool endReached = track->endOfTrack() || (isPlaying() && videoEndTimeReached);
+		bool videoEndTimeReached = _endTimeSet && getVideoTrackNextFrameStartTime(track) >= (uint)_endTime.msecs();
+		bool endReached = videoTrackEnded(track) || (isPlaying() && videoEndTimeReached);
 		if (!endReached)
 			return true;
 	}
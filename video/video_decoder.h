@@ -52,7 +52,7 @@ namespace Video {
 class VideoDecoder {
 public:
 	VideoDecoder();
-	virtual ~VideoDecoder() {}
+	virtual ~VideoDecoder();
 
 	/////////////////////////////////////////
 	// Opening/Closing a Video
@@ -395,6 +395,51 @@ public:
 	 */
 	bool setOutputPixelFormat(const Graphics::PixelFormat &format);
 
+	/**
+	 * Statistics about decoding the frames of a video track.
+	 */
+	struct DecodeStats {
+		DecodeStats() : framesDecoded(0), totalDecodeTime(0), maxDecodeTime(0),
+			queueDepth(0), maxQueueDepth(0), underruns(0) {}
+
+		uint32 framesDecoded;   ///< Number of frames decoded
+		uint32 totalDecodeTime; ///< Time spent decoding the frames, in ms, or waiting for them when decoded ahead
+		uint32 maxDecodeTime;   ///< Longest time spent on a single frame, in ms
+		uint32 queueDepth;      ///< Number of frames currently decoded ahead
+		uint32 maxQueueDepth;   ///< Highest number of frames decoded ahead at once
+		uint32 underruns;       ///< Number of frames that were due before being decoded ahead
+	};
+
+	/**
+	 * Decode frames ahead on a worker thread.
+	 *
+	 * The video track then decodes up to numFrames frames into a queue
+	 * while the current frame is displayed, and decodeNextFrame() returns
+	 * the next frame of the queue. Seeking and rewinding flush the queue.
+	 * This needs thread support, and is only available for decoders
+	 * supporting it (see canDecodeAhead()) with a single video track
+	 * playing forward.
+	 *
+	 * While frames are decoded ahead, the worker thread uses the video
+	 * track, so subclasses must not access it directly. readNextPacket()
+	 * still runs on the calling thread, unless the decoder reads packets
+	 * on the worker thread as well (see canReadPacketsAhead()). close()
+	 * stops the worker thread first.
+	 *
+	 * @param numFrames The maximum number of frames to decode ahead, or 0
+	 *                  to decode synchronously in decodeNextFrame() again,
+	 *                  once the frames already decoded ahead are returned.
+	 * @return true if frames are decoded ahead
+	 */
+	bool setDecodeAhead(uint numFrames);
+
+	/**
+	 * Get the decoding statistics of a video track.
+	 *
+	 * @param track The index of the track among the video tracks.
+	 */
+	DecodeStats getDecodeStats(uint track = 0) const;
+
 	/////////////////////////////////////////
 	// Audio Control
 	/////////////////////////////////////////
@@ -654,6 +699,16 @@ protected:
 		 * Activate dithering mode with a palette
 		 */
 		virtual void setDither(const byte *palette) {}
+
+		/**
+		 * Get the statistics about the frames decoded by VideoDecoder.
+		 */
+		const DecodeStats &getDecodeStats() const { return _decodeStats; }
+
+	private:
+		friend class VideoDecoder;
+
+		DecodeStats _decodeStats;
 	};
 
 	/**
@@ -880,6 +935,29 @@ protected:
 	 */
 	virtual bool useAudioSync() const { return true; }
 
+	/**
+	 * Whether the video track can decode frames on a worker thread, see
+	 * setDecodeAhead().
+	 *
+	 * A subclass can override this to enable this feature, if its video
+	 * tracks do not depend on readNextPacket() and only touch their own
+	 * data when decoding a frame.
+	 */
+	virtual bool canDecodeAhead() const { return false; }
+
+	/**
+	 * Whether readNextPacket() can run on the worker thread along with the
+	 * video track, see setDecodeAhead(). This is used by decoders whose
+	 * video tracks depend on readNextPacket(), if canDecodeAhead() does not
+	 * hold.
+	 *
+	 * A subclass can override this to enable this feature, if
+	 * readNextPacket() only touches the stream and the tracks of the
+	 * decoder, and its audio tracks take packets in a thread-safe way, like
+	 * a QueuingAudioStream does, or the video has no audio.
+	 */
+	virtual bool canReadPacketsAhead() const { return false; }
+
 	/**
 	 * Get the given track based on its index.
 	 *
@@ -979,6 +1057,17 @@ private:
 	bool _canSetDither;
 	bool _canSetDefaultFormat;
 
+	// Frames decoded ahead on a worker thread, see setDecodeAhead()
+	class DecodeAheadQueue;
+	DecodeAheadQueue *_decodeAhead;
+
+	void stopDecodeAhead();
+
+	// The state of a video track, as seen by the displayed frame
+	int getVideoTrackCurFrame(const VideoTrack *track) const;
+	uint32 getVideoTrackNextFrameStartTime(const VideoTrack *track) const;
+	bool videoTrackEnded(const VideoTrack *track) const;
+
 protected:
 	// Internal helper functions
 	void stopAudio();